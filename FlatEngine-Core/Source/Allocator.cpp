@@ -80,7 +80,7 @@ namespace FlatEngine
 		// Default Descriptor Set Layout config
 		VkDescriptorSetLayoutBinding uboLayoutBinding{};
 		uboLayoutBinding.binding = 0;
-		uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC; // Points into VM_uniformRing, offset given at bind time
 		uboLayoutBinding.descriptorCount = 1;
 		uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 		uboLayoutBinding.pImmutableSamplers = nullptr; // Optional
@@ -172,7 +172,7 @@ namespace FlatEngine
 	{
 		// Default Descriptor Pool Settings	
 		m_poolSizes = std::vector<VkDescriptorPoolSize>(m_textureCount + 1, {});
-		m_poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		m_poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 		m_poolSizes[0].descriptorCount = static_cast<uint32_t>(m_sizePerPool);
 		for (uint32_t j = 1; j < m_textureCount + 1; j++)
 		{
@@ -232,6 +232,12 @@ namespace FlatEngine
 				FlatEngine::LogError("failed to allocate descriptor sets!");
 			}
 
+			bool b_hasUniforms = model.GetModelPath() != "";
+			if (b_hasUniforms)
+			{
+				WriteUniformDescriptors(descriptorSets);
+			}
+
 			for (int i = 0; i < VM_MAX_FRAMES_IN_FLIGHT; i++)
 			{
 				int descriptorCounter = 0;
@@ -239,23 +245,8 @@ namespace FlatEngine
 				std::vector<VkWriteDescriptorSet> descriptorWrites{};
 				descriptorWrites.resize(newSize);
 
-				if (model.GetModelPath() != "")
+				if (b_hasUniforms)
 				{
-					descriptorWrites.resize(newSize + 1);
-
-					VkDescriptorBufferInfo bufferInfo{};
-					bufferInfo.buffer = model.GetUniformBuffers()[i];
-					bufferInfo.offset = 0;
-					bufferInfo.range = sizeof(UniformBufferObject);
-
-					descriptorWrites[descriptorCounter].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-					descriptorWrites[descriptorCounter].dstSet = descriptorSets[i];
-					descriptorWrites[descriptorCounter].dstBinding = 0;
-					descriptorWrites[descriptorCounter].dstArrayElement = 0;
-					descriptorWrites[descriptorCounter].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-					descriptorWrites[descriptorCounter].descriptorCount = 1;
-					descriptorWrites[descriptorCounter].pBufferInfo = &bufferInfo;
-
 					descriptorCounter++;
 				}
 
@@ -268,13 +259,13 @@ namespace FlatEngine
 					imageInfos[j].imageView = textures[j].GetImageView();
 					imageInfos[j].sampler = textures[j].GetTextureSampler();
 
-					descriptorWrites[descriptorCounter].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-					descriptorWrites[descriptorCounter].dstSet = descriptorSets[i];
-					descriptorWrites[descriptorCounter].dstBinding = descriptorCounter;
-					descriptorWrites[descriptorCounter].dstArrayElement = 0;
-					descriptorWrites[descriptorCounter].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-					descriptorWrites[descriptorCounter].descriptorCount = 1;
-					descriptorWrites[descriptorCounter].pImageInfo = &imageInfos[j];
+					descriptorWrites[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					descriptorWrites[j].dstSet = descriptorSets[i];
+					descriptorWrites[j].dstBinding = descriptorCounter;
+					descriptorWrites[j].dstArrayElement = 0;
+					descriptorWrites[j].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+					descriptorWrites[j].descriptorCount = 1;
+					descriptorWrites[j].pImageInfo = &imageInfos[j];
 
 					descriptorCounter++;
 				}
@@ -293,6 +284,29 @@ namespace FlatEngine
 		}
 	}
 
+	// Binding 0 of each frame's set points at that frame's VM_uniformRing buffer, called again whenever the ring is reallocated
+	void Allocator::WriteUniformDescriptors(std::vector<VkDescriptorSet>& descriptorSets)
+	{
+		for (int i = 0; i < VM_MAX_FRAMES_IN_FLIGHT && i < (int)descriptorSets.size(); i++)
+		{
+			VkDescriptorBufferInfo bufferInfo{};
+			bufferInfo.buffer = VM_uniformRing.GetBuffer(i);
+			bufferInfo.offset = 0;
+			bufferInfo.range = sizeof(UniformBufferObject);
+
+			VkWriteDescriptorSet descriptorWrite{};
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstSet = descriptorSets[i];
+			descriptorWrite.dstBinding = 0;
+			descriptorWrite.dstArrayElement = 0;
+			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.pBufferInfo = &bufferInfo;
+
+			vkUpdateDescriptorSets(m_deviceHandle->GetDevice(), 1, &descriptorWrite, 0, nullptr);
+		}
+	}
+
 	void Allocator::CheckPoolAvailability()
 	{
 		uint32_t availableSets = m_allocationsRemainingByPool[m_currentPoolIndex];
@@ -26,6 +26,7 @@ namespace FlatEngine
 		void Init(AllocatorType type, uint32_t textureCount, LogicalDevice& logicalDevice, uint32_t perPool = 50);
 		void SetFreed(uint32_t freedFrom);
 		void AllocateDescriptorSets(std::vector<VkDescriptorSet>& descriptorSets, Model& model, std::vector<Texture>& textures, int& allocatedFrom);
+		void WriteUniformDescriptors(std::vector<VkDescriptorSet>& descriptorSets);
 		void ConfigureDescriptorSetLayout(std::vector<VkDescriptorSetLayoutBinding> bindings, VkDescriptorSetLayoutCreateInfo layoutInfo);
 		void CreateDescriptorSetLayout();
 		void CleanupDescriptorSetLayout();
@@ -24,6 +24,7 @@ namespace FlatEngine
 			m_windowWidth = 1920;
 			m_windowHeight = 1080;
 			m_directoryType = NoDir;  // Tells the engine where to look for the xxxDirectories.lua file containing important paths and dir locations
+			m_exitCode = 1;
 		}
 		~Application() {};
 
@@ -49,6 +50,8 @@ namespace FlatEngine
 
 		void Quit() { m_b_hasQuit = true; };
 		bool& HasQuit() { return m_b_hasQuit; };
+		void SetExitCode(int exitCode) { m_exitCode = exitCode; };
+		int GetExitCode() { return m_exitCode; };
 		virtual void OnLoadScene(std::string sceneName) {};
 		
 	private:
@@ -57,5 +60,6 @@ namespace FlatEngine
 		int m_windowWidth;
 		int m_windowHeight;
 		DirectoryType m_directoryType;
+		int m_exitCode;
 	};
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "AssetManager.h"
 #include "FlatEngine.h"
 #include "Texture.h"
+#include "TextureCache.h"
+#include "VirtualFileSystem.h"
 #include "Vector4.h"
 #include "Project.h"
 
@@ -62,7 +64,7 @@ namespace FlatEngine
 		// Load in lua script
 		if (DoesFileExist(dirPath))
 		{
-			auto script = F_Lua.safe_script_file(dirPath);
+			auto script = RunLuaScriptFile(dirPath);
 			std::optional<sol::table> dirTable = F_Lua["F_Dirs"];
 			std::optional<sol::table> pathTable = F_Lua["F_Paths"];
 
@@ -110,7 +112,7 @@ namespace FlatEngine
 			if (CheckLuaScriptFile(GetFilePath("colors")))
 			{
 				m_colors.clear();
-				auto script = F_Lua.safe_script_file(GetFilePath("colors"));
+				auto script = RunLuaScriptFile(GetFilePath("colors"));
 				std::optional<sol::table> colorTable = F_Lua["F_Colors"];
 
 				if (colorTable)
@@ -141,7 +143,7 @@ namespace FlatEngine
 			if (CheckLuaScriptFile(GetFilePath("textures")))
 			{
 				m_textures.clear();
-				auto script = F_Lua.safe_script_file(GetFilePath("textures"));
+				auto script = RunLuaScriptFile(GetFilePath("textures"));
 				sol::object errPath = F_Lua["F_ResourceFailedToLoadImagePath"];
 				m_resourceFailedToLoadImagePath = errPath.as<std::string>();
 				m_errorTexture->LoadFromFile(m_resourceFailedToLoadImagePath);
@@ -156,9 +158,12 @@ namespace FlatEngine
 						std::string sKey = key.as<std::string>();     // cast key as a string
 						std::string sValue = value.as<std::string>(); // cast key as a string
 
-						std::shared_ptr<Texture> newTexture = std::make_shared<Texture>();
-						m_textures.emplace(sKey, newTexture);
-						m_textures.at(sKey)->LoadFromFile(sValue);
+						// Decoded off the main thread, the error texture is shown until the image is uploaded
+						std::shared_ptr<Texture> newTexture = F_TextureCache.Acquire(sValue);
+						if (newTexture != nullptr)
+						{
+							m_textures.emplace(sKey, newTexture);
+						}
 					}
 				}
 			}
@@ -240,6 +245,11 @@ namespace FlatEngine
 		}
 	}
 
+	std::shared_ptr<Texture> AssetManager::GetErrorTexture()
+	{
+		return m_errorTexture;
+	}
+
 	VkDescriptorSet AssetManager::GetTexture(std::string textureName)
 	{
 		if (m_textures.count(textureName))
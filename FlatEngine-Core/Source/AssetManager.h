@@ -33,6 +33,7 @@ namespace FlatEngine
 		Vector4 GetColor(std::string colorName);
 		Uint32 GetColor32(std::string colorName);
 		std::shared_ptr<Texture>GetTextureObject(std::string textureName);
+		std::shared_ptr<Texture> GetErrorTexture();
 		VkDescriptorSet GetTexture(std::string textureName);		
 	private:
 		std::map<std::string, std::string> m_directories;
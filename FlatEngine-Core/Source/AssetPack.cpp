@@ -0,0 +1,427 @@
+#include "AssetPack.h"
+#include "VirtualFileSystem.h"
+#include "CookedTexture.h"
+#include "CookedMesh.h"
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+
+
+namespace FlatEngine
+{
+	AssetPack::AssetPack()
+	{
+		m_header = AssetPackHeader();
+		m_entries = nullptr;
+		m_pathTable = nullptr;
+	}
+
+	AssetPack::~AssetPack()
+	{
+		Close();
+	}
+
+	bool AssetPack::Open(std::string packPath)
+	{
+		Close();
+
+		if (!m_file.Open(packPath) || m_file.GetSize() < sizeof(AssetPackHeader))
+		{
+			Close();
+			return false;
+		}
+
+		memcpy(&m_header, m_file.GetData(), sizeof(AssetPackHeader));
+		uint64_t tableEnd = sizeof(AssetPackHeader) + (uint64_t)m_header.entryCount * sizeof(AssetPackEntry) + m_header.pathTableSize;
+		if (m_header.magic != ASSET_PACK_MAGIC || m_header.version != ASSET_PACK_VERSION || tableEnd > m_file.GetSize())
+		{
+			Close();
+			return false;
+		}
+
+		m_entries = (const AssetPackEntry*)(m_file.GetData() + sizeof(AssetPackHeader));
+		m_pathTable = (const char*)(m_entries + m_header.entryCount);
+
+		for (uint32_t i = 0; i < m_header.entryCount; i++)
+		{
+			const AssetPackEntry& entry = m_entries[i];
+			if (entry.offset + entry.storedSize > m_file.GetSize() || (uint64_t)entry.pathOffset + entry.pathLength > m_header.pathTableSize ||
+				(entry.compression == PackStored && entry.storedSize != entry.size) || entry.compression > PackLZ4)
+			{
+				Close();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void AssetPack::Close()
+	{
+		m_file.Close();
+		m_header = AssetPackHeader();
+		m_entries = nullptr;
+		m_pathTable = nullptr;
+	}
+
+	bool AssetPack::IsOpen()
+	{
+		return m_entries != nullptr;
+	}
+
+	uint32_t AssetPack::GetEntryCount()
+	{
+		return m_header.entryCount;
+	}
+
+	const AssetPackEntry* AssetPack::GetEntries()
+	{
+		return m_entries;
+	}
+
+	// Write() refuses packs with colliding hashes, so a matching hash is the entry
+	const AssetPackEntry* AssetPack::Find(std::string path)
+	{
+		if (!IsOpen())
+		{
+			return nullptr;
+		}
+
+		uint64_t hash = HashPath(path);
+		const AssetPackEntry* end = m_entries + m_header.entryCount;
+		const AssetPackEntry* found = std::lower_bound(m_entries, end, hash, [](const AssetPackEntry& entry, uint64_t value) { return entry.pathHash < value; });
+
+		if (found != end && found->pathHash == hash)
+		{
+			return found;
+		}
+		return nullptr;
+	}
+
+	std::string AssetPack::GetEntryPath(const AssetPackEntry& entry)
+	{
+		return std::string(m_pathTable + entry.pathOffset, entry.pathLength);
+	}
+
+	const unsigned char* AssetPack::GetEntryData(const AssetPackEntry& entry)
+	{
+		return m_file.GetData() + entry.offset;
+	}
+
+	bool AssetPack::Decompress(const AssetPackEntry& entry, std::vector<unsigned char>& data)
+	{
+		data.resize(static_cast<size_t>(entry.size));
+		if (entry.compression == PackStored)
+		{
+			memcpy(data.data(), GetEntryData(entry), data.size());
+			return true;
+		}
+		return DecompressLZ4(GetEntryData(entry), static_cast<size_t>(entry.storedSize), data.data(), data.size());
+	}
+
+	// Already compressed formats gain nothing, cooked assets stay stored so they are read in place without a copy
+	static bool ShouldCompress(std::string path)
+	{
+		std::string extension = std::filesystem::path(path).extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char character) { return (char)std::tolower(character); });
+		std::vector<std::string> storedExtensions = { ".png", ".jpg", ".jpeg", ".ogg", ".mp3", COOKED_TEXTURE_EXTENSION, COOKED_MESH_EXTENSION };
+
+		return std::find(storedExtensions.begin(), storedExtensions.end(), extension) == storedExtensions.end();
+	}
+
+	bool AssetPack::Write(std::string packPath, std::vector<std::string>& filePaths, bool b_compress)
+	{
+		struct S_PackFile
+		{
+			std::string path;
+			AssetPackEntry entry;
+		};
+		std::vector<S_PackFile> files;
+		files.reserve(filePaths.size());
+		std::string pathTable = "";
+
+		for (std::string& filePath : filePaths)
+		{
+			S_PackFile file = S_PackFile();
+			file.path = filePath;
+			file.entry.pathHash = HashPath(filePath);
+			file.entry.pathOffset = (uint32_t)pathTable.size();
+			file.entry.pathLength = (uint32_t)filePath.size();
+			pathTable += filePath;
+			files.push_back(file);
+		}
+
+		std::sort(files.begin(), files.end(), [](const S_PackFile& first, const S_PackFile& second) { return first.entry.pathHash < second.entry.pathHash; });
+		for (size_t i = 1; i < files.size(); i++)
+		{
+			if (files[i].entry.pathHash == files[i - 1].entry.pathHash)
+			{
+				return false;
+			}
+		}
+
+		AssetPackHeader header = AssetPackHeader();
+		header.magic = ASSET_PACK_MAGIC;
+		header.version = ASSET_PACK_VERSION;
+		header.entryCount = (uint32_t)files.size();
+		header.pathTableSize = (uint32_t)pathTable.size();
+
+		// Data is written first and the table after it is complete, the table's space is reserved up front
+		std::string tempPath = packPath + ".tmp";
+		{
+			std::ofstream pack(tempPath, std::ios::binary | std::ios::trunc);
+			if (!pack.is_open())
+			{
+				return false;
+			}
+
+			uint64_t offset = sizeof(AssetPackHeader) + files.size() * sizeof(AssetPackEntry) + pathTable.size();
+			std::vector<unsigned char> reserved(static_cast<size_t>(offset), 0);
+			pack.write((const char*)reserved.data(), reserved.size());
+
+			std::vector<unsigned char> contents;
+			std::vector<unsigned char> compressed;
+			for (S_PackFile& file : files)
+			{
+				std::ifstream source(file.path, std::ios::binary | std::ios::ate);
+				if (!source.is_open())
+				{
+					return false;
+				}
+				contents.resize(static_cast<size_t>(source.tellg()));
+				source.seekg(0);
+				source.read((char*)contents.data(), contents.size());
+				if (!source.good() && contents.size() > 0)
+				{
+					return false;
+				}
+
+				uint64_t aligned = (offset + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+				std::vector<char> alignment(static_cast<size_t>(aligned - offset), 0);
+				pack.write(alignment.data(), alignment.size());
+				offset = aligned;
+
+				file.entry.offset = offset;
+				file.entry.size = contents.size();
+				file.entry.compression = PackStored;
+				const unsigned char* data = contents.data();
+				size_t dataSize = contents.size();
+
+				// Kept only when it saves at least an eighth, decompressing costs more than reading a few bytes
+				if (b_compress && ShouldCompress(file.path) && CompressLZ4(contents.data(), contents.size(), compressed) && compressed.size() < contents.size() - contents.size() / 8)
+				{
+					file.entry.compression = PackLZ4;
+					data = compressed.data();
+					dataSize = compressed.size();
+				}
+
+				file.entry.storedSize = dataSize;
+				pack.write((const char*)data, dataSize);
+				offset += dataSize;
+			}
+
+			pack.seekp(0);
+			pack.write((const char*)&header, sizeof(AssetPackHeader));
+			for (S_PackFile& file : files)
+			{
+				pack.write((const char*)&file.entry, sizeof(AssetPackEntry));
+			}
+			pack.write(pathTable.data(), pathTable.size());
+			if (!pack.good())
+			{
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, packPath, error);
+		return !error;
+	}
+
+	// 64-bit FNV-1a of the normalized path, so "..\Images\a.png" and "../images/a.png" find the same entry
+	uint64_t AssetPack::HashPath(std::string path)
+	{
+		std::string normalized = VirtualFileSystem::NormalizePath(path);
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (unsigned char character : normalized)
+		{
+			hash ^= character;
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	// LZ4 block format: sequences of a token, literals, a 16-bit offset and a match length. Greedy matching through a table of
+	// the last position each 4-byte sequence was seen at.
+	// Refer to - https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+	static void WriteLength(std::vector<unsigned char>& output, size_t length)
+	{
+		while (length >= 255)
+		{
+			output.push_back(255);
+			length -= 255;
+		}
+		output.push_back((unsigned char)length);
+	}
+
+	static void WriteSequence(std::vector<unsigned char>& output, const unsigned char* literals, size_t literalLength, size_t offset, size_t matchLength)
+	{
+		size_t matchCode = matchLength >= 4 ? matchLength - 4 : 0;
+		output.push_back((unsigned char)((std::min(literalLength, (size_t)15) << 4) | std::min(matchCode, (size_t)15)));
+		if (literalLength >= 15)
+		{
+			WriteLength(output, literalLength - 15);
+		}
+		output.insert(output.end(), literals, literals + literalLength);
+
+		// The last sequence is only literals
+		if (matchLength == 0)
+		{
+			return;
+		}
+		output.push_back((unsigned char)(offset & 0xFF));
+		output.push_back((unsigned char)(offset >> 8));
+		if (matchCode >= 15)
+		{
+			WriteLength(output, matchCode - 15);
+		}
+	}
+
+	bool AssetPack::CompressLZ4(const unsigned char* source, size_t size, std::vector<unsigned char>& compressed)
+	{
+		const int hashBits = 16;
+		const size_t lastLiterals = 5; // The format requires the last 5 bytes to be literals
+		const size_t matchStartLimit = 12; // and the last match to start at least 12 bytes before the end
+		const uint32_t noPosition = UINT32_MAX;
+
+		compressed.clear();
+		compressed.reserve(size + size / 255 + 16);
+		if (size > UINT32_MAX)
+		{
+			return false;
+		}
+
+		size_t anchor = 0;
+		if (size > matchStartLimit)
+		{
+			std::vector<uint32_t> table((size_t)1 << hashBits, noPosition);
+			size_t position = 0;
+			size_t matchLimit = size - matchStartLimit;
+
+			while (position < matchLimit)
+			{
+				uint32_t sequence;
+				memcpy(&sequence, source + position, sizeof(uint32_t));
+				uint32_t hash = (sequence * 2654435761u) >> (32 - hashBits);
+				uint32_t candidate = table[hash];
+				table[hash] = (uint32_t)position;
+
+				uint32_t candidateSequence = 0;
+				if (candidate != noPosition)
+				{
+					memcpy(&candidateSequence, source + candidate, sizeof(uint32_t));
+				}
+				if (candidate == noPosition || position - candidate > 0xFFFF || candidateSequence != sequence)
+				{
+					position++;
+					continue;
+				}
+
+				size_t matchEnd = position + 4;
+				while (matchEnd < size - lastLiterals && source[matchEnd] == source[candidate + matchEnd - position])
+				{
+					matchEnd++;
+				}
+
+				WriteSequence(compressed, source + anchor, position - anchor, position - candidate, matchEnd - position);
+				position = matchEnd;
+				anchor = position;
+			}
+		}
+
+		WriteSequence(compressed, source + anchor, size - anchor, 0, 0);
+		return true;
+	}
+
+	// Bounds checked throughout, a corrupt entry fails instead of writing past the destination
+	bool AssetPack::DecompressLZ4(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationSize)
+	{
+		size_t input = 0;
+		size_t output = 0;
+
+		while (input < sourceSize)
+		{
+			unsigned char token = source[input++];
+
+			size_t literalLength = token >> 4;
+			if (literalLength == 15)
+			{
+				unsigned char extra = 255;
+				while (extra == 255)
+				{
+					if (input >= sourceSize)
+					{
+						return false;
+					}
+					extra = source[input++];
+					literalLength += extra;
+				}
+			}
+			if (literalLength > sourceSize - input || literalLength > destinationSize - output)
+			{
+				return false;
+			}
+			memcpy(destination + output, source + input, literalLength);
+			input += literalLength;
+			output += literalLength;
+
+			if (input == sourceSize)
+			{
+				break;
+			}
+
+			if (sourceSize - input < 2)
+			{
+				return false;
+			}
+			size_t offset = source[input] | ((size_t)source[input + 1] << 8);
+			input += 2;
+			if (offset == 0 || offset > output)
+			{
+				return false;
+			}
+
+			size_t matchLength = token & 0x0F;
+			if (matchLength == 15)
+			{
+				unsigned char extra = 255;
+				while (extra == 255)
+				{
+					if (input >= sourceSize)
+					{
+						return false;
+					}
+					extra = source[input++];
+					matchLength += extra;
+				}
+			}
+			matchLength += 4;
+			if (matchLength > destinationSize - output)
+			{
+				return false;
+			}
+
+			// Byte by byte, a match may overlap the bytes it is producing
+			const unsigned char* match = destination + output - offset;
+			for (size_t i = 0; i < matchLength; i++)
+			{
+				destination[output + i] = match[i];
+			}
+			output += matchLength;
+		}
+
+		return output == destinationSize;
+	}
+}
\ No newline at end of file
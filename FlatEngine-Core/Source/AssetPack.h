@@ -0,0 +1,73 @@
+#pragma once
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+namespace FlatEngine
+{
+	const uint32_t ASSET_PACK_MAGIC = 0x4B504C46; // "FLPK"
+	const uint32_t ASSET_PACK_VERSION = 1;
+	const std::string ASSET_PACK_FILENAME = "assets.flpak";
+	const uint64_t ASSET_PACK_ALIGNMENT = 16; // Entry data is aligned so cooked assets can be read in place
+
+	enum AssetPackCompression {
+		PackStored = 0,
+		PackLZ4 = 1
+	};
+
+	// Followed by entryCount AssetPackEntry sorted by pathHash, the path table, then the entry data
+	struct AssetPackHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t pathTableSize;
+	};
+
+	struct AssetPackEntry
+	{
+		uint64_t pathHash;
+		uint64_t offset; // From the start of the pack
+		uint64_t size; // Uncompressed
+		uint64_t storedSize;
+		uint32_t compression;
+		uint32_t pathOffset; // Into the path table, the path as it was packed
+		uint32_t pathLength;
+		uint32_t padding;
+	};
+
+	// Every file of a runtime build in one archive. The table of contents is binary searched by the hash of the normalized
+	// path, stored entries are read straight out of the mapping and LZ4 entries are decompressed on read.
+	class AssetPack
+	{
+	public:
+		AssetPack();
+		~AssetPack();
+		AssetPack(const AssetPack&) = delete;
+		AssetPack& operator=(const AssetPack&) = delete;
+
+		bool Open(std::string packPath);
+		void Close();
+		bool IsOpen();
+		uint32_t GetEntryCount();
+		const AssetPackEntry* GetEntries();
+		const AssetPackEntry* Find(std::string path);
+		std::string GetEntryPath(const AssetPackEntry& entry);
+		const unsigned char* GetEntryData(const AssetPackEntry& entry);
+		bool Decompress(const AssetPackEntry& entry, std::vector<unsigned char>& data);
+
+		static bool Write(std::string packPath, std::vector<std::string>& filePaths, bool b_compress);
+		static uint64_t HashPath(std::string path);
+		static bool CompressLZ4(const unsigned char* source, size_t size, std::vector<unsigned char>& compressed);
+		static bool DecompressLZ4(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationSize);
+
+	private:
+		AssetPackHeader m_header;
+		const AssetPackEntry* m_entries;
+		const char* m_pathTable;
+		MappedFile m_file;
+	};
+}
\ No newline at end of file
@@ -44,6 +44,7 @@ namespace FlatEngine
 			{ "activeOffsetX", GetActiveOffset().x},
 			{ "activeOffsetY", GetActiveOffset().y },
 			{ "_isContinuous", IsContinuous()},
+			{ "_firesStayEvents", FiresStayEvents() },
 			{ "_isSolid", IsSolid() },
 			{ "_isStatic", IsStatic() },
 			{ "activeLayer", GetActiveLayer() },
@@ -72,6 +73,11 @@ namespace FlatEngine
 		{
 			m_activeWidth = width;
 			m_activeHeight = height;
+			MarkRenderBoundsDirty();
+			if (IsStatic())
+			{
+				F_b_staticCollidersChanged = true;
+			}
 		}
 		else
 		{
@@ -272,7 +278,10 @@ namespace FlatEngine
 		float rise = std::abs(topLeft.y - GetCenterCoord().y);
 		float run = std::abs(topLeft.x - GetCenterCoord().x);
 		SetActiveRadiusScreen(std::sqrt((rise * rise) + (run * run)));
-		SetActiveRadiusGrid(std::sqrt((rise * rise) + (run * run)) / gridStep);
+		// Grid radius comes straight from grid space values so it does not change with the view it was calculated for
+		float halfWidthGrid = m_activeWidth * scale.x / 2;
+		float halfHeightGrid = m_activeHeight * scale.y / 2;
+		SetActiveRadiusGrid(std::sqrt((halfWidthGrid * halfWidthGrid) + (halfHeightGrid * halfHeightGrid)));
 
 		// For collision detection
 		Vector2 nextTopLeft = { m_nextActiveLeft, m_nextActiveTop };
@@ -340,6 +349,22 @@ namespace FlatEngine
 		return m_normals;
 	}
 
+	Vector4 BoxCollider::GetGridEdges()
+	{
+		// Rotated boxes fall back to the bounding circle
+		if (GetRotation() != 0 || GetParent() == nullptr || GetParent()->GetTransform() == nullptr)
+		{
+			return Collider::GetGridEdges();
+		}
+
+		Vector2 scale = GetParent()->GetTransform()->GetScale();
+		Vector2 center = GetCenterGrid();
+		float halfWidth = m_activeWidth * std::abs(scale.x) / 2;
+		float halfHeight = m_activeHeight * std::abs(scale.y) / 2;
+
+		return Vector4(center.y + halfHeight, center.x + halfWidth, center.y - halfHeight, center.x - halfWidth);
+	}
+
 	void BoxCollider::RecalculateBounds(float gridStep, Vector2 viewportCenter)
 	{
 		//UpdateRotation();
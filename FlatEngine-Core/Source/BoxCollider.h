@@ -42,6 +42,7 @@ namespace FlatEngine
 		void SetNormals(Vector2 normals[4]);
 		Vector2* GetNormals();
 		void RecalculateBounds(float gridstep, Vector2 viewportCenter);
+		Vector4 GetGridEdges();
 
 	private:		
 		bool m_b_isTileMapCollider;
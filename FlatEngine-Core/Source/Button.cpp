@@ -74,6 +74,7 @@ namespace FlatEngine
 		{
 			m_activeWidth = width;
 			m_activeHeight = height;
+			MarkRenderBoundsDirty();
 		}
 		else
 		{
@@ -84,6 +85,7 @@ namespace FlatEngine
 	void Button::SetActiveOffset(Vector2 offset)
 	{
 		m_activeOffset = offset;
+		MarkRenderBoundsDirty();
 	}
 
 	void Button::SetActiveLayer(int layer)
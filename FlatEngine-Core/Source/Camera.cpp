@@ -128,6 +128,7 @@ namespace FlatEngine
 	{
 		m_width = newWidth;
 		m_height = newHeight;
+		MarkRenderBoundsDirty();
 	}
 
 	float Camera::GetWidth()
@@ -56,6 +56,7 @@ namespace FlatEngine
 		{
 			m_width = newWidth;
 			m_height = newHeight;
+			MarkRenderBoundsDirty();
 		}
 		else
 		{
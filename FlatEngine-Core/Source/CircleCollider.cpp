@@ -34,6 +34,7 @@ namespace FlatEngine {
 			{ "_isCollapsed", IsCollapsed() },
 			{ "_isActive", IsActive() },
 			{ "_isContinuous", IsContinuous()},
+			{ "_firesStayEvents", FiresStayEvents() },
 			{ "_isSolid", IsSolid() },
 			{ "_isStatic", IsStatic() },
 			{ "activeLayer", GetActiveLayer() },
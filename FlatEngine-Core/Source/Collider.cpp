@@ -3,6 +3,7 @@
 #include "BoxCollider.h"
 #include "CircleCollider.h"
 #include "CompositeCollider.h"
+#include "ContactCache.h"
 #include "RigidBody.h"
 #include "GameObject.h"
 #include "Transform.h"
@@ -34,6 +35,7 @@ namespace FlatEngine
 		m_b_isStatic = false;
 		m_b_isSolid = true;
 		m_b_showActiveRadius = false;
+		m_b_firesStayEvents = false;
 
 		m_b_isCollidingRight = false;
 		m_b_isCollidingLeft = false;
@@ -139,7 +141,10 @@ namespace FlatEngine
 			{
 				collider1->AddCollidingObject(collider2);
 				// For Collider events - Fire OnActiveCollision while there is a collision happening
-				CallLuaCollisionFunction(collider1->GetParent(), collider2, LuaEventFunction::OnBoxCollision);
+				if (collider1->FiresStayEvents())
+				{
+					CallLuaCollisionFunction(collider1->GetParent(), collider2, LuaEventFunction::OnBoxCollision);
+				}
 			}
 			else
 			{
@@ -152,7 +157,10 @@ namespace FlatEngine
 			{
 				collider2->AddCollidingObject(collider1);
 				// For Collider events - Fire OnActiveCollision while there is a collision happening
-				CallLuaCollisionFunction(collider2->GetParent(), collider1, LuaEventFunction::OnBoxCollision);
+				if (collider2->FiresStayEvents())
+				{
+					CallLuaCollisionFunction(collider2->GetParent(), collider1, LuaEventFunction::OnBoxCollision);
+				}
 			}
 			else
 			{
@@ -160,6 +168,12 @@ namespace FlatEngine
 				compositeCollider->AddCollidingObject(collider1);
 				//compositeCollider->OnActiveCollision(collider2->GetParent(), collider1->GetParent());
 			}
+
+			F_ContactCache.ReportContact(collider1, collider2);
+		}
+		else
+		{
+			F_ContactCache.ReportSeparation(collider1, collider2);
 		}
 
 		return b_colliding;
@@ -991,6 +1005,11 @@ namespace FlatEngine
 	void Collider::SetActiveOffset(Vector2 offset)
 	{
 		m_activeOffset = offset;
+		MarkRenderBoundsDirty();
+		if (m_b_isStatic)
+		{
+			F_b_staticCollidersChanged = true;
+		}
 	}
 
 	void Collider::SetActiveLayer(int layer)
@@ -1028,6 +1047,7 @@ namespace FlatEngine
 	void Collider::SetActiveRadiusGrid(float radius)
 	{
 		m_activeRadiusGrid = radius;
+		MarkRenderBoundsDirty();
 	}
 
 	float Collider::GetActiveRadiusGrid()
@@ -1091,6 +1111,13 @@ namespace FlatEngine
 		m_bottomLeftCollidedPosition = Vector2(0, 0);
 	}
 
+	Vector4 Collider::GetGridEdges()
+	{
+		Vector2 center = GetCenterGrid();
+		float radius = GetActiveRadiusGrid();
+		return Vector4(center.y + radius, center.x + radius, center.y - radius, center.x - radius);
+	}
+
 	void Collider::SetCenterGrid(Vector2 newCenter)
 	{
 		m_centerGrid = newCenter;
@@ -1143,6 +1170,11 @@ namespace FlatEngine
 
 	void Collider::SetIsStatic(bool b_isStatic)
 	{
+		// Static and dynamic colliders are tracked separately, so they need to be sorted again
+		if (m_b_isStatic != b_isStatic)
+		{
+			F_b_colliderPairsStale = true;
+		}
 		m_b_isStatic = b_isStatic;
 	}
 
@@ -1185,4 +1217,14 @@ namespace FlatEngine
 	{
 		return m_b_isComposite;
 	}
+
+	void Collider::SetFiresStayEvents(bool b_firesStayEvents)
+	{
+		m_b_firesStayEvents = b_firesStayEvents;
+	}
+
+	bool Collider::FiresStayEvents()
+	{
+		return m_b_firesStayEvents;
+	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "Component.h"
 #include "Vector2.h"
+#include "Vector4.h"
 
 #include <string>
 #include <vector>
@@ -29,6 +30,8 @@ namespace FlatEngine
 
 		virtual void RecalculateBounds() {};
 		virtual void ResetCollisions();		
+		//Vector4(top, right, bottom, left) in grid space
+		virtual Vector4 GetGridEdges();
 
 		void AddCollidingObject(Collider* collidedWith);		
 		bool IsColliding();
@@ -72,6 +75,9 @@ namespace FlatEngine
 		float GetRotation();
 		void SetIsComposite(bool b_isComposite);
 		bool IsComposite();
+		// OnBoxCollision and OnCollisionStay fire every step a contact persists, so they are opt-in
+		void SetFiresStayEvents(bool b_firesStayEvents);
+		bool FiresStayEvents();
 
 		Vector2 m_collidedPosition;
 		Vector2 m_leftCollidedPosition;
@@ -137,5 +143,6 @@ namespace FlatEngine
 		bool m_b_isSolid;
 		bool m_b_showActiveRadius;
 		bool m_b_isComposite;
+		bool m_b_firesStayEvents;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,301 @@
+#include "CommandRecorder.h"
+#include "VulkanManager.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "FlatEngine.h"
+
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace FlatEngine
+{
+    CommandRecorder::CommandRecorder()
+    {
+        m_deviceHandle = nullptr;
+        m_slotCount = 0;
+        m_commandPools = std::vector<std::vector<VkCommandPool>>();
+        m_commandBuffers = std::vector<std::vector<VkCommandBuffer>>();
+        m_recorded = std::vector<VkCommandBuffer>();
+        m_frameIndex = 0;
+        m_renderPass = VK_NULL_HANDLE;
+        m_framebuffer = VK_NULL_HANDLE;
+        m_extent = { 0, 0 };
+        m_rangeCount = 0;
+        m_drawCount = 0;
+        m_instanceCount = 0;
+        m_recordTime = 0;
+    }
+
+    CommandRecorder::~CommandRecorder()
+    {
+    }
+
+    void CommandRecorder::Cleanup()
+    {
+        m_workers.Stop();
+
+        if (m_deviceHandle != nullptr)
+        {
+            // Destroying the pools frees their command buffers
+            for (std::vector<VkCommandPool>& framePools : m_commandPools)
+            {
+                for (VkCommandPool commandPool : framePools)
+                {
+                    vkDestroyCommandPool(m_deviceHandle->GetDevice(), commandPool, nullptr);
+                }
+            }
+        }
+        m_commandPools.clear();
+        m_commandBuffers.clear();
+        m_recorded.clear();
+    }
+
+    void CommandRecorder::Init(LogicalDevice& logicalDevice, uint32_t queueFamilyIndex)
+    {
+        m_deviceHandle = &logicalDevice;
+
+        int hardwareThreads = (int)std::thread::hardware_concurrency();
+        int workerCount = std::max(0, std::min(hardwareThreads - 1, MAX_RECORDING_THREADS - 1));
+        m_workers.Start(workerCount);
+
+        // A mesh slot for every worker plus the calling thread, and the calling thread's own slot for the sprite batch
+        m_slotCount = workerCount + 2;
+        m_commandPools.resize(VM_MAX_FRAMES_IN_FLIGHT);
+        m_commandBuffers.resize(VM_MAX_FRAMES_IN_FLIGHT);
+
+        for (size_t frame = 0; frame < VM_MAX_FRAMES_IN_FLIGHT; frame++)
+        {
+            m_commandPools[frame].resize(m_slotCount);
+            m_commandBuffers[frame].resize(m_slotCount);
+
+            for (int slot = 0; slot < m_slotCount; slot++)
+            {
+                VulkanManager::CreateCommandPool(m_commandPools[frame][slot], logicalDevice, queueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+                VkCommandBufferAllocateInfo allocInfo{};
+                allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                allocInfo.commandPool = m_commandPools[frame][slot];
+                allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+                allocInfo.commandBufferCount = 1;
+
+                if (vkAllocateCommandBuffers(logicalDevice.GetDevice(), &allocInfo, &m_commandBuffers[frame][slot]) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("failed to allocate secondary command buffers!");
+                }
+            }
+        }
+    }
+
+    // Call once the frame's fence has been waited on, nothing recorded from these pools can still be in flight
+    void CommandRecorder::BeginFrame(uint32_t frameIndex, VkRenderPass renderPass, VkFramebuffer framebuffer, VkExtent2D extent)
+    {
+        m_frameIndex = frameIndex;
+        m_renderPass = renderPass;
+        m_framebuffer = framebuffer;
+        m_extent = extent;
+        m_recorded.clear();
+
+        for (VkCommandPool commandPool : m_commandPools[frameIndex])
+        {
+            vkResetCommandPool(m_deviceHandle->GetDevice(), commandPool, 0);
+        }
+    }
+
+    VkCommandBuffer CommandRecorder::BeginSecondary(int slot)
+    {
+        VkCommandBuffer commandBuffer = m_commandBuffers[m_frameIndex][slot];
+
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.renderPass = m_renderPass;
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = m_framebuffer;
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            return VK_NULL_HANDLE;
+        }
+
+        // Dynamic state is not inherited from the primary command buffer
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(m_extent.width);
+        viewport.height = static_cast<float>(m_extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+        VkRect2D scissor{};
+        scissor.offset = { 0, 0 };
+        scissor.extent = m_extent;
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        return commandBuffer;
+    }
+
+    // Pipeline, push constants and vertex/index buffers are only bound when they change within the range. The descriptor set
+    // is bound for every group since its dynamic offset selects the group's VM_uniformRing slot, slot i belongs to drawGroups[i]
+    void CommandRecorder::RecordRange(VkCommandBuffer commandBuffer, std::vector<MeshDrawGroup>& drawGroups, size_t first, size_t last, VkBuffer instanceBuffer, float time)
+    {
+        VkPipeline boundPipeline = VK_NULL_HANDLE;
+        VkPipelineLayout pushedLayout = VK_NULL_HANDLE;
+        VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+        VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+        float pushConstants[3] = { sinf(time), cosf(time), 0 };
+
+        for (size_t i = first; i < last; i++)
+        {
+            MeshDrawGroup& drawGroup = drawGroups[i];
+            Mesh& mesh = *drawGroup.mesh;
+            Material* material = mesh.GetMaterial().get();
+            VkPipeline graphicsPipeline = material->GetGraphicsPipeline();
+            VkPipelineLayout pipelineLayout = material->GetPipelineLayout();
+            VkDescriptorSet descriptorSet = mesh.GetDescriptorSets()[m_frameIndex];
+            VkBuffer vertexBuffer = mesh.GetModel().GetVertexBuffer();
+            VkBuffer indexBuffer = mesh.GetModel().GetIndexBuffer();
+
+            if (graphicsPipeline != boundPipeline)
+            {
+                vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+                boundPipeline = graphicsPipeline;
+            }
+            if (pipelineLayout != pushedLayout)
+            {
+                vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pushConstants), pushConstants);
+                pushedLayout = pipelineLayout;
+            }
+
+            uint32_t uniformOffset = VM_uniformRing.GetOffset(static_cast<uint32_t>(i));
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 1, &uniformOffset);
+
+            if (vertexBuffer != boundVertexBuffer)
+            {
+                VkBuffer vertexBuffers[] = { vertexBuffer, instanceBuffer };
+                VkDeviceSize offsets[] = { 0, 0 };
+                vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
+                boundVertexBuffer = vertexBuffer;
+            }
+            if (indexBuffer != boundIndexBuffer)
+            {
+                vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                boundIndexBuffer = indexBuffer;
+            }
+
+            vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(mesh.GetModel().GetIndices().size()), drawGroup.instanceCount, 0, 0, drawGroup.firstInstance);
+        }
+    }
+
+    // Splits the draw groups into contiguous ranges, one secondary command buffer each, executed in draw list order
+    void CommandRecorder::RecordMeshes(std::vector<MeshDrawGroup>& drawGroups, VkBuffer instanceBuffer)
+    {
+        double recordStart = GetTimeInMicroseconds();
+        m_rangeCount = 0;
+        m_drawCount = (int)drawGroups.size();
+        m_instanceCount = 0;
+        for (MeshDrawGroup& drawGroup : drawGroups)
+        {
+            m_instanceCount += drawGroup.instanceCount;
+        }
+
+        if (drawGroups.size() == 0)
+        {
+            m_recordTime = 0;
+            return;
+        }
+
+        static auto startTime = std::chrono::high_resolution_clock::now();
+        auto currentTime = std::chrono::high_resolution_clock::now();
+        float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
+
+        int meshSlots = m_slotCount - 1;
+        int rangeCount = std::max(1, std::min(meshSlots, (int)((drawGroups.size() + MIN_DRAWS_PER_RANGE - 1) / MIN_DRAWS_PER_RANGE)));
+        size_t rangeSize = (drawGroups.size() + rangeCount - 1) / rangeCount;
+        std::vector<VkCommandBuffer> rangeBuffers = std::vector<VkCommandBuffer>(rangeCount, VK_NULL_HANDLE);
+
+        m_workers.ParallelFor(rangeCount, [&](int range)
+        {
+            size_t first = range * rangeSize;
+            size_t last = std::min(drawGroups.size(), first + rangeSize);
+            VkCommandBuffer commandBuffer = BeginSecondary(range);
+
+            if (commandBuffer != VK_NULL_HANDLE)
+            {
+                RecordRange(commandBuffer, drawGroups, first, last, instanceBuffer, time);
+                if (vkEndCommandBuffer(commandBuffer) == VK_SUCCESS)
+                {
+                    rangeBuffers[range] = commandBuffer;
+                }
+            }
+        });
+
+        // Exceptions can not leave the worker threads, failures are reported from here
+        for (VkCommandBuffer commandBuffer : rangeBuffers)
+        {
+            if (commandBuffer == VK_NULL_HANDLE)
+            {
+                throw std::runtime_error("failed to record secondary command buffer!");
+            }
+            m_recorded.push_back(commandBuffer);
+        }
+
+        m_rangeCount = rangeCount;
+        m_recordTime = (float)(GetTimeInMicroseconds() - recordStart);
+    }
+
+    VkCommandBuffer CommandRecorder::BeginCallerBuffer()
+    {
+        VkCommandBuffer commandBuffer = BeginSecondary(m_slotCount - 1);
+        if (commandBuffer == VK_NULL_HANDLE)
+        {
+            throw std::runtime_error("failed to begin recording secondary command buffer!");
+        }
+        return commandBuffer;
+    }
+
+    void CommandRecorder::EndCallerBuffer()
+    {
+        VkCommandBuffer commandBuffer = m_commandBuffers[m_frameIndex][m_slotCount - 1];
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to record secondary command buffer!");
+        }
+        m_recorded.push_back(commandBuffer);
+    }
+
+    void CommandRecorder::Execute(VkCommandBuffer primaryCommandBuffer)
+    {
+        if (m_recorded.size() > 0)
+        {
+            vkCmdExecuteCommands(primaryCommandBuffer, static_cast<uint32_t>(m_recorded.size()), m_recorded.data());
+        }
+    }
+
+    int CommandRecorder::GetRangeCount()
+    {
+        return m_rangeCount;
+    }
+
+    int CommandRecorder::GetDrawCount()
+    {
+        return m_drawCount;
+    }
+
+    int CommandRecorder::GetInstanceCount()
+    {
+        return m_instanceCount;
+    }
+
+    float CommandRecorder::GetRecordTime()
+    {
+        return m_recordTime;
+    }
+}
\ No newline at end of file
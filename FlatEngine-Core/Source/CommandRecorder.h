@@ -0,0 +1,69 @@
+#pragma once
+#include "LogicalDevice.h"
+#include "WorkerPool.h"
+
+#define GLFW_INCLUDE_VULKAN
+#include <glfw3.h>
+
+#include <vector>
+
+
+namespace FlatEngine
+{
+	class Mesh;
+
+	const int MAX_RECORDING_THREADS = 4;
+	const int MIN_DRAWS_PER_RANGE = 64; // below this a range is not worth a thread of its own
+
+	// Meshes sharing a Model and Material, drawn with one instanced vkCmdDrawIndexed. Their MeshInstances are
+	// instanceCount consecutive entries of the frame's InstanceBuffer starting at firstInstance.
+	struct MeshDrawGroup
+	{
+		Mesh* mesh;
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+	};
+
+	// Records the main RenderPass's draws into secondary command buffers so mesh ranges can be recorded in parallel.
+	// Every recording slot owns its own VkCommandPool per frame in flight (pools are externally synchronized), the pools
+	// are reset together in BeginFrame() once that frame's fence has been waited on. The last slot is kept for the calling
+	// thread (sprite batch), the others take contiguous ranges of mesh draw groups. The RenderPass must be begun with
+	// VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS and Execute() called before it ends.
+	class CommandRecorder
+	{
+	public:
+		CommandRecorder();
+		~CommandRecorder();
+		void Cleanup();
+
+		void Init(LogicalDevice& logicalDevice, uint32_t queueFamilyIndex);
+		void BeginFrame(uint32_t frameIndex, VkRenderPass renderPass, VkFramebuffer framebuffer, VkExtent2D extent);
+		void RecordMeshes(std::vector<MeshDrawGroup>& drawGroups, VkBuffer instanceBuffer);
+		VkCommandBuffer BeginCallerBuffer();
+		void EndCallerBuffer();
+		void Execute(VkCommandBuffer primaryCommandBuffer);
+		int GetRangeCount();
+		int GetDrawCount();
+		int GetInstanceCount();
+		float GetRecordTime();
+
+	private:
+		VkCommandBuffer BeginSecondary(int slot);
+		void RecordRange(VkCommandBuffer commandBuffer, std::vector<MeshDrawGroup>& drawGroups, size_t first, size_t last, VkBuffer instanceBuffer, float time);
+
+		LogicalDevice* m_deviceHandle;
+		WorkerPool m_workers;
+		int m_slotCount;
+		std::vector<std::vector<VkCommandPool>> m_commandPools;         // [frame][slot]
+		std::vector<std::vector<VkCommandBuffer>> m_commandBuffers;     // [frame][slot]
+		std::vector<VkCommandBuffer> m_recorded;
+		uint32_t m_frameIndex;
+		VkRenderPass m_renderPass;
+		VkFramebuffer m_framebuffer;
+		VkExtent2D m_extent;
+		int m_rangeCount;
+		int m_drawCount;
+		int m_instanceCount;
+		float m_recordTime; // microseconds
+	};
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "Component.h"
 #include "FlatEngine.h"
+#include "RenderIndex.h"
 
 
 namespace FlatEngine
@@ -140,4 +141,10 @@ namespace FlatEngine
 	{
 		return m_b_isActive;
 	}
+
+	// For anything that changes where or how large the owner is drawn, so the render culling index picks up the new bounds
+	void Component::MarkRenderBoundsDirty()
+	{
+		F_RenderIndex.MarkDirty(m_parentID);
+	}
 }
\ No newline at end of file
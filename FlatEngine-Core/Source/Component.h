@@ -44,6 +44,7 @@ namespace FlatEngine
 		void SetCollapsed(bool collapsed);
 		void SetActive(bool _active);
 		bool IsActive();
+		void MarkRenderBoundsDirty();
 
 	private:
 		ComponentTypes m_type = T_Null;
@@ -0,0 +1,217 @@
+#include "ContactCache.h"
+#include "FlatEngine.h"
+#include "Collider.h"
+#include "BoxCollider.h"
+#include "CircleCollider.h"
+#include "GameObject.h"
+
+#include <algorithm>
+
+
+namespace FlatEngine
+{
+	ContactCache::ContactCache()
+	{
+		m_contacts = std::map<std::pair<long long, long long>, S_Contact>();
+		m_exited = std::vector<S_Contact>();
+		m_step = 0;
+	}
+
+	ContactCache::~ContactCache()
+	{
+	}
+
+	void ContactCache::BeginStep()
+	{
+		m_step++;
+	}
+
+	// A contact that was neither reported nor kept this step lost its pair to removal, deactivation or the broadphase
+	void ContactCache::EndStep()
+	{
+		m_exited.clear();
+
+		for (std::map<std::pair<long long, long long>, S_Contact>::iterator contact = m_contacts.begin(); contact != m_contacts.end();)
+		{
+			S_Contact& data = contact->second;
+
+			if (data.lastSeenStep != m_step || !ColliderExists(data.collider1, data.collider1ID, data.parent1ID) || !ColliderExists(data.collider2, data.collider2ID, data.parent2ID))
+			{
+				m_exited.push_back(data);
+				contact = m_contacts.erase(contact);
+			}
+			else
+			{
+				contact++;
+			}
+		}
+
+		// Fired after the map is settled in case a script destroys or moves something in response, in ID order since that is how the map is keyed
+		for (S_Contact& contact : m_exited)
+		{
+			FireExit(contact);
+		}
+	}
+
+	void ContactCache::ReportContact(Collider* collider1, Collider* collider2)
+	{
+		std::pair<long long, long long> key = GetPairKey(collider1, collider2);
+
+		if (m_contacts.count(key) > 0)
+		{
+			m_contacts.at(key).lastSeenStep = m_step;
+
+			if (collider1->FiresStayEvents() && !collider1->IsComposite())
+			{
+				CallLuaCollisionFunction(collider1->GetParent(), collider2, LuaEventFunction::OnCollisionStay);
+			}
+			if (collider2->FiresStayEvents() && !collider2->IsComposite())
+			{
+				CallLuaCollisionFunction(collider2->GetParent(), collider1, LuaEventFunction::OnCollisionStay);
+			}
+		}
+		else
+		{
+			// Stored lowest ID first, the same order as the key
+			if (GetColliderKey(collider2) < GetColliderKey(collider1))
+			{
+				std::swap(collider1, collider2);
+			}
+			S_Contact contact = S_Contact();
+			contact.collider1 = collider1;
+			contact.collider2 = collider2;
+			contact.collider1ID = collider1->GetID();
+			contact.collider2ID = collider2->GetID();
+			contact.parent1ID = collider1->GetParentID();
+			contact.parent2ID = collider2->GetParentID();
+			contact.firstContactStep = m_step;
+			contact.lastSeenStep = m_step;
+			m_contacts.emplace(key, contact);
+
+			if (!collider1->IsComposite())
+			{
+				CallLuaCollisionFunction(collider1->GetParent(), collider2, LuaEventFunction::OnCollisionEnter);
+			}
+			if (!collider2->IsComposite())
+			{
+				CallLuaCollisionFunction(collider2->GetParent(), collider1, LuaEventFunction::OnCollisionEnter);
+			}
+		}
+	}
+
+	void ContactCache::ReportSeparation(Collider* collider1, Collider* collider2)
+	{
+		if (m_contacts.size() == 0)
+		{
+			return;
+		}
+
+		std::map<std::pair<long long, long long>, S_Contact>::iterator contact = m_contacts.find(GetPairKey(collider1, collider2));
+
+		if (contact != m_contacts.end())
+		{
+			S_Contact data = contact->second;
+			m_contacts.erase(contact);
+			FireExit(data);
+		}
+	}
+
+	// For pairs skipped this step only because neither collider is continuous, their contact carries over to the next test
+	void ContactCache::KeepContact(Collider* collider1, Collider* collider2)
+	{
+		if (m_contacts.size() == 0)
+		{
+			return;
+		}
+
+		std::map<std::pair<long long, long long>, S_Contact>::iterator contact = m_contacts.find(GetPairKey(collider1, collider2));
+
+		if (contact != m_contacts.end())
+		{
+			contact->second.lastSeenStep = m_step;
+		}
+	}
+
+	void ContactCache::Clear()
+	{
+		m_contacts.clear();
+		m_exited.clear();
+	}
+
+	bool ContactCache::HasContact(Collider* collider1, Collider* collider2)
+	{
+		return m_contacts.count(GetPairKey(collider1, collider2)) > 0;
+	}
+
+	int ContactCache::GetContactCount()
+	{
+		return (int)m_contacts.size();
+	}
+
+	long ContactCache::GetStep()
+	{
+		return m_step;
+	}
+
+	// Component IDs are counted per scene, the persistant scene's colliders are kept apart by the high bit
+	long long ContactCache::GetColliderKey(Collider* collider)
+	{
+		long long key = (long long)collider->GetID();
+		if (collider->GetParent() != nullptr && collider->GetParent()->IsPersistant())
+		{
+			key |= 1LL << 62;
+		}
+		return key;
+	}
+
+	std::pair<long long, long long> ContactCache::GetPairKey(Collider* collider1, Collider* collider2)
+	{
+		long long key1 = GetColliderKey(collider1);
+		long long key2 = GetColliderKey(collider2);
+		return { std::min(key1, key2), std::max(key1, key2) };
+	}
+
+	// Component addresses can be reused after removal, so the IDs have to match as well
+	bool ContactCache::ColliderExists(Collider* collider, long colliderID, long parentID)
+	{
+		GameObject* parent = GetObjectByID(parentID);
+
+		if (parent != nullptr)
+		{
+			for (BoxCollider* boxCollider : parent->GetBoxColliders())
+			{
+				if (boxCollider == collider && boxCollider->GetID() == colliderID)
+				{
+					return true;
+				}
+			}
+			for (CircleCollider* circleCollider : parent->GetCircleColliders())
+			{
+				if (circleCollider == collider && circleCollider->GetID() == colliderID)
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	// The destroyed side of a contact gets no event and is passed to the other side as nil
+	void ContactCache::FireExit(S_Contact contact)
+	{
+		bool b_collider1Exists = ColliderExists(contact.collider1, contact.collider1ID, contact.parent1ID);
+		bool b_collider2Exists = ColliderExists(contact.collider2, contact.collider2ID, contact.parent2ID);
+		Collider* collider1 = b_collider1Exists ? contact.collider1 : nullptr;
+		Collider* collider2 = b_collider2Exists ? contact.collider2 : nullptr;
+
+		if (collider1 != nullptr && !collider1->IsComposite())
+		{
+			CallLuaCollisionFunction(collider1->GetParent(), collider2, LuaEventFunction::OnCollisionExit);
+		}
+		if (collider2 != nullptr && !collider2->IsComposite())
+		{
+			CallLuaCollisionFunction(collider2->GetParent(), collider1, LuaEventFunction::OnCollisionExit);
+		}
+	}
+}
\ No newline at end of file
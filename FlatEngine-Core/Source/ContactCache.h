@@ -0,0 +1,55 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <utility>
+
+
+namespace FlatEngine
+{
+	class Collider;
+
+	// Contacts between collider pairs that persist across physics steps.
+	// Collider::CheckForCollision reports every tested pair and OnCollisionEnter, OnCollisionStay and OnCollisionExit are fired from the transitions.
+	// Pairs that are only tested every few steps (non-continuous colliders) keep their contact in between tests through KeepContact(),
+	// any other contact that was not reported during a step ends with that step.
+	class ContactCache
+	{
+	public:
+		ContactCache();
+		~ContactCache();
+
+		void BeginStep();
+		void EndStep();
+		void ReportContact(Collider* collider1, Collider* collider2);
+		void ReportSeparation(Collider* collider1, Collider* collider2);
+		void KeepContact(Collider* collider1, Collider* collider2);
+		// Drops every contact without firing OnCollisionExit, used when the colliders are destroyed with their scene
+		void Clear();
+		bool HasContact(Collider* collider1, Collider* collider2);
+		int GetContactCount();
+		long GetStep();
+
+	private:
+		struct S_Contact
+		{
+			Collider* collider1;
+			Collider* collider2;
+			long collider1ID;
+			long collider2ID;
+			long parent1ID;
+			long parent2ID;
+			long firstContactStep;
+			long lastSeenStep;
+		};
+
+		long long GetColliderKey(Collider* collider);
+		std::pair<long long, long long> GetPairKey(Collider* collider1, Collider* collider2);
+		bool ColliderExists(Collider* collider, long colliderID, long parentID);
+		void FireExit(S_Contact contact);
+
+		// Keyed by collider ID rather than address, a collider allocated where a removed one used to be starts with no contacts
+		std::map<std::pair<long long, long long>, S_Contact> m_contacts;
+		std::vector<S_Contact> m_exited;
+		long m_step;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,343 @@
+#include "CookedMesh.h"
+#include "FlatEngine.h"
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+
+namespace FlatEngine
+{
+	CookedMesh::CookedMesh()
+	{
+		m_header = CookedMeshHeader();
+	}
+
+	CookedMesh::~CookedMesh()
+	{
+		Close();
+	}
+
+	bool CookedMesh::Open(std::string path)
+	{
+		Close();
+
+		if (!F_VirtualFileSystem.Read(path, m_file) || m_file.GetSize() < sizeof(CookedMeshHeader))
+		{
+			Close();
+			return false;
+		}
+
+		memcpy(&m_header, m_file.GetData(), sizeof(CookedMeshHeader));
+		uint64_t expectedSize = sizeof(CookedMeshHeader) + (uint64_t)m_header.vertexCount * sizeof(Vertex) + (uint64_t)m_header.indexCount * sizeof(uint32_t);
+		if (m_header.magic != COOKED_MESH_MAGIC || m_header.version != COOKED_MESH_VERSION || m_header.vertexStride != sizeof(Vertex) ||
+			m_header.indexCount % 3 != 0 || expectedSize > m_file.GetSize())
+		{
+			Close();
+			return false;
+		}
+
+		const uint32_t* indices = GetIndices();
+		for (uint32_t i = 0; i < m_header.indexCount; i++)
+		{
+			if (indices[i] >= m_header.vertexCount)
+			{
+				Close();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void CookedMesh::Close()
+	{
+		m_file.Close();
+		m_header = CookedMeshHeader();
+	}
+
+	bool CookedMesh::IsOpen()
+	{
+		return m_file.IsOpen() && m_header.magic == COOKED_MESH_MAGIC;
+	}
+
+	CookedMeshHeader& CookedMesh::GetHeader()
+	{
+		return m_header;
+	}
+
+	const Vertex* CookedMesh::GetVertices()
+	{
+		return (const Vertex*)(m_file.GetData() + sizeof(CookedMeshHeader));
+	}
+
+	const uint32_t* CookedMesh::GetIndices()
+	{
+		return (const uint32_t*)(m_file.GetData() + sizeof(CookedMeshHeader) + (uint64_t)m_header.vertexCount * sizeof(Vertex));
+	}
+
+	// Optimizes vertices and indices in place before writing them, the caller is left holding the optimized order
+	bool CookedMesh::Cook(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, std::string cookedPath)
+	{
+		if (vertices.size() == 0 || indices.size() == 0 || indices.size() % 3 != 0)
+		{
+			return false;
+		}
+
+		OptimizeVertexCache(indices, (uint32_t)vertices.size());
+		OptimizeVertexFetch(vertices, indices);
+
+		CookedMeshHeader header = CookedMeshHeader();
+		header.magic = COOKED_MESH_MAGIC;
+		header.version = COOKED_MESH_VERSION;
+		header.vertexStride = sizeof(Vertex);
+		header.vertexCount = (uint32_t)vertices.size();
+		header.indexCount = (uint32_t)indices.size();
+		header.flags = CookedMeshCacheOptimized;
+
+		// Written beside the final path and renamed over it so a load never maps a half written file
+		std::string tempPath = cookedPath + ".tmp";
+		std::error_code error;
+		std::filesystem::create_directories(std::filesystem::path(cookedPath).parent_path(), error);
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				return false;
+			}
+			file.write((const char*)&header, sizeof(CookedMeshHeader));
+			file.write((const char*)vertices.data(), vertices.size() * sizeof(Vertex));
+			file.write((const char*)indices.data(), indices.size() * sizeof(uint32_t));
+			if (!file.good())
+			{
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, cookedPath, error);
+		return !error;
+	}
+
+	// Tom Forsyth's linear-speed vertex cache optimisation. Vertices score higher the more recently they were used and the fewer
+	// triangles they have left, each step emits the best scoring triangle touching the simulated cache.
+	// Refer to - https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+	static float ScoreVertex(int cachePosition, int remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = 0;
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				// The last triangle's vertices are scored a little lower so the strip does not just turn back on itself
+				score = 0.75f;
+			}
+			else
+			{
+				float scaler = 1.0f / (VERTEX_CACHE_SIZE - 3);
+				score = std::pow(1.0f - (cachePosition - 3) * scaler, 1.5f);
+			}
+		}
+
+		// Vertices with few triangles left get a boost so they are finished off and leave the cache
+		return score + 2.0f * std::pow((float)remainingTriangles, -0.5f);
+	}
+
+	void CookedMesh::OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		uint32_t triangleCount = (uint32_t)indices.size() / 3;
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		// Triangles of each vertex, vertexTriangles[triangleStart[v] .. triangleStart[v + 1])
+		std::vector<uint32_t> triangleStart(vertexCount + 1, 0);
+		for (uint32_t index : indices)
+		{
+			triangleStart[index + 1]++;
+		}
+		for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			triangleStart[vertex + 1] += triangleStart[vertex];
+		}
+		std::vector<uint32_t> vertexTriangles(indices.size());
+		std::vector<uint32_t> fill(triangleStart.begin(), triangleStart.end() - 1);
+		for (uint32_t triangle = 0; triangle < triangleCount; triangle++)
+		{
+			for (int corner = 0; corner < 3; corner++)
+			{
+				uint32_t vertex = indices[triangle * 3 + corner];
+				vertexTriangles[fill[vertex]++] = triangle;
+			}
+		}
+
+		std::vector<int> remaining(vertexCount, 0);
+		std::vector<int> cachePosition(vertexCount, -1);
+		std::vector<float> vertexScore(vertexCount, 0);
+		for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			remaining[vertex] = triangleStart[vertex + 1] - triangleStart[vertex];
+			vertexScore[vertex] = ScoreVertex(-1, remaining[vertex]);
+		}
+
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<float> triangleScore(triangleCount, 0);
+		for (uint32_t triangle = 0; triangle < triangleCount; triangle++)
+		{
+			triangleScore[triangle] = vertexScore[indices[triangle * 3]] + vertexScore[indices[triangle * 3 + 1]] + vertexScore[indices[triangle * 3 + 2]];
+		}
+
+		std::vector<uint32_t> optimized;
+		optimized.reserve(indices.size());
+		std::vector<uint32_t> cache;
+		cache.reserve(VERTEX_CACHE_SIZE + 3);
+		uint32_t scanCursor = 0;
+		int bestTriangle = -1;
+
+		for (uint32_t step = 0; step < triangleCount; step++)
+		{
+			if (bestTriangle == -1)
+			{
+				// Nothing in the cache has triangles left, continue with the best of the rest
+				float bestScore = -1.0f;
+				while (scanCursor < triangleCount && emitted[scanCursor])
+				{
+					scanCursor++;
+				}
+				for (uint32_t triangle = scanCursor; triangle < triangleCount; triangle++)
+				{
+					if (!emitted[triangle] && triangleScore[triangle] > bestScore)
+					{
+						bestScore = triangleScore[triangle];
+						bestTriangle = (int)triangle;
+					}
+				}
+			}
+
+			uint32_t triangle = (uint32_t)bestTriangle;
+			emitted[triangle] = true;
+
+			// Emitted vertices move to the front of the cache, whatever falls off the end is evicted
+			std::vector<uint32_t> newCache;
+			newCache.reserve(VERTEX_CACHE_SIZE + 3);
+			for (int corner = 0; corner < 3; corner++)
+			{
+				uint32_t vertex = indices[triangle * 3 + corner];
+				optimized.push_back(vertex);
+				newCache.push_back(vertex);
+
+				// Take the triangle out of the vertex's remaining list
+				uint32_t start = triangleStart[vertex];
+				uint32_t end = start + remaining[vertex];
+				for (uint32_t i = start; i < end; i++)
+				{
+					if (vertexTriangles[i] == triangle)
+					{
+						std::swap(vertexTriangles[i], vertexTriangles[end - 1]);
+						break;
+					}
+				}
+				remaining[vertex]--;
+			}
+			for (uint32_t vertex : cache)
+			{
+				if (vertex != newCache[0] && vertex != newCache[1] && vertex != newCache[2])
+				{
+					newCache.push_back(vertex);
+				}
+			}
+			for (size_t i = VERTEX_CACHE_SIZE; i < newCache.size(); i++)
+			{
+				cachePosition[newCache[i]] = -1;
+				vertexScore[newCache[i]] = ScoreVertex(-1, remaining[newCache[i]]);
+			}
+			newCache.resize(std::min(newCache.size(), (size_t)VERTEX_CACHE_SIZE));
+			cache.swap(newCache);
+
+			for (size_t i = 0; i < cache.size(); i++)
+			{
+				cachePosition[cache[i]] = (int)i;
+				vertexScore[cache[i]] = ScoreVertex((int)i, remaining[cache[i]]);
+			}
+
+			// Only triangles of cached vertices changed score, the next one is picked from those
+			bestTriangle = -1;
+			float bestScore = -1.0f;
+			for (uint32_t vertex : cache)
+			{
+				uint32_t start = triangleStart[vertex];
+				for (uint32_t i = start; i < start + remaining[vertex]; i++)
+				{
+					uint32_t candidate = vertexTriangles[i];
+					float score = vertexScore[indices[candidate * 3]] + vertexScore[indices[candidate * 3 + 1]] + vertexScore[indices[candidate * 3 + 2]];
+					triangleScore[candidate] = score;
+					if (score > bestScore)
+					{
+						bestScore = score;
+						bestTriangle = (int)candidate;
+					}
+				}
+			}
+		}
+
+		indices.swap(optimized);
+	}
+
+	// Renumbers vertices in the order the indices first use them so vertex fetches walk the buffer forwards
+	void CookedMesh::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+		std::vector<Vertex> reordered;
+		reordered.reserve(vertices.size());
+
+		for (uint32_t& index : indices)
+		{
+			if (remap[index] == UINT32_MAX)
+			{
+				remap[index] = (uint32_t)reordered.size();
+				reordered.push_back(vertices[index]);
+			}
+			index = remap[index];
+		}
+
+		vertices.swap(reordered);
+	}
+
+	// Average transformed vertices per triangle through a FIFO of VERTEX_CACHE_SIZE, 0.5 is ideal and 3 means no reuse at all
+	float CookedMesh::GetCacheMissRatio(std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		if (indices.size() < 3)
+		{
+			return 0;
+		}
+
+		std::vector<uint32_t> insertedAt(vertexCount, 0);
+		uint32_t misses = 0;
+		for (uint32_t index : indices)
+		{
+			if (insertedAt[index] == 0 || misses - insertedAt[index] >= VERTEX_CACHE_SIZE)
+			{
+				misses++;
+				insertedAt[index] = misses;
+			}
+		}
+		return (float)misses / (indices.size() / 3);
+	}
+
+	std::string CookedMesh::GetCookedPath(std::string sourcePath)
+	{
+		return VirtualFileSystem::GetCookedPath(sourcePath, COOKED_MESH_EXTENSION);
+	}
+
+	bool CookedMesh::HasCurrentCook(std::string sourcePath)
+	{
+		return F_VirtualFileSystem.IsUpToDate(GetCookedPath(sourcePath), sourcePath);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+#include "Structs.h"
+#include "VirtualFileSystem.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+namespace FlatEngine
+{
+	const uint32_t COOKED_MESH_MAGIC = 0x534D4C46; // "FLMS"
+	const uint32_t COOKED_MESH_VERSION = 1;
+	const std::string COOKED_MESH_EXTENSION = ".flmesh";
+	const int VERTEX_CACHE_SIZE = 32; // FIFO size the index order is optimized for
+
+	enum CookedMeshFlags {
+		CookedMeshCacheOptimized = 1
+	};
+
+	// Followed by vertexCount Vertex structs, then indexCount uint32_t indices
+	struct CookedMeshHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t vertexStride; // sizeof(Vertex) when cooked, a cook from a different vertex layout is rejected
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t flags;
+	};
+
+	// A model cooked from an .obj: vertices already deduplicated, triangles reordered for the post-transform vertex cache and
+	// vertices reordered by first use, stored as the exact bytes the vertex and index buffers are filled with. Open() maps the
+	// file, or points into the mounted asset pack, loading it is two copies with no parsing or hashing.
+	class CookedMesh
+	{
+	public:
+		CookedMesh();
+		~CookedMesh();
+		CookedMesh(const CookedMesh&) = delete;
+		CookedMesh& operator=(const CookedMesh&) = delete;
+
+		bool Open(std::string path);
+		void Close();
+		bool IsOpen();
+		CookedMeshHeader& GetHeader();
+		const Vertex* GetVertices();
+		const uint32_t* GetIndices();
+
+		static bool Cook(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, std::string cookedPath);
+		static void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+		static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+		static float GetCacheMissRatio(std::vector<uint32_t>& indices, uint32_t vertexCount);
+		static std::string GetCookedPath(std::string sourcePath);
+		static bool HasCurrentCook(std::string sourcePath);
+
+	private:
+		CookedMeshHeader m_header;
+		FileData m_file;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "CookedTexture.h"
+#include "FlatEngine.h"
+#include "stb_image.h"
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+
+namespace FlatEngine
+{
+	CookedTexture::CookedTexture()
+	{
+		m_header = CookedTextureHeader();
+		m_mips = std::vector<CookedMip>();
+	}
+
+	CookedTexture::~CookedTexture()
+	{
+		Close();
+	}
+
+	bool CookedTexture::Open(std::string path)
+	{
+		Close();
+
+		if (!F_VirtualFileSystem.Read(path, m_file) || m_file.GetSize() < sizeof(CookedTextureHeader))
+		{
+			Close();
+			return false;
+		}
+
+		memcpy(&m_header, m_file.GetData(), sizeof(CookedTextureHeader));
+		uint64_t tableSize = (uint64_t)m_header.mipLevels * sizeof(CookedMip);
+		if (m_header.magic != COOKED_TEXTURE_MAGIC || m_header.version != COOKED_TEXTURE_VERSION || m_header.format != CookedRGBA8 ||
+			m_header.mipLevels == 0 || sizeof(CookedTextureHeader) + tableSize + m_header.dataSize > m_file.GetSize())
+		{
+			Close();
+			return false;
+		}
+
+		m_mips.resize(m_header.mipLevels);
+		memcpy(m_mips.data(), m_file.GetData() + sizeof(CookedTextureHeader), static_cast<size_t>(tableSize));
+		for (CookedMip& mip : m_mips)
+		{
+			if (mip.offset + mip.size > m_header.dataSize)
+			{
+				Close();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void CookedTexture::Close()
+	{
+		m_file.Close();
+		m_mips.clear();
+		m_header = CookedTextureHeader();
+	}
+
+	bool CookedTexture::IsOpen()
+	{
+		return m_file.IsOpen() && m_mips.size() > 0;
+	}
+
+	CookedTextureHeader& CookedTexture::GetHeader()
+	{
+		return m_header;
+	}
+
+	std::vector<CookedMip>& CookedTexture::GetMips()
+	{
+		return m_mips;
+	}
+
+	const unsigned char* CookedTexture::GetPixelData()
+	{
+		if (!IsOpen())
+		{
+			return nullptr;
+		}
+		return m_file.GetData() + sizeof(CookedTextureHeader) + m_mips.size() * sizeof(CookedMip);
+	}
+
+	// Each level is filtered from the one above it the way RecordGenerateMipmaps() blits with VK_FILTER_LINEAR: a bilinear sample at
+	// the destination texel's center, clamped to the edge, which is a 2x2 average wherever the source dimension is even
+	void CookedTexture::BuildMipChain(const unsigned char* pixels, int width, int height, std::vector<unsigned char>& chain, std::vector<CookedMip>& mips)
+	{
+		uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+		chain.clear();
+		mips.clear();
+
+		CookedMip base = CookedMip();
+		base.width = width;
+		base.height = height;
+		base.offset = 0;
+		base.size = (uint64_t)width * height * 4;
+		mips.push_back(base);
+		chain.assign(pixels, pixels + base.size);
+
+		for (uint32_t level = 1; level < mipLevels; level++)
+		{
+			CookedMip source = mips.back();
+			CookedMip mip = CookedMip();
+			mip.width = std::max(1u, source.width / 2);
+			mip.height = std::max(1u, source.height / 2);
+			mip.offset = chain.size();
+			mip.size = (uint64_t)mip.width * mip.height * 4;
+			chain.resize(static_cast<size_t>(mip.offset + mip.size));
+
+			const unsigned char* src = chain.data() + source.offset;
+			unsigned char* dst = chain.data() + mip.offset;
+			float scaleX = (float)source.width / mip.width;
+			float scaleY = (float)source.height / mip.height;
+
+			for (uint32_t y = 0; y < mip.height; y++)
+			{
+				float v = (y + 0.5f) * scaleY - 0.5f;
+				int y0 = (int)std::floor(v);
+				float fy = v - y0;
+				int y1 = std::min(y0 + 1, (int)source.height - 1);
+				y0 = std::max(y0, 0);
+
+				for (uint32_t x = 0; x < mip.width; x++)
+				{
+					float u = (x + 0.5f) * scaleX - 0.5f;
+					int x0 = (int)std::floor(u);
+					float fx = u - x0;
+					int x1 = std::min(x0 + 1, (int)source.width - 1);
+					x0 = std::max(x0, 0);
+
+					for (int channel = 0; channel < 4; channel++)
+					{
+						float topLeft = src[((size_t)y0 * source.width + x0) * 4 + channel];
+						float topRight = src[((size_t)y0 * source.width + x1) * 4 + channel];
+						float bottomLeft = src[((size_t)y1 * source.width + x0) * 4 + channel];
+						float bottomRight = src[((size_t)y1 * source.width + x1) * 4 + channel];
+						float top = topLeft + (topRight - topLeft) * fx;
+						float bottom = bottomLeft + (bottomRight - bottomLeft) * fx;
+						dst[((size_t)y * mip.width + x) * 4 + channel] = (unsigned char)std::min(255.0f, top + (bottom - top) * fy + 0.5f);
+					}
+				}
+			}
+			mips.push_back(mip);
+		}
+	}
+
+	bool CookedTexture::Write(std::string cookedPath, const unsigned char* pixels, int width, int height)
+	{
+		if (pixels == nullptr || width <= 0 || height <= 0)
+		{
+			return false;
+		}
+
+		std::vector<unsigned char> chain;
+		std::vector<CookedMip> mips;
+		BuildMipChain(pixels, width, height, chain, mips);
+
+		CookedTextureHeader header = CookedTextureHeader();
+		header.magic = COOKED_TEXTURE_MAGIC;
+		header.version = COOKED_TEXTURE_VERSION;
+		header.format = CookedRGBA8;
+		header.width = width;
+		header.height = height;
+		header.mipLevels = (uint32_t)mips.size();
+		header.dataSize = chain.size();
+
+		// Written beside the final path and renamed over it so a running game never maps a half written file
+		std::string tempPath = cookedPath + ".tmp";
+		std::error_code error;
+		std::filesystem::create_directories(std::filesystem::path(cookedPath).parent_path(), error);
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				return false;
+			}
+			file.write((const char*)&header, sizeof(CookedTextureHeader));
+			file.write((const char*)mips.data(), mips.size() * sizeof(CookedMip));
+			file.write((const char*)chain.data(), chain.size());
+			if (!file.good())
+			{
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, cookedPath, error);
+		return !error;
+	}
+
+	bool CookedTexture::Cook(std::string sourcePath, std::string cookedPath)
+	{
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		stbi_uc* pixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+		if (pixels == nullptr)
+		{
+			return false;
+		}
+
+		bool b_written = Write(cookedPath, pixels, width, height);
+		stbi_image_free(pixels);
+		return b_written;
+	}
+
+	std::string CookedTexture::GetCookedPath(std::string sourcePath)
+	{
+		return VirtualFileSystem::GetCookedPath(sourcePath, COOKED_TEXTURE_EXTENSION);
+	}
+
+	bool CookedTexture::HasCurrentCook(std::string sourcePath)
+	{
+		return F_VirtualFileSystem.IsUpToDate(GetCookedPath(sourcePath), sourcePath);
+	}
+}
\ No newline at end of file
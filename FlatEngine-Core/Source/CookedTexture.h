@@ -0,0 +1,68 @@
+#pragma once
+#include "VirtualFileSystem.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+namespace FlatEngine
+{
+	const uint32_t COOKED_TEXTURE_MAGIC = 0x58544C46; // "FLTX"
+	const uint32_t COOKED_TEXTURE_VERSION = 1;
+	const std::string COOKED_TEXTURE_EXTENSION = ".fltex";
+
+	enum CookedTextureFormat {
+		CookedRGBA8 = 0
+	};
+
+	// Followed by one CookedMip per level, then the pixel data of every level back to back
+	struct CookedTextureHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t format;
+		uint32_t width;
+		uint32_t height;
+		uint32_t mipLevels;
+		uint64_t dataSize;
+	};
+
+	struct CookedMip
+	{
+		uint32_t width;
+		uint32_t height;
+		uint64_t offset; // from the start of the pixel data
+		uint64_t size;
+	};
+
+	// A texture cooked by BuildProject(): RGBA8 pixels with the whole mip chain already built, so loading it is a file
+	// mapping and a copy into the staging ring with no image decode or GPU blits. Open() maps the file, or points into the mounted
+	// asset pack, and the pixel data stays mapped until Close(). Cooking only needs the CPU.
+	class CookedTexture
+	{
+	public:
+		CookedTexture();
+		~CookedTexture();
+		CookedTexture(const CookedTexture&) = delete;
+		CookedTexture& operator=(const CookedTexture&) = delete;
+
+		bool Open(std::string path);
+		void Close();
+		bool IsOpen();
+		CookedTextureHeader& GetHeader();
+		std::vector<CookedMip>& GetMips();
+		const unsigned char* GetPixelData();
+
+		static bool Cook(std::string sourcePath, std::string cookedPath);
+		static bool Write(std::string cookedPath, const unsigned char* pixels, int width, int height);
+		static void BuildMipChain(const unsigned char* pixels, int width, int height, std::vector<unsigned char>& chain, std::vector<CookedMip>& mips);
+		static std::string GetCookedPath(std::string sourcePath);
+		static bool HasCurrentCook(std::string sourcePath);
+
+	private:
+		CookedTextureHeader m_header;
+		std::vector<CookedMip> m_mips;
+		FileData m_file;
+	};
+}
\ No newline at end of file
@@ -20,6 +20,7 @@
 #include "TileMap.h"
 #include "Mesh.h"
 #include "FlatEngine.h"
+#include "SpatialIndex.h"
 
 namespace FL = FlatEngine;
 
@@ -524,6 +525,7 @@ namespace FlatEngine
 		{
 			if (m_BoxColliders.at(ownerID).count(componentID))
 			{
+				F_SpatialIndex.Remove(&m_BoxColliders.at(ownerID).at(componentID));
 				m_BoxColliders.at(ownerID).erase(componentID);
 				b_success = true;
 				UpdateColliderPairs();
@@ -540,6 +542,7 @@ namespace FlatEngine
 		{
 			if (m_CircleColliders.at(ownerID).count(componentID))
 			{
+				F_SpatialIndex.Remove(&m_CircleColliders.at(ownerID).at(componentID));
 				m_CircleColliders.at(ownerID).erase(componentID);
 				b_success = true;
 				UpdateColliderPairs();
@@ -36,6 +36,6 @@ namespace FlatEngine
 			CloseProgram();
 		}
 
-		return 1;
+		return F_Application->GetExitCode();
 	}
 }
\ No newline at end of file
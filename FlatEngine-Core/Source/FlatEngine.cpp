@@ -11,6 +11,18 @@
 #include "MappingContext.h"
 #include "Scene.h"
 #include "Animation.h"
+#include "SpatialIndex.h"
+#include "ContactCache.h"
+#include "Replay.h"
+#include "RenderIndex.h"
+#include "TextureAtlas.h"
+#include "GlyphCache.h"
+#include "TextureLoader.h"
+#include "TextureCache.h"
+#include "CookedTexture.h"
+#include "CookedMesh.h"
+#include "AssetPack.h"
+#include "VirtualFileSystem.h"
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
@@ -26,6 +38,8 @@
 #include <cmath>
 #include <shobjidl.h> 
 #include <random>
+#include <algorithm>
+#include <chrono>
 
 
 /*
@@ -79,8 +93,13 @@ namespace FlatEngine
 	std::vector<std::string> F_KeyBindingsAvailable = std::vector<std::string>();
 	std::string F_selectedMappingContextName = "";
 	TTF_Font* F_fontCinzel;
+	GlyphCache F_GlyphCache = GlyphCache();
+	TextureLoader F_TextureLoader = TextureLoader();
+	TextureCache F_TextureCache = TextureCache();
+	VirtualFileSystem F_VirtualFileSystem = VirtualFileSystem();
 	std::shared_ptr<PrefabManager> F_PrefabManager = std::make_shared<PrefabManager>();
 	std::vector<TileSet> F_TileSets = std::vector<TileSet>();
+	unsigned long F_tileSetsGeneration = 0;
 	std::string F_selectedTileSetToEdit = "- none -";
 	std::pair<std::string, int> F_tileSetAndIndexOnBrush = std::pair<std::string, int>();
 
@@ -96,6 +115,17 @@ namespace FlatEngine
 
 	// Collision Detection
 	std::vector<std::pair<Collider*, Collider*>> F_ColliderPairs = std::vector<std::pair<Collider*, Collider*>>();
+	std::vector<BoxCollider*> F_DynamicColliders = std::vector<BoxCollider*>();
+	std::vector<BoxCollider*> F_StaticColliders = std::vector<BoxCollider*>();
+	SpatialIndex F_StaticColliderIndex = SpatialIndex();
+	bool F_b_colliderPairsStale = true;
+	bool F_b_staticCollidersChanged = true;
+	ContactCache F_ContactCache = ContactCache();
+	Replay F_Replay = Replay();
+	SpatialIndex F_SpatialIndex = SpatialIndex();
+
+	// Sprite Atlas
+	TextureAtlas F_TextureAtlas = TextureAtlas();
 
 
 	bool LoadFonts()
@@ -204,10 +234,10 @@ namespace FlatEngine
 			};
 			Vector2 uvs[4] =
 			{
-				Vector2(0.0f, 0.0f),
-				Vector2(1.0f, 0.0f),
-				Vector2(1.0f, 1.0f),
-				Vector2(0.0f, 1.0f)
+				Vector2(uvStart.x, uvStart.y),
+				Vector2(uvEnd.x, uvStart.y),
+				Vector2(uvEnd.x, uvEnd.y),
+				Vector2(uvStart.x, uvEnd.y)
 			};
 
 			// Render sprite to viewport
@@ -318,7 +348,16 @@ namespace FlatEngine
 
 	void CloseProgram()
 	{
+		// Glyph and atlas pages are Vulkan textures, so they go before the VulkanManager does
+		F_TextureLoader.Stop();
+		F_TextureCache.Clear();
+		F_GlyphCache.Clear();
+		F_TextureAtlas.Clear();
+		// Pipelines compiled this run are kept for the next launch
+		VM_pipelineCache.Save();
 		F_VulkanManager->Cleanup();
+		// Cooked assets read in place point into the pack, so it stays mounted until nothing is left using them
+		F_VirtualFileSystem.Unmount();
 
 		// Clean up old gamepads
 		for (SDL_Joystick* gamepad : F_gamepads)
@@ -385,6 +424,12 @@ namespace FlatEngine
 		return (int)SDL_GetTicks();
 	}
 
+	// For timing work that finishes well inside a millisecond, GetEngineTime() only counts whole milliseconds
+	double GetTimeInMicroseconds()
+	{
+		return (double)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+	}
+
 
 	GameObject* GetPlayerObject()
 	{
@@ -396,6 +441,7 @@ namespace FlatEngine
 	void SetLoadedProject(Project &loadedProject)
 	{
 		F_LoadedProject = loadedProject;
+		F_RenderIndex.Clear();
 	}
 
 	Project& GetLoadedProject()
@@ -408,28 +454,10 @@ namespace FlatEngine
 		Project newProject = Project();
 		newProject.SetPath(path);
 		
-		std::ofstream fileObject;
-		std::ifstream ifstream(path);
+		projectJson = LoadFileData(path);
 
-		// Open file in in mode
-		fileObject.open(path, std::ios::in);		
-		std::string fileContent = "";
-		
-		if (fileObject.good())
-		{
-			std::string line;
-			while (!ifstream.eof()) 
-			{
-				std::getline(ifstream, line);
-				fileContent.append(line + "\n");
-			}
-		}
-		
-		fileObject.close();
-
-		if (fileObject.good())
+		if (projectJson != nullptr)
 		{		
-			projectJson = json::parse(fileContent);
 
 			if (projectJson["Project Properties"][0] != "nullptr")
 			{				
@@ -453,11 +481,16 @@ namespace FlatEngine
 					newProject.SetVsyncEnabled(CheckJsonBool(projectData, "_vsyncEnabled", name));
 					newProject.SetMusicVolume(CheckJsonInt(projectData, "musicVolume", name));
 					newProject.SetEffectsVolume(CheckJsonInt(projectData, "effectsVolume", name));
+					if (projectData.contains("_packTexturesOnLoad"))
+					{
+						newProject.SetPackTexturesOnLoad(CheckJsonBool(projectData, "_packTexturesOnLoad", name));
+					}
 				}
 			}
 		}
 
 		SetLoadedProject(newProject);
+		LoadTextureAtlas();
 
 		if (F_LoadedProject.GetPersistantGameObjectsScenePath() != "")
 		{
@@ -474,10 +507,203 @@ namespace FlatEngine
 		}
 	}
 
+	static std::string GetProjectDirectory()
+	{
+		return "..\\projects\\" + GetFilenameFromPath(F_LoadedProject.GetPath());
+	}
+
+	// Measures and packs every small project image into atlas pages, only the layout is written so the pages are composed at load
+	void BuildTextureAtlas()
+	{
+		TextureAtlas atlas = TextureAtlas();
+		std::string manifestPath = GetProjectDirectory() + "\\atlas.json";
+
+		try
+		{
+			if (atlas.Build(FindAllFilesWithExtension(GetProjectDirectory(), ".png")))
+			{
+				atlas.SaveManifest(manifestPath);
+				LogString("Packed " + std::to_string(atlas.GetRegionCount()) + " images into " + std::to_string(atlas.GetPageCount()) + " atlas pages in " + std::to_string((int)atlas.GetBuildTime()) + "us");
+			}
+			else if (DoesFileExist(manifestPath))
+			{
+				DeleteFileUsingPath(manifestPath);
+			}
+		}
+		catch (std::exception& e)
+		{
+			LogError("Failed to build texture atlas : ");
+			LogError(e.what());
+		}
+	}
+
+	// Writes a CookedTexture into the cook cache for every project image that has none or an outdated one, loading those skips the decode and mip blits
+	void CookProjectTextures()
+	{
+		double cookStart = GetTimeInMicroseconds();
+		std::vector<std::string> imagePaths = FindAllFilesWithExtension(GetProjectDirectory(), ".png");
+		std::vector<std::string> jpgPaths = FindAllFilesWithExtension(GetProjectDirectory(), ".jpg");
+		imagePaths.insert(imagePaths.end(), jpgPaths.begin(), jpgPaths.end());
+		int cookedCount = 0;
+
+		for (std::string& imagePath : imagePaths)
+		{
+			if (CookedTexture::HasCurrentCook(imagePath))
+			{
+				continue;
+			}
+			if (CookedTexture::Cook(imagePath, CookedTexture::GetCookedPath(imagePath)))
+			{
+				cookedCount++;
+			}
+			else
+			{
+				LogError("Failed to cook texture : " + imagePath);
+			}
+		}
+
+		LogString("Cooked " + std::to_string(cookedCount) + " of " + std::to_string(imagePaths.size()) + " textures in " + std::to_string((int)(GetTimeInMicroseconds() - cookStart)) + "us");
+	}
+
+	// Writes a CookedMesh into the cook cache for every project model that has none or an outdated one, loading those skips the obj parse and deduplication
+	void CookProjectMeshes()
+	{
+		double cookStart = GetTimeInMicroseconds();
+		std::vector<std::string> modelPaths = FindAllFilesWithExtension(GetProjectDirectory(), ".obj");
+		int cookedCount = 0;
+
+		for (std::string& modelPath : modelPaths)
+		{
+			if (CookedMesh::HasCurrentCook(modelPath))
+			{
+				continue;
+			}
+			if (Model::CookModel(modelPath))
+			{
+				cookedCount++;
+			}
+			else
+			{
+				LogError("Failed to cook model : " + modelPath);
+			}
+		}
+
+		LogString("Cooked " + std::to_string(cookedCount) + " of " + std::to_string(modelPaths.size()) + " models in " + std::to_string((int)(GetTimeInMicroseconds() - cookStart)) + "us");
+	}
+
+	// Packs the project and engine directories and the project's cooks into the archive a runtime build mounts instead of reading
+	// loose files. Runs after the cook steps so the cooks are packed and read in place.
+	void BuildAssetPack()
+	{
+		double packStart = GetTimeInMicroseconds();
+		std::string packPath = F_LoadedProject.GetBuildPath() + "\\" + ASSET_PACK_FILENAME;
+		std::vector<std::string> packedDirectories = { GetProjectDirectory(), "..\\engine" };
+		std::vector<std::string> filePaths;
+
+		// The project's cooks are packed under the same paths GetCookedPath() gives, so the runtime finds them in the pack
+		std::string cookedDirectory = VirtualFileSystem::GetCookedPath(GetProjectDirectory(), "");
+		std::error_code cookedError;
+		if (std::filesystem::is_directory(cookedDirectory, cookedError))
+		{
+			packedDirectories.push_back(cookedDirectory);
+		}
+
+		try
+		{
+			for (std::string& directory : packedDirectories)
+			{
+				for (auto& p : std::filesystem::recursive_directory_iterator(directory))
+				{
+					if (p.is_regular_file() && p.path().extension() != ".tmp")
+					{
+						filePaths.push_back(p.path().string());
+					}
+				}
+			}
+		}
+		catch (std::exception& e)
+		{
+			LogError("Failed to collect files for the asset pack : ");
+			LogError(e.what());
+			return;
+		}
+
+		if (AssetPack::Write(packPath, filePaths, true))
+		{
+			std::error_code error;
+			float megabyte = 1024.0f * 1024.0f;
+			LogString("Packed " + std::to_string(filePaths.size()) + " files into " + std::to_string(std::filesystem::file_size(packPath, error) / megabyte) + "MB in " + std::to_string((int)(GetTimeInMicroseconds() - packStart)) + "us");
+		}
+		else
+		{
+			LogError("Failed to write asset pack : " + packPath);
+		}
+	}
+
+	// Uses the manifest written by BuildProject() when there is one, otherwise packs at load if the project asks for it
+	void LoadTextureAtlas()
+	{
+		std::string manifestPath = GetProjectDirectory() + "\\atlas.json";
+
+		if (DoesFileExist(manifestPath))
+		{
+			F_TextureAtlas.LoadManifest(manifestPath);
+		}
+		else if (F_LoadedProject.PacksTexturesOnLoad() && F_TextureAtlas.Build(FindAllFilesWithExtension(GetProjectDirectory(), ".png")))
+		{
+			F_TextureAtlas.UploadPages();
+		}
+		else
+		{
+			F_TextureAtlas.Clear();
+		}
+	}
+
+	// Decodes every project image on one worker, then again on threadCount workers, times are wall clock microseconds.
+	// Images with a current cook are mapped instead of decoded, the same as when they load
+	bool MeasureImageDecode(int threadCount, int& imageCount, uint64_t& decodedBytes, float& singleThreadTime, float& threadedTime)
+	{
+		std::vector<std::string> imagePaths = FindAllFilesWithExtension(GetProjectDirectory(), ".png");
+		std::vector<std::string> jpgPaths = FindAllFilesWithExtension(GetProjectDirectory(), ".jpg");
+		imagePaths.insert(imagePaths.end(), jpgPaths.begin(), jpgPaths.end());
+		if (imagePaths.size() == 0)
+		{
+			return false;
+		}
+
+		std::vector<DecodedImage> decoded = std::vector<DecodedImage>();
+		ImageDecoder singleThreadDecoder;
+		singleThreadDecoder.Start(1);
+		singleThreadTime = singleThreadDecoder.DecodeAll(imagePaths, decoded);
+		singleThreadDecoder.Stop();
+		decoded.clear();
+
+		ImageDecoder threadedDecoder;
+		threadedDecoder.Start(threadCount);
+		threadedTime = threadedDecoder.DecodeAll(imagePaths, decoded);
+		threadedDecoder.Stop();
+
+		imageCount = 0;
+		for (DecodedImage& image : decoded)
+		{
+			if (image.b_success)
+			{
+				imageCount++;
+			}
+		}
+		decodedBytes = threadedDecoder.GetDecodedBytes();
+		return imageCount > 0;
+	}
+
 	void BuildProject()
 	{
 		if (F_LoadedProject.GetBuildPath() != "")
 		{
+			BuildTextureAtlas();
+			CookProjectTextures();
+			CookProjectMeshes();
+			BuildAssetPack();
+
 			try
 			{
 				std::filesystem::copy("..\\FlatEngine-Core", F_LoadedProject.GetBuildPath() + "\\Core", std::filesystem::copy_options::overwrite_existing | std::filesystem::copy_options::recursive);
@@ -914,6 +1140,14 @@ namespace FlatEngine
 
 		glfwPollEvents();
 
+		// Replays drive the game with the input recorded for the upcoming step instead
+		if (F_Replay.IsPlaying())
+		{
+			for (SDL_Event event : F_Replay.GetStepEvents())
+			{
+				DispatchInputEvent(event, firedKeys);
+			}
+		}
 
 
 
@@ -974,12 +1208,9 @@ namespace FlatEngine
 
 		//	HandleEngineEvents(event);
 
-		//	if (GameLoopStarted())
+		//	if (GameLoopStarted() && !F_Replay.IsPlaying())
 		//	{
-		//		for (MappingContext& context : F_MappingContexts)
-		//		{
-		//			HandleContextEvents(context, event, firedKeys);
-		//		}
+		//		DispatchInputEvent(event, firedKeys);
 		//	}
 		//}
 	}
@@ -1030,6 +1261,20 @@ namespace FlatEngine
 		}
 	}
 
+	// All game input goes through here so it can be recorded for replays
+	void DispatchInputEvent(SDL_Event event, std::vector<std::string>& firedKeys)
+	{
+		if (F_Replay.IsRecording())
+		{
+			F_Replay.RecordEvent(event);
+		}
+
+		for (MappingContext& context : F_MappingContexts)
+		{
+			HandleContextEvents(context, event, firedKeys);
+		}
+	}
+
 	void HandleContextEvents(MappingContext& context, SDL_Event event, std::vector<std::string> &firedKeys)
 	{
 		// Keyboard Keys Down
@@ -1201,12 +1446,14 @@ namespace FlatEngine
 			tileSet.SetTileSetIndices(indices);
 
 			F_TileSets.push_back(tileSet);
+			F_tileSetsGeneration++;
 		}
 	}
 
 	void InitializeTileSets()
 	{
 		F_TileSets.clear();
+		F_tileSetsGeneration++;
 
 		std::vector<std::string> tileSetFiles = std::vector<std::string>();
 		tileSetFiles = FindAllFilesWithExtension(GetDir("projectDir"), ".tls");
@@ -1236,6 +1483,10 @@ namespace FlatEngine
 	{	
 		ImGuiIO& io = ImGui::GetIO();
 
+		// Textures decoded since the last frame replace their placeholders before anything is drawn with them
+		F_TextureLoader.ProcessDecoded();
+		F_TextureCache.Trim();
+
 		// Start the Dear ImGui frame
 		ImGui_ImplVulkan_NewFrame();
 		ImGui_ImplGlfw_NewFrame();		
@@ -1627,26 +1878,10 @@ namespace FlatEngine
 		std::shared_ptr<Animation::S_Sprite > spriteProperties;
 		animProps->animationPath = path;
 
-		std::ofstream fileObject;
-		std::ifstream ifstream(path);
-		fileObject.open(path, std::ios::in);
-		std::string fileContent = "";
-
-		if (fileObject.good())
-		{
-			std::string line;
-			while (!ifstream.eof()) 
-			{
-				std::getline(ifstream, line);
-				fileContent.append(line + "\n");
-			}
-		}
-
-		fileObject.close();
+		json fileContentJson = LoadFileData(path);
 
-		if (fileObject.good())
+		if (fileContentJson != nullptr)
 		{
-			json fileContentJson = json::parse(fileContent);
 
 			if (fileContentJson.contains("animation"))
 			{
@@ -1882,14 +2117,22 @@ namespace FlatEngine
 
 		// Remake colliderPairs
 		F_ColliderPairs.clear();
-		std::vector<BoxCollider*> colliders;
+		F_DynamicColliders.clear();
+		F_StaticColliders.clear();
 
-		// Collect BoxColliders into a simple to navigate vector
+		// Sort BoxColliders into static and dynamic
 		for (std::map<long, std::map<long, BoxCollider>>::iterator colliderMap = sceneBoxColliders.begin(); colliderMap != sceneBoxColliders.end();)
 		{
 			for (std::map<long, BoxCollider>::iterator innerMap = colliderMap->second.begin(); innerMap != colliderMap->second.end();)
 			{
-				colliders.push_back(&innerMap->second);
+				if (innerMap->second.IsStatic())
+				{
+					F_StaticColliders.push_back(&innerMap->second);
+				}
+				else
+				{
+					F_DynamicColliders.push_back(&innerMap->second);
+				}
 				innerMap++;
 			}
 			colliderMap++;
@@ -1898,54 +2141,186 @@ namespace FlatEngine
 		{
 			for (std::map<long, BoxCollider>::iterator innerMap = colliderMap->second.begin(); innerMap != colliderMap->second.end();)
 			{
-				colliders.push_back(&innerMap->second);
+				if (innerMap->second.IsStatic())
+				{
+					F_StaticColliders.push_back(&innerMap->second);
+				}
+				else
+				{
+					F_DynamicColliders.push_back(&innerMap->second);
+				}
 				innerMap++;
 			}
 			colliderMap++;
 		}
 
-		int colliderCounter = 1;
-		for (std::vector<BoxCollider*>::iterator collider1 = colliders.begin(); collider1 != colliders.end(); collider1++)
+		// Static colliders never get paired, dynamic colliders query F_StaticColliderIndex for them instead
+		for (std::vector<BoxCollider*>::iterator collider1 = F_DynamicColliders.begin(); collider1 != F_DynamicColliders.end(); collider1++)
 		{
-			for (std::vector<BoxCollider*>::iterator collider2 = collider1 + colliderCounter; collider2 != colliders.end(); collider2++)
+			for (std::vector<BoxCollider*>::iterator collider2 = collider1 + 1; collider2 != F_DynamicColliders.end(); collider2++)
 			{
-				if ((*collider1)->GetParentID() != (*collider2)->GetParentID())
+				if ((*collider1)->GetParentID() != (*collider2)->GetParentID() && !IgnoresCollision(*collider1, *collider2))
 				{
-					TagList coll1TagList = (*collider1)->GetParent()->GetTagList();
-					TagList coll2TagList = (*collider2)->GetParent()->GetTagList();
+					std::pair<Collider*, Collider*> newPair = { (*collider1), (*collider2) };
+					F_ColliderPairs.push_back(newPair);
+				}
+			}
+		}
 
-					std::vector<std::string> coll1Ignored = coll1TagList.GetIgnoredTags();
-					std::vector<std::string> coll2Ignored = coll2TagList.GetIgnoredTags();
+		F_b_colliderPairsStale = false;
+		F_b_staticCollidersChanged = true;
+	}
 
-					bool _ignorePair = false;
+	bool IgnoresCollision(Collider* collider1, Collider* collider2)
+	{
+		if (collider1->GetParent() == nullptr || collider2->GetParent() == nullptr)
+		{
+			return false;
+		}
 
-					for (std::string ignoredTag : coll1Ignored)
-					{
-						if (coll2TagList.HasTag(ignoredTag))
-						{
-							_ignorePair = true;
-							break;
-						}
-					}
-					if (!_ignorePair)
-					{
-						for (std::string ignoredTag : coll2Ignored)
-						{
-							if (coll1TagList.HasTag(ignoredTag))
-							{
-								_ignorePair = true;
-								break;
-							}
-						}
-					}
-					if (!_ignorePair)
-					{
-						std::pair<Collider*, Collider*> newPair = { (*collider1), (*collider2) };
-						F_ColliderPairs.push_back(newPair);
-					}
-				}
+		TagList& coll1TagList = collider1->GetParent()->GetTagList();
+		TagList& coll2TagList = collider2->GetParent()->GetTagList();
+
+		for (std::string ignoredTag : coll1TagList.GetIgnoredTags())
+		{
+			if (coll2TagList.HasTag(ignoredTag))
+			{
+				return true;
+			}
+		}
+		for (std::string ignoredTag : coll2TagList.GetIgnoredTags())
+		{
+			if (coll1TagList.HasTag(ignoredTag))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Static colliders only get their bounds recalculated here, so this needs to run whenever the set of static colliders changes
+	void RebuildStaticColliderIndex(float gridStep, Vector2 viewportCenter)
+	{
+		F_StaticColliderIndex.Clear();
+
+		for (BoxCollider* staticCollider : F_StaticColliders)
+		{
+			if (staticCollider->GetParent() != nullptr)
+			{
+				staticCollider->RecalculateBounds(gridStep, viewportCenter);
+				F_StaticColliderIndex.Insert(staticCollider, staticCollider->GetGridEdges());
+			}
+		}
+
+		F_b_staticCollidersChanged = false;
+	}
+
+
+	// Replays
+	// FNV-1a
+	void HashBytes(unsigned long long& hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	// Hashes the exact bits of every position, rotation and velocity in owner ID order
+	unsigned long long HashPhysicsState()
+	{
+		unsigned long long hash = 14695981039346656037ULL;
+		std::vector<Scene*> scenes = { GetLoadedScene(), GetLoadedProject().GetPersistantGameObjectScene() };
+
+		for (Scene* scene : scenes)
+		{
+			if (scene == nullptr)
+			{
+				continue;
+			}
+
+			for (std::pair<const long, Transform>& transform : scene->GetTransforms())
+			{
+				Vector2 position = transform.second.GetPosition();
+				float rotation = transform.second.GetRotation();
+				HashBytes(hash, &transform.first, sizeof(long));
+				HashBytes(hash, &position.x, sizeof(float));
+				HashBytes(hash, &position.y, sizeof(float));
+				HashBytes(hash, &rotation, sizeof(float));
+			}
+			for (std::pair<const long, RigidBody>& rigidBody : scene->GetRigidBodies())
+			{
+				Vector2 velocity = rigidBody.second.GetVelocity();
+				float angularVelocity = rigidBody.second.GetAngularVelocity();
+				HashBytes(hash, &rigidBody.first, sizeof(long));
+				HashBytes(hash, &velocity.x, sizeof(float));
+				HashBytes(hash, &velocity.y, sizeof(float));
+				HashBytes(hash, &angularVelocity, sizeof(float));
 			}
 		}
+
+		return hash;
+	}
+
+
+	// Spatial Queries
+	std::vector<GameObject*> GetUniqueOwners(std::vector<Collider*> colliders)
+	{
+		std::vector<GameObject*> owners;
+		for (Collider* collider : colliders)
+		{
+			GameObject* owner = collider->GetParent();
+			if (owner != nullptr && std::find(owners.begin(), owners.end(), owner) == owners.end())
+			{
+				owners.push_back(owner);
+			}
+		}
+		return owners;
+	}
+
+	RaycastHit Raycast(Vector2 origin, Vector2 direction, float maxDistance, int layerMask)
+	{
+		RaycastHit hit = RaycastHit();
+		F_SpatialIndex.Raycast(origin, direction, maxDistance, layerMask, hit);
+		return hit;
+	}
+
+	std::vector<GameObject*> OverlapBox(Vector2 center, Vector2 halfExtents, int layerMask)
+	{
+		return GetUniqueOwners(F_SpatialIndex.OverlapBox(center, halfExtents, layerMask));
+	}
+
+	std::vector<GameObject*> OverlapCircle(Vector2 center, float radius, int layerMask)
+	{
+		return GetUniqueOwners(F_SpatialIndex.OverlapCircle(center, radius, layerMask));
+	}
+
+	// Objects with several colliders count once, so more than count colliders may need to be gathered
+	std::vector<GameObject*> QueryNearest(Vector2 point, int count, int layerMask)
+	{
+		std::vector<GameObject*> nearest;
+		int colliderCount = count;
+
+		while (count > 0)
+		{
+			std::vector<Collider*> colliders = F_SpatialIndex.QueryNearest(point, colliderCount, layerMask);
+			nearest = GetUniqueOwners(colliders);
+
+			if ((int)nearest.size() >= count || (int)colliders.size() < colliderCount)
+			{
+				break;
+			}
+			colliderCount *= 2;
+		}
+		if ((int)nearest.size() > count)
+		{
+			nearest.resize(count);
+		}
+
+		return nearest;
 	}
 
 
@@ -2327,29 +2702,14 @@ namespace FlatEngine
 		return dir;
 	}
 
+	// One read (or a view into the asset pack) parsed in place, the file's text is never copied into a string
 	json LoadFileData(std::string filepath)
 	{		
-		std::ofstream fileObject;
-		std::ifstream ifstream(filepath);
-
-		// Open file in in mode
-		fileObject.open(filepath, std::ios::in);		
-		std::string fileContent = "";
+		FileData file;
 
-		if (fileObject.good())
-		{
-			std::string line;
-			while (!ifstream.eof()) {
-				std::getline(ifstream, line);
-				fileContent.append(line + "\n");
-			}
-		}
-		
-		fileObject.close();
-
-		if (fileObject.good() && fileContent != "\n")
+		if (F_VirtualFileSystem.Read(filepath, file) && file.GetSize() > 0)
 		{			
-			return json::parse(fileContent);
+			return json::parse(file.GetData(), file.GetData() + file.GetSize());
 		}
 		else
 		{
@@ -2360,7 +2720,7 @@ namespace FlatEngine
 
 	bool DoesFileExist(std::string filepath)
 	{
-		return (filepath != "" && std::filesystem::exists(filepath));
+		return F_VirtualFileSystem.Exists(filepath);
 	}
 
 	bool FilepathHasExtension(std::string filepath, std::string extension)
@@ -2400,17 +2760,86 @@ namespace FlatEngine
 
 	std::vector<std::string> FindAllFilesWithExtension(std::string dirPath, std::string extension)
 	{
-		std::vector<std::string> files;
+		return F_VirtualFileSystem.FindAllFilesWithExtension(dirPath, extension);
+	}
 
-		for (auto& p : std::filesystem::recursive_directory_iterator(dirPath))
+	// For storing binary blobs (packed tile data) inside the json save files
+	std::string EncodeBase64(const std::vector<uint8_t>& data)
+	{
+		static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		std::string encoded;
+		encoded.reserve((data.size() + 2) / 3 * 4);
+
+		for (size_t i = 0; i < data.size(); i += 3)
 		{
-			if (p.path().extension() == extension || p.path().string().find(extension) != std::string::npos)
+			uint32_t triple = (uint32_t)data[i] << 16;
+			if (i + 1 < data.size())
 			{
-				files.push_back(p.path().string());
+				triple |= (uint32_t)data[i + 1] << 8;
 			}
+			if (i + 2 < data.size())
+			{
+				triple |= (uint32_t)data[i + 2];
+			}
+
+			encoded.push_back(alphabet[(triple >> 18) & 0x3F]);
+			encoded.push_back(alphabet[(triple >> 12) & 0x3F]);
+			encoded.push_back(i + 1 < data.size() ? alphabet[(triple >> 6) & 0x3F] : '=');
+			encoded.push_back(i + 2 < data.size() ? alphabet[triple & 0x3F] : '=');
 		}
 
-		return files;
+		return encoded;
+	}
+
+	std::vector<uint8_t> DecodeBase64(std::string encoded)
+	{
+		std::vector<uint8_t> data;
+		data.reserve(encoded.size() / 4 * 3);
+		uint32_t buffer = 0;
+		int bits = 0;
+
+		for (char c : encoded)
+		{
+			int value = -1;
+			if (c >= 'A' && c <= 'Z')
+			{
+				value = c - 'A';
+			}
+			else if (c >= 'a' && c <= 'z')
+			{
+				value = c - 'a' + 26;
+			}
+			else if (c >= '0' && c <= '9')
+			{
+				value = c - '0' + 52;
+			}
+			else if (c == '+')
+			{
+				value = 62;
+			}
+			else if (c == '/')
+			{
+				value = 63;
+			}
+			else if (c == '=')
+			{
+				break;
+			}
+			else
+			{
+				continue;
+			}
+
+			buffer = (buffer << 6) | (uint32_t)value;
+			bits += 6;
+			if (bits >= 8)
+			{
+				bits -= 8;
+				data.push_back((uint8_t)((buffer >> bits) & 0xFF));
+			}
+		}
+
+		return data;
 	}
 
 
@@ -3033,6 +3462,8 @@ namespace FlatEngine
 					newBoxCollider->SetActiveDimensions(CheckJsonFloat(componentJson, "activeWidth", objectName), CheckJsonFloat(componentJson, "activeHeight", objectName));
 					newBoxCollider->SetActiveOffset(Vector2(CheckJsonFloat(componentJson, "activeOffsetX", objectName), CheckJsonFloat(componentJson, "activeOffsetY", objectName)));
 					newBoxCollider->SetIsContinuous(CheckJsonBool(componentJson, "_isContinuous", objectName));
+					// Colliders saved before stay events were opt-in always fired OnBoxCollision
+					newBoxCollider->SetFiresStayEvents(!componentJson.contains("_firesStayEvents") || CheckJsonBool(componentJson, "_firesStayEvents", objectName));
 					newBoxCollider->SetIsStatic(CheckJsonBool(componentJson, "_isStatic", objectName));
 					newBoxCollider->SetIsSolid(CheckJsonBool(componentJson, "_isSolid", objectName));
 					newBoxCollider->SetActiveLayer(CheckJsonInt(componentJson, "activeLayer", objectName));
@@ -3046,6 +3477,7 @@ namespace FlatEngine
 					newCircleCollider->SetActiveRadiusGrid(CheckJsonFloat(componentJson, "activeRadius", objectName));
 					newCircleCollider->SetActiveOffset(Vector2(CheckJsonFloat(componentJson, "activeOffsetX", objectName), CheckJsonFloat(componentJson, "activeOffsetY", objectName)));
 					newCircleCollider->SetIsContinuous(CheckJsonBool(componentJson, "_isContinuous", objectName));
+					newCircleCollider->SetFiresStayEvents(!componentJson.contains("_firesStayEvents") || CheckJsonBool(componentJson, "_firesStayEvents", objectName));
 					newCircleCollider->SetIsStatic(CheckJsonBool(componentJson, "_isStatic", objectName));
 					newCircleCollider->SetIsSolid(CheckJsonBool(componentJson, "_isSolid", objectName));
 					newCircleCollider->SetActiveLayer(CheckJsonInt(componentJson, "activeLayer", objectName));
@@ -3090,20 +3522,24 @@ namespace FlatEngine
 							}
 						}
 					}
-					// Get Tile data
-					if (JsonContains(componentJson, "tiles", objectName))
+					// Get Tile data, packed binary since the chunked tile storage, one json object per tile before that
+					if (componentJson.contains("tileData"))
+					{
+						newTileMap->DecodeTiles(DecodeBase64(CheckJsonString(componentJson, "tileData", objectName)));
+					}
+					else if (JsonContains(componentJson, "tiles", objectName))
 					{
 						for (int tile = 0; tile < componentJson["tiles"].size(); tile++)
 						{
 							json tileJson = componentJson["tiles"][tile];
-							float x = CheckJsonFloat(tileJson, "tileCoordX", objectName);
-							float y = CheckJsonFloat(tileJson, "tileCoordY", objectName);
+							int x = (int)CheckJsonFloat(tileJson, "tileCoordX", objectName);
+							int y = (int)CheckJsonFloat(tileJson, "tileCoordY", objectName);
 							std::string tileSetName = CheckJsonString(tileJson, "tileSetName", objectName);
 							int tileSetIndex = CheckJsonInt(tileJson, "tileSetIndex", objectName);
 				
-							if (tileSetName != "" && GetTileSet(tileSetName) != nullptr && tileSetIndex != -1)
+							if (tileSetName != "" && tileSetIndex != -1)
 							{								
-								newTileMap->SetTile(Vector2(x, y), GetTileSet(tileSetName), tileSetIndex);
+								newTileMap->SetTile(x, y, tileSetName, tileSetIndex);
 							}
 						}
 					}
@@ -3125,9 +3561,12 @@ namespace FlatEngine
 								collisionCoordBuffer.push_back(colPair);
 							}
 
+							// Scenes saved since collision areas were merged store the merged rectangles, older ones get merged now
+							bool b_isMerged = colliderAreaJson.contains("_isMerged") && CheckJsonBool(colliderAreaJson, "_isMerged", objectName);
+
 							if (collisionCoordBuffer.size() > 0)
 							{
-								newTileMap->SetCollisionAreaValues(collisionAreaName, collisionCoordBuffer);
+								newTileMap->SetCollisionAreaValues(collisionAreaName, collisionCoordBuffer, !b_isMerged);
 							}										
 						}
 					}
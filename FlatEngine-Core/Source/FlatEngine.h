@@ -15,6 +15,7 @@
 #include <map>
 #include <sstream>
 #include <vector>
+#include <cstdint>
 #include "SDL.h"
 #include <SDL_syswm.h> // Uint32
 #include <SDL_image.h>
@@ -65,6 +66,7 @@ namespace FlatEngine
 	class TagList;
 	class Camera;
 	class Collider;
+	class BoxCollider;
 	class ScriptComponent;
 	class Sound;
 	class RigidBody;
@@ -72,6 +74,17 @@ namespace FlatEngine
 	class CharacterController;	
 	class ECSManager;
 	class TileSet;
+	class SpatialIndex;
+	class ContactCache;
+	class Replay;
+	class RenderQueue;
+	class RenderIndex;
+	class TextureAtlas;
+	class GlyphCache;
+	class TextureLoader;
+	class TextureCache;
+	class VirtualFileSystem;
+	struct RaycastHit;
 
 	enum F_CURSOR_MODE {
 		TRANSLATE,
@@ -107,6 +120,7 @@ namespace FlatEngine
 	extern std::string F_selectedMappingContextName;
 	extern std::shared_ptr<PrefabManager> F_PrefabManager;
 	extern std::vector<TileSet> F_TileSets;
+	extern unsigned long F_tileSetsGeneration; // bumped whenever F_TileSets changes, so TileMaps waiting on a missing TileSet know to look again
 	extern std::string F_selectedTileSetToEdit;
 	extern std::pair<std::string, int> F_tileSetAndIndexOnBrush;
 
@@ -141,6 +155,10 @@ namespace FlatEngine
 	extern std::vector<Process> F_ProfilerProcesses;
 	extern Sound F_SoundController;
 	extern TTF_Font* F_fontCinzel;
+	extern GlyphCache F_GlyphCache;
+	extern TextureLoader F_TextureLoader;
+	extern TextureCache F_TextureCache;
+	extern VirtualFileSystem F_VirtualFileSystem;
 
 	extern int F_maxSpriteLayers;
 	extern float F_spriteScaleMultiplier;
@@ -160,8 +178,28 @@ namespace FlatEngine
 	extern void UpdateVulkanMeshes();
 
 	// Collision Detection
+	// F_ColliderPairs only holds dynamic-dynamic pairs, static BoxColliders are matched through F_StaticColliderIndex
 	extern std::vector<std::pair<Collider*, Collider*>> F_ColliderPairs;
+	extern std::vector<BoxCollider*> F_DynamicColliders;
+	extern std::vector<BoxCollider*> F_StaticColliders;
+	extern SpatialIndex F_StaticColliderIndex;
+	extern bool F_b_colliderPairsStale;
+	extern bool F_b_staticCollidersChanged;
 	extern void UpdateColliderPairs();
+	extern bool IgnoresCollision(Collider* collider1, Collider* collider2);
+	extern void RebuildStaticColliderIndex(float gridStep, Vector2 viewportCenter);
+	extern ContactCache F_ContactCache;
+
+	// Replays ( deterministic playback of recorded input, verified against a per-step state hash )
+	extern Replay F_Replay;
+	extern unsigned long long HashPhysicsState();
+
+	// Spatial Queries ( grid space, layerMask is a bit mask of Collider active layers, -1 for all )
+	extern SpatialIndex F_SpatialIndex;
+	extern RaycastHit Raycast(Vector2 origin, Vector2 direction, float maxDistance, int layerMask = -1);
+	extern std::vector<GameObject*> OverlapBox(Vector2 center, Vector2 halfExtents, int layerMask = -1);
+	extern std::vector<GameObject*> OverlapCircle(Vector2 center, float radius, int layerMask = -1);
+	extern std::vector<GameObject*> QueryNearest(Vector2 point, int count, int layerMask = -1);
 
 	extern bool LoadFonts();
 	extern void FreeFonts();
@@ -176,6 +214,7 @@ namespace FlatEngine
 	extern void HandleEvents(bool& b_quit);
 	extern void HandleEngineEvents(SDL_Event event);
 	extern void HandleContextEvents(MappingContext& context, SDL_Event event, std::vector<std::string>& firedKeys);
+	extern void DispatchInputEvent(SDL_Event event, std::vector<std::string>& firedKeys);
 	extern void RemapInputAction(std::string contextName, std::string inputAction, Uint32 timeoutTime = 0);
 
 	// Lua / Sol
@@ -186,19 +225,25 @@ namespace FlatEngine
 		OnCircleCollision,
 		OnCircleCollisionEnter,
 		OnCircleCollisionLeave,
+		OnCollisionEnter,
+		OnCollisionStay,
+		OnCollisionExit,
 		OnButtonMouseOver,
 		OnButtonMouseEnter,
 		OnButtonMouseLeave,
 		OnButtonLeftClick,
 		OnButtonRightClick
 	};
-	const std::string F_LuaEventNames[11] = {
+	const std::string F_LuaEventNames[14] = {
 		"OnBoxCollision",
 		"OnBoxCollisionEnter",
 		"OnBoxCollisionLeave",
 		"OnCircleCollision",
 		"OnCircleCollisionEnter",
 		"OnCircleCollisionLeave",
+		"OnCollisionEnter",
+		"OnCollisionStay",
+		"OnCollisionExit",
 		"OnButtonMouseOver",
 		"OnButtonMouseEnter",
 		"OnButtonMouseLeave",
@@ -216,6 +261,7 @@ namespace FlatEngine
 	extern void RunPersistantAwakeAndStart();
 	extern void RetrieveLuaScriptPaths();
 	extern bool CheckLuaScriptFile(std::string filePath);
+	extern sol::protected_function_result RunLuaScriptFile(std::string filePath);
 	extern void LoadLuaGameObject(GameObject* object, std::string scriptName);
 	// Lua/Sol Events
 	template <class T>
@@ -240,6 +286,13 @@ namespace FlatEngine
 	extern Project& GetLoadedProject();
 	extern void LoadGameProject(std::string path, json& projectJson);
 	extern void BuildProject();
+	extern void BuildTextureAtlas();
+	extern void CookProjectTextures();
+	extern void CookProjectMeshes();
+	extern void BuildAssetPack();
+	extern void LoadTextureAtlas();
+	extern bool MeasureImageDecode(int threadCount, int& imageCount, uint64_t& decodedBytes, float& singleThreadTime, float& threadedTime);
+	extern TextureAtlas F_TextureAtlas;
 	extern void SetProjectLoadedScenePath(std::string scenePath);
 	extern GameObject* CreatePersistantGameObject(long parentID = -1, long myID = -1);
 	extern std::map<long, GameObject>& GetPersistantObjects();
@@ -277,6 +330,7 @@ namespace FlatEngine
 	extern bool Init(int windowWidth, int windowHeight, DirectoryType dirType);
 	extern void CloseProgram();
 	extern Uint32 GetEngineTime();
+	extern double GetTimeInMicroseconds();
 	extern void ManageControllers();
 
 	// Controls Context Management
@@ -309,7 +363,11 @@ namespace FlatEngine
 	// Game View
 	extern void Game_RenderView(bool b_inRuntime = false);
 	extern void Game_RenderObjects(Vector2 canvasP0, Vector2 canvasSize);
-	extern void Game_RenderObject(GameObject self, Vector2 canvasP0, Vector2 canvasSize, ImDrawList* drawList, ImDrawListSplitter* drawSplitter, Vector2 cameraPosition, float cameraWidth, float cameraHeight);
+	extern void Game_UpdateViewComponents(Scene& scene);
+	extern void Game_ExtractRenderItems(GameObject& self, RenderQueue& renderQueue, Vector2 cameraPosition, float cameraWidth, float cameraHeight);
+	extern bool Game_MeasureExtraction(int objectCount, int iterations, std::vector<int>& objectCounts, std::vector<float>& extractionTimes);
+	extern RenderQueue F_GameRenderQueue;
+	extern RenderIndex F_RenderIndex;
 
 	// Game Loop Prettification
 	extern void StartGameLoop();
@@ -446,4 +504,6 @@ namespace FlatEngine
 	extern void DeleteFileUsingPath(std::string filePath);
 	extern std::vector<std::string> FindAllFilesWithExtension(std::string dirPath, std::string extension);
 	extern std::string GetFilePathUsingFileName(std::string dirPath, std::string name);
+	extern std::string EncodeBase64(const std::vector<uint8_t>& data);
+	extern std::vector<uint8_t> DecodeBase64(std::string encoded);
 };
\ No newline at end of file
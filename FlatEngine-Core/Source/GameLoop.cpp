@@ -17,8 +17,12 @@
 #include "Scene.h"
 #include "CharacterController.h"
 #include "MappingContext.h"
+#include "SpatialIndex.h"
+#include "ContactCache.h"
+#include "Replay.h"
 
 #include <vector>
+#include <algorithm>
 #include <process.h>
 #include <crtdefs.h>
 
@@ -38,6 +42,7 @@ namespace FlatEngine
 		m_currentTime = 0;
 		m_pausedTime = 0;
 		m_framesCounted = 0;
+		m_continuousCounter = 0;
 		m_deltaTime = 0.005f;
 		m_accumulator = m_deltaTime;		
 		m_hoveredButtons = std::vector<Button>();
@@ -54,6 +59,8 @@ namespace FlatEngine
 		m_activeTime = m_time - m_pausedTime;
 		m_b_paused = false;
 		m_accumulator = 0.0f;
+		// Non-continuous colliders are tested on a 10 step cycle, every run has to start it at the same point
+		m_continuousCounter = 0;
 
 		// Save the name of the scene we started with so we can load it back up when we stop
 		m_b_started = true;
@@ -75,6 +82,15 @@ namespace FlatEngine
 		HandleCollisions(gridstep, viewportCenter);
 		ApplyPhysics();
 
+		if (F_Replay.IsRecording())
+		{
+			F_Replay.RecordStep(HashPhysicsState());
+		}
+		else if (F_Replay.IsPlaying())
+		{
+			F_Replay.VerifyStep(HashPhysicsState());
+		}
+
 		FL::UpdateVulkanMeshes();
 	}
 
@@ -402,13 +418,34 @@ namespace FlatEngine
 
 	void GameLoop::HandleCollisions(float gridstep, Vector2 viewportCenter)
 	{		
+		// Spatial queries (Raycast, OverlapBox, etc.) use the bounds gathered here
+		F_SpatialIndex.Clear();
+		F_ContactCache.BeginStep();
+
+		if (F_b_colliderPairsStale)
+		{
+			UpdateColliderPairs();
+		}
+		if (F_b_staticCollidersChanged)
+		{
+			RebuildStaticColliderIndex(gridstep, viewportCenter);
+		}
+
 		std::map<long, std::map<long, BoxCollider>>& sceneBoxColliders = GetLoadedScene()->GetBoxColliders();
 		for (std::map<long, std::map<long, BoxCollider>>::iterator outerIter = sceneBoxColliders.begin(); outerIter != sceneBoxColliders.end();)
 		{
 			for (std::map<long, BoxCollider>::iterator innerIter = outerIter->second.begin(); innerIter != outerIter->second.end();)
 			{
 				innerIter->second.ResetCollisions();
-				innerIter->second.RecalculateBounds(gridstep, viewportCenter);
+				// Static collider bounds are kept from the last RebuildStaticColliderIndex()
+				if (!innerIter->second.IsStatic())
+				{
+					innerIter->second.RecalculateBounds(gridstep, viewportCenter);
+				}
+				if (innerIter->second.IsActive() && innerIter->second.GetParent() != nullptr && innerIter->second.GetParent()->IsActive())
+				{
+					F_SpatialIndex.Insert(&innerIter->second, innerIter->second.GetGridEdges());
+				}
 				innerIter++;
 			}
 			outerIter++;
@@ -419,20 +456,33 @@ namespace FlatEngine
 			for (std::map<long, BoxCollider>::iterator innerIter = outerIter->second.begin(); innerIter != outerIter->second.end();)
 			{
 				innerIter->second.ResetCollisions();
-				innerIter->second.RecalculateBounds(gridstep, viewportCenter);
+				// Static collider bounds are kept from the last RebuildStaticColliderIndex()
+				if (!innerIter->second.IsStatic())
+				{
+					innerIter->second.RecalculateBounds(gridstep, viewportCenter);
+				}
+				if (innerIter->second.IsActive() && innerIter->second.GetParent() != nullptr && innerIter->second.GetParent()->IsActive())
+				{
+					F_SpatialIndex.Insert(&innerIter->second, innerIter->second.GetGridEdges());
+				}
 				innerIter++;
 			}
 			outerIter++;
 		}
 
 		float processTime = (float)GetEngineTime();		
-		static int continuousCounter = 0;
 		for (std::pair<Collider*, Collider*>& colliderPair : F_ColliderPairs)
 		{
 			Collider* collider1 = colliderPair.first;
 			Collider* collider2 = colliderPair.second;
 
-			if (collider1->GetParent() != nullptr && collider1 != nullptr && collider1->IsActive() && collider2->GetParent() != nullptr && collider2 != nullptr && collider2->IsActive() && (!collider1->IsStatic() || !collider2->IsStatic()) && ((collider1->IsContinuous() || (!collider1->IsContinuous() && continuousCounter == 10)) || (collider2->IsContinuous() || (!collider2->IsContinuous() && continuousCounter == 10))))
+			bool b_testable = collider1 != nullptr && collider1->GetParent() != nullptr && collider1->IsActive() && collider2 != nullptr && collider2->GetParent() != nullptr && collider2->IsActive() && (!collider1->IsStatic() || !collider2->IsStatic());
+
+			if (b_testable && !collider1->IsContinuous() && !collider2->IsContinuous() && m_continuousCounter != 10)
+			{
+				F_ContactCache.KeepContact(collider1, collider2);
+			}
+			else if (b_testable)
 			{
 				if (collider2 != nullptr && (collider1->GetID() != collider2->GetID()) && collider2->IsActive())
 				{
@@ -443,11 +493,51 @@ namespace FlatEngine
 				}
 			}
 		}
-		if (continuousCounter >= 10)
+
+		// Dynamic vs static, only the static colliders near each dynamic collider get tested
+		for (BoxCollider* dynamicCollider : F_DynamicColliders)
 		{
-			continuousCounter = 0;
+			if (dynamicCollider->GetParent() == nullptr || !dynamicCollider->IsActive())
+			{
+				continue;
+			}
+
+			// Cover both the current and next position so fast movers still find what they are moving into
+			Vector4 edges = dynamicCollider->GetGridEdges();
+			Vector2 movement = dynamicCollider->GetNextCenterGrid() - dynamicCollider->GetCenterGrid();
+			float top = std::max(edges.x, edges.x + movement.y);
+			float right = std::max(edges.y, edges.y + movement.x);
+			float bottom = std::min(edges.z, edges.z + movement.y);
+			float left = std::min(edges.w, edges.w + movement.x);
+			Vector2 center = Vector2((left + right) / 2, (top + bottom) / 2);
+			Vector2 halfExtents = Vector2((right - left) / 2 + 0.1f, (top - bottom) / 2 + 0.1f);
+
+			for (Collider* staticCollider : F_StaticColliderIndex.OverlapBox(center, halfExtents))
+			{
+				if (staticCollider->GetParent() != nullptr && staticCollider->IsActive() && staticCollider->GetParentID() != dynamicCollider->GetParentID() &&
+					staticCollider->GetActiveLayer() == dynamicCollider->GetActiveLayer() &&
+					!IgnoresCollision(dynamicCollider, staticCollider))
+				{
+					if (dynamicCollider->IsContinuous() || staticCollider->IsContinuous() || m_continuousCounter == 10)
+					{
+						Collider::CheckForCollision(dynamicCollider, staticCollider);
+					}
+					else
+					{
+						F_ContactCache.KeepContact(dynamicCollider, staticCollider);
+					}
+				}
+			}
 		}
-		continuousCounter++;
+
+		if (m_continuousCounter >= 10)
+		{
+			m_continuousCounter = 0;
+		}
+		m_continuousCounter++;
+
+		// Fires OnCollisionExit for contacts whose pair was not tested or kept this step
+		F_ContactCache.EndStep();
 
 		processTime = (float)GetEngineTime() - processTime;
 		AddProcessData("Collision Testing", processTime);
@@ -61,7 +61,8 @@ namespace FlatEngine
 		bool m_b_paused;
 		bool m_b_frameSkipped;
 		bool m_b_gamePaused;
-		long m_framesCounted;		
+		long m_framesCounted;
+		int m_continuousCounter;
 		std::vector<Button> m_hoveredButtons;
 		std::vector<long> m_objectsQueuedForDelete;
 	};
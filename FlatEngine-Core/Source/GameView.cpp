@@ -12,8 +12,13 @@
 #include "TileMap.h"
 #include "TileSet.h"
 #include "Project.h"
+#include "RenderQueue.h"
+#include "RenderIndex.h"
+#include "AssetManager.h"
 
 #include "imgui.h"
+#include <cmath>
+#include <algorithm>
 
 
 namespace FL = FlatEngine;
@@ -34,6 +39,8 @@ namespace FlatEngine
 	float F_yGameCenter = 400 / 2;
 	Vector2 F_gameViewCenter = Vector2(0, 0);
 	Vector2 F_gameViewGridStep = Vector2(50, 50);
+	RenderQueue F_GameRenderQueue = RenderQueue();
+	RenderIndex F_RenderIndex = RenderIndex();
 
 
 	void Game_RenderView(bool b_inRuntime)
@@ -84,32 +91,16 @@ namespace FlatEngine
 	void Game_RenderObjects(Vector2 canvasP0, Vector2 canvasSize)
 	{		
 		Scene* loadedScene = FL::GetLoadedScene();
-		std::map<long, GameObject> sceneObjects;
 		Scene* persistantObjectScene = GetLoadedProject().GetPersistantGameObjectScene();
-		std::map<long, GameObject> persistantObjects = std::map<long, GameObject>();
-		Camera* primaryCamera;
+		Camera* primaryCamera = nullptr;
 		Transform* cameraTransform = nullptr;
 
 		if (loadedScene != nullptr)
 		{
-			sceneObjects = loadedScene->GetSceneObjects();			
 			primaryCamera = loadedScene->GetPrimaryCamera();
 		}
-		else
-		{
-			sceneObjects = std::map<long, GameObject>();
-			primaryCamera = nullptr;
-		}
-
-		if (persistantObjectScene != nullptr)
-		{
-			persistantObjects = persistantObjectScene->GetSceneObjects();
-		}
 		
 		ImDrawList* drawList = ImGui::GetWindowDrawList();
-		ImDrawListSplitter* drawSplitter = new ImDrawListSplitter();
-		// 3 channels for now in this scene view. 0 = scene objects, 1 = other UI (camera icon, etc), 2 = transform arrow
-		drawSplitter->Split(drawList, F_maxSpriteLayers + 5);
 
 		Vector2 cameraPosition(0, 0);
 		float cameraWidth = 50;
@@ -142,41 +133,112 @@ namespace FlatEngine
 		
 		F_gameViewCenter = Vector2((F_GAME_VIEWPORT_WIDTH / 2) - (cameraPosition.x * F_gameViewGridStep.x) + canvasP0.x, (F_GAME_VIEWPORT_HEIGHT / 2) + (cameraPosition.y * F_gameViewGridStep.x) + canvasP0.y);
 		Vector2 viewportCenterPoint = Vector2((F_GAME_VIEWPORT_WIDTH / 2) + canvasP0.x, (F_GAME_VIEWPORT_HEIGHT / 2) + canvasP0.y);
-		
-		float renderStartTime = 0;
-		renderStartTime = (float)FL::GetEngineTime();
 
-		for (std::map<long, GameObject>::iterator iter = sceneObjects.begin(); iter != sceneObjects.end();)
+		// Animations, Buttons and Canvases update for every object, on screen or not
+		if (loadedScene != nullptr)
+		{
+			Game_UpdateViewComponents(*loadedScene);
+		}
+		if (persistantObjectScene != nullptr)
+		{
+			Game_UpdateViewComponents(*persistantObjectScene);
+		}
+
+		// Gather everything visible into the render queue first, then draw it.
+		// Only the objects the render index places inside the camera are visited, so off screen objects cost nothing here
+		F_GameRenderQueue.BeginExtraction();
+		F_RenderIndex.Update();
+		AddProcessData("Render Index", F_RenderIndex.GetUpdateTime() / 1000);
+
+		float cameraTopEdge = cameraPosition.y + cameraHeight / 2;
+		float cameraRightEdge = cameraPosition.x + cameraWidth / 2;
+		float cameraBottomEdge = cameraPosition.y - cameraHeight / 2;
+		float cameraLeftEdge = cameraPosition.x - cameraWidth / 2;
+		std::vector<GameObject*>& visibleObjects = F_RenderIndex.Query(Vector4(cameraTopEdge, cameraRightEdge, cameraBottomEdge, cameraLeftEdge));
+		int objectCount = (int)visibleObjects.size();
+
+		for (GameObject* visibleObject : visibleObjects)
 		{
-			if (iter->second.IsActive())
+			if (visibleObject->IsActive())
 			{
-				Game_RenderObject(iter->second, canvasP0, canvasSize, drawList, drawSplitter, cameraPosition, cameraWidth, cameraHeight);
+				Game_ExtractRenderItems(*visibleObject, F_GameRenderQueue, cameraPosition, cameraWidth, cameraHeight);
 			}
+		}
 
-			iter++;
+		F_GameRenderQueue.EndExtraction(objectCount);
+		AddProcessData("Render Extraction", F_GameRenderQueue.GetExtractionTime() / 1000);
+
+		// Sorted by layer then texture, consecutive images with the same texture end up in one ImGui draw command
+		F_GameRenderQueue.Sort();
+		AddProcessData("Render Sort", F_GameRenderQueue.GetSortTime() / 1000);
+
+		// The sprite pipeline draws the whole queue in the main render pass, ImDrawList is only used when it could not be created
+		if (F_VulkanManager != nullptr && F_VulkanManager->GetSpriteBatch().HasResources())
+		{
+			SpriteBatch& spriteBatch = F_VulkanManager->GetSpriteBatch();
+			spriteBatch.Begin(canvasP0, canvasSize);
+			spriteBatch.Build(F_GameRenderQueue, F_gameViewCenter, F_gameViewGridStep.x);
+			AddProcessData("Sprite Batch", spriteBatch.GetBuildTime() / 1000);
 		}
-		for (std::map<long, GameObject>::iterator iter = persistantObjects.begin(); iter != persistantObjects.end();)
+		else
 		{
-			if (iter->second.IsActive())
+			for (int i = 0; i < F_GameRenderQueue.GetItemCount(); i++)
 			{
-				Game_RenderObject(iter->second, canvasP0, canvasSize, drawList, drawSplitter, cameraPosition, cameraWidth, cameraHeight);
+				RenderItem& item = F_GameRenderQueue.GetSortedItem(i);
+				AddImageToDrawList(item.texture, item.position, F_gameViewCenter, item.textureWidth, item.textureHeight, item.offset, item.scale, item.b_scalesWithZoom, F_gameViewGridStep.x, drawList, item.rotation, item.tintColor, item.uvStart, item.uvEnd);
 			}
+		}
+	}
 
-			iter++;
+	// Steps playing Animations and recalculates Button and Canvas active edges against the current gameViewCenter.
+	// Walks the component maps directly since these have to run whether or not their owner is on screen
+	void Game_UpdateViewComponents(Scene& scene)
+	{
+		auto b_ownerIsActive = [&](long ownerID)
+		{
+			GameObject* owner = scene.GetObjectByID(ownerID);
+			return owner != nullptr && owner->IsActive() && owner->GetTransform() != nullptr && owner->GetTransform()->IsActive();
+		};
+
+		for (std::pair<const long, Animation>& animationPair : scene.GetAnimations())
+		{
+			Animation& animation = animationPair.second;
+			if (animation.IsActive() && b_ownerIsActive(animationPair.first))
+			{
+				for (Animation::AnimationData& animData : animation.GetAnimations())
+				{
+					if (animData.b_playing)
+					{
+						animation.PlayAnimation(animData.name, GetEngineTime());
+					}
+				}
+			}
 		}
 
-		drawSplitter->Merge(drawList);
+		for (std::pair<const long, Button>& buttonPair : scene.GetButtons())
+		{
+			if (buttonPair.second.IsActive() && b_ownerIsActive(buttonPair.first))
+			{
+				buttonPair.second.CalculateActiveEdges();
+			}
+		}
+
+		for (std::pair<const long, Canvas>& canvasPair : scene.GetCanvases())
+		{
+			if (canvasPair.second.IsActive() && b_ownerIsActive(canvasPair.first))
+			{
+				canvasPair.second.CalculateActiveEdges();
+			}
+		}
 	}
 
-	void Game_RenderObject(GameObject self, Vector2 canvasP0, Vector2 canvasSize, ImDrawList* drawList, ImDrawListSplitter* drawSplitter, Vector2 cameraPosition, float cameraWidth, float cameraHeight)
+	// Adds the visible sprite, text and tiles of one GameObject to the render queue, nothing is drawn here
+	void Game_ExtractRenderItems(GameObject& self, RenderQueue& renderQueue, Vector2 cameraPosition, float cameraWidth, float cameraHeight)
 	{
 		FL::Transform* transform = self.GetTransform();
 		Sprite* sprite = self.GetSprite();
 		TileMap* tileMap = self.GetTileMap();
-		Animation* animation = self.GetAnimation();
 		Text* text = self.GetText();
-		Button* button = self.GetButton();
-		Canvas* canvas = self.GetCanvas();
 
 
 		if (transform != nullptr && transform->IsActive())
@@ -190,18 +252,6 @@ namespace FlatEngine
 			float cameraTopEdge = cameraPosition.y + cameraHeight / 2;
 			float cameraBottomEdge = cameraPosition.y - cameraHeight / 2;
 			
-			// I may want to find somewhere else to do this that is not dependent on a view.
-			if (animation != nullptr && animation->IsActive())
-			{
-				for (Animation::AnimationData animData : animation->GetAnimations())
-				{
-					if (animData.b_playing)
-					{
-						animation->PlayAnimation(animData.name, GetEngineTime());						
-					}
-				}
-			}
-
 			if (sprite != nullptr && sprite->GetTexture() != nullptr && sprite->IsActive())
 			{
 				VkDescriptorSet spriteTexture = sprite->GetTexture();
@@ -209,7 +259,6 @@ namespace FlatEngine
 				float textureHeight = (float)sprite->GetTextureHeight();
 				Vector2 spriteScale = sprite->GetScale();
 				Vector2 offset = sprite->GetOffset();
-				bool b_scalesWithZoom = true;
 				int renderOrder = sprite->GetRenderOrder();
 				Vector4 tintColor = sprite->GetTintColor();
 				Vector2 newScale = Vector2(scale.x * spriteScale.x * F_spriteScaleMultiplier, scale.y * spriteScale.y * F_spriteScaleMultiplier);
@@ -219,42 +268,33 @@ namespace FlatEngine
 				float spriteTopEdge = position.y + offset.y * newScale.y;
 				float spriteBottomEdge = position.y - offset.y * newScale.y;
 
-				bool b_isIntersecting = false;
-
-				if (spriteLeftEdge < cameraRightEdge && spriteRightEdge > cameraLeftEdge && spriteTopEdge > cameraBottomEdge && spriteBottomEdge < cameraTopEdge)
-				{
-					b_isIntersecting = true;
-				}
+				spriteScale.x *= scale.x;
+				spriteScale.y *= scale.y;
 
-				if (b_isIntersecting)
+				if (spriteLeftEdge < cameraRightEdge && spriteRightEdge > cameraLeftEdge && spriteTopEdge > cameraBottomEdge && spriteBottomEdge < cameraTopEdge && spriteScale.x > 0 && spriteScale.y > 0 && spriteTexture != nullptr)
 				{
-					if (renderOrder <= F_maxSpriteLayers && renderOrder >= 0)
-					{
-						drawSplitter->SetCurrentChannel(drawList, renderOrder);
-					}
-					else
-					{
-						drawSplitter->SetCurrentChannel(drawList, 0);
-					}
-				
-					spriteScale.x *= scale.x;
-					spriteScale.y *= scale.y;
-
-					if (spriteScale.x > 0 && spriteScale.y > 0 && spriteTexture != nullptr)
-					{
-						AddImageToDrawList(spriteTexture, position, F_gameViewCenter, textureWidth, textureHeight, offset, spriteScale, b_scalesWithZoom, F_gameViewGridStep.x, drawList, rotation, ImGui::GetColorU32(tintColor));
-					}
+					RenderItem item = RenderItem();
+					item.texture = spriteTexture;
+					item.position = position;
+					item.textureWidth = textureWidth;
+					item.textureHeight = textureHeight;
+					item.offset = offset;
+					item.scale = spriteScale;
+					item.rotation = rotation;
+					item.tintColor = ImGui::GetColorU32(tintColor);
+					item.uvStart = sprite->GetUVStart();
+					item.uvEnd = sprite->GetUVEnd();
+					item.renderOrder = renderOrder;
+					item.b_scalesWithZoom = true;
+					renderQueue.AddItem(item);
 				}
 			}
 
 			if (text != nullptr && text->IsActive())
 			{
-				std::shared_ptr<Texture> textTexture = text->GetTexture();
-				float textWidth = (float)textTexture->GetWidth();
-				float textHeight = (float)textTexture->GetHeight();				
-				int renderOrder = text->GetRenderOrder();
+				float textWidth = (float)text->GetWidth();
+				float textHeight = (float)text->GetHeight();
 				Vector2 offset = text->GetOffset();
-				bool b_spriteScalesWithZoom = true;
 				Vector4 tintColor = text->GetColor();
 				Vector2 newScale = Vector2(scale.x * F_spriteScaleMultiplier, scale.y * F_spriteScaleMultiplier);
 
@@ -263,120 +303,119 @@ namespace FlatEngine
 				float spriteTopEdge = position.y + offset.y * newScale.y;
 				float spriteBottomEdge = position.y - offset.y * newScale.y;
 
-				bool b_isIntersecting = false;
-
-				if (spriteLeftEdge < cameraRightEdge && spriteRightEdge > cameraLeftEdge && spriteTopEdge > cameraBottomEdge && spriteBottomEdge < cameraTopEdge)
-				{
-					b_isIntersecting = true;
-				}
-
-				if (b_isIntersecting)
+				if (spriteLeftEdge < cameraRightEdge && spriteRightEdge > cameraLeftEdge && spriteTopEdge > cameraBottomEdge && spriteBottomEdge < cameraTopEdge && textWidth > 0 && textHeight > 0)
 				{
-					if (textTexture->GetTexture() != nullptr)
+					// One quad per glyph from the font's shared page, kept between calls so extraction does not allocate
+					static std::vector<RenderItem> glyphItems = std::vector<RenderItem>();
+					text->GetGlyphRenderItems(position, newScale, rotation, ImGui::GetColorU32(tintColor), glyphItems);
+					for (RenderItem& item : glyphItems)
 					{
-						if (renderOrder <= F_maxSpriteLayers && renderOrder >= 0)
-						{
-							drawSplitter->SetCurrentChannel(drawList, renderOrder);
-						}
-						else
-						{
-							drawSplitter->SetCurrentChannel(drawList, 0);
-						}
-
-						AddImageToDrawList(textTexture->GetTexture(), position, F_gameViewCenter, textWidth, textHeight, offset, newScale, b_spriteScalesWithZoom, F_gameViewGridStep.x, drawList, rotation, ImGui::GetColorU32(tintColor));
+						renderQueue.AddItem(item);
 					}
 				}
 			}
 
 			if (tileMap != nullptr && tileMap->IsActive())
 			{
-				long id = tileMap->GetID();
-				bool b_isActive = tileMap->IsActive();
-				float width = (float)tileMap->GetWidth();							// in tiles
-				float height = (float)tileMap->GetHeight();							// in tiles
 				float tileWidth = (float)tileMap->GetTileWidth();
 				float tileHeight = (float)tileMap->GetTileHeight();
-				float gridWidth = width * tileWidth / FL::F_pixelsPerGridSpace;		// in grid tiles
-				float gridHeight = height * tileHeight / FL::F_pixelsPerGridSpace;	// in grid tiles
+				float gridWidth = tileMap->GetWidth() * tileWidth / FL::F_pixelsPerGridSpace;		// in grid tiles
+				float gridHeight = tileMap->GetHeight() * tileHeight / FL::F_pixelsPerGridSpace;	// in grid tiles
 				int renderOrder = tileMap->GetRenderOrder();
+				Vector2 mapTopLeft = Vector2(position.x - (gridWidth / 2), position.y + (gridHeight / 2));
 
-				std::map<int, std::map<int, Tile>> tiles = tileMap->GetTiles();
-				for (int w = 0; w < width; w++)
+				// Tiles are placed 2 grid spaces apart and drawn from their top left corner
+				float chunkSpan = 2.0f * (TILEMAP_CHUNK_SIZE - 1);
+				float tileDrawWidth = fabs(tileWidth * scale.x * F_spriteScaleMultiplier);
+				float tileDrawHeight = fabs(tileHeight * scale.y * F_spriteScaleMultiplier);
+
+				tileMap->UpdateChunks();
+
+				for (std::pair<const std::pair<int, int>, TileMapChunk>& chunkPair : tileMap->GetChunks())
 				{
-					if (tiles.count((int)w) > 0)
+					TileMapChunk& chunk = chunkPair.second;
+					float chunkLeftEdge = mapTopLeft.x + 2.0f * TILEMAP_CHUNK_SIZE * chunk.chunkX;
+					float chunkRightEdge = chunkLeftEdge + chunkSpan + tileDrawWidth;
+					float chunkTopEdge = mapTopLeft.y - 2.0f * TILEMAP_CHUNK_SIZE * chunk.chunkY;
+					float chunkBottomEdge = chunkTopEdge - chunkSpan - tileDrawHeight;
+
+					if (chunkLeftEdge < cameraRightEdge && chunkRightEdge > cameraLeftEdge && chunkTopEdge > cameraBottomEdge && chunkBottomEdge < cameraTopEdge)
 					{
-						for (int h = 0; h < height; h++)
+						for (RenderItem& chunkItem : chunk.items)
 						{
-							if (tiles.at((int)w).count((int)h) > 0)
-							{
-								Tile tile = tiles.at(w).at(h);
-
-								// Get TileSet for this tiles texture data
-								TileSet* usedTileSet = nullptr;
-								std::string tileSetName = tile.tileSetName;
-
-								if (tileSetName != "")
-								{
-									usedTileSet = FL::GetTileSet(tileSetName);
-								}
-
-								VkDescriptorSet texture = tile.tileSetTexture;
-								int textureWidth = usedTileSet->GetTexture()->GetWidth();
-								int textureHeight = usedTileSet->GetTexture()->GetHeight();
-								Vector2 uvStart = Vector2(tile.uvStart.x / textureWidth, tile.uvStart.y / textureHeight);
-								Vector2 uvEnd = Vector2(tile.uvEnd.x / textureWidth, tile.uvEnd.y / textureHeight);
-								float gridXPosition = (position.x - (gridWidth / 2)) + 2 * (float)w;
-								float gridYPosition = (position.y + (gridHeight / 2)) - 2 * (float)h;
-								Vector2 tilePosition = Vector2(gridXPosition, gridYPosition);
-
-								if (renderOrder <= F_maxSpriteLayers && renderOrder >= 0)
-								{
-									drawSplitter->SetCurrentChannel(drawList, renderOrder);
-								}
-								else
-								{
-									drawSplitter->SetCurrentChannel(drawList, 0);
-								}
-
-								FL::AddImageToDrawList(texture, tilePosition, F_gameViewCenter, tileWidth, tileHeight, Vector2(0, 0), scale, true, F_gameViewGridStep.x, drawList, 0, FL::GetColor32("white"), uvStart, uvEnd);
-							}
+							RenderItem item = chunkItem;
+							item.position = Vector2(mapTopLeft.x + chunkItem.position.x, mapTopLeft.y + chunkItem.position.y);
+							item.scale = scale;
+							item.renderOrder = renderOrder;
+							renderQueue.AddItem(item);
 						}
 					}
 				}
 			}
+		}
+	}
 
-			if (button != nullptr && button->IsActive())
-			{
-				float activeWidth = button->GetActiveWidth();
-				float activeHeight = button->GetActiveHeight();
-				Vector2 activeOffset = button->GetActiveOffset();				
-				Vector4 activeEdges = button->GetActiveEdges();
-
-				float activeTop = activeEdges.x;
-				float activeRight = activeEdges.y;
-				float activeBottom = activeEdges.z;
-				float activeLeft = activeEdges.w;
-
-				// Active Edges depends on gameViewCenter, which can change with every call to Game_RenderView(), so we recalculate
-				button->CalculateActiveEdges();
-
-				// For drawing border in game view //
-				//Vector2 topLeft = { activeLeft, activeTop };
-				//Vector2 bottomRight = { activeRight, activeBottom };
+	// Adds sprites to the loaded scene in three rounds up to objectCount and times the extraction step of Game_RenderObjects() over all
+	// of them, render index query plus Game_ExtractRenderItems(), averaged over iterations. Fills objectCounts and extractionTimes
+	// (microseconds per frame) with one entry per round and deletes the sprites again before returning.
+	bool Game_MeasureExtraction(int objectCount, int iterations, std::vector<int>& objectCounts, std::vector<float>& extractionTimes)
+	{
+		objectCounts.clear();
+		extractionTimes.clear();
+		Scene* loadedScene = GetLoadedScene();
+		if (objectCount <= 0 || iterations <= 0 || loadedScene == nullptr)
+		{
+			return false;
+		}
 
-				//drawSplitter->SetCurrentChannel(drawList, F_maxSpriteLayers + 2);
+		std::vector<long> createdIDs = std::vector<long>();
+		createdIDs.reserve(objectCount);
+		RenderQueue renderQueue = RenderQueue();
+		int columns = (int)std::ceil(std::sqrt((float)objectCount));
+		float cameraSize = columns * 2.0f + 4.0f;
+		Vector2 cameraPosition = Vector2(columns - 1.0f, -(columns - 1.0f));
+		Vector4 cameraEdges = Vector4(cameraPosition.y + cameraSize / 2, cameraPosition.x + cameraSize / 2, cameraPosition.y - cameraSize / 2, cameraPosition.x - cameraSize / 2);
+		std::string texturePath = F_AssetManager.GetFailedToLoadImagePath();
 
-				//if (_isActive)
-				//	FL::DrawRectangle(topLeft, bottomRight, canvasP0, canvasSize, FL::GetColor("buttonComponentActive"), 3.0f, drawList);
-				//else
-				//	FL::DrawRectangle(topLeft, bottomRight, canvasP0, canvasSize, FL::GetColor("buttonComponentInactive"), 3.0f, drawList);
+		for (int round = 1; round <= 3; round++)
+		{
+			int roundCount = (round == 3) ? objectCount : std::max(1, objectCount / (4 / round));
+			while ((int)createdIDs.size() < roundCount)
+			{
+				int index = (int)createdIDs.size();
+				GameObject* object = loadedScene->CreateGameObject();
+				object->AddTransform()->SetPosition(Vector2((index % columns) * 2.0f, -(index / columns) * 2.0f));
+				object->AddSprite()->SetTexture(texturePath);
+				createdIDs.push_back(object->GetID());
 			}
+			F_RenderIndex.Update();
 
-			if (canvas != nullptr && canvas->IsActive())
+			double totalTime = 0;
+			for (int iteration = 0; iteration < iterations; iteration++)
 			{
-				// Active Edges depends on gameViewCenter, which can change with every call to Game_RenderView(), so we recalculate
-				canvas->CalculateActiveEdges();
+				renderQueue.BeginExtraction();
+				std::vector<GameObject*>& visibleObjects = F_RenderIndex.Query(cameraEdges);
+				for (GameObject* visibleObject : visibleObjects)
+				{
+					if (visibleObject->IsActive())
+					{
+						Game_ExtractRenderItems(*visibleObject, renderQueue, cameraPosition, cameraSize, cameraSize);
+					}
+				}
+				renderQueue.EndExtraction((int)visibleObjects.size());
+				totalTime += renderQueue.GetExtractionTime();
 			}
+
+			objectCounts.push_back(roundCount);
+			extractionTimes.push_back((float)(totalTime / iterations));
 		}
+
+		for (long createdID : createdIDs)
+		{
+			loadedScene->DeleteGameObject(createdID);
+		}
+		F_RenderIndex.Update();
+
+		return true;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,391 @@
+#include "GlyphCache.h"
+#include "FlatEngine.h"
+#include "Texture.h"
+
+#include <cstring>
+#include <algorithm>
+
+
+namespace FlatEngine
+{
+	FontAtlas::FontAtlas()
+	{
+		m_font = nullptr;
+		m_fontHeight = 0;
+		m_lineSkip = 0;
+		m_packer = AtlasPacker();
+		m_pageWidth = 0;
+		m_pageHeight = 0;
+		m_pixels = std::vector<unsigned char>();
+		m_glyphs = std::unordered_map<Uint16, Glyph>();
+		m_texture = nullptr;
+		m_b_dirty = false;
+	}
+
+	// The TTF_Font and page are released by Free() from GlyphCache::Clear(), while SDL_ttf and Vulkan are still up
+	FontAtlas::~FontAtlas()
+	{
+	}
+
+	bool FontAtlas::Load(std::string fontPath, int fontSize)
+	{
+		m_font = TTF_OpenFont(fontPath.c_str(), fontSize);
+		if (m_font == nullptr)
+		{
+			LogError("FontAtlas::Load() - Could not open font " + fontPath + " : " + TTF_GetError());
+			return false;
+		}
+
+		m_fontHeight = TTF_FontHeight(m_font);
+		m_lineSkip = TTF_FontLineSkip(m_font);
+
+		// Wide enough for roughly ten glyphs a row, the page grows downwards if it runs out of room
+		m_pageWidth = 256;
+		while (m_pageWidth < m_fontHeight * 10 && m_pageWidth < 2048)
+		{
+			m_pageWidth *= 2;
+		}
+		m_pageHeight = m_pageWidth / 2;
+		m_packer.Init(m_pageWidth, m_pageHeight);
+		m_pixels = std::vector<unsigned char>((size_t)m_pageWidth * m_pageHeight * 4, 0);
+
+		for (Uint16 codepoint = 32; codepoint < 127; codepoint++)
+		{
+			GetGlyph(codepoint);
+		}
+		Upload();
+
+		return true;
+	}
+
+	void FontAtlas::Free()
+	{
+		if (m_font != nullptr)
+		{
+			TTF_CloseFont(m_font);
+			m_font = nullptr;
+		}
+		if (m_texture != nullptr)
+		{
+			// A frame still in flight may be sampling the page
+			F_VulkanManager->WaitIdle();
+			m_texture->FreeTexture();
+			m_texture->Cleanup(F_VulkanManager->GetLogicalDevice());
+			m_texture = nullptr;
+		}
+		m_glyphs.clear();
+		m_pixels.clear();
+	}
+
+	bool FontAtlas::AddGlyph(Uint16 codepoint)
+	{
+		if (m_font == nullptr || !TTF_GlyphIsProvided(m_font, codepoint))
+		{
+			return false;
+		}
+
+		int advance = 0;
+		TTF_GlyphMetrics(m_font, codepoint, nullptr, nullptr, nullptr, nullptr, &advance);
+
+		SDL_Color white = { (Uint8)255, (Uint8)255, (Uint8)255, (Uint8)255 };
+		SDL_Surface* rendered = TTF_RenderGlyph_Blended(m_font, codepoint, white);
+		if (rendered == nullptr)
+		{
+			return false;
+		}
+
+		// ABGR8888 is R, G, B, A in memory, the byte order the page is uploaded with
+		SDL_Surface* surface = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ABGR8888, 0);
+		SDL_FreeSurface(rendered);
+		if (surface == nullptr)
+		{
+			return false;
+		}
+
+		Glyph glyph = { 0, 0, surface->w, surface->h, advance };
+
+		while (glyph.width > 0 && glyph.height > 0 && !m_packer.Pack(glyph.width, glyph.height, glyph.x, glyph.y))
+		{
+			if (m_pageHeight * 2 > GLYPH_PAGE_MAX_HEIGHT)
+			{
+				LogError("FontAtlas::AddGlyph() - Glyph page is full, glyph " + std::to_string(codepoint) + " will not be drawn.");
+				SDL_FreeSurface(surface);
+				return false;
+			}
+			// Rows are appended, so everything already on the page keeps its place
+			m_pageHeight *= 2;
+			m_packer.Grow(m_pageHeight);
+			m_pixels.resize((size_t)m_pageWidth * m_pageHeight * 4, 0);
+		}
+
+		SDL_LockSurface(surface);
+		for (int row = 0; row < glyph.height; row++)
+		{
+			std::memcpy(&m_pixels[((size_t)(glyph.y + row) * m_pageWidth + glyph.x) * 4], (unsigned char*)surface->pixels + (size_t)row * surface->pitch, (size_t)glyph.width * 4);
+		}
+		SDL_UnlockSurface(surface);
+		SDL_FreeSurface(surface);
+
+		m_glyphs.emplace(codepoint, glyph);
+		m_b_dirty = true;
+		return true;
+	}
+
+	Glyph* FontAtlas::GetGlyph(Uint16 codepoint)
+	{
+		auto found = m_glyphs.find(codepoint);
+		if (found == m_glyphs.end())
+		{
+			if (!AddGlyph(codepoint))
+			{
+				// Remember the miss so it is not rasterized again every layout
+				m_glyphs.emplace(codepoint, Glyph{ 0, 0, 0, 0, 0 });
+			}
+			found = m_glyphs.find(codepoint);
+		}
+		return &found->second;
+	}
+
+	int FontAtlas::GetKerning(Uint16 previous, Uint16 codepoint)
+	{
+		if (m_font == nullptr)
+		{
+			return 0;
+		}
+		return TTF_GetFontKerningSizeGlyphs(m_font, previous, codepoint);
+	}
+
+	// Only uploads when glyphs were added since the last upload
+	void FontAtlas::Upload()
+	{
+		if (!m_b_dirty)
+		{
+			return;
+		}
+
+		// The whole page is uploaded again, so the previous image is released first rather than left behind by LoadFromPixels()
+		if (m_texture != nullptr)
+		{
+			F_VulkanManager->WaitIdle();
+			m_texture->FreeTexture();
+			m_texture->Cleanup(F_VulkanManager->GetLogicalDevice());
+		}
+		m_texture = std::make_shared<Texture>();
+		std::vector<unsigned char> pixels = m_pixels;
+		if (!m_texture->LoadFromPixels(pixels, m_pageWidth, m_pageHeight))
+		{
+			LogError("FontAtlas::Upload() - Failed to upload glyph page.");
+		}
+		m_b_dirty = false;
+	}
+
+	VkDescriptorSet FontAtlas::GetTexture()
+	{
+		if (m_texture == nullptr)
+		{
+			return VK_NULL_HANDLE;
+		}
+		return m_texture->GetTexture();
+	}
+
+	int FontAtlas::GetPageWidth()
+	{
+		return m_pageWidth;
+	}
+
+	int FontAtlas::GetPageHeight()
+	{
+		return m_pageHeight;
+	}
+
+	int FontAtlas::GetLineSkip()
+	{
+		return m_lineSkip;
+	}
+
+	int FontAtlas::GetFontHeight()
+	{
+		return m_fontHeight;
+	}
+
+	int FontAtlas::GetGlyphCount()
+	{
+		return (int)m_glyphs.size();
+	}
+
+
+	GlyphCache::GlyphCache()
+	{
+		m_fonts = std::map<std::pair<std::string, int>, std::shared_ptr<FontAtlas>>();
+		m_layouts = std::unordered_map<std::string, std::shared_ptr<TextLayout>>();
+		m_layoutMisses = 0;
+	}
+
+	GlyphCache::~GlyphCache()
+	{
+	}
+
+	std::shared_ptr<FontAtlas> GlyphCache::GetFont(std::string fontPath, int fontSize)
+	{
+		std::pair<std::string, int> key = { fontPath, fontSize };
+		auto found = m_fonts.find(key);
+		if (found != m_fonts.end())
+		{
+			return found->second;
+		}
+
+		std::shared_ptr<FontAtlas> font = std::make_shared<FontAtlas>();
+		if (!font->Load(fontPath, fontSize))
+		{
+			return nullptr;
+		}
+		m_fonts.emplace(key, font);
+		return font;
+	}
+
+	// Decodes the UTF-8 text one codepoint at a time (Basic Multilingual Plane only, which is all SDL_ttf glyph calls take)
+	static Uint16 NextCodepoint(const std::string& text, size_t& index)
+	{
+		unsigned char lead = (unsigned char)text[index++];
+		int followBytes = 0;
+		Uint32 codepoint = lead;
+
+		if (lead >= 0xF0)
+		{
+			codepoint = lead & 0x07;
+			followBytes = 3;
+		}
+		else if (lead >= 0xE0)
+		{
+			codepoint = lead & 0x0F;
+			followBytes = 2;
+		}
+		else if (lead >= 0xC0)
+		{
+			codepoint = lead & 0x1F;
+			followBytes = 1;
+		}
+
+		for (int i = 0; i < followBytes && index < text.size(); i++)
+		{
+			codepoint = (codepoint << 6) | ((unsigned char)text[index++] & 0x3F);
+		}
+
+		if (codepoint > 0xFFFF)
+		{
+			return (Uint16)'?';
+		}
+		return (Uint16)codepoint;
+	}
+
+	std::shared_ptr<TextLayout> GlyphCache::GetLayout(std::string text, std::string fontPath, int fontSize)
+	{
+		std::string key = fontPath + '\n' + std::to_string(fontSize) + '\n' + text;
+		auto found = m_layouts.find(key);
+		if (found != m_layouts.end())
+		{
+			return found->second;
+		}
+
+		std::shared_ptr<FontAtlas> font = GetFont(fontPath, fontSize);
+		if (font == nullptr)
+		{
+			return nullptr;
+		}
+
+		m_layoutMisses++;
+		std::shared_ptr<TextLayout> layout = std::make_shared<TextLayout>();
+		layout->font = font;
+		layout->width = 0;
+		layout->height = text != "" ? font->GetFontHeight() : 0;
+
+		int penX = 0;
+		int lineTop = 0;
+		Uint16 previous = 0;
+		size_t index = 0;
+
+		while (index < text.size())
+		{
+			Uint16 codepoint = NextCodepoint(text, index);
+
+			if (codepoint == '\n')
+			{
+				penX = 0;
+				lineTop += font->GetLineSkip();
+				layout->height = lineTop + font->GetFontHeight();
+				previous = 0;
+				continue;
+			}
+
+			Glyph* glyph = font->GetGlyph(codepoint);
+			if (previous != 0)
+			{
+				penX += font->GetKerning(previous, codepoint);
+			}
+			if (glyph->width > 0 && glyph->height > 0)
+			{
+				GlyphQuad quad;
+				quad.position = Vector2((float)penX, (float)lineTop);
+				quad.width = (float)glyph->width;
+				quad.height = (float)glyph->height;
+				quad.glyph = *glyph;
+				layout->quads.push_back(quad);
+				layout->width = std::max(layout->width, penX + glyph->width);
+			}
+			penX += glyph->advance;
+			layout->width = std::max(layout->width, penX);
+			previous = codepoint;
+		}
+
+		// Uploads only if this text brought in a glyph outside printable ASCII
+		font->Upload();
+
+		if ((int)m_layouts.size() >= MAX_CACHED_TEXT_LAYOUTS)
+		{
+			TrimLayouts();
+		}
+		m_layouts.emplace(key, layout);
+		return layout;
+	}
+
+	// Drops the layouts nothing but the cache is holding, a score counter's old values go here
+	void GlyphCache::TrimLayouts()
+	{
+		for (auto layout = m_layouts.begin(); layout != m_layouts.end();)
+		{
+			if (layout->second.use_count() == 1)
+			{
+				layout = m_layouts.erase(layout);
+			}
+			else
+			{
+				layout++;
+			}
+		}
+	}
+
+	void GlyphCache::Clear()
+	{
+		m_layouts.clear();
+		for (std::pair<const std::pair<std::string, int>, std::shared_ptr<FontAtlas>>& font : m_fonts)
+		{
+			font.second->Free();
+		}
+		m_fonts.clear();
+	}
+
+	int GlyphCache::GetFontCount()
+	{
+		return (int)m_fonts.size();
+	}
+
+	int GlyphCache::GetLayoutCount()
+	{
+		return (int)m_layouts.size();
+	}
+
+	long GlyphCache::GetLayoutMisses()
+	{
+		return m_layoutMisses;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+#include "TextureAtlas.h"
+#include "Vector2.h"
+
+#include <SDL_ttf.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <map>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glfw3.h>
+
+
+namespace FlatEngine
+{
+	class Texture;
+
+	const int GLYPH_PAGE_MAX_HEIGHT = 4096;
+	const int MAX_CACHED_TEXT_LAYOUTS = 1024; // layouts no Text is holding on to are dropped past this
+
+	// Where one glyph sits in its FontAtlas page, in pixels
+	struct Glyph
+	{
+		int x;
+		int y;
+		int width;
+		int height;
+		int advance;
+	};
+
+	class FontAtlas;
+
+	struct GlyphQuad
+	{
+		Vector2 position; // top left in pixels, relative to the top left of the whole text
+		float width;
+		float height;
+		Glyph glyph;
+	};
+
+	struct TextLayout
+	{
+		std::shared_ptr<FontAtlas> font;
+		std::vector<GlyphQuad> quads;
+		int width;
+		int height;
+	};
+
+	// Every glyph of one font at one size, rasterized once with SDL_ttf into a single RGBA page.
+	// Printable ASCII is rasterized up front, anything else is added the first time a layout needs it.
+	class FontAtlas
+	{
+	public:
+		FontAtlas();
+		~FontAtlas();
+
+		bool Load(std::string fontPath, int fontSize);
+		void Free();
+		Glyph* GetGlyph(Uint16 codepoint);
+		int GetKerning(Uint16 previous, Uint16 codepoint);
+		void Upload();
+		VkDescriptorSet GetTexture();
+		int GetPageWidth();
+		int GetPageHeight();
+		int GetLineSkip();
+		int GetFontHeight();
+		int GetGlyphCount();
+
+	private:
+		bool AddGlyph(Uint16 codepoint);
+
+		TTF_Font* m_font;
+		int m_fontHeight;
+		int m_lineSkip;
+		AtlasPacker m_packer;
+		int m_pageWidth;
+		int m_pageHeight;
+		std::vector<unsigned char> m_pixels; // CPU copy of the page so late glyphs can be added and the page re-uploaded
+		std::unordered_map<Uint16, Glyph> m_glyphs;
+		std::shared_ptr<Texture> m_texture;
+		bool m_b_dirty;
+	};
+
+	// FontAtlases keyed by (font path, size) and laid out strings keyed by (font path, size, text).
+	// A string that has been shown before costs one lookup, a new one costs a glyph lookup per character,
+	// neither touches the GPU unless a glyph outside printable ASCII shows up for the first time.
+	class GlyphCache
+	{
+	public:
+		GlyphCache();
+		~GlyphCache();
+
+		std::shared_ptr<FontAtlas> GetFont(std::string fontPath, int fontSize);
+		std::shared_ptr<TextLayout> GetLayout(std::string text, std::string fontPath, int fontSize);
+		void Clear();
+		int GetFontCount();
+		int GetLayoutCount();
+		long GetLayoutMisses();
+
+	private:
+		void TrimLayouts();
+
+		std::map<std::pair<std::string, int>, std::shared_ptr<FontAtlas>> m_fonts;
+		std::unordered_map<std::string, std::shared_ptr<TextLayout>> m_layouts;
+		long m_layoutMisses;
+	};
+}
\ No newline at end of file
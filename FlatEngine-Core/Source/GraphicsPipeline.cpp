@@ -1,6 +1,7 @@
 #include "GraphicsPipeline.h"
 #include "Helper.h"
 #include "VulkanManager.h"
+#include "FlatEngine.h"
 
 #include <stdexcept>
 
@@ -91,13 +92,22 @@ namespace FlatEngine
         // 1. Bindings: spacing between data and whether the data is per - vertex or per - instance(see instancing)
         // 2. Attribute descriptions : type of the attributes passed to the vertex shader, which binding to load them from and at which offset
 
-        auto bindingDescription = Vertex::getBindingDescription();
-        auto attributeDescription = Vertex::getAttributeDescriptions();
+        // Binding 0 is the Model's vertices, binding 1 the per instance transforms meshes are drawn with
+        std::array<VkVertexInputBindingDescription, 2> bindingDescriptions = { Vertex::getBindingDescription(), MeshInstance::getBindingDescription() };
+        std::vector<VkVertexInputAttributeDescription> attributeDescription;
+        for (VkVertexInputAttributeDescription attribute : Vertex::getAttributeDescriptions())
+        {
+            attributeDescription.push_back(attribute);
+        }
+        for (VkVertexInputAttributeDescription attribute : MeshInstance::getAttributeDescriptions())
+        {
+            attributeDescription.push_back(attribute);
+        }
 
         VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
         vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputInfo.vertexBindingDescriptionCount = 1;
-        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+        vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
+        vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
         vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescription.size());
         vertexInputInfo.pVertexAttributeDescriptions = attributeDescription.data();
 
@@ -261,10 +271,12 @@ namespace FlatEngine
         // For Depth testing
         pipelineInfo.pDepthStencilState = &depthStencil;       
 
-        if (vkCreateGraphicsPipelines(logicalDevice.GetDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_graphicsPipeline) != VK_SUCCESS)
+        double creationStart = GetTimeInMicroseconds();
+        if (vkCreateGraphicsPipelines(logicalDevice.GetDevice(), VM_pipelineCache.GetCache(), 1, &pipelineInfo, nullptr, &m_graphicsPipeline) != VK_SUCCESS)
         {
             throw std::runtime_error("failed to create graphics pipeline.");
         }
+        VM_pipelineCache.AddCreationTime((float)(GetTimeInMicroseconds() - creationStart));
 
 
         // Cleanup when pipeline is finished being created
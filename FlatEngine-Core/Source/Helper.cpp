@@ -164,9 +164,15 @@ namespace FlatEngine
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &commandBuffer;
-        // We just want to execute the transfer on the buffers immediately.
-        vkQueueSubmit(logicalDevice.GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(logicalDevice.GetGraphicsQueue());
+        // We just want to execute the transfer on the buffers immediately. Waiting on a fence rather than the queue going idle
+        // means frames or uploads already in flight on the graphics queue are not waited on as well
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        VkFence fence = VK_NULL_HANDLE;
+        vkCreateFence(logicalDevice.GetDevice(), &fenceInfo, nullptr, &fence);
+        vkQueueSubmit(logicalDevice.GetGraphicsQueue(), 1, &submitInfo, fence);
+        vkWaitForFences(logicalDevice.GetDevice(), 1, &fence, VK_TRUE, UINT64_MAX);
+        vkDestroyFence(logicalDevice.GetDevice(), fence, nullptr);
         // Don't forget to clean up the command buffer used for the transfer operation.
         vkFreeCommandBuffers(logicalDevice.GetDevice(), commandPool, 1, &commandBuffer);
     }
@@ -156,7 +156,7 @@ namespace FlatEngine
         init_info.Device = m_deviceHandle->GetDevice();
         init_info.QueueFamily = ImGui_ImplVulkanH_SelectQueueFamilyIndex(m_physicalDeviceHandle->GetDevice());
         init_info.Queue = m_deviceHandle->GetGraphicsQueue();
-        init_info.PipelineCache = VK_NULL_HANDLE;
+        init_info.PipelineCache = VM_pipelineCache.GetCache();
         init_info.DescriptorPool = m_material->CreateDescriptorPool();
         init_info.RenderPass = m_renderPass.GetRenderPass();
         init_info.Subpass = 0;
@@ -0,0 +1,100 @@
+#include "InstanceBuffer.h"
+#include "VulkanManager.h"
+#include "WinSys.h"
+
+#include <cstring>
+#include <algorithm>
+
+
+namespace FlatEngine
+{
+    InstanceBuffer::InstanceBuffer()
+    {
+        m_physicalDeviceHandle = nullptr;
+        m_deviceHandle = nullptr;
+        m_capacity = 0;
+        m_buffers = std::vector<VkBuffer>();
+        m_buffersMemory = std::vector<MemoryAllocation>();
+    }
+
+    InstanceBuffer::~InstanceBuffer()
+    {
+    }
+
+    void InstanceBuffer::Cleanup()
+    {
+        DestroyBuffers();
+    }
+
+    void InstanceBuffer::Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
+    {
+        m_physicalDeviceHandle = &physicalDevice;
+        m_deviceHandle = &logicalDevice;
+        CreateBuffers(INSTANCE_BUFFER_STARTING_INSTANCES);
+    }
+
+    void InstanceBuffer::CreateBuffers(uint32_t capacity)
+    {
+        VkDeviceSize bufferSize = sizeof(MeshInstance) * capacity;
+        m_capacity = capacity;
+        m_buffers.resize(VM_MAX_FRAMES_IN_FLIGHT);
+        m_buffersMemory.resize(VM_MAX_FRAMES_IN_FLIGHT);
+
+        for (size_t i = 0; i < VM_MAX_FRAMES_IN_FLIGHT; i++)
+        {
+            WinSys::CreateBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_buffers[i], m_buffersMemory[i], *m_physicalDeviceHandle, *m_deviceHandle);
+        }
+    }
+
+    void InstanceBuffer::DestroyBuffers()
+    {
+        if (m_deviceHandle == nullptr)
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < m_buffers.size(); i++)
+        {
+            vkDestroyBuffer(m_deviceHandle->GetDevice(), m_buffers[i], nullptr);
+            VM_memoryAllocator.Free(m_buffersMemory[i]);
+        }
+        m_buffers.clear();
+        m_buffersMemory.clear();
+        m_capacity = 0;
+    }
+
+    // Grows by doubling like UniformRing::Reserve(), nothing refers to the buffers besides the commands recorded each frame
+    void InstanceBuffer::Reserve(uint32_t instanceCount)
+    {
+        if (instanceCount <= m_capacity)
+        {
+            return;
+        }
+
+        uint32_t capacity = std::max(m_capacity, INSTANCE_BUFFER_STARTING_INSTANCES);
+        while (capacity < instanceCount)
+        {
+            capacity *= 2;
+        }
+
+        // The other frame in flight may still be reading its buffer
+        vkDeviceWaitIdle(m_deviceHandle->GetDevice());
+        DestroyBuffers();
+        CreateBuffers(capacity);
+    }
+
+    void InstanceBuffer::Write(uint32_t frameIndex, uint32_t index, MeshInstance& instance)
+    {
+        memcpy((MeshInstance*)m_buffersMemory[frameIndex].mapped + index, &instance, sizeof(instance));
+    }
+
+    VkBuffer InstanceBuffer::GetBuffer(uint32_t frameIndex)
+    {
+        return m_buffers[frameIndex];
+    }
+
+    uint32_t InstanceBuffer::GetCapacity()
+    {
+        return m_capacity;
+    }
+}
\ No newline at end of file
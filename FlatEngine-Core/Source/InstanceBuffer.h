@@ -0,0 +1,43 @@
+#pragma once
+#include "Structs.h"
+#include "PhysicalDevice.h"
+#include "LogicalDevice.h"
+#include "MemoryAllocator.h"
+
+#define GLFW_INCLUDE_VULKAN
+#include <glfw3.h>
+
+#include <vector>
+
+
+namespace FlatEngine
+{
+	const uint32_t INSTANCE_BUFFER_STARTING_INSTANCES = 1024;
+
+	// One persistently mapped vertex buffer per frame in flight holding a MeshInstance for every drawn mesh, bound at binding 1
+	// with VK_VERTEX_INPUT_RATE_INSTANCE. Meshes sharing a Model and Material sit next to each other so one instanced draw
+	// covers them with firstInstance pointing at their first entry.
+	class InstanceBuffer
+	{
+	public:
+		InstanceBuffer();
+		~InstanceBuffer();
+		void Cleanup();
+
+		void Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
+		void Reserve(uint32_t instanceCount);
+		void Write(uint32_t frameIndex, uint32_t index, MeshInstance& instance);
+		VkBuffer GetBuffer(uint32_t frameIndex);
+		uint32_t GetCapacity();
+
+	private:
+		void CreateBuffers(uint32_t capacity);
+		void DestroyBuffers();
+
+		PhysicalDevice* m_physicalDeviceHandle;
+		LogicalDevice* m_deviceHandle;
+		uint32_t m_capacity;
+		std::vector<VkBuffer> m_buffers;
+		std::vector<MemoryAllocation> m_buffersMemory;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "JsonStream.h"
+
+
+namespace FlatEngine
+{
+	JsonArrayStream::JsonArrayStream(std::string arrayKey, std::function<bool(json& element)> onElement)
+	{
+		m_arrayKey = arrayKey;
+		m_onElement = onElement;
+		m_element = json();
+		m_building = std::vector<json*>();
+		m_key = "";
+		m_depth = 0;
+		m_arrayDepth = 0;
+		m_b_keyMatched = false;
+		m_b_foundArray = false;
+		m_elementCount = 0;
+		m_error = "";
+	}
+
+	JsonArrayStream::~JsonArrayStream()
+	{
+	}
+
+	// Parses straight from the buffer, false if the json is malformed or onElement asked to stop
+	bool JsonArrayStream::Parse(const unsigned char* data, uint64_t size, std::string arrayKey, std::function<bool(json& element)> onElement, std::string& error)
+	{
+		JsonArrayStream stream = JsonArrayStream(arrayKey, onElement);
+		bool b_parsed = json::sax_parse(data, data + size, &stream);
+		error = stream.m_error;
+		return b_parsed;
+	}
+
+	bool JsonArrayStream::FoundArray()
+	{
+		return m_b_foundArray;
+	}
+
+	long JsonArrayStream::GetElementCount()
+	{
+		return m_elementCount;
+	}
+
+	bool JsonArrayStream::AddValue(json&& value)
+	{
+		// The matched key's value was not the array
+		m_b_keyMatched = false;
+
+		if (m_building.size() > 0)
+		{
+			json* container = m_building.back();
+			if (container->is_object())
+			{
+				(*container)[m_key] = std::move(value);
+			}
+			else
+			{
+				container->push_back(std::move(value));
+			}
+			return true;
+		}
+
+		// A scalar element of the streamed array
+		if (m_arrayDepth != 0 && m_depth == m_arrayDepth - 1)
+		{
+			m_element = std::move(value);
+			m_elementCount++;
+			return m_onElement(m_element);
+		}
+		return true;
+	}
+
+	bool JsonArrayStream::StartContainer(json&& container)
+	{
+		m_b_keyMatched = false;
+		m_depth++;
+
+		if (m_building.size() > 0)
+		{
+			json* parent = m_building.back();
+			if (parent->is_object())
+			{
+				(*parent)[m_key] = std::move(container);
+				m_building.push_back(&(*parent)[m_key]);
+			}
+			else
+			{
+				parent->push_back(std::move(container));
+				m_building.push_back(&parent->back());
+			}
+		}
+		else if (m_arrayDepth != 0 && m_depth == m_arrayDepth)
+		{
+			m_element = std::move(container);
+			m_building.push_back(&m_element);
+		}
+		return true;
+	}
+
+	bool JsonArrayStream::EndContainer()
+	{
+		m_depth--;
+
+		if (m_building.size() > 0)
+		{
+			m_building.pop_back();
+			if (m_building.size() == 0)
+			{
+				m_elementCount++;
+				bool b_continue = m_onElement(m_element);
+				m_element = json();
+				return b_continue;
+			}
+		}
+		return true;
+	}
+
+	bool JsonArrayStream::null()
+	{
+		return AddValue(nullptr);
+	}
+
+	bool JsonArrayStream::boolean(bool value)
+	{
+		return AddValue(value);
+	}
+
+	bool JsonArrayStream::number_integer(number_integer_t value)
+	{
+		return AddValue(value);
+	}
+
+	bool JsonArrayStream::number_unsigned(number_unsigned_t value)
+	{
+		return AddValue(value);
+	}
+
+	bool JsonArrayStream::number_float(number_float_t value, const string_t& text)
+	{
+		return AddValue(value);
+	}
+
+	bool JsonArrayStream::string(string_t& value)
+	{
+		return AddValue(std::move(value));
+	}
+
+	bool JsonArrayStream::binary(binary_t& value)
+	{
+		return AddValue(json::binary(std::move(value)));
+	}
+
+	bool JsonArrayStream::start_object(std::size_t elements)
+	{
+		return StartContainer(json::object());
+	}
+
+	bool JsonArrayStream::key(string_t& value)
+	{
+		// Keys of the root object, the streamed array is the value of the matching one
+		m_b_keyMatched = m_depth == 1 && m_building.size() == 0 && value == m_arrayKey;
+		m_key = value;
+		return true;
+	}
+
+	bool JsonArrayStream::end_object()
+	{
+		return EndContainer();
+	}
+
+	bool JsonArrayStream::start_array(std::size_t elements)
+	{
+		if (m_b_keyMatched && m_arrayDepth == 0 && m_building.size() == 0)
+		{
+			m_b_keyMatched = false;
+			m_b_foundArray = true;
+			m_depth++;
+			m_arrayDepth = m_depth + 1;
+			return true;
+		}
+		return StartContainer(json::array());
+	}
+
+	bool JsonArrayStream::end_array()
+	{
+		if (m_arrayDepth != 0 && m_building.size() == 0 && m_depth == m_arrayDepth - 1)
+		{
+			m_depth--;
+			m_arrayDepth = 0;
+			return true;
+		}
+		return EndContainer();
+	}
+
+	bool JsonArrayStream::parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& exception)
+	{
+		m_error = exception.what();
+		return false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+#include "json.hpp"
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+using json = nlohmann::json;
+
+
+namespace FlatEngine
+{
+	// SAX handler that hands each element of one top level array to a callback as soon as the element is parsed, then drops it.
+	// Only one element is ever built at a time, so a scene's memory peak is its largest GameObject instead of the whole document.
+	// Everything outside the array is skipped.
+	class JsonArrayStream : public json::json_sax_t
+	{
+	public:
+		JsonArrayStream(std::string arrayKey, std::function<bool(json& element)> onElement);
+		~JsonArrayStream();
+
+		static bool Parse(const unsigned char* data, uint64_t size, std::string arrayKey, std::function<bool(json& element)> onElement, std::string& error);
+		bool FoundArray();
+		long GetElementCount();
+
+		bool null() override;
+		bool boolean(bool value) override;
+		bool number_integer(number_integer_t value) override;
+		bool number_unsigned(number_unsigned_t value) override;
+		bool number_float(number_float_t value, const string_t& text) override;
+		bool string(string_t& value) override;
+		bool binary(binary_t& value) override;
+		bool start_object(std::size_t elements) override;
+		bool key(string_t& value) override;
+		bool end_object() override;
+		bool start_array(std::size_t elements) override;
+		bool end_array() override;
+		bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& exception) override;
+
+	private:
+		bool AddValue(json&& value);
+		bool StartContainer(json&& container);
+		bool EndContainer();
+
+		std::string m_arrayKey;
+		std::function<bool(json& element)> m_onElement;
+		json m_element;
+		std::vector<json*> m_building; // Open containers of m_element, innermost last
+		std::string m_key;
+		int m_depth;
+		int m_arrayDepth; // Depth of the streamed array's elements, 0 while outside it
+		bool m_b_keyMatched;
+		bool m_b_foundArray;
+		long m_elementCount;
+		std::string m_error;
+	};
+}
\ No newline at end of file
@@ -14,6 +14,7 @@ namespace FlatEngine
         m_device = VK_NULL_HANDLE;
         m_graphicsQueue = VK_NULL_HANDLE;
         m_presentQueue = VK_NULL_HANDLE;
+        m_uploadQueue = VK_NULL_HANDLE;
         m_graphicsPipelineCache = VK_NULL_HANDLE;
         m_graphicsQueueFamilyIndex = 0;
     }
@@ -37,6 +38,16 @@ namespace FlatEngine
         return m_presentQueue;
     }
 
+    VkQueue& LogicalDevice::GetUploadQueue()
+    {
+        return m_uploadQueue;
+    }
+
+    bool LogicalDevice::HasDedicatedUploadQueue()
+    {
+        return m_uploadQueue != m_graphicsQueue;
+    }
+
     void LogicalDevice::SetGraphicsIndex(uint32_t index)
     {
         m_graphicsQueueFamilyIndex = index;
@@ -70,15 +81,23 @@ namespace FlatEngine
         std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value() };
 
 
-        float f_queuePriority = 1.0f; // Vulkan lets you assign priorities to queues to influence the scheduling of command buffer execution using floating point numbers between 0.0 and 1.0
+        // Uploads get a second queue from the graphics family if it has one. Mipmaps are generated with vkCmdBlitImage so a transfer only family
+        // would not do, and staying in the graphics family means resources need no queue family ownership transfer before they are drawn
+        uint32_t ui_queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice.GetDevice(), &ui_queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(ui_queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice.GetDevice(), &ui_queueFamilyCount, queueFamilies.data());
+        bool b_uploadQueue = queueFamilies[indices.graphicsFamily.value()].queueCount > 1;
+
+        float f_queuePriorities[] = { 1.0f, 0.5f }; // Vulkan lets you assign priorities to queues to influence the scheduling of command buffer execution using floating point numbers between 0.0 and 1.0
         for (uint32_t ui_queueFamily : uniqueQueueFamilies)
         {
             // Create info struct with info to pass to the logical device later
             VkDeviceQueueCreateInfo queueCreateInfo{};
             queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
             queueCreateInfo.queueFamilyIndex = ui_queueFamily;
-            queueCreateInfo.queueCount = 1; // Number of queues, will only ever really need 1 because of multi threaded command buffers
-            queueCreateInfo.pQueuePriorities = &f_queuePriority;
+            queueCreateInfo.queueCount = (ui_queueFamily == indices.graphicsFamily.value() && b_uploadQueue) ? 2 : 1;
+            queueCreateInfo.pQueuePriorities = f_queuePriorities;
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
@@ -123,6 +142,11 @@ namespace FlatEngine
             // ^^ NOTE FROM WIKI: The parameters are the logical device, queue family, queue index and a pointer to the variable to store the queue handle in. Because we're only creating a single queue from this family, we'll simply use index 0.
             vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0, &m_presentQueue); // Present queue handle
             // ^^ NOTE FROM WIKI: In case the queue families are the same, the two handles will most likely have the same value now. 
+            m_uploadQueue = m_graphicsQueue;
+            if (b_uploadQueue)
+            {
+                vkGetDeviceQueue(m_device, indices.graphicsFamily.value(), 1, &m_uploadQueue);
+            }
         }
     }
 
@@ -16,6 +16,8 @@ namespace FlatEngine
 		VkDevice& GetDevice();
 		VkQueue& GetGraphicsQueue();
 		VkQueue& GetPresentQueue();
+		VkQueue& GetUploadQueue();
+		bool HasDedicatedUploadQueue();
 		void SetGraphicsIndex(uint32_t index);
 		uint32_t GetGraphicsIndex();
 		void SetGraphicsPipelineCache(VkPipelineCache& cache);
@@ -27,6 +29,7 @@ namespace FlatEngine
 		VkDevice m_device;
 		VkQueue m_graphicsQueue;
 		VkQueue m_presentQueue;
+		VkQueue m_uploadQueue; // Second queue of the graphics family when it has one, otherwise the graphics queue
 		uint32_t m_graphicsQueueFamilyIndex;
 		VkPipelineCache m_graphicsPipelineCache;
 	};
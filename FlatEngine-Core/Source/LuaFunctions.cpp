@@ -17,6 +17,8 @@
 #include "Script.h"
 #include "MappingContext.h"
 #include "Project.h"
+#include "SpatialIndex.h"
+#include "VirtualFileSystem.h"
 
 #include <fstream>
 #include <random>
@@ -394,6 +396,46 @@ namespace FlatEngine
 		{
 			RemapInputAction(contextName, inputAction, Uint32(timeoutTime));
 		};
+		F_Lua["Raycast"] = sol::overload(
+			[](Vector2 origin, Vector2 direction, float maxDistance)
+			{
+				return Raycast(origin, direction, maxDistance);
+			},
+			[](Vector2 origin, Vector2 direction, float maxDistance, int layerMask)
+			{
+				return Raycast(origin, direction, maxDistance, layerMask);
+			}
+		);
+		F_Lua["OverlapBox"] = sol::overload(
+			[](Vector2 center, Vector2 halfExtents)
+			{
+				return OverlapBox(center, halfExtents);
+			},
+			[](Vector2 center, Vector2 halfExtents, int layerMask)
+			{
+				return OverlapBox(center, halfExtents, layerMask);
+			}
+		);
+		F_Lua["OverlapCircle"] = sol::overload(
+			[](Vector2 center, float radius)
+			{
+				return OverlapCircle(center, radius);
+			},
+			[](Vector2 center, float radius, int layerMask)
+			{
+				return OverlapCircle(center, radius, layerMask);
+			}
+		);
+		F_Lua["QueryNearest"] = sol::overload(
+			[](Vector2 point, int count)
+			{
+				return QueryNearest(point, count);
+			},
+			[](Vector2 point, int count, int layerMask)
+			{
+				return QueryNearest(point, count, layerMask);
+			}
+		);
 	}
 
 	// Map C++ types to Lua "Types" -- https://sol2.readthedocs.io/en/latest/api/usertype.html
@@ -623,7 +665,9 @@ namespace FlatEngine
 			"GetParentID", &Collider::GetParentID,
 			"SetActive", &Collider::SetActive,
 			"IsActive", &Collider::IsActive,
-			"GetID", &Collider::GetID
+			"GetID", &Collider::GetID,
+			"SetFiresStayEvents", &Collider::SetFiresStayEvents,
+			"FiresStayEvents", &Collider::FiresStayEvents
 		);
 
 		F_Lua.new_usertype<BoxCollider>("BoxCollider",
@@ -631,7 +675,16 @@ namespace FlatEngine
 			"GetParentID", &BoxCollider::GetParentID,
 			"SetActive", &BoxCollider::SetActive,
 			"IsActive", &BoxCollider::IsActive,
-			"GetID", &BoxCollider::GetID
+			"GetID", &BoxCollider::GetID,
+			"SetFiresStayEvents", &BoxCollider::SetFiresStayEvents,
+			"FiresStayEvents", &BoxCollider::FiresStayEvents
+		);
+
+		F_Lua.new_usertype<RaycastHit>("RaycastHit",
+			"object", &RaycastHit::object,
+			"collider", &RaycastHit::collider,
+			"point", &RaycastHit::point,
+			"distance", &RaycastHit::distance
 		);
 
 		F_Lua.new_usertype<CharacterController>("CharacterController",
@@ -862,6 +915,17 @@ namespace FlatEngine
 			"function OnCircleCollisionLeave(collidedWith)\n" +
 			"end\n\n" +
 
+			"function OnCollisionEnter(collidedWith)\n" +
+			"end\n\n" +
+
+			"-- only called for colliders with Fires Stay Events enabled\n" +
+			"function OnCollisionStay(collidedWith)\n" +
+			"end\n\n" +
+
+			"-- collidedWith is nil if the other collider was destroyed\n" +
+			"function OnCollisionExit(collidedWith)\n" +
+			"end\n\n" +
+
 			"function OnButtonMouseOver()\n" +
 			"end\n\n" +
 
@@ -885,7 +949,7 @@ namespace FlatEngine
 	{
 		try
 		{
-			F_Lua.safe_script_file(filePath);
+			RunLuaScriptFile(filePath);
 			return true;
 		}
 		catch (const sol::error& err)
@@ -896,6 +960,14 @@ namespace FlatEngine
 		}
 	}
 
+	// Reads the file through F_VirtualFileSystem so scripts come out of the asset pack in a runtime build, errors throw like safe_script_file()
+	sol::protected_function_result RunLuaScriptFile(std::string filePath)
+	{
+		std::string scriptText = "";
+		F_VirtualFileSystem.ReadText(filePath, scriptText);
+		return F_Lua.safe_script(scriptText, "@" + filePath);
+	}
+
 	void LoadLuaGameObject(GameObject* object, std::string scriptName)
 	{
 		if (object != nullptr)
@@ -939,7 +1011,9 @@ namespace FlatEngine
 			return false;
 		}
 
-		auto scriptFile = F_Lua.load_file(filePath);
+		std::string scriptText = "";
+		F_VirtualFileSystem.ReadText(filePath, scriptText);
+		auto scriptFile = F_Lua.load(scriptText, "@" + filePath);
 		if (scriptFile.valid())
 		{
 			sol::protected_function loadedScriptFile = scriptFile.get<sol::protected_function>();
@@ -0,0 +1,142 @@
+#include "MappedFile.h"
+
+#include <fstream>
+#include <filesystem>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+
+namespace FlatEngine
+{
+	MappedFile::MappedFile()
+	{
+		m_view = nullptr;
+		m_size = 0;
+		m_fileHandle = nullptr;
+		m_mappingHandle = nullptr;
+		m_fileData = std::vector<unsigned char>();
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open(std::string path)
+	{
+		Close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		m_fileHandle = file;
+
+		LARGE_INTEGER fileSize;
+		HANDLE mapping = nullptr;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+		{
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		}
+		if (mapping == nullptr)
+		{
+			Close();
+			return false;
+		}
+		m_mappingHandle = mapping;
+
+		m_view = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (m_view == nullptr)
+		{
+			Close();
+			return false;
+		}
+		m_size = (uint64_t)fileSize.QuadPart;
+		return true;
+#else
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		m_fileData.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read((char*)m_fileData.data(), m_fileData.size());
+		if (!file.good() || m_fileData.size() == 0)
+		{
+			Close();
+			return false;
+		}
+		m_view = m_fileData.data();
+		m_size = m_fileData.size();
+		return true;
+#endif
+	}
+
+	void MappedFile::Close()
+	{
+#ifdef _WIN32
+		if (m_view != nullptr)
+		{
+			UnmapViewOfFile(m_view);
+		}
+		if (m_mappingHandle != nullptr)
+		{
+			CloseHandle((HANDLE)m_mappingHandle);
+		}
+		if (m_fileHandle != nullptr)
+		{
+			CloseHandle((HANDLE)m_fileHandle);
+		}
+#endif
+		m_fileHandle = nullptr;
+		m_mappingHandle = nullptr;
+		m_view = nullptr;
+		m_size = 0;
+		m_fileData.clear();
+		m_fileData.shrink_to_fit();
+	}
+
+	bool MappedFile::IsOpen()
+	{
+		return m_view != nullptr;
+	}
+
+	const unsigned char* MappedFile::GetData()
+	{
+		return m_view;
+	}
+
+	uint64_t MappedFile::GetSize()
+	{
+		return m_size;
+	}
+
+	// True when path exists and sourcePath has not been written since, or is gone as in a shipped build that only carries the cook
+	bool MappedFile::IsUpToDate(std::string path, std::string sourcePath)
+	{
+		std::error_code error;
+		if (!std::filesystem::exists(path, error))
+		{
+			return false;
+		}
+		if (!std::filesystem::exists(sourcePath, error))
+		{
+			return true;
+		}
+
+		std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+		if (error)
+		{
+			return false;
+		}
+		std::filesystem::file_time_type sourceTime = std::filesystem::last_write_time(sourcePath, error);
+		return !error && time >= sourceTime;
+	}
+}
\ No newline at end of file
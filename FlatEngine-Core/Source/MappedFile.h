@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+namespace FlatEngine
+{
+	// Read-only view of a whole file. Memory mapped on Windows, read into memory elsewhere. The view stays valid until Close().
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(std::string path);
+		void Close();
+		bool IsOpen();
+		const unsigned char* GetData();
+		uint64_t GetSize();
+		static bool IsUpToDate(std::string path, std::string sourcePath);
+
+	private:
+		const unsigned char* m_view;
+		uint64_t m_size;
+		void* m_fileHandle;
+		void* m_mappingHandle;
+		std::vector<unsigned char> m_fileData; // Holds the file where memory mapping is not available
+	};
+}
\ No newline at end of file
@@ -0,0 +1,600 @@
+#include "MemoryAllocator.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+
+
+namespace FlatEngine
+{
+    MemoryRangeAllocator::MemoryRangeAllocator()
+    {
+        m_size = 0;
+        m_used = 0;
+        m_freeByOffset = std::map<uint64_t, uint64_t>();
+        m_freeBySize = std::multimap<uint64_t, uint64_t>();
+        m_allocations = std::unordered_map<uint64_t, S_Range>();
+    }
+
+    MemoryRangeAllocator::~MemoryRangeAllocator()
+    {
+    }
+
+    void MemoryRangeAllocator::Init(uint64_t size)
+    {
+        m_size = size;
+        m_used = 0;
+        m_freeByOffset.clear();
+        m_freeBySize.clear();
+        m_allocations.clear();
+        AddFreeRange(0, size);
+    }
+
+    void MemoryRangeAllocator::AddFreeRange(uint64_t start, uint64_t size)
+    {
+        m_freeByOffset.emplace(start, size);
+        m_freeBySize.emplace(size, start);
+    }
+
+    void MemoryRangeAllocator::RemoveFreeRange(std::map<uint64_t, uint64_t>::iterator range)
+    {
+        auto sized = m_freeBySize.equal_range(range->second);
+        for (auto entry = sized.first; entry != sized.second; entry++)
+        {
+            if (entry->second == range->first)
+            {
+                m_freeBySize.erase(entry);
+                break;
+            }
+        }
+        m_freeByOffset.erase(range);
+    }
+
+    // Takes the smallest free range the aligned request fits in, what is left of the range past the allocation stays free
+    bool MemoryRangeAllocator::Allocate(uint64_t size, uint64_t alignment, uint64_t& offset)
+    {
+        if (size == 0)
+        {
+            return false;
+        }
+        if (alignment == 0)
+        {
+            alignment = 1;
+        }
+
+        for (auto candidate = m_freeBySize.lower_bound(size); candidate != m_freeBySize.end(); candidate++)
+        {
+            uint64_t rangeStart = candidate->second;
+            uint64_t rangeSize = candidate->first;
+            uint64_t alignedStart = (rangeStart + alignment - 1) / alignment * alignment;
+            uint64_t padding = alignedStart - rangeStart;
+
+            if (padding + size > rangeSize)
+            {
+                continue;
+            }
+
+            m_freeBySize.erase(candidate);
+            m_freeByOffset.erase(rangeStart);
+
+            uint64_t taken = padding + size;
+            if (rangeSize > taken)
+            {
+                AddFreeRange(rangeStart + taken, rangeSize - taken);
+            }
+
+            m_allocations.emplace(alignedStart, S_Range{ rangeStart, taken });
+            m_used += taken;
+            offset = alignedStart;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool MemoryRangeAllocator::Free(uint64_t offset)
+    {
+        auto allocation = m_allocations.find(offset);
+        if (allocation == m_allocations.end())
+        {
+            return false;
+        }
+
+        uint64_t start = allocation->second.start;
+        uint64_t size = allocation->second.size;
+        m_used -= size;
+        m_allocations.erase(allocation);
+
+        // Merge with the free ranges on either side
+        auto next = m_freeByOffset.lower_bound(start);
+        if (next != m_freeByOffset.begin())
+        {
+            auto previous = std::prev(next);
+            if (previous->first + previous->second == start)
+            {
+                start = previous->first;
+                size += previous->second;
+                RemoveFreeRange(previous);
+            }
+        }
+        next = m_freeByOffset.lower_bound(start + size);
+        if (next != m_freeByOffset.end() && next->first == start + size)
+        {
+            size += next->second;
+            RemoveFreeRange(next);
+        }
+
+        AddFreeRange(start, size);
+        return true;
+    }
+
+    uint64_t MemoryRangeAllocator::GetSize()
+    {
+        return m_size;
+    }
+
+    uint64_t MemoryRangeAllocator::GetUsed()
+    {
+        return m_used;
+    }
+
+    uint64_t MemoryRangeAllocator::GetLargestFree()
+    {
+        if (m_freeBySize.size() == 0)
+        {
+            return 0;
+        }
+        return m_freeBySize.rbegin()->first;
+    }
+
+    int MemoryRangeAllocator::GetFreeRangeCount()
+    {
+        return (int)m_freeByOffset.size();
+    }
+
+    int MemoryRangeAllocator::GetAllocationCount()
+    {
+        return (int)m_allocations.size();
+    }
+
+    bool MemoryRangeAllocator::IsEmpty()
+    {
+        return m_allocations.size() == 0;
+    }
+
+
+    VulkanMemorySource::VulkanMemorySource()
+    {
+        m_physicalDeviceHandle = nullptr;
+        m_deviceHandle = nullptr;
+        m_memoryProperties = VkPhysicalDeviceMemoryProperties{};
+    }
+
+    VulkanMemorySource::~VulkanMemorySource()
+    {
+    }
+
+    void VulkanMemorySource::Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
+    {
+        m_physicalDeviceHandle = &physicalDevice;
+        m_deviceHandle = &logicalDevice;
+        vkGetPhysicalDeviceMemoryProperties(m_physicalDeviceHandle->GetDevice(), &m_memoryProperties);
+    }
+
+    uint32_t VulkanMemorySource::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
+    {
+        return m_physicalDeviceHandle->FindMemoryType(typeFilter, properties);
+    }
+
+    bool VulkanMemorySource::AllocateMemory(uint32_t memoryType, VkDeviceSize size, VkDeviceMemory& memory, void*& mapped)
+    {
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = memoryType;
+
+        mapped = nullptr;
+        if (vkAllocateMemory(m_deviceHandle->GetDevice(), &allocInfo, nullptr, &memory) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        if (m_memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            vkMapMemory(m_deviceHandle->GetDevice(), memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+        }
+        return true;
+    }
+
+    void VulkanMemorySource::FreeMemory(VkDeviceMemory memory, void* mapped)
+    {
+        if (mapped != nullptr)
+        {
+            vkUnmapMemory(m_deviceHandle->GetDevice(), memory);
+        }
+        vkFreeMemory(m_deviceHandle->GetDevice(), memory, nullptr);
+    }
+
+
+    MemoryAllocator::MemoryAllocator()
+    {
+        m_vulkanMemorySource = VulkanMemorySource();
+        m_memorySource = nullptr;
+        m_blocks = std::vector<S_MemoryBlock>();
+        m_freeBlockSlots = std::vector<int>();
+    }
+
+    MemoryAllocator::~MemoryAllocator()
+    {
+    }
+
+    void MemoryAllocator::Cleanup()
+    {
+        for (int i = 0; i < (int)m_blocks.size(); i++)
+        {
+            DestroyBlock(i);
+        }
+        m_blocks.clear();
+        m_freeBlockSlots.clear();
+    }
+
+    void MemoryAllocator::Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
+    {
+        m_vulkanMemorySource.Init(physicalDevice, logicalDevice);
+        m_memorySource = &m_vulkanMemorySource;
+    }
+
+    void MemoryAllocator::Init(DeviceMemorySource& memorySource)
+    {
+        m_memorySource = &memorySource;
+    }
+
+    int MemoryAllocator::CreateBlock(uint32_t memoryType, VkDeviceSize size, bool b_linear, bool b_dedicated)
+    {
+        S_MemoryBlock block{};
+        block.memoryType = memoryType;
+        block.b_linear = b_linear;
+        block.b_dedicated = b_dedicated;
+        block.mapped = nullptr;
+        block.ranges.Init(size);
+
+        if (!m_memorySource->AllocateMemory(memoryType, size, block.memory, block.mapped))
+        {
+            throw std::runtime_error("failed to allocate device memory block!");
+        }
+
+        if (m_freeBlockSlots.size() > 0)
+        {
+            int blockIndex = m_freeBlockSlots.back();
+            m_freeBlockSlots.pop_back();
+            m_blocks[blockIndex] = block;
+            return blockIndex;
+        }
+        m_blocks.push_back(block);
+        return (int)m_blocks.size() - 1;
+    }
+
+    void MemoryAllocator::DestroyBlock(int blockIndex)
+    {
+        S_MemoryBlock& block = m_blocks[blockIndex];
+        if (block.memory == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        m_memorySource->FreeMemory(block.memory, block.mapped);
+        block.memory = VK_NULL_HANDLE;
+        block.mapped = nullptr;
+        m_freeBlockSlots.push_back(blockIndex);
+    }
+
+    void MemoryAllocator::Allocate(VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool b_linear, MemoryAllocation& allocation)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        uint32_t memoryType = m_memorySource->FindMemoryType(requirements.memoryTypeBits, properties);
+        VkDeviceSize blockSize = (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) ? HOST_MEMORY_BLOCK_SIZE : DEVICE_MEMORY_BLOCK_SIZE;
+        int blockIndex = -1;
+        uint64_t offset = 0;
+
+        if (requirements.size > blockSize / 2)
+        {
+            blockIndex = CreateBlock(memoryType, requirements.size, b_linear, true);
+            m_blocks[blockIndex].ranges.Allocate(requirements.size, requirements.alignment, offset);
+        }
+        else
+        {
+            for (int i = 0; i < (int)m_blocks.size(); i++)
+            {
+                S_MemoryBlock& block = m_blocks[i];
+                if (block.memory != VK_NULL_HANDLE && !block.b_dedicated && block.memoryType == memoryType && block.b_linear == b_linear &&
+                    block.ranges.Allocate(requirements.size, requirements.alignment, offset))
+                {
+                    blockIndex = i;
+                    break;
+                }
+            }
+            if (blockIndex == -1)
+            {
+                blockIndex = CreateBlock(memoryType, blockSize, b_linear, false);
+                if (!m_blocks[blockIndex].ranges.Allocate(requirements.size, requirements.alignment, offset))
+                {
+                    throw std::runtime_error("failed to sub-allocate device memory!");
+                }
+            }
+        }
+
+        S_MemoryBlock& block = m_blocks[blockIndex];
+        allocation.memory = block.memory;
+        allocation.offset = offset;
+        allocation.size = requirements.size;
+        allocation.mapped = block.mapped != nullptr ? (unsigned char*)block.mapped + offset : nullptr;
+        allocation.blockIndex = blockIndex;
+    }
+
+    void MemoryAllocator::Free(MemoryAllocation& allocation)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (allocation.blockIndex < 0 || allocation.blockIndex >= (int)m_blocks.size())
+        {
+            return;
+        }
+
+        S_MemoryBlock& block = m_blocks[allocation.blockIndex];
+        block.ranges.Free(allocation.offset);
+
+        // Shared blocks are kept when they empty out so a scene reload does not reallocate them, see ReleaseEmptyBlocks()
+        if (block.b_dedicated)
+        {
+            DestroyBlock(allocation.blockIndex);
+        }
+
+        allocation = MemoryAllocation();
+    }
+
+    // Defragmentation hook. Live allocations are not moved (resources would have to be rebound), this gives empty blocks back to the driver
+    int MemoryAllocator::ReleaseEmptyBlocks()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        int released = 0;
+        for (int i = 0; i < (int)m_blocks.size(); i++)
+        {
+            if (m_blocks[i].memory != VK_NULL_HANDLE && m_blocks[i].ranges.IsEmpty())
+            {
+                DestroyBlock(i);
+                released++;
+            }
+        }
+        return released;
+    }
+
+    MemoryStats MemoryAllocator::GetStats()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        MemoryStats stats = MemoryStats();
+        VkDeviceSize totalFree = 0;
+
+        for (S_MemoryBlock& block : m_blocks)
+        {
+            if (block.memory == VK_NULL_HANDLE)
+            {
+                continue;
+            }
+            stats.blockCount++;
+            stats.allocationCount += block.ranges.GetAllocationCount();
+            stats.reserved += block.ranges.GetSize();
+            stats.used += block.ranges.GetUsed();
+            stats.largestFree = std::max(stats.largestFree, (VkDeviceSize)block.ranges.GetLargestFree());
+            totalFree += block.ranges.GetSize() - block.ranges.GetUsed();
+        }
+
+        if (totalFree > 0)
+        {
+            stats.fragmentation = 1.0f - (float)stats.largestFree / (float)totalFree;
+        }
+        return stats;
+    }
+
+    // Memory type 0 is device local and type 1 host visible. Handles are counters and host visible blocks are backed by
+    // real buffers so mapped pointers can be compared, every block given out is tracked so leaks and double frees show up.
+    class FakeMemorySource : public DeviceMemorySource
+    {
+    public:
+        FakeMemorySource()
+        {
+            m_nextHandle = 1;
+            m_allocateCount = 0;
+            m_b_doubleFree = false;
+            m_liveBlocks = std::map<uint64_t, std::vector<unsigned char>>();
+        }
+
+        uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) override
+        {
+            return (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) ? 1 : 0;
+        }
+
+        bool AllocateMemory(uint32_t memoryType, VkDeviceSize size, VkDeviceMemory& memory, void*& mapped) override
+        {
+            uint64_t handle = m_nextHandle++;
+            std::vector<unsigned char>& buffer = m_liveBlocks[handle];
+            if (memoryType == 1)
+            {
+                buffer.resize((size_t)size);
+            }
+            memory = (VkDeviceMemory)handle;
+            mapped = memoryType == 1 ? buffer.data() : nullptr;
+            m_allocateCount++;
+            return true;
+        }
+
+        void FreeMemory(VkDeviceMemory memory, void* mapped) override
+        {
+            if (m_liveBlocks.erase((uint64_t)memory) == 0)
+            {
+                m_b_doubleFree = true;
+            }
+        }
+
+        uint64_t m_nextHandle;
+        int m_allocateCount;
+        bool m_b_doubleFree;
+        std::map<uint64_t, std::vector<unsigned char>> m_liveBlocks;
+    };
+
+    static bool TestRangeAllocator(std::string& failure)
+    {
+        MemoryRangeAllocator ranges = MemoryRangeAllocator();
+        uint64_t a = 0;
+        uint64_t b = 0;
+        uint64_t c = 0;
+        uint64_t d = 0;
+
+        // Best fit, the smallest hole the request fits in is used rather than the first or the largest
+        ranges.Init(1000);
+        ranges.Allocate(100, 1, a);
+        ranges.Allocate(50, 1, b);
+        ranges.Allocate(200, 1, c);
+        ranges.Allocate(50, 1, d);
+        ranges.Free(a);
+        ranges.Free(c);
+        if (ranges.GetFreeRangeCount() != 3 || ranges.GetUsed() != 100 || ranges.GetLargestFree() != 600)
+        {
+            failure = "range allocator did not leave holes of 100, 200 and 600";
+            return false;
+        }
+        if (!ranges.Allocate(90, 1, a) || a != 0 || !ranges.Allocate(150, 1, c) || c != 150)
+        {
+            failure = "range allocator did not pick the best fitting hole";
+            return false;
+        }
+
+        // Freeing everything merges back into one range whatever the order
+        ranges.Free(c);
+        ranges.Free(a);
+        ranges.Free(d);
+        ranges.Free(b);
+        if (!ranges.IsEmpty() || ranges.GetFreeRangeCount() != 1 || ranges.GetLargestFree() != 1000 || ranges.GetUsed() != 0)
+        {
+            failure = "range allocator did not coalesce freed ranges";
+            return false;
+        }
+
+        // Alignment padding belongs to the allocation and is given back with it
+        ranges.Init(1024);
+        ranges.Allocate(10, 1, a);
+        if (!ranges.Allocate(16, 256, b) || b != 256 || ranges.GetFreeRangeCount() != 1 || ranges.GetUsed() != 272)
+        {
+            failure = "range allocator did not align or account for the padding";
+            return false;
+        }
+        ranges.Free(b);
+        ranges.Free(a);
+        if (ranges.GetFreeRangeCount() != 1 || ranges.GetLargestFree() != 1024)
+        {
+            failure = "range allocator did not give back the alignment padding";
+            return false;
+        }
+
+        if (ranges.Allocate(0, 1, a) || ranges.Allocate(1025, 1, a) || ranges.Free(5))
+        {
+            failure = "range allocator accepted an empty, oversized or unknown request";
+            return false;
+        }
+        return true;
+    }
+
+    static bool TestBlocks(std::string& failure)
+    {
+        FakeMemorySource memorySource = FakeMemorySource();
+        MemoryAllocator allocator;
+        allocator.Init(memorySource);
+
+        VkMemoryRequirements small{};
+        small.size = 4096;
+        small.alignment = 256;
+        small.memoryTypeBits = 0x3;
+        VkMemoryRequirements large = small;
+        large.size = DEVICE_MEMORY_BLOCK_SIZE / 2 + 1;
+
+        // Small allocations of one kind share a block, linear and optimal resources never do
+        MemoryAllocation first;
+        MemoryAllocation second;
+        MemoryAllocation linear;
+        allocator.Allocate(small, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false, first);
+        allocator.Allocate(small, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false, second);
+        allocator.Allocate(small, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true, linear);
+        if (memorySource.m_allocateCount != 2 || first.memory != second.memory || first.offset == second.offset || linear.memory == first.memory)
+        {
+            failure = "small allocations did not share blocks by kind";
+            return false;
+        }
+
+        // Past half a block an allocation gets its own block, freed as soon as the allocation is
+        MemoryAllocation dedicated;
+        allocator.Allocate(large, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false, dedicated);
+        if (memorySource.m_liveBlocks.size() != 3 || dedicated.offset != 0)
+        {
+            failure = "large allocation did not get a dedicated block";
+            return false;
+        }
+        allocator.Free(dedicated);
+        if (memorySource.m_liveBlocks.size() != 2 || dedicated.memory != VK_NULL_HANDLE)
+        {
+            failure = "dedicated block was not released with its allocation";
+            return false;
+        }
+
+        // Host visible blocks stay mapped, each allocation points at its own offset
+        MemoryAllocation staging;
+        allocator.Allocate(small, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, false, staging);
+        unsigned char* blockStart = memorySource.m_liveBlocks[(uint64_t)staging.memory].data();
+        if (staging.mapped == nullptr || staging.mapped != blockStart + staging.offset || first.mapped != nullptr)
+        {
+            failure = "host visible allocation was not mapped at its offset";
+            return false;
+        }
+
+        MemoryStats stats = allocator.GetStats();
+        if (stats.blockCount != 3 || stats.allocationCount != 4)
+        {
+            failure = "stats did not count 3 blocks and 4 allocations";
+            return false;
+        }
+
+        // Emptied shared blocks are kept until released, then their slot is reused
+        int sharedBlockIndex = first.blockIndex;
+        allocator.Free(first);
+        allocator.Free(second);
+        if (memorySource.m_liveBlocks.size() != 3 || allocator.ReleaseEmptyBlocks() != 1 || memorySource.m_liveBlocks.size() != 2)
+        {
+            failure = "emptied block was not kept until ReleaseEmptyBlocks()";
+            return false;
+        }
+        allocator.Allocate(small, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false, first);
+        if (first.blockIndex != sharedBlockIndex)
+        {
+            failure = "released block slot was not reused";
+            return false;
+        }
+
+        allocator.Free(first);
+        allocator.Free(linear);
+        allocator.Free(staging);
+        allocator.Cleanup();
+        if (memorySource.m_liveBlocks.size() != 0 || memorySource.m_b_doubleFree)
+        {
+            failure = "blocks were leaked or freed twice";
+            return false;
+        }
+        return true;
+    }
+
+    // Checks the range allocator and the block bookkeeping against a fake device, false with what went wrong in failure
+    bool MemoryAllocator::RunSelfTest(std::string& failure)
+    {
+        return TestRangeAllocator(failure) && TestBlocks(failure);
+    }
+}
\ No newline at end of file
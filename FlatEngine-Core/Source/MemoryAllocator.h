@@ -0,0 +1,142 @@
+#pragma once
+#include "PhysicalDevice.h"
+#include "LogicalDevice.h"
+
+#define GLFW_INCLUDE_VULKAN
+#include <glfw3.h>
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <string>
+#include <cstdint>
+
+
+namespace FlatEngine
+{
+	const uint64_t DEVICE_MEMORY_BLOCK_SIZE = 64ull * 1024 * 1024;
+	const uint64_t HOST_MEMORY_BLOCK_SIZE = 16ull * 1024 * 1024;
+
+	// Best-fit sub-allocation of one block's address range. Free ranges are kept both by offset (to merge neighbours when
+	// freed) and by size (to find the smallest range that fits). Touches no Vulkan objects so it can be exercised on its own.
+	class MemoryRangeAllocator
+	{
+	public:
+		MemoryRangeAllocator();
+		~MemoryRangeAllocator();
+
+		void Init(uint64_t size);
+		bool Allocate(uint64_t size, uint64_t alignment, uint64_t& offset);
+		bool Free(uint64_t offset);
+		uint64_t GetSize();
+		uint64_t GetUsed();
+		uint64_t GetLargestFree();
+		int GetFreeRangeCount();
+		int GetAllocationCount();
+		bool IsEmpty();
+
+	private:
+		struct S_Range
+		{
+			uint64_t start;
+			uint64_t size;
+		};
+
+		void AddFreeRange(uint64_t start, uint64_t size);
+		void RemoveFreeRange(std::map<uint64_t, uint64_t>::iterator range);
+
+		uint64_t m_size;
+		uint64_t m_used;
+		std::map<uint64_t, uint64_t> m_freeByOffset;
+		std::multimap<uint64_t, uint64_t> m_freeBySize;
+		std::unordered_map<uint64_t, S_Range> m_allocations; // aligned offset -> range taken, including alignment padding
+	};
+
+	struct MemoryAllocation
+	{
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+		void* mapped = nullptr; // Set for host visible memory, blocks stay mapped for their whole lifetime
+		int blockIndex = -1;
+	};
+
+	struct MemoryStats
+	{
+		int blockCount = 0;
+		int allocationCount = 0;
+		VkDeviceSize reserved = 0;
+		VkDeviceSize used = 0;
+		VkDeviceSize largestFree = 0;
+		float fragmentation = 0; // 1 - largest free range / total free, 0 when all free space is in one range
+	};
+
+	// Where MemoryAllocator gets its blocks from. VulkanMemorySource is the real one, RunSelfTest() swaps in a fake that hands
+	// out made up handles so the block bookkeeping can be checked without a device.
+	class DeviceMemorySource
+	{
+	public:
+		virtual ~DeviceMemorySource() {};
+		virtual uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) = 0;
+		// mapped is set when the memory type is host visible, the memory stays mapped until FreeMemory()
+		virtual bool AllocateMemory(uint32_t memoryType, VkDeviceSize size, VkDeviceMemory& memory, void*& mapped) = 0;
+		virtual void FreeMemory(VkDeviceMemory memory, void* mapped) = 0;
+	};
+
+	class VulkanMemorySource : public DeviceMemorySource
+	{
+	public:
+		VulkanMemorySource();
+		~VulkanMemorySource();
+
+		void Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
+		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) override;
+		bool AllocateMemory(uint32_t memoryType, VkDeviceSize size, VkDeviceMemory& memory, void*& mapped) override;
+		void FreeMemory(VkDeviceMemory memory, void* mapped) override;
+
+	private:
+		PhysicalDevice* m_physicalDeviceHandle;
+		LogicalDevice* m_deviceHandle;
+		VkPhysicalDeviceMemoryProperties m_memoryProperties;
+	};
+
+	// Hands out buffer and image memory from a few large VkDeviceMemory blocks per memory type instead of one
+	// vkAllocateMemory per resource. Buffers and images never share a block so bufferImageGranularity can be ignored.
+	// Allocations bigger than half a block get a dedicated block of their own.
+	class MemoryAllocator
+	{
+	public:
+		MemoryAllocator();
+		~MemoryAllocator();
+		void Cleanup();
+
+		void Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
+		void Init(DeviceMemorySource& memorySource);
+		void Allocate(VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool b_linear, MemoryAllocation& allocation);
+		void Free(MemoryAllocation& allocation);
+		int ReleaseEmptyBlocks();
+		MemoryStats GetStats();
+		static bool RunSelfTest(std::string& failure);
+
+	private:
+		struct S_MemoryBlock
+		{
+			VkDeviceMemory memory;
+			uint32_t memoryType;
+			bool b_linear;
+			bool b_dedicated;
+			void* mapped;
+			MemoryRangeAllocator ranges;
+		};
+
+		int CreateBlock(uint32_t memoryType, VkDeviceSize size, bool b_linear, bool b_dedicated);
+		void DestroyBlock(int blockIndex);
+
+		VulkanMemorySource m_vulkanMemorySource;
+		DeviceMemorySource* m_memorySource;
+		std::vector<S_MemoryBlock> m_blocks;
+		std::vector<int> m_freeBlockSlots;
+		std::mutex m_mutex;
+	};
+}
\ No newline at end of file
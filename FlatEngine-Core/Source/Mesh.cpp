@@ -1,11 +1,16 @@
 #include "Mesh.h"
+#include "FlatEngine.h"
+#include "GameObject.h"
+#include "Transform.h"
+
+#include <gtc/matrix_transform.hpp>
 
 
 namespace FlatEngine
 {
 	Mesh::Mesh()
 	{
-		m_model = Model();
+		m_model = std::make_shared<Model>();
 		m_material = nullptr;
 		m_descriptorSets = std::vector<VkDescriptorSet>();
 		m_allocationPoolIndex = -1;
@@ -23,20 +28,43 @@ namespace FlatEngine
 
 	void Mesh::SetModel(Model model)
 	{
-		m_model = model;
+		m_model = std::make_shared<Model>(model);
 	}
 
 	Model& Mesh::GetModel()
+	{
+		return *m_model;
+	}
+
+	std::shared_ptr<Model> Mesh::GetSharedModel()
 	{
 		return m_model;
 	}
 
+	// The owning GameObject's Transform, identity for meshes that are not attached to one
+	MeshInstance Mesh::GetInstance()
+	{
+		MeshInstance instance{};
+		instance.transform = glm::mat4(1.0f);
+
+		GameObject* parent = GetParentID() != -1 ? GetParent() : nullptr;
+		if (parent != nullptr && parent->GetTransform() != nullptr)
+		{
+			Transform* transform = parent->GetTransform();
+			Vector2 position = transform->GetTruePosition();
+			Vector2 scale = transform->GetScale();
+			instance.transform = glm::translate(instance.transform, glm::vec3(position.x, position.y, transform->GetPosition3D().z));
+			instance.transform = glm::rotate(instance.transform, glm::radians(transform->GetRotation()), glm::vec3(0.0f, 0.0f, 1.0f));
+			instance.transform = glm::scale(instance.transform, glm::vec3(scale.x, scale.y, 1.0f));
+		}
+
+		return instance;
+	}
+
+	// Vertex and index buffers are loaded once per model file and shared, see VulkanManager::LoadSharedModel()
 	void Mesh::CreateModelResources(VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
 	{
-		m_model.LoadModel();
-		m_model.CreateVertexBuffer(commandPool, physicalDevice, logicalDevice);
-		m_model.CreateIndexBuffer(commandPool, physicalDevice, logicalDevice);
-		m_model.CreateUniformBuffers(physicalDevice, logicalDevice);
+		m_model = F_VulkanManager->LoadSharedModel(m_model->GetModelPath());
 	}
 
 	void Mesh::SetMaterial(std::shared_ptr<Material> material)
@@ -51,13 +79,13 @@ namespace FlatEngine
 
 	void Mesh::CreateResources(VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
 	{
-		if (m_model.GetModelPath() != "")
+		if (m_model->GetModelPath() != "")
 		{
 			CreateModelResources(commandPool, physicalDevice, logicalDevice);
 		}
 		if (m_material != nullptr)
 		{
-			m_material->CreateDescriptorSets(m_descriptorSets, m_model, m_allocationPoolIndex);
+			m_material->CreateDescriptorSets(m_descriptorSets, *m_model, m_allocationPoolIndex);
 		}
 	}
 
@@ -23,6 +23,8 @@ namespace FlatEngine
 
 		void SetModel(Model model);
 		Model& GetModel();
+		std::shared_ptr<Model> GetSharedModel();
+		MeshInstance GetInstance();
 		void CreateModelResources(VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
 		void SetMaterial(std::shared_ptr<Material> material);
 		std::shared_ptr<Material> GetMaterial();
@@ -30,7 +32,7 @@ namespace FlatEngine
 		std::vector<VkDescriptorSet>& GetDescriptorSets();
 
 	private:		
-		Model m_model;
+		std::shared_ptr<Model> m_model; // Shared with every Mesh using the same model file once CreateResources() has run
 		std::shared_ptr<Material> m_material;
 		std::vector<VkDescriptorSet> m_descriptorSets;
 		int m_allocationPoolIndex;
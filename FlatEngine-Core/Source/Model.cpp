@@ -1,5 +1,6 @@
 #include "Model.h"
 #include "VulkanManager.h"
+#include "CookedMesh.h"
 
 #define TINYOBJLOADER_IMPLEMENTATION // Loading obj files
 #include "tiny_obj_loader.h"
@@ -17,36 +18,29 @@ namespace FlatEngine
         m_indices = std::vector<uint32_t>();
         m_vertexBuffer = VK_NULL_HANDLE;
         m_indexBuffer = VK_NULL_HANDLE;
-        m_indexBufferMemory = VK_NULL_HANDLE;
-        m_vertexBufferMemory = VK_NULL_HANDLE;
-        m_uniformBuffers = std::vector<VkBuffer>();
-        m_uniformBuffersMemory = std::vector<VkDeviceMemory>();
-        m_uniformBuffersMapped = std::vector<void*>();
+        m_indexBufferMemory = MemoryAllocation();
+        m_vertexBufferMemory = MemoryAllocation();
+        m_loadTime = 0;
+        m_b_loadedFromCook = false;
 	}
 
     Model::~Model()
     {
     }
 
-    void Model::CleanupUniformBuffers(LogicalDevice& logicalDevice)
-    {
-        for (size_t i = 0; i < VM_MAX_FRAMES_IN_FLIGHT; i++)
-        {
-            vkDestroyBuffer(logicalDevice.GetDevice(), m_uniformBuffers[i], nullptr);
-            vkFreeMemory(logicalDevice.GetDevice(), m_uniformBuffersMemory[i], nullptr);
-        }
-    }
-
     void Model::CleanupIndexBuffers(LogicalDevice& logicalDevice)
     {
+        // The buffer may still be the destination of an upload that has not executed yet
+        VM_uploadManager.WaitIdle();
         vkDestroyBuffer(logicalDevice.GetDevice(), m_indexBuffer, nullptr);
-        vkFreeMemory(logicalDevice.GetDevice(), m_indexBufferMemory, nullptr);
+        VM_memoryAllocator.Free(m_indexBufferMemory);
     }
 
     void Model::CleanupVertexBuffers(LogicalDevice& logicalDevice)
     {
+        VM_uploadManager.WaitIdle();
         vkDestroyBuffer(logicalDevice.GetDevice(), m_vertexBuffer, nullptr);
-        vkFreeMemory(logicalDevice.GetDevice(), m_vertexBufferMemory, nullptr);
+        VM_memoryAllocator.Free(m_vertexBufferMemory);
     }
 
 
@@ -60,7 +54,25 @@ namespace FlatEngine
         return m_modelPath;
     }
 
+    // Maps the model's cook when it is current, otherwise parses the .obj. Loading never writes a cook, that only happens in CookProjectMeshes()
     void Model::LoadModel()
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        m_vertices.clear();
+        m_indices.clear();
+        m_b_loadedFromCook = CookedMesh::HasCurrentCook(m_modelPath) && LoadCooked(CookedMesh::GetCookedPath(m_modelPath), m_vertices, m_indices);
+
+        if (!m_b_loadedFromCook)
+        {
+            LoadObj(m_modelPath, m_vertices, m_indices);
+        }
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        m_loadTime = std::chrono::duration<float, std::chrono::microseconds::period>(endTime - startTime).count();
+    }
+
+    void Model::LoadObj(std::string path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
     {
         // Refer to - https://vulkan-tutorial.com/en/Loading_models
 
@@ -69,13 +81,23 @@ namespace FlatEngine
         std::vector<tinyobj::material_t> materials;
         std::string warn, err;
 
-        std::unordered_map<Vertex, uint32_t> uniqueVertices{};
-
-        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, m_modelPath.c_str()))
+        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str()))
         {
             throw std::runtime_error(warn + err);
         }
 
+        size_t indexCount = 0;
+        for (const auto& shape : shapes)
+        {
+            indexCount += shape.mesh.indices.size();
+        }
+        vertices.clear();
+        indices.clear();
+        indices.reserve(indexCount);
+        // Sized up front so the map never rehashes mid load, there are at most as many unique vertices as indices
+        std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+        uniqueVertices.reserve(indexCount);
+
         for (const auto& shape : shapes) 
         {
             for (const auto& index : shape.mesh.indices) 
@@ -89,102 +111,147 @@ namespace FlatEngine
                     attrib.vertices[3 * index.vertex_index + 2]
                 };
 
-                vertex.texCoord = 
+                if (index.texcoord_index >= 0)
                 {
-                    attrib.texcoords[2 * index.texcoord_index + 0],
-                    1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-                };
+                    vertex.texCoord =
+                    {
+                        attrib.texcoords[2 * index.texcoord_index + 0],
+                        1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
+                    };
+                }
 
                 vertex.color = { 1.0f, 1.0f, 1.0f };
 
-                vertex.normal =
+                if (index.normal_index >= 0)
                 {
-                    attrib.normals[3 * index.normal_index + 0],
-                    attrib.normals[3 * index.normal_index + 1],
-                    attrib.normals[3 * index.normal_index + 2]
-                };
+                    vertex.normal =
+                    {
+                        attrib.normals[3 * index.normal_index + 0],
+                        attrib.normals[3 * index.normal_index + 1],
+                        attrib.normals[3 * index.normal_index + 2]
+                    };
+                }
 
                 // Keep only unique vertices
-                if (uniqueVertices.count(vertex) == 0)
+                auto inserted = uniqueVertices.try_emplace(vertex, static_cast<uint32_t>(vertices.size()));
+                if (inserted.second)
                 {
-                    uniqueVertices[vertex] = static_cast<uint32_t>(m_vertices.size());
-                    m_vertices.push_back(vertex);
+                    vertices.push_back(vertex);
                 }
 
-                m_indices.push_back(uniqueVertices[vertex]);
+                indices.push_back(inserted.first->second);
             }
         }
     }
 
-    void Model::CreateVertexBuffer(VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
+    bool Model::LoadCooked(std::string path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
     {
-        // Create staging buffer for control from the cpu
-        // Refer to - https://vulkan-tutorial.com/en/Vertex_buffers/Staging_buffer
+        CookedMesh cookedMesh;
+        if (!cookedMesh.Open(path))
+        {
+            return false;
+        }
 
-        VkDeviceSize bufferSize = sizeof(m_vertices[0]) * m_vertices.size();
+        CookedMeshHeader& header = cookedMesh.GetHeader();
+        vertices.assign(cookedMesh.GetVertices(), cookedMesh.GetVertices() + header.vertexCount);
+        indices.assign(cookedMesh.GetIndices(), cookedMesh.GetIndices() + header.indexCount);
+        return true;
+    }
 
-        VkBuffer stagingBuffer{};
-        VkDeviceMemory stagingBufferMemory{};
-        WinSys::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory, physicalDevice, logicalDevice);
+    bool Model::CookModel(std::string path)
+    {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        try
+        {
+            LoadObj(path, vertices, indices);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
 
-        void* data;
-        vkMapMemory(logicalDevice.GetDevice(), stagingBufferMemory, 0, bufferSize, 0, &data);
-        memcpy(data, m_vertices.data(), (size_t)bufferSize);
-        vkUnmapMemory(logicalDevice.GetDevice(), stagingBufferMemory);
+        return CookedMesh::Cook(vertices, indices, CookedMesh::GetCookedPath(path));
+    }
 
-        // Create device local vertex buffer for actual buffer
-        WinSys::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_vertexBuffer, m_vertexBufferMemory, physicalDevice, logicalDevice);
+    // Average microseconds to load the model from its .obj and from its cook, cooking it first if needed
+    bool Model::BenchmarkLoad(std::string path, int iterations, float& objTime, float& cookedTime)
+    {
+        objTime = 0;
+        cookedTime = 0;
+        if (iterations <= 0 || (!CookedMesh::HasCurrentCook(path) && !CookModel(path)))
+        {
+            return false;
+        }
+
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::string cookedPath = CookedMesh::GetCookedPath(path);
 
-        // We can now call copyBuffer function to move the vertex data to the device local buffer:
-        WinSys::CopyBuffer(stagingBuffer, m_vertexBuffer, bufferSize, commandPool, logicalDevice);
+        for (int i = 0; i < iterations; i++)
+        {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            try
+            {
+                LoadObj(path, vertices, indices);
+            }
+            catch (const std::exception&)
+            {
+                return false;
+            }
+            auto objEnd = std::chrono::high_resolution_clock::now();
+            if (!LoadCooked(cookedPath, vertices, indices))
+            {
+                return false;
+            }
+            auto cookedEnd = std::chrono::high_resolution_clock::now();
 
-        // After copying the data from the staging buffer to the device buffer, we should clean it up:
-        vkDestroyBuffer(logicalDevice.GetDevice(), stagingBuffer, nullptr);
-        vkFreeMemory(logicalDevice.GetDevice(), stagingBufferMemory, nullptr);
+            objTime += std::chrono::duration<float, std::chrono::microseconds::period>(objEnd - startTime).count();
+            cookedTime += std::chrono::duration<float, std::chrono::microseconds::period>(cookedEnd - objEnd).count();
+        }
+
+        objTime /= iterations;
+        cookedTime /= iterations;
+        return true;
     }
 
-    void Model::CreateIndexBuffer(VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
+    float Model::GetLoadTime()
     {
-        // Refer to - https://vulkan-tutorial.com/en/Vertex_buffers/Index_buffer
-
-        VkDeviceSize bufferSize = sizeof(m_indices[0]) * m_indices.size();
+        return m_loadTime;
+    }
 
-        VkBuffer stagingBuffer;
-        VkDeviceMemory stagingBufferMemory;
-        WinSys::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory, physicalDevice, logicalDevice);
+    bool Model::LoadedFromCook()
+    {
+        return m_b_loadedFromCook;
+    }
 
-        void* data;
-        vkMapMemory(logicalDevice.GetDevice(), stagingBufferMemory, 0, bufferSize, 0, &data);
-        memcpy(data, m_indices.data(), (size_t)bufferSize);
-        vkUnmapMemory(logicalDevice.GetDevice(), stagingBufferMemory);
+    void Model::CreateVertexBuffer(VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
+    {
+        // Create staging buffer for control from the cpu
+        // Refer to - https://vulkan-tutorial.com/en/Vertex_buffers/Staging_buffer
 
-        WinSys::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_indexBuffer, m_indexBufferMemory, physicalDevice, logicalDevice);
+        VkDeviceSize bufferSize = sizeof(m_vertices[0]) * m_vertices.size();
 
-        WinSys::CopyBuffer(stagingBuffer, m_indexBuffer, bufferSize, commandPool, logicalDevice);
+        // Create device local vertex buffer for actual buffer
+        WinSys::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_vertexBuffer, m_vertexBufferMemory, physicalDevice, logicalDevice);
 
-        vkDestroyBuffer(logicalDevice.GetDevice(), stagingBuffer, nullptr);
-        vkFreeMemory(logicalDevice.GetDevice(), stagingBufferMemory, nullptr);
+        // The vertices are staged in the upload manager's ring and copied with its next batch, nothing waits on the copy here
+        VM_uploadManager.UploadBuffer(m_vertices.data(), bufferSize, m_vertexBuffer);
     }
 
-    void Model::CreateUniformBuffers(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice) 
+    void Model::CreateIndexBuffer(VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
     {
-        // Refer to - https://vulkan-tutorial.com/en/Uniform_buffers/Descriptor_layout_and_buffer
-
-        VkDeviceSize bufferSize = sizeof(UniformBufferObject);
+        // Refer to - https://vulkan-tutorial.com/en/Vertex_buffers/Index_buffer
 
-        m_uniformBuffers.resize(VM_MAX_FRAMES_IN_FLIGHT);
-        m_uniformBuffersMemory.resize(VM_MAX_FRAMES_IN_FLIGHT);
-        m_uniformBuffersMapped.resize(VM_MAX_FRAMES_IN_FLIGHT);
+        VkDeviceSize bufferSize = sizeof(m_indices[0]) * m_indices.size();
 
-        for (size_t i = 0; i < VM_MAX_FRAMES_IN_FLIGHT; i++)
-        {
-            WinSys::CreateBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_uniformBuffers[i], m_uniformBuffersMemory[i], physicalDevice, logicalDevice);
+        WinSys::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_indexBuffer, m_indexBufferMemory, physicalDevice, logicalDevice);
 
-            vkMapMemory(logicalDevice.GetDevice(), m_uniformBuffersMemory[i], 0, bufferSize, 0, &m_uniformBuffersMapped[i]);
-        }
+        VM_uploadManager.UploadBuffer(m_indices.data(), bufferSize, m_indexBuffer);
     }
 
-    void Model::UpdateUniformBuffer(uint32_t currentImage, WinSys& winSystem, float multiplier)
+    // The result is written into the frame's UniformRing slot for this model, models no longer own uniform buffers
+    void Model::FillUniformBufferObject(UniformBufferObject& ubo, WinSys& winSystem, float multiplier)
     {
         // This function will generate a new transformation every frame to make the geometry spin around.We need to include two new headers to implement this functionality:
         static auto startTime = std::chrono::high_resolution_clock::now();
@@ -192,18 +259,10 @@ namespace FlatEngine
         auto currentTime = std::chrono::high_resolution_clock::now();
         float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
 
-        UniformBufferObject ubo{};
         ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(45.0f), glm::vec3(0.0f, 0.0f, 1.0f)); // Creates a vec4 that is used to matrix multiply by the positions of each vertex.
         ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
         ubo.proj = glm::perspective(glm::radians(90.0f), winSystem.GetExtent().width / (float)winSystem.GetExtent().height, 0.1f, 10.0f);
         ubo.proj[1][1] *= -1;
-
-        memcpy(m_uniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
-    }
-
-    std::vector<VkBuffer>& Model::GetUniformBuffers()
-    {
-        return m_uniformBuffers;
     }
 
     VkBuffer& Model::GetVertexBuffer()
@@ -17,18 +17,21 @@ namespace FlatEngine
 	public:
 		Model();
 		~Model();
-		void CleanupUniformBuffers(LogicalDevice& logicalDevice);
 		void CleanupIndexBuffers(LogicalDevice& logicalDevice);
 		void CleanupVertexBuffers(LogicalDevice& logicalDevice);
 
 		void SetModelPath(std::string path);
 		std::string GetModelPath();
 		void LoadModel();
+		static void LoadObj(std::string path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+		static bool LoadCooked(std::string path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+		static bool CookModel(std::string path);
+		static bool BenchmarkLoad(std::string path, int iterations, float& objTime, float& cookedTime);
+		float GetLoadTime();
+		bool LoadedFromCook();
 		void CreateVertexBuffer(VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
 		void CreateIndexBuffer(VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
-		void CreateUniformBuffers(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
-		void UpdateUniformBuffer(uint32_t currentImage, WinSys& winSystem, float multiplier);
-		std::vector<VkBuffer>& GetUniformBuffers();
+		void FillUniformBufferObject(UniformBufferObject& ubo, WinSys& winSystem, float multiplier);
 		VkBuffer& GetVertexBuffer();
 		VkBuffer& GetIndexBuffer();		
 		std::vector<uint32_t>& GetIndices();
@@ -39,11 +42,10 @@ namespace FlatEngine
 		std::vector<uint32_t> m_indices;
 		VkBuffer m_vertexBuffer;
 		VkBuffer m_indexBuffer;
-		VkDeviceMemory m_vertexBufferMemory;
-		VkDeviceMemory m_indexBufferMemory;
-		std::vector<VkBuffer> m_uniformBuffers;
-		std::vector<VkDeviceMemory> m_uniformBuffersMemory;
-		std::vector<void*> m_uniformBuffersMapped;
+		MemoryAllocation m_vertexBufferMemory;
+		MemoryAllocation m_indexBufferMemory;
+		float m_loadTime; // Microseconds
+		bool m_b_loadedFromCook;
 	};
 }
 
@@ -26,6 +26,11 @@ namespace FlatEngine
         return m_physicalDevice;
     }
 
+    VkPhysicalDeviceProperties& PhysicalDevice::GetProperties()
+    {
+        return m_physicalDeviceProperties;
+    }
+
     void PhysicalDevice::Init(VkInstance instance, VkSurfaceKHR surface)
     {
         PickPhysicalDevice(instance, surface);
@@ -13,6 +13,7 @@ namespace FlatEngine
         ~PhysicalDevice();
 
         VkPhysicalDevice GetDevice();
+        VkPhysicalDeviceProperties& GetProperties();
         void Init(VkInstance instance, VkSurfaceKHR surface);
         void PickPhysicalDevice(VkInstance instance, VkSurfaceKHR surface);
         bool IsDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface);
@@ -0,0 +1,157 @@
+#include "PipelineCache.h"
+#include "FlatEngine.h"
+
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace FlatEngine
+{
+    PipelineCache::PipelineCache()
+    {
+        m_physicalDeviceHandle = nullptr;
+        m_deviceHandle = nullptr;
+        m_cache = VK_NULL_HANDLE;
+        m_filepath = "";
+        m_b_loadedFromDisk = false;
+        m_pipelineCount = 0;
+        m_creationTime = 0;
+    }
+
+    PipelineCache::~PipelineCache()
+    {
+    }
+
+    void PipelineCache::Cleanup()
+    {
+        if (m_cache != VK_NULL_HANDLE)
+        {
+            vkDestroyPipelineCache(m_deviceHandle->GetDevice(), m_cache, nullptr);
+            m_cache = VK_NULL_HANDLE;
+        }
+    }
+
+    void PipelineCache::Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, std::string filepath)
+    {
+        m_physicalDeviceHandle = &physicalDevice;
+        m_deviceHandle = &logicalDevice;
+        m_filepath = filepath;
+        m_b_loadedFromDisk = false;
+
+        std::vector<char> data = std::vector<char>();
+        std::ifstream file(filepath, std::ios::ate | std::ios::binary);
+        if (file.is_open())
+        {
+            size_t fileSize = (size_t)file.tellg();
+            data.resize(fileSize);
+            file.seekg(0);
+            file.read(data.data(), fileSize);
+            file.close();
+
+            if (ValidateHeader(data))
+            {
+                m_b_loadedFromDisk = true;
+            }
+            else
+            {
+                LogString("Pipeline cache at " + filepath + " was saved for a different device or driver, discarding it.");
+                data.clear();
+            }
+        }
+
+        VkPipelineCacheCreateInfo cacheInfo{};
+        cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        cacheInfo.initialDataSize = data.size();
+        cacheInfo.pInitialData = data.size() > 0 ? data.data() : nullptr;
+
+        if (vkCreatePipelineCache(logicalDevice.GetDevice(), &cacheInfo, nullptr, &m_cache) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create pipeline cache!");
+        }
+    }
+
+    // Header layout is VkPipelineCacheHeaderVersionOne: size, version, vendorID, deviceID, pipelineCacheUUID
+    bool PipelineCache::ValidateHeader(std::vector<char>& data)
+    {
+        const size_t headerSize = sizeof(uint32_t) * 4 + VK_UUID_SIZE;
+        if (data.size() < headerSize)
+        {
+            return false;
+        }
+
+        uint32_t header[4];
+        std::memcpy(header, data.data(), sizeof(header));
+        VkPhysicalDeviceProperties& properties = m_physicalDeviceHandle->GetProperties();
+
+        return header[0] >= headerSize &&
+            header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+            header[2] == properties.vendorID &&
+            header[3] == properties.deviceID &&
+            std::memcmp(data.data() + sizeof(header), properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
+    // Written to a temporary file first so a crash mid-write can not leave a truncated cache behind
+    void PipelineCache::Save()
+    {
+        if (m_cache == VK_NULL_HANDLE || m_filepath == "")
+        {
+            return;
+        }
+
+        size_t dataSize = 0;
+        if (vkGetPipelineCacheData(m_deviceHandle->GetDevice(), m_cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0)
+        {
+            return;
+        }
+        std::vector<char> data = std::vector<char>(dataSize);
+        if (vkGetPipelineCacheData(m_deviceHandle->GetDevice(), m_cache, &dataSize, data.data()) != VK_SUCCESS)
+        {
+            return;
+        }
+
+        std::string tempPath = m_filepath + ".tmp";
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LogError("Could not write pipeline cache to " + m_filepath);
+            return;
+        }
+        file.write(data.data(), dataSize);
+        file.close();
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, m_filepath, error);
+        if (error)
+        {
+            LogError("Could not write pipeline cache to " + m_filepath);
+        }
+    }
+
+    VkPipelineCache PipelineCache::GetCache()
+    {
+        return m_cache;
+    }
+
+    void PipelineCache::AddCreationTime(float microseconds)
+    {
+        m_pipelineCount++;
+        m_creationTime += microseconds;
+    }
+
+    int PipelineCache::GetPipelineCount()
+    {
+        return m_pipelineCount;
+    }
+
+    float PipelineCache::GetCreationTime()
+    {
+        return m_creationTime;
+    }
+
+    bool PipelineCache::LoadedFromDisk()
+    {
+        return m_b_loadedFromDisk;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include "PhysicalDevice.h"
+#include "LogicalDevice.h"
+
+#define GLFW_INCLUDE_VULKAN
+#include <glfw3.h>
+
+#include <string>
+#include <vector>
+
+
+namespace FlatEngine
+{
+	const std::string PIPELINE_CACHE_FILEPATH = "..\\engine\\pipeline.cache";
+
+	// VkPipelineCache shared by every pipeline the engine creates. Its data is loaded from disk in Init() and written back by Save(),
+	// so pipelines compiled in an earlier run are not compiled again. Data saved by a different driver or GPU is detected from
+	// the cache header and discarded, the cache then starts empty.
+	class PipelineCache
+	{
+	public:
+		PipelineCache();
+		~PipelineCache();
+		void Cleanup();
+
+		void Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, std::string filepath);
+		void Save();
+		VkPipelineCache GetCache();
+		void AddCreationTime(float microseconds);
+		int GetPipelineCount();
+		float GetCreationTime();
+		bool LoadedFromDisk();
+
+	private:
+		bool ValidateHeader(std::vector<char>& data);
+
+		PhysicalDevice* m_physicalDeviceHandle;
+		LogicalDevice* m_deviceHandle;
+		VkPipelineCache m_cache;
+		std::string m_filepath;
+		bool m_b_loadedFromDisk;
+		int m_pipelineCount;
+		float m_creationTime;
+	};
+}
\ No newline at end of file
@@ -326,6 +326,7 @@ namespace FlatEngine
 				boxCollider->activeDimensions = Vector2(CheckJsonFloat(componentJson, "activeWidth", objectName), CheckJsonFloat(componentJson, "activeHeight", objectName));
 				boxCollider->activeOffset = Vector2(CheckJsonFloat(componentJson, "activeOffsetX", objectName), CheckJsonFloat(componentJson, "activeOffsetY", objectName));
 				boxCollider->b_isContinuous = CheckJsonBool(componentJson, "_isContinuous", objectName);
+				boxCollider->b_firesStayEvents = !componentJson.contains("_firesStayEvents") || CheckJsonBool(componentJson, "_firesStayEvents", objectName);
 				boxCollider->b_isStatic = CheckJsonBool(componentJson, "_isStatic", objectName);
 				boxCollider->b_isSolid = CheckJsonBool(componentJson, "_isSolid", objectName);
 				boxCollider->activeLayer = CheckJsonInt(componentJson, "activeLayer", objectName);
@@ -342,6 +343,7 @@ namespace FlatEngine
 				circleCollider->activeRadius = CheckJsonFloat(componentJson, "activeRadius", objectName);
 				circleCollider->activeOffset = Vector2(CheckJsonFloat(componentJson, "activeOffsetX", objectName), CheckJsonFloat(componentJson, "activeOffsetY", objectName));
 				circleCollider->b_isContinuous = CheckJsonBool(componentJson, "_isContinuous", objectName);
+				circleCollider->b_firesStayEvents = !componentJson.contains("_firesStayEvents") || CheckJsonBool(componentJson, "_firesStayEvents", objectName);
 				circleCollider->b_isStatic = CheckJsonBool(componentJson, "_isStatic", objectName);
 				circleCollider->b_isSolid = CheckJsonBool(componentJson, "_isSolid", objectName);
 				circleCollider->activeLayer = CheckJsonInt(componentJson, "activeLayer", objectName);
@@ -384,57 +386,30 @@ namespace FlatEngine
 						tileMap->tileSetNames.push_back(CheckJsonString(tileSetJson, "name", objectName));
 					}
 				}
-				// Get Tile data
-				if (JsonContains(componentJson, "tiles", objectName))
+				// Get Tile data, kept packed until the prefab is instantiated
+				if (componentJson.contains("tileData"))
 				{
-					std::map<int, std::map<int, Tile>> tiles;
+					tileMap->encodedTiles = DecodeBase64(CheckJsonString(componentJson, "tileData", objectName));
+				}
+				else if (JsonContains(componentJson, "tiles", objectName))
+				{
+					TileMap tiles = TileMap();
 
 					for (int tile = 0; tile < componentJson["tiles"].size(); tile++)
 					{
 						json tileJson = componentJson["tiles"][tile];
-						float x = CheckJsonFloat(tileJson, "tileCoordX", objectName);
-						float y = CheckJsonFloat(tileJson, "tileCoordY", objectName);
+						int x = (int)CheckJsonFloat(tileJson, "tileCoordX", objectName);
+						int y = (int)CheckJsonFloat(tileJson, "tileCoordY", objectName);
 						std::string tileSetName = CheckJsonString(tileJson, "tileSetName", objectName);
 						int tileSetIndex = CheckJsonInt(tileJson, "tileSetIndex", objectName);
-						Vector2 coord = Vector2(x, y);
 
 						if (tileSetName != "" && tileSetIndex != -1)
 						{
-							TileSet* tileSet = GetTileSet(tileSetName);
-							VkDescriptorSet texture = tileSet->GetTexture()->GetTexture();
-							Vector2 uvStart = tileSet->GetIndexUVs(tileSetIndex).first;
-							Vector2 uvEnd = tileSet->GetIndexUVs(tileSetIndex).second;
-
-							Tile newTile = Tile();
-							newTile.tileCoord = coord;
-							int x = (int)coord.x;
-							int y = (int)coord.y;
-							newTile.tileSetName = tileSet->GetName();
-							newTile.tileSetIndex = tileSetIndex;
-							newTile.tileSetTexture = texture;
-							newTile.uvStart = uvStart;
-							newTile.uvEnd = uvEnd;
-
-							if (tiles.count(x) > 0 && tiles.at(x).count(y) > 0)
-							{
-								tiles.at(x).at(y) = newTile;
-							}
-							else if (tiles.count(x) > 0 && tiles.at(x).count(y) == 0)
-							{
-								std::pair<int, Tile> newPair = { y, newTile };
-								tiles.at(x).emplace(newPair);
-							}
-							else if (tiles.count(x) == 0)
-							{
-								std::pair<int, Tile> newPair = { y, newTile };
-								std::map<int, Tile> yCoords;
-								yCoords.emplace(newPair);
-								tiles.emplace(x, yCoords);
-							}
+							tiles.SetTile(x, y, tileSetName, tileSetIndex);
 						}
 					}
 
-					tileMap->tiles = tiles;
+					tileMap->encodedTiles = tiles.EncodeTiles();
 				}
 				// Get Collision Area data
 				if (JsonContains(componentJson, "collisionAreas", objectName))
@@ -714,6 +689,7 @@ namespace FlatEngine
 						boxCol->SetActiveDimensions(colData->activeDimensions.x, colData->activeDimensions.y);
 						boxCol->SetActiveOffset(colData->activeOffset);
 						boxCol->SetIsContinuous(colData->b_isContinuous);
+						boxCol->SetFiresStayEvents(colData->b_firesStayEvents);
 						boxCol->SetIsStatic(colData->b_isStatic);
 						boxCol->SetIsSolid(colData->b_isSolid);
 						boxCol->SetActiveLayer(colData->activeLayer);
@@ -727,6 +703,7 @@ namespace FlatEngine
 						cirCol->SetActiveRadiusGrid(colData->activeRadius);
 						cirCol->SetActiveOffset(colData->activeOffset);
 						cirCol->SetIsContinuous(colData->b_isContinuous);
+						cirCol->SetFiresStayEvents(colData->b_firesStayEvents);
 						cirCol->SetIsStatic(colData->b_isStatic);
 						cirCol->SetIsSolid(colData->b_isSolid);
 						cirCol->SetActiveLayer(colData->activeLayer);
@@ -769,7 +746,10 @@ namespace FlatEngine
 						tileMap->SetTileWidth(tileMapData->tileWidth);
 						tileMap->SetTileHeight(tileMapData->tileHeight);
 						tileMap->SetTileSets(tileMapData->tileSetNames);
-						tileMap->SetTiles(tileMapData->tiles);
+						if (tileMapData->encodedTiles.size() > 0)
+						{
+							tileMap->DecodeTiles(tileMapData->encodedTiles);
+						}
 
 						for (std::pair<std::string, std::vector<std::pair<Vector2, Vector2>>> collisionAreaPair : tileMapData->collisionAreas)
 						{
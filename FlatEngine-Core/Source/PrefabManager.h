@@ -3,7 +3,7 @@
 #include "TagList.h"
 #include "Animation.h"
 #include "Audio.h"    // SoundData
-#include "TileMap.h"  // Tile
+#include "TileMap.h"
 #include "Scene.h"
 
 #include <string>
@@ -99,6 +99,7 @@ namespace FlatEngine
 		float rotation;
 		bool b_tileMapCollider;
 		bool b_isContinuous;
+		bool b_firesStayEvents;
 		bool b_isStatic;
 		bool b_isSolid;
 		bool b_showActiveRadius;
@@ -108,6 +109,7 @@ namespace FlatEngine
 		float activeRadius;
 		Vector2 activeOffset;
 		bool b_isContinuous;
+		bool b_firesStayEvents;
 		bool b_isStatic;
 		bool b_isSolid;
 		bool b_isComposite;
@@ -138,7 +140,7 @@ namespace FlatEngine
 		int tileWidth;
 		int tileHeight;
 		int renderOrder;
-		std::map<int, std::map<int, Tile>> tiles;
+		std::vector<uint8_t> encodedTiles; // TileMap::EncodeTiles format
 		std::vector<std::string> tileSetNames;
 		std::map<std::string, std::vector<std::pair<Vector2, Vector2>>> collisionAreas;
 	};
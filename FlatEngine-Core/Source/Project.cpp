@@ -1,5 +1,7 @@
 #include "Project.h"
 #include "FlatEngine.h"
+#include "VirtualFileSystem.h"
+#include "JsonStream.h"
 //#include "WindowManager.h"
 
 #include "SDL_mixer.h"
@@ -22,11 +24,13 @@ namespace FlatEngine
 		m_currentFileDirectory = "";
 		m_persistantGameObjectsScenePath = "";
 		m_persistantGameObjectsScene = Scene();
+		m_b_persistantSceneUnreadable = false;
 		m_sceneViewScrolling = Vector2(0, 0);
 		m_focusedGameObjectID = -1;
 		m_b_autoSave = true;
 		m_resolution = Vector2(1920, 1080);
 		m_b_vsyncEnabled = true;
+		m_b_packTexturesOnLoad = false;
 		m_b_fullscreen = false;
 		m_musicVolume = 10;
 		m_effectsVolume = 10;
@@ -95,29 +99,11 @@ namespace FlatEngine
 	{
 		m_persistantGameObjectsScene.UnloadSceneObjects();
 		m_persistantGameObjectsScene.UnloadECSManager();
+		m_b_persistantSceneUnreadable = false;
 
-		std::ofstream file_obj;
-		std::ifstream ifstream(m_persistantGameObjectsScenePath);
+		FileData sceneFile;
 
-		file_obj.open(m_persistantGameObjectsScenePath, std::ios::in);
-		std::string fileContent = "";
-
-		if (file_obj.good())
-		{
-			std::string line;
-			while (!ifstream.eof())
-			{
-				std::getline(ifstream, line);
-				if (line != "")
-				{
-					fileContent.append(line + "\n");
-				}
-			}
-		}
-
-		file_obj.close();
-
-		if (file_obj.good() && fileContent != "")
+		if (F_VirtualFileSystem.Read(m_persistantGameObjectsScenePath, sceneFile) && sceneFile.GetSize() > 0)
 		{
 			m_persistantGameObjectsScene = Scene();
 			// Set persistant gameobjects starting ID's at arbitrarily high values so they will never collide with the regular scene object ID's
@@ -126,25 +112,45 @@ namespace FlatEngine
 			m_persistantGameObjectsScene.SetName(GetFilenameFromPath(m_persistantGameObjectsScenePath, false));
 			m_persistantGameObjectsScene.SetPersistantScene(true);
 
-			json fileContentJson = json::parse(fileContent);
+			bool b_hasObjects = false;
+			std::string parseError = "";
 
-			if (fileContentJson.contains("Persistant GameObjects") && fileContentJson["Persistant GameObjects"][0] != "NULL")
+			// Streamed like SceneManager::LoadScene(), objects are created as they are parsed
+			bool b_parsed = JsonArrayStream::Parse(sceneFile.GetData(), sceneFile.GetSize(), "Persistant GameObjects", [&](json& objectJson)
 			{
-				auto firstObjectName = fileContentJson["Persistant GameObjects"];
+				if (objectJson == "NULL")
+				{
+					return true;
+				}
+				b_hasObjects = true;
 
-				// Loop through the saved GameObjects in the JSON file
-				for (int i = 0; i < fileContentJson["Persistant GameObjects"].size(); i++)
+				// Add created GameObject to our new Scene
+				GameObject* loadedObject = CreateObjectFromJson(std::move(objectJson), &m_persistantGameObjectsScene);
+				// Check for primary camera
+				if (loadedObject != nullptr && loadedObject->HasComponent("Camera") && loadedObject->GetCamera()->IsPrimary())
 				{
-					// Add created GameObject to our new Scene
-					bool b_persistant = true;
-					GameObject* loadedObject = CreateObjectFromJson(fileContentJson["Persistant GameObjects"][i], &m_persistantGameObjectsScene);
-					// Check for primary camera
-					if (loadedObject != nullptr && loadedObject->HasComponent("Camera") && loadedObject->GetCamera()->IsPrimary())
-					{
-						m_persistantGameObjectsScene.SetPrimaryCamera(loadedObject->GetCamera());
-					}
+					m_persistantGameObjectsScene.SetPrimaryCamera(loadedObject->GetCamera());
 				}
+				return true;
+			}, parseError);
+
+			if (!b_parsed)
+			{
+				LogError("Failed to parse scene: " + m_persistantGameObjectsScenePath + "\n" + parseError);
+
+				// Drop the objects created before the error, a save would otherwise write the partial scene over the file
+				m_persistantGameObjectsScene.UnloadSceneObjects();
+				m_persistantGameObjectsScene.UnloadECSManager();
+				m_persistantGameObjectsScene = Scene();
+				m_persistantGameObjectsScene.SetNextComponentID(10000000);
+				m_persistantGameObjectsScene.SetNextGameObjectID(10000000);
+				m_persistantGameObjectsScene.SetPersistantScene(true);
+				m_b_persistantSceneUnreadable = true;
+				return;
+			}
 
+			if (b_hasObjects)
+			{
 				// Just in case any parent objects had not been created at the time of children being created on scene load,
 				// loop through objects with parents and add them as children to their parent objects
 				for (std::pair<long, GameObject> sceneObject : m_persistantGameObjectsScene.GetSceneObjects())
@@ -170,6 +176,12 @@ namespace FlatEngine
 
 	void Project::SaveScene()
 	{
+		if (m_b_persistantSceneUnreadable)
+		{
+			LogError("Persistant scene not saved, its file failed to load: " + m_persistantGameObjectsScenePath);
+			return;
+		}
+
 		std::ofstream file_obj;
 		std::ifstream ifstream(m_persistantGameObjectsScenePath);
 
@@ -306,6 +318,16 @@ namespace FlatEngine
 		return m_b_vsyncEnabled;
 	}
 
+	void Project::SetPackTexturesOnLoad(bool b_packTexturesOnLoad)
+	{
+		m_b_packTexturesOnLoad = b_packTexturesOnLoad;
+	}
+
+	bool Project::PacksTexturesOnLoad()
+	{
+		return m_b_packTexturesOnLoad;
+	}
+
 	void Project::SetMusicVolume(int volume)
 	{
 		if (volume >= 0 && volume <= MIX_MAX_VOLUME)
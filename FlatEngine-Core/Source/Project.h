@@ -45,6 +45,8 @@ namespace FlatEngine
 		bool IsFullscreen();
 		void SetVsyncEnabled(bool b_vsync);
 		bool IsVsyncEnabled();
+		void SetPackTexturesOnLoad(bool b_packTexturesOnLoad);
+		bool PacksTexturesOnLoad();
 		void SetMusicVolume(int volume);
 		int GetMusicVolume();
 		void SetEffectsVolume(int volume);
@@ -59,6 +61,7 @@ namespace FlatEngine
 		std::string m_currentFileDirectory;
 		std::string m_persistantGameObjectsScenePath;
 		Scene m_persistantGameObjectsScene;
+		bool m_b_persistantSceneUnreadable; // Its file failed to parse, so SaveScene() leaves the file alone
 		Vector2 m_sceneViewScrolling;
 		Vector2 m_sceneViewGridStep;
 		long m_focusedGameObjectID;
@@ -66,6 +69,7 @@ namespace FlatEngine
 		Vector2 m_resolution;
 		bool m_b_fullscreen;
 		bool m_b_vsyncEnabled;
+		bool m_b_packTexturesOnLoad;
 		int m_musicVolume;
 		int m_effectsVolume;
 	};
@@ -0,0 +1,480 @@
+#include "RenderIndex.h"
+#include "FlatEngine.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "Sprite.h"
+#include "Text.h"
+#include "Texture.h"
+#include "TileMap.h"
+#include "Camera.h"
+#include "Canvas.h"
+#include "Button.h"
+#include "BoxCollider.h"
+#include "CircleCollider.h"
+#include "Scene.h"
+#include "Project.h"
+
+#include <cmath>
+#include <algorithm>
+#include <climits>
+
+
+namespace FlatEngine
+{
+	RenderIndex::RenderIndex(float cellSize)
+	{
+		m_cellSize = cellSize;
+		m_entries = std::unordered_map<long, S_Entry>();
+		m_cells = std::unordered_map<long long, std::vector<S_Entry*>>();
+		m_oversized = std::vector<S_Entry*>();
+		m_dirtyIDs = std::unordered_set<long>();
+		m_visited = std::vector<S_Entry*>();
+		m_results = std::vector<GameObject*>();
+		m_queryStamp = 0;
+		m_b_rebuildAll = true;
+		m_updateTime = 0;
+	}
+
+	RenderIndex::~RenderIndex()
+	{
+	}
+
+	// Called whenever a scenes GameObjects are unloaded or replaced, the stored GameObject pointers are not valid after that
+	void RenderIndex::Clear()
+	{
+		m_entries.clear();
+		m_cells.clear();
+		m_oversized.clear();
+		m_dirtyIDs.clear();
+		m_visited.clear();
+		m_results.clear();
+		m_b_rebuildAll = true;
+	}
+
+	void RenderIndex::MarkDirty(long objectID)
+	{
+		if (m_b_rebuildAll || objectID == -1)
+		{
+			return;
+		}
+
+		// Nothing has queried for a while (no view open), stop collecting and rebuild once when someone does
+		if (m_dirtyIDs.size() >= MAX_DIRTY_RENDER_OBJECTS && m_dirtyIDs.count(objectID) == 0)
+		{
+			m_dirtyIDs.clear();
+			m_b_rebuildAll = true;
+			return;
+		}
+
+		m_dirtyIDs.insert(objectID);
+	}
+
+	void RenderIndex::Remove(long objectID)
+	{
+		std::unordered_map<long, S_Entry>::iterator entryIter = m_entries.find(objectID);
+		if (entryIter != m_entries.end())
+		{
+			Unlink(&entryIter->second);
+			m_entries.erase(entryIter);
+		}
+	}
+
+	void RenderIndex::Update()
+	{
+		double updateStart = GetTimeInMicroseconds();
+
+		if (m_b_rebuildAll)
+		{
+			m_entries.clear();
+			m_cells.clear();
+			m_oversized.clear();
+			m_dirtyIDs.clear();
+			m_b_rebuildAll = false;
+
+			if (GetLoadedScene() != nullptr)
+			{
+				IndexScene(GetLoadedScene()->GetSceneObjects());
+			}
+			if (GetLoadedProject().GetPersistantGameObjectScene() != nullptr)
+			{
+				IndexScene(GetLoadedProject().GetPersistantGameObjectScene()->GetSceneObjects());
+			}
+		}
+		else
+		{
+			for (long objectID : m_dirtyIDs)
+			{
+				RefreshEntry(objectID);
+			}
+			m_dirtyIDs.clear();
+		}
+
+		m_updateTime = (float)(GetTimeInMicroseconds() - updateStart);
+	}
+
+	std::vector<GameObject*>& RenderIndex::Query(Vector4 edges)
+	{
+		float top = edges.x;
+		float right = edges.y;
+		float bottom = edges.z;
+		float left = edges.w;
+
+		m_visited.clear();
+		m_results.clear();
+		m_queryStamp++;
+
+		int startX = GetCellCoord(left);
+		int endX = GetCellCoord(right);
+		int startY = GetCellCoord(bottom);
+		int endY = GetCellCoord(top);
+		long long cellCount = (long long)(endX - startX + 1) * (long long)(endY - startY + 1);
+
+		// Zoomed far out it is cheaper to test every entry than to walk the empty cells
+		if (cellCount > (long long)m_entries.size())
+		{
+			for (std::pair<const long, S_Entry>& entryPair : m_entries)
+			{
+				S_Entry& entry = entryPair.second;
+				if (entry.edges.w < right && entry.edges.y > left && entry.edges.x > bottom && entry.edges.z < top)
+				{
+					m_visited.push_back(&entry);
+				}
+			}
+		}
+		else
+		{
+			for (int cellX = startX; cellX <= endX; cellX++)
+			{
+				for (int cellY = startY; cellY <= endY; cellY++)
+				{
+					std::unordered_map<long long, std::vector<S_Entry*>>::iterator cell = m_cells.find(GetCellKey(cellX, cellY));
+					if (cell == m_cells.end())
+					{
+						continue;
+					}
+
+					for (S_Entry* entry : cell->second)
+					{
+						// Entries span multiple cells, stamp them so each is only returned once
+						if (entry->queryStamp != m_queryStamp && entry->edges.w < right && entry->edges.y > left && entry->edges.x > bottom && entry->edges.z < top)
+						{
+							entry->queryStamp = m_queryStamp;
+							m_visited.push_back(entry);
+						}
+					}
+				}
+			}
+
+			for (S_Entry* entry : m_oversized)
+			{
+				if (entry->edges.w < right && entry->edges.y > left && entry->edges.x > bottom && entry->edges.z < top)
+				{
+					m_visited.push_back(entry);
+				}
+			}
+		}
+
+		// Same order as walking the scene maps so render items with equal sort keys keep a stable draw order
+		std::sort(m_visited.begin(), m_visited.end(), [](S_Entry* first, S_Entry* second) { return first->id < second->id; });
+
+		for (S_Entry* entry : m_visited)
+		{
+			m_results.push_back(entry->object);
+		}
+
+		return m_results;
+	}
+
+	int RenderIndex::GetEntryCount()
+	{
+		return (int)m_entries.size();
+	}
+
+	float RenderIndex::GetUpdateTime()
+	{
+		return m_updateTime;
+	}
+
+	// Conservative bounds of everything the Game View or Scene View draws for this GameObject.
+	// Returns false if it has nothing with a size (no Transform, or no Sprite, Text, TileMap, Camera, Canvas, Button or Collider)
+	bool RenderIndex::GetRenderBounds(GameObject& object, Vector4& edges)
+	{
+		Transform* transform = object.GetTransform();
+		if (transform == nullptr)
+		{
+			return false;
+		}
+
+		Vector2 position = transform->GetTruePosition();
+		Vector2 scale = transform->GetScale();
+		float rotation = transform->GetRotation();
+		float top = position.y;
+		float right = position.x;
+		float bottom = position.y;
+		float left = position.x;
+		bool b_hasBounds = false;
+
+		auto addRect = [&](float rectTop, float rectRight, float rectBottom, float rectLeft)
+		{
+			top = std::max(top, std::max(rectTop, rectBottom));
+			right = std::max(right, std::max(rectRight, rectLeft));
+			bottom = std::min(bottom, std::min(rectTop, rectBottom));
+			left = std::min(left, std::min(rectRight, rectLeft));
+			b_hasBounds = true;
+		};
+		// Images are drawn from position - offset, so whichever side of the offset is longer bounds the image
+		auto addImage = [&](float width, float height, Vector2 offset, Vector2 imageScale)
+		{
+			float halfWidth = std::max(fabs(offset.x), fabs(width - offset.x)) * fabs(imageScale.x);
+			float halfHeight = std::max(fabs(offset.y), fabs(height - offset.y)) * fabs(imageScale.y);
+			addRect(position.y + halfHeight, position.x + halfWidth, position.y - halfHeight, position.x - halfWidth);
+		};
+		auto addCenteredRect = [&](Vector2 center, float width, float height)
+		{
+			float halfWidth = fabs(width * scale.x) / 2;
+			float halfHeight = fabs(height * scale.y) / 2;
+			addRect(center.y + halfHeight, center.x + halfWidth, center.y - halfHeight, center.x - halfWidth);
+		};
+
+		Sprite* sprite = object.GetSprite();
+		if (sprite != nullptr)
+		{
+			Vector2 spriteScale = sprite->GetScale();
+			addImage((float)sprite->GetTextureWidth(), (float)sprite->GetTextureHeight(), sprite->GetOffset(), Vector2(scale.x * spriteScale.x * F_spriteScaleMultiplier, scale.y * spriteScale.y * F_spriteScaleMultiplier));
+		}
+
+		Text* text = object.GetText();
+		if (text != nullptr && text->GetLayout() != nullptr)
+		{
+			addImage((float)text->GetWidth(), (float)text->GetHeight(), text->GetOffset(), Vector2(scale.x * F_spriteScaleMultiplier, scale.y * F_spriteScaleMultiplier));
+		}
+
+		TileMap* tileMap = object.GetTileMap();
+		if (tileMap != nullptr)
+		{
+			float tileWidth = (float)tileMap->GetTileWidth();
+			float tileHeight = (float)tileMap->GetTileHeight();
+			float gridWidth = tileMap->GetWidth() * tileWidth / F_pixelsPerGridSpace;
+			float gridHeight = tileMap->GetHeight() * tileHeight / F_pixelsPerGridSpace;
+			Vector2 mapTopLeft = Vector2(position.x - (gridWidth / 2), position.y + (gridHeight / 2));
+
+			// Only the chunks holding tiles count, clipped to the map, so a large mostly empty map stays small in the grid
+			int startTileX = INT_MAX;
+			int startTileY = INT_MAX;
+			int endTileX = INT_MIN;
+			int endTileY = INT_MIN;
+			for (std::pair<const std::pair<int, int>, TileMapChunk>& chunkPair : tileMap->GetChunks())
+			{
+				TileMapChunk& chunk = chunkPair.second;
+				int chunkStartX = std::max(chunk.chunkX * TILEMAP_CHUNK_SIZE, 0);
+				int chunkStartY = std::max(chunk.chunkY * TILEMAP_CHUNK_SIZE, 0);
+				int chunkEndX = std::min((chunk.chunkX + 1) * TILEMAP_CHUNK_SIZE, tileMap->GetWidth()) - 1;
+				int chunkEndY = std::min((chunk.chunkY + 1) * TILEMAP_CHUNK_SIZE, tileMap->GetHeight()) - 1;
+
+				// Tiles outside the map are kept but never drawn
+				if (chunk.tileCount > 0 && chunkStartX <= chunkEndX && chunkStartY <= chunkEndY)
+				{
+					startTileX = std::min(startTileX, chunkStartX);
+					startTileY = std::min(startTileY, chunkStartY);
+					endTileX = std::max(endTileX, chunkEndX);
+					endTileY = std::max(endTileY, chunkEndY);
+				}
+			}
+
+			if (startTileX <= endTileX && startTileY <= endTileY)
+			{
+				// Tiles are placed 2 grid spaces apart and drawn from their top left corner at the Transform scale
+				float tilesLeft = mapTopLeft.x + 2.0f * startTileX;
+				float tilesTop = mapTopLeft.y - 2.0f * startTileY;
+				float tilesRight = mapTopLeft.x + 2.0f * endTileX + fabs(tileWidth * scale.x * F_spriteScaleMultiplier);
+				float tilesBottom = mapTopLeft.y - 2.0f * endTileY - fabs(tileHeight * scale.y * F_spriteScaleMultiplier);
+				addRect(tilesTop, tilesRight, tilesBottom, tilesLeft);
+			}
+			else
+			{
+				// Nothing painted yet, the Scene View still draws the map's border
+				addCenteredRect(position, gridWidth, gridHeight);
+			}
+		}
+
+		Camera* camera = object.GetCamera();
+		if (camera != nullptr)
+		{
+			addCenteredRect(position, camera->GetWidth(), camera->GetHeight());
+		}
+
+		Canvas* canvas = object.GetCanvas();
+		if (canvas != nullptr)
+		{
+			addCenteredRect(position, canvas->GetWidth(), canvas->GetHeight());
+		}
+
+		Button* button = object.GetButton();
+		if (button != nullptr)
+		{
+			Vector2 activeOffset = button->GetActiveOffset();
+			addCenteredRect(Vector2(position.x + activeOffset.x * scale.x, position.y + activeOffset.y * scale.y), button->GetActiveWidth(), button->GetActiveHeight());
+		}
+
+		for (BoxCollider* boxCollider : object.GetBoxColliders())
+		{
+			Vector2 activeOffset = boxCollider->GetActiveOffset();
+			addCenteredRect(Vector2(position.x + activeOffset.x * scale.x, position.y + activeOffset.y * scale.y), boxCollider->GetActiveWidth(), boxCollider->GetActiveHeight());
+		}
+
+		for (CircleCollider* circleCollider : object.GetCircleColliders())
+		{
+			Vector2 activeOffset = circleCollider->GetActiveOffset();
+			float radius = circleCollider->GetActiveRadiusGrid();
+			addRect(position.y + activeOffset.y + radius, position.x + activeOffset.x + radius, position.y + activeOffset.y - radius, position.x + activeOffset.x - radius);
+		}
+
+		if (!b_hasBounds)
+		{
+			return false;
+		}
+
+		// Rotating around the position can reach any point within the furthest corner
+		if (rotation != 0)
+		{
+			float reachX = std::max(right - position.x, position.x - left);
+			float reachY = std::max(top - position.y, position.y - bottom);
+			float reach = std::sqrt((reachX * reachX) + (reachY * reachY));
+			top = position.y + reach;
+			right = position.x + reach;
+			bottom = position.y - reach;
+			left = position.x - reach;
+		}
+
+		edges = Vector4(top, right, bottom, left);
+		return true;
+	}
+
+	long long RenderIndex::GetCellKey(int cellX, int cellY)
+	{
+		return ((long long)cellX << 32) | (unsigned int)cellY;
+	}
+
+	int RenderIndex::GetCellCoord(float value)
+	{
+		return (int)std::floor(value / m_cellSize);
+	}
+
+	void RenderIndex::SetCells(S_Entry& entry)
+	{
+		entry.startCellX = GetCellCoord(entry.edges.w);
+		entry.endCellX = GetCellCoord(entry.edges.y);
+		entry.startCellY = GetCellCoord(entry.edges.z);
+		entry.endCellY = GetCellCoord(entry.edges.x);
+		long long cellCount = (long long)(entry.endCellX - entry.startCellX + 1) * (long long)(entry.endCellY - entry.startCellY + 1);
+		entry.b_oversized = cellCount > MAX_CELLS_PER_ENTRY;
+	}
+
+	void RenderIndex::Link(S_Entry* entry)
+	{
+		if (entry->b_oversized)
+		{
+			m_oversized.push_back(entry);
+			return;
+		}
+
+		for (int cellX = entry->startCellX; cellX <= entry->endCellX; cellX++)
+		{
+			for (int cellY = entry->startCellY; cellY <= entry->endCellY; cellY++)
+			{
+				m_cells[GetCellKey(cellX, cellY)].push_back(entry);
+			}
+		}
+	}
+
+	void RenderIndex::Unlink(S_Entry* entry)
+	{
+		if (entry->b_oversized)
+		{
+			m_oversized.erase(std::remove(m_oversized.begin(), m_oversized.end(), entry), m_oversized.end());
+			return;
+		}
+
+		for (int cellX = entry->startCellX; cellX <= entry->endCellX; cellX++)
+		{
+			for (int cellY = entry->startCellY; cellY <= entry->endCellY; cellY++)
+			{
+				std::unordered_map<long long, std::vector<S_Entry*>>::iterator cell = m_cells.find(GetCellKey(cellX, cellY));
+				if (cell != m_cells.end())
+				{
+					std::vector<S_Entry*>& cellEntries = cell->second;
+					cellEntries.erase(std::remove(cellEntries.begin(), cellEntries.end(), entry), cellEntries.end());
+					if (cellEntries.size() == 0)
+					{
+						m_cells.erase(cell);
+					}
+				}
+			}
+		}
+	}
+
+	void RenderIndex::IndexScene(std::map<long, GameObject>& sceneObjects)
+	{
+		for (std::pair<const long, GameObject>& sceneObject : sceneObjects)
+		{
+			S_Entry entry = S_Entry();
+			if (GetRenderBounds(sceneObject.second, entry.edges))
+			{
+				entry.id = sceneObject.first;
+				entry.object = &sceneObject.second;
+				entry.queryStamp = 0;
+				SetCells(entry);
+
+				S_Entry& storedEntry = m_entries[entry.id];
+				storedEntry = entry;
+				Link(&storedEntry);
+			}
+		}
+	}
+
+	// Moves the entry between cells only when the cells it covers changed, small movements just update the stored edges
+	void RenderIndex::RefreshEntry(long objectID)
+	{
+		GameObject* object = GetObjectByID(objectID);
+		std::unordered_map<long, S_Entry>::iterator entryIter = m_entries.find(objectID);
+		Vector4 edges = Vector4();
+
+		if (object == nullptr || !GetRenderBounds(*object, edges))
+		{
+			if (entryIter != m_entries.end())
+			{
+				Unlink(&entryIter->second);
+				m_entries.erase(entryIter);
+			}
+			return;
+		}
+
+		S_Entry entry = S_Entry();
+		entry.id = objectID;
+		entry.object = object;
+		entry.edges = edges;
+		entry.queryStamp = 0;
+		SetCells(entry);
+
+		if (entryIter != m_entries.end())
+		{
+			S_Entry& storedEntry = entryIter->second;
+			if (storedEntry.b_oversized == entry.b_oversized && storedEntry.startCellX == entry.startCellX && storedEntry.endCellX == entry.endCellX && storedEntry.startCellY == entry.startCellY && storedEntry.endCellY == entry.endCellY)
+			{
+				storedEntry.object = object;
+				storedEntry.edges = edges;
+				return;
+			}
+			Unlink(&storedEntry);
+			entry.queryStamp = storedEntry.queryStamp;
+			storedEntry = entry;
+			Link(&storedEntry);
+		}
+		else
+		{
+			S_Entry& storedEntry = m_entries[objectID];
+			storedEntry = entry;
+			Link(&storedEntry);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+#include "Vector2.h"
+#include "Vector4.h"
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace FlatEngine
+{
+	class GameObject;
+
+	const int MAX_CELLS_PER_ENTRY = 256;
+	const int MAX_DIRTY_RENDER_OBJECTS = 4096; // past this one full rebuild is cheaper than refreshing one by one
+
+	// Uniform grid of GameObject render bounds in grid space, so the Game View and Scene View only visit what can be seen.
+	// Bounds are only recalculated for objects marked dirty, Transforms and the components that change an objects size call MarkDirty
+	// through Component::MarkRenderBoundsDirty(). Clear() drops everything and the next Update() re-indexes both loaded scenes.
+	// Objects covering more than MAX_CELLS_PER_ENTRY cells (large TileMaps) are kept out of the grid and returned by every query.
+	class RenderIndex
+	{
+	public:
+		RenderIndex(float cellSize = 16.0f);
+		~RenderIndex();
+
+		void Clear();
+		void MarkDirty(long objectID);
+		void Remove(long objectID);
+		void Update();
+		//Vector4(top, right, bottom, left) in grid space, results are in GameObject ID order
+		std::vector<GameObject*>& Query(Vector4 edges);
+		int GetEntryCount();
+		float GetUpdateTime();
+		static bool GetRenderBounds(GameObject& object, Vector4& edges);
+
+	private:
+		struct S_Entry
+		{
+			long id;
+			GameObject* object;
+			Vector4 edges;
+			int startCellX;
+			int startCellY;
+			int endCellX;
+			int endCellY;
+			bool b_oversized;
+			unsigned int queryStamp;
+		};
+
+		long long GetCellKey(int cellX, int cellY);
+		int GetCellCoord(float value);
+		void SetCells(S_Entry& entry);
+		void Link(S_Entry* entry);
+		void Unlink(S_Entry* entry);
+		void IndexScene(std::map<long, GameObject>& sceneObjects);
+		void RefreshEntry(long objectID);
+
+		float m_cellSize;
+		std::unordered_map<long, S_Entry> m_entries;
+		std::unordered_map<long long, std::vector<S_Entry*>> m_cells;
+		std::vector<S_Entry*> m_oversized;
+		std::unordered_set<long> m_dirtyIDs; // a set so an object moved many times between updates is only refreshed once
+		std::vector<S_Entry*> m_visited;
+		std::vector<GameObject*> m_results;
+		unsigned int m_queryStamp;
+		bool m_b_rebuildAll;
+		float m_updateTime; // microseconds
+	};
+}
\ No newline at end of file
@@ -28,12 +28,12 @@ namespace FlatEngine
         // antialiasing
         m_msaaSamples = VK_SAMPLE_COUNT_1_BIT;
         m_colorImage = VK_NULL_HANDLE;
-        m_colorImageMemory = VK_NULL_HANDLE;
+        m_colorImageMemory = MemoryAllocation();
         m_colorImageView = VK_NULL_HANDLE;
         m_b_msaaEnabled = false;
         // depth testing
         m_depthImage = VK_NULL_HANDLE;
-        m_depthImageMemory = VK_NULL_HANDLE;
+        m_depthImageMemory = MemoryAllocation();
         m_depthImageView = VK_NULL_HANDLE;
         m_b_depthBuffersEnabled = false;
         // handles
@@ -301,7 +301,7 @@ namespace FlatEngine
         {
             vkDestroyImageView(m_deviceHandle->GetDevice(), m_colorImageView, nullptr);
             vkDestroyImage(m_deviceHandle->GetDevice(), m_colorImage, nullptr);
-            vkFreeMemory(m_deviceHandle->GetDevice(), m_colorImageMemory, nullptr);
+            VM_memoryAllocator.Free(m_colorImageMemory);
         }
     }
 
@@ -328,11 +328,11 @@ namespace FlatEngine
         {
             vkDestroyImageView(m_deviceHandle->GetDevice(), m_depthImageView, nullptr);
             vkDestroyImage(m_deviceHandle->GetDevice(), m_depthImage, nullptr);
-            vkFreeMemory(m_deviceHandle->GetDevice(), m_depthImageMemory, nullptr);
+            VM_memoryAllocator.Free(m_depthImageMemory);
         }
     }
 
-    void RenderPass::BeginRenderPass(uint32_t imageIndex)
+    void RenderPass::BeginRenderPass(uint32_t imageIndex, VkSubpassContents contents)
     {
         // Reset to make sure it is able to be recorded
         vkResetCommandBuffer(m_commandBuffers[VM_currentFrame], 0);
@@ -388,7 +388,7 @@ namespace FlatEngine
         scissor.extent = m_winSystem->GetExtent();
         vkCmdSetScissor(m_commandBuffers[VM_currentFrame], 0, 1, &scissor);
 
-        vkCmdBeginRenderPass(m_commandBuffers[VM_currentFrame], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdBeginRenderPass(m_commandBuffers[VM_currentFrame], &renderPassInfo, contents);
     }
 
     void RenderPass::EndRenderPass()
@@ -425,7 +425,7 @@ namespace FlatEngine
         vkCmdBindPipeline(m_commandBuffers[VM_currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
     }
 
-    void RenderPass::DrawIndexed(Mesh& mesh)
+    void RenderPass::DrawIndexed(Mesh& mesh, uint32_t uniformOffset)
     {
         VkPipelineLayout& pipelineLayout = mesh.GetMaterial()->GetPipelineLayout();
         VkDescriptorSet& descriptorSet = mesh.GetDescriptorSets()[VM_currentFrame];
@@ -439,7 +439,7 @@ namespace FlatEngine
 
         vkCmdBindIndexBuffer(m_commandBuffers[VM_currentFrame], indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
-        vkCmdBindDescriptorSets(m_commandBuffers[VM_currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+        vkCmdBindDescriptorSets(m_commandBuffers[VM_currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 1, &uniformOffset);
 
         // Refer to - https://vulkan-tutorial.com/en/Vertex_buffers/Index_buffer
         vkCmdDrawIndexed(m_commandBuffers[VM_currentFrame], static_cast<uint32_t>(indices.size()), 1, 0, 0, 0); // reusing vertices with index buffers.
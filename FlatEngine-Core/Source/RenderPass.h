@@ -42,8 +42,8 @@ namespace FlatEngine
 		void DestroyCommandBuffers();
 		std::vector<VkCommandBuffer>& GetCommandBuffers();		
 		void RecordCommandBuffer(uint32_t imageIndex, Mesh& mesh);
-		void DrawIndexed(Mesh& mesh);
-		void BeginRenderPass(uint32_t imageIndex);
+		void DrawIndexed(Mesh& mesh, uint32_t uniformOffset = 0);
+		void BeginRenderPass(uint32_t imageIndex, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 		void EndRenderPass();
 
 	private:
@@ -64,12 +64,12 @@ namespace FlatEngine
 		// antialiasing
 		VkSampleCountFlagBits m_msaaSamples;
 		VkImage m_colorImage;
-		VkDeviceMemory m_colorImageMemory;
+		MemoryAllocation m_colorImageMemory;
 		VkImageView m_colorImageView;
 		bool m_b_msaaEnabled;
 		// depth buffers
 		VkImage m_depthImage;
-		VkDeviceMemory m_depthImageMemory;
+		MemoryAllocation m_depthImageMemory;
 		VkImageView m_depthImageView;
 		bool m_b_depthBuffersEnabled;
 		// handles
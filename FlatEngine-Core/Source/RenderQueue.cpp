@@ -0,0 +1,163 @@
+#include "RenderQueue.h"
+#include "FlatEngine.h"
+
+
+namespace FlatEngine
+{
+	RenderQueue::RenderQueue()
+	{
+		m_items = std::vector<RenderItem>();
+		m_sortEntries = std::vector<S_SortEntry>();
+		m_sortScratch = std::vector<S_SortEntry>();
+		m_textureSortIDs = std::unordered_map<VkDescriptorSet, unsigned int>();
+		m_batchCount = 0;
+		m_objectCount = 0;
+		m_extractionTime = 0;
+		m_extractionStart = 0;
+		m_sortTime = 0;
+	}
+
+	RenderQueue::~RenderQueue()
+	{
+	}
+
+	void RenderQueue::BeginExtraction()
+	{
+		m_items.clear();
+		m_sortEntries.clear();
+		m_batchCount = 0;
+		m_extractionStart = GetTimeInMicroseconds();
+	}
+
+	void RenderQueue::EndExtraction(int objectCount)
+	{
+		m_objectCount = objectCount;
+		m_extractionTime = (float)(GetTimeInMicroseconds() - m_extractionStart);
+	}
+
+	void RenderQueue::AddItem(RenderItem item)
+	{
+		// Out of range render orders have always been drawn on the bottom layer
+		unsigned long long layer = 0;
+		if (item.renderOrder <= F_maxSpriteLayers && item.renderOrder >= 0)
+		{
+			layer = (unsigned long long)item.renderOrder;
+		}
+
+		item.sortKey = (layer << 48) | ((unsigned long long)GetTextureSortID(item.texture) << 32) | (unsigned long long)m_items.size();
+		m_items.push_back(item);
+	}
+
+	// Textures keep their ID between frames, only once more than 16 bits worth have been seen are they handed out again
+	unsigned int RenderQueue::GetTextureSortID(VkDescriptorSet texture)
+	{
+		std::unordered_map<VkDescriptorSet, unsigned int>::iterator sortID = m_textureSortIDs.find(texture);
+		if (sortID != m_textureSortIDs.end())
+		{
+			return sortID->second;
+		}
+
+		if (m_textureSortIDs.size() > 0xFFFF)
+		{
+			m_textureSortIDs.clear();
+		}
+
+		unsigned int newID = (unsigned int)m_textureSortIDs.size();
+		m_textureSortIDs.emplace(texture, newID);
+		return newID;
+	}
+
+	// LSD radix sort, 8 bits per pass, skipping the passes where every key has the same byte (usually most of the layer and texture bytes)
+	void RenderQueue::Sort()
+	{
+		double sortStart = GetTimeInMicroseconds();
+		int itemCount = (int)m_items.size();
+		m_sortEntries.resize(itemCount);
+		m_sortScratch.resize(itemCount);
+
+		for (int i = 0; i < itemCount; i++)
+		{
+			m_sortEntries[i].key = m_items[i].sortKey;
+			m_sortEntries[i].index = i;
+		}
+
+		int histograms[8][256] = {};
+		for (S_SortEntry& entry : m_sortEntries)
+		{
+			for (int pass = 0; pass < 8; pass++)
+			{
+				histograms[pass][(entry.key >> (pass * 8)) & 0xFF]++;
+			}
+		}
+
+		for (int pass = 0; pass < 8; pass++)
+		{
+			int* histogram = histograms[pass];
+			if (itemCount == 0 || histogram[(m_sortEntries[0].key >> (pass * 8)) & 0xFF] == itemCount)
+			{
+				continue;
+			}
+
+			int offset = 0;
+			for (int bucket = 0; bucket < 256; bucket++)
+			{
+				int count = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += count;
+			}
+			for (S_SortEntry& entry : m_sortEntries)
+			{
+				m_sortScratch[histogram[(entry.key >> (pass * 8)) & 0xFF]++] = entry;
+			}
+			m_sortEntries.swap(m_sortScratch);
+		}
+
+		m_batchCount = 0;
+		VkDescriptorSet lastTexture = VK_NULL_HANDLE;
+		for (S_SortEntry& entry : m_sortEntries)
+		{
+			if (m_batchCount == 0 || m_items[entry.index].texture != lastTexture)
+			{
+				lastTexture = m_items[entry.index].texture;
+				m_batchCount++;
+			}
+		}
+
+		m_sortTime = (float)(GetTimeInMicroseconds() - sortStart);
+	}
+
+	RenderItem& RenderQueue::GetSortedItem(int index)
+	{
+		return m_items[m_sortEntries[index].index];
+	}
+
+	std::vector<RenderItem>& RenderQueue::GetItems()
+	{
+		return m_items;
+	}
+
+	int RenderQueue::GetItemCount()
+	{
+		return (int)m_items.size();
+	}
+
+	int RenderQueue::GetObjectCount()
+	{
+		return m_objectCount;
+	}
+
+	int RenderQueue::GetBatchCount()
+	{
+		return m_batchCount;
+	}
+
+	float RenderQueue::GetExtractionTime()
+	{
+		return m_extractionTime;
+	}
+
+	float RenderQueue::GetSortTime()
+	{
+		return m_sortTime;
+	}
+}
\ No newline at end of file
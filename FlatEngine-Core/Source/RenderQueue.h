@@ -0,0 +1,73 @@
+#pragma once
+#include "Vector2.h"
+
+#include <vector>
+#include <unordered_map>
+#include "imgui.h"
+
+#define GLFW_INCLUDE_VULKAN
+#include <glfw3.h>
+
+
+namespace FlatEngine
+{
+	// Everything AddImageToDrawList() needs to draw one textured quad
+	struct RenderItem
+	{
+		VkDescriptorSet texture;
+		Vector2 position;       // grid space
+		float textureWidth;
+		float textureHeight;
+		Vector2 offset;
+		Vector2 scale;
+		float rotation;
+		ImU32 tintColor;
+		Vector2 uvStart;
+		Vector2 uvEnd;
+		int renderOrder;
+		bool b_scalesWithZoom;
+		unsigned long long sortKey;
+	};
+
+	// Flat per-frame buffer of the visible sprites, texts and tiles, filled by Game_RenderObjects() before anything is drawn.
+	// The buffer keeps its capacity between frames so extraction does not allocate once the scene has settled.
+	// Each item gets a 64 bit sort key | layer (16) | texture (16) | submission order (32) | so after Sort() items are drawn
+	// layer by layer with the draws sharing a texture next to each other, which ImGui merges into a single draw command.
+	class RenderQueue
+	{
+	public:
+		RenderQueue();
+		~RenderQueue();
+
+		void BeginExtraction();
+		void EndExtraction(int objectCount);
+		void AddItem(RenderItem item);
+		void Sort();
+		std::vector<RenderItem>& GetItems();
+		RenderItem& GetSortedItem(int index);
+		int GetItemCount();
+		int GetObjectCount();
+		int GetBatchCount();
+		float GetExtractionTime();
+		float GetSortTime();
+
+	private:
+		struct S_SortEntry
+		{
+			unsigned long long key;
+			int index;
+		};
+
+		unsigned int GetTextureSortID(VkDescriptorSet texture);
+
+		std::vector<RenderItem> m_items;
+		std::vector<S_SortEntry> m_sortEntries;
+		std::vector<S_SortEntry> m_sortScratch;
+		std::unordered_map<VkDescriptorSet, unsigned int> m_textureSortIDs;
+		int m_batchCount;
+		int m_objectCount;
+		float m_extractionTime;  // microseconds
+		double m_extractionStart;
+		float m_sortTime;  // microseconds
+	};
+}
\ No newline at end of file
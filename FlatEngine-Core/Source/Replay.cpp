@@ -0,0 +1,240 @@
+#include "Replay.h"
+#include "FlatEngine.h"
+
+#include <fstream>
+#include <sstream>
+
+
+namespace FlatEngine
+{
+	Replay::Replay()
+	{
+		m_steps = std::vector<S_ReplayStep>();
+		m_pendingEvents = std::vector<SDL_Event>();
+		m_b_recording = false;
+		m_b_playing = false;
+		m_currentStep = 0;
+		m_mismatchStep = -1;
+	}
+
+	Replay::~Replay()
+	{
+	}
+
+	void Replay::StartRecording()
+	{
+		m_steps.clear();
+		m_pendingEvents.clear();
+		m_b_playing = false;
+		m_b_recording = true;
+	}
+
+	void Replay::StopRecording()
+	{
+		m_b_recording = false;
+	}
+
+	bool Replay::IsRecording()
+	{
+		return m_b_recording;
+	}
+
+	void Replay::RecordEvent(SDL_Event event)
+	{
+		m_pendingEvents.push_back(event);
+	}
+
+	// Input dispatched since the last step belongs to the step that just ran
+	void Replay::RecordStep(unsigned long long stateHash)
+	{
+		S_ReplayStep step = S_ReplayStep();
+		step.events = m_pendingEvents;
+		step.stateHash = stateHash;
+		m_steps.push_back(step);
+		m_pendingEvents.clear();
+	}
+
+	void Replay::StartPlayback()
+	{
+		m_b_recording = false;
+		m_currentStep = 0;
+		m_mismatchStep = -1;
+		m_b_playing = m_steps.size() > 0;
+	}
+
+	void Replay::StopPlayback()
+	{
+		m_b_playing = false;
+	}
+
+	bool Replay::IsPlaying()
+	{
+		return m_b_playing;
+	}
+
+	std::vector<SDL_Event>& Replay::GetStepEvents()
+	{
+		static std::vector<SDL_Event> noEvents = std::vector<SDL_Event>();
+
+		if (m_b_playing && m_currentStep < (long)m_steps.size())
+		{
+			return m_steps[m_currentStep].events;
+		}
+		return noEvents;
+	}
+
+	bool Replay::VerifyStep(unsigned long long stateHash)
+	{
+		if (!m_b_playing)
+		{
+			return false;
+		}
+
+		bool b_matches = m_steps[m_currentStep].stateHash == stateHash;
+
+		if (!b_matches)
+		{
+			std::stringstream message;
+			message << "Replay desync at step " << m_currentStep << ": expected state hash " << std::hex << m_steps[m_currentStep].stateHash << " got " << stateHash;
+			LogError(message.str());
+			m_mismatchStep = m_currentStep;
+			m_b_playing = false;
+		}
+		else
+		{
+			m_currentStep++;
+			if (m_currentStep >= (long)m_steps.size())
+			{
+				m_b_playing = false;
+			}
+		}
+
+		return b_matches;
+	}
+
+	bool Replay::HasMismatch()
+	{
+		return m_mismatchStep != -1;
+	}
+
+	long Replay::GetMismatchStep()
+	{
+		return m_mismatchStep;
+	}
+
+	long Replay::GetCurrentStep()
+	{
+		return m_currentStep;
+	}
+
+	long Replay::GetStepCount()
+	{
+		return (long)m_steps.size();
+	}
+
+	// Only the event fields read by HandleContextEvents() are saved
+	bool Replay::SaveToFile(std::string path)
+	{
+		json steps = json::array();
+
+		for (S_ReplayStep& step : m_steps)
+		{
+			json events = json::array();
+
+			for (SDL_Event& event : step.events)
+			{
+				json eventJson = { { "type", event.type } };
+
+				if (event.type == SDL_KEYDOWN || event.type == SDL_KEYUP)
+				{
+					eventJson["key"] = event.key.keysym.sym;
+				}
+				else if (event.type == SDL_JOYAXISMOTION)
+				{
+					eventJson["axis"] = event.jaxis.axis;
+					eventJson["axisValue"] = event.jaxis.value;
+				}
+				else if (event.type == SDL_JOYBUTTONDOWN || event.type == SDL_JOYBUTTONUP)
+				{
+					eventJson["button"] = event.jbutton.button;
+				}
+				else if (event.type == SDL_JOYHATMOTION)
+				{
+					eventJson["hat"] = event.jhat.value;
+				}
+
+				events.push_back(eventJson);
+			}
+
+			steps.push_back({
+				{ "stateHash", step.stateHash },
+				{ "events", events }
+			});
+		}
+
+		std::ofstream fileObject;
+		fileObject.open(path, std::ofstream::out | std::ofstream::trunc);
+
+		if (!fileObject.good())
+		{
+			LogError("Could not save replay to " + path);
+			return false;
+		}
+
+		json newFileObject = json::object({ { "Replay Steps", steps } });
+		fileObject << newFileObject.dump().c_str() << std::endl;
+		fileObject.close();
+
+		return true;
+	}
+
+	bool Replay::LoadFromFile(std::string path)
+	{
+		json replayData = LoadFileData(path);
+
+		if (replayData == nullptr || !replayData.contains("Replay Steps"))
+		{
+			LogError("Could not load replay from " + path);
+			return false;
+		}
+
+		m_steps.clear();
+
+		for (json& stepJson : replayData["Replay Steps"])
+		{
+			S_ReplayStep step = S_ReplayStep();
+			step.stateHash = stepJson["stateHash"].get<unsigned long long>();
+
+			for (json& eventJson : stepJson["events"])
+			{
+				SDL_Event event;
+				SDL_zero(event);
+				event.type = eventJson["type"].get<Uint32>();
+
+				if (event.type == SDL_KEYDOWN || event.type == SDL_KEYUP)
+				{
+					event.key.keysym.sym = eventJson["key"].get<SDL_Keycode>();
+				}
+				else if (event.type == SDL_JOYAXISMOTION)
+				{
+					event.jaxis.axis = eventJson["axis"].get<Uint8>();
+					event.jaxis.value = eventJson["axisValue"].get<Sint16>();
+				}
+				else if (event.type == SDL_JOYBUTTONDOWN || event.type == SDL_JOYBUTTONUP)
+				{
+					event.jbutton.button = eventJson["button"].get<Uint8>();
+				}
+				else if (event.type == SDL_JOYHATMOTION)
+				{
+					event.jhat.value = eventJson["hat"].get<Uint8>();
+				}
+
+				step.events.push_back(event);
+			}
+
+			m_steps.push_back(step);
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include "SDL.h" // SDL_Event
+
+#include <string>
+#include <vector>
+
+
+namespace FlatEngine
+{
+	// Records the input dispatched before each GameLoop step along with a hash of the simulation state after it.
+	// Playing a recording back feeds the same input to the same steps and checks the hashes match, the first mismatch stops playback.
+	class Replay
+	{
+	public:
+		Replay();
+		~Replay();
+
+		void StartRecording();
+		void StopRecording();
+		bool IsRecording();
+		void RecordEvent(SDL_Event event);
+		void RecordStep(unsigned long long stateHash);
+
+		void StartPlayback();
+		void StopPlayback();
+		bool IsPlaying();
+		std::vector<SDL_Event>& GetStepEvents();
+		bool VerifyStep(unsigned long long stateHash);
+		bool HasMismatch();
+		long GetMismatchStep();
+		long GetCurrentStep();
+		long GetStepCount();
+
+		bool SaveToFile(std::string path);
+		bool LoadFromFile(std::string path);
+
+	private:
+		struct S_ReplayStep
+		{
+			std::vector<SDL_Event> events;
+			unsigned long long stateHash;
+		};
+
+		std::vector<S_ReplayStep> m_steps;
+		std::vector<SDL_Event> m_pendingEvents;
+		bool m_b_recording;
+		bool m_b_playing;
+		long m_currentStep;
+		long m_mismatchStep;
+	};
+}
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include "GameLoop.h"
 #include "ECSManager.h"
 #include "TileMap.h"
+#include "RenderIndex.h"
 #include "FlatEngine.h"
 
 namespace FL = FlatEngine;
@@ -73,6 +74,7 @@ namespace FlatEngine
 	void Scene::UnloadSceneObjects()
 	{
 		m_sceneObjects.clear();
+		F_RenderIndex.Clear();
 	}
 
 	GameObject* Scene::AddSceneObject(GameObject sceneObject)
@@ -80,6 +82,7 @@ namespace FlatEngine
 		long id = sceneObject.GetID();
 		m_sceneObjects.emplace(id, sceneObject);
 		KeepNextGameObjectIDUpToDate(id);
+		F_RenderIndex.MarkDirty(id);
 
 		if (sceneObject.HasComponent("BoxCollider") || (sceneObject.HasComponent("TileMap") && sceneObject.GetTileMap()->GetCollisionAreas().size() > 0))
 		{
@@ -229,6 +232,7 @@ namespace FlatEngine
 			}
 		}
 
+		F_RenderIndex.Remove(ID);
 		m_sceneObjects.erase(ID);
 		m_freedGameObjectIDs.push_back(ID);
 	}
@@ -356,18 +360,21 @@ namespace FlatEngine
 	Transform* Scene::AddTransform(Transform transform, long ownerID)
 	{
 		KeepNextComponentIDUpToDate(transform.GetID());
+		F_RenderIndex.MarkDirty(ownerID);
 		return m_ECSManager.AddTransform(transform, ownerID);
 	}
 
 	Sprite* Scene::AddSprite(Sprite sprite, long ownerID)
 	{
 		KeepNextComponentIDUpToDate(sprite.GetID());
+		F_RenderIndex.MarkDirty(ownerID);
 		return m_ECSManager.AddSprite(sprite, ownerID);
 	}
 
 	Camera* Scene::AddCamera(Camera camera, long ownerID)
 	{
 		KeepNextComponentIDUpToDate(camera.GetID());
+		F_RenderIndex.MarkDirty(ownerID);
 		return m_ECSManager.AddCamera(camera, ownerID);
 	}
 
@@ -380,6 +387,7 @@ namespace FlatEngine
 	Canvas* Scene::AddCanvas(Canvas canvas, long ownerID)
 	{
 		KeepNextComponentIDUpToDate(canvas.GetID());
+		F_RenderIndex.MarkDirty(ownerID);
 		return m_ECSManager.AddCanvas(canvas, ownerID);
 	}
 
@@ -392,6 +400,7 @@ namespace FlatEngine
 	Text* Scene::AddText(Text text, long ownerID)
 	{
 		KeepNextComponentIDUpToDate(text.GetID());
+		F_RenderIndex.MarkDirty(ownerID);
 		return m_ECSManager.AddText(text, ownerID);
 	}
 
@@ -404,12 +413,14 @@ namespace FlatEngine
 	BoxCollider* Scene::AddBoxCollider(BoxCollider collider, long ownerID)
 	{
 		KeepNextComponentIDUpToDate(collider.GetID());
+		F_RenderIndex.MarkDirty(ownerID);
 		return m_ECSManager.AddBoxCollider(collider, ownerID);
 	}
 
 	CircleCollider* Scene::AddCircleCollider(CircleCollider collider, long ownerID)
 	{
 		KeepNextComponentIDUpToDate(collider.GetID());
+		F_RenderIndex.MarkDirty(ownerID);
 		return m_ECSManager.AddCircleCollider(collider, ownerID);
 	}
 
@@ -422,6 +433,7 @@ namespace FlatEngine
 	Button* Scene::AddButton(Button button, long ownerID)
 	{
 		KeepNextComponentIDUpToDate(button.GetID());
+		F_RenderIndex.MarkDirty(ownerID);
 		return m_ECSManager.AddButton(button, ownerID);
 	}
 
@@ -440,12 +452,14 @@ namespace FlatEngine
 	TileMap* Scene::AddTileMap(TileMap tileMap, long ownerID)
 	{
 		KeepNextComponentIDUpToDate(tileMap.GetID());
+		F_RenderIndex.MarkDirty(ownerID);
 		return m_ECSManager.AddTileMap(tileMap, ownerID);
 	}
 
 	void Scene::RemoveComponent(Component* component)
 	{
 		long ID = component->GetID();
+		F_RenderIndex.MarkDirty(component->GetParentID());
 		if (m_ECSManager.RemoveComponent(component))
 		{
 			m_freedComponentIDs.push_back(ID);
@@ -1,9 +1,15 @@
 #include "SceneManager.h"
 #include "FlatEngine.h"
+#include "ContactCache.h"
+#include "SpatialIndex.h"
+#include "RenderIndex.h"
+#include "VirtualFileSystem.h"
+#include "JsonStream.h"
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <filesystem>
 #include <SDL.h>
 
 
@@ -23,6 +29,7 @@ namespace FlatEngine
 	Scene *SceneManager::CreateNewScene()
 	{
 		m_loadedScene = Scene();
+		F_RenderIndex.Clear();
 		return &m_loadedScene;
 	}
 
@@ -80,56 +87,70 @@ namespace FlatEngine
 			pointToPath = loadFrom;
 		}
 		bool b_success = true;
+		std::string previousPath = m_loadedScenePath;
 
 		m_loadedScene.UnloadSceneObjects();
 		m_loadedScene.UnloadECSManager();
+		F_b_colliderPairsStale = true;
+		F_ContactCache.Clear();
+		F_SpatialIndex.Clear();
 
-		std::ofstream file_obj;
-		std::ifstream ifstream(loadFrom);
-
-		file_obj.open(loadFrom, std::ios::in);
-		std::string fileContent = "";
-
-		if (file_obj.good())
-		{
-			std::string line;
-			while (!ifstream.eof()) 
-			{
-				std::getline(ifstream, line);
-				if (line != "")
-				{
-					fileContent.append(line + "\n");
-				}
-			}
-		}
+		FileData sceneFile;
 
-		file_obj.close();
-
-		if (file_obj.good() && fileContent != "")
+		if (F_VirtualFileSystem.Read(loadFrom, sceneFile) && sceneFile.GetSize() > 0)
 		{
 			m_loadedScene = Scene();
 			m_loadedScenePath = pointToPath;
 			m_loadedScene.SetPath(pointToPath);
 			m_loadedScene.SetName(GetFilenameFromPath(pointToPath, false));
 
-			json fileContentJson = json::parse(fileContent);
+			bool b_hasObjects = false;
+			std::string parseError = "";
 
-			if (fileContentJson.contains("Scene GameObjects") && fileContentJson["Scene GameObjects"][0] != "NULL")
+			// Each GameObject is created as soon as its json is parsed, the json of the whole scene never exists at once
+			bool b_parsed = JsonArrayStream::Parse(sceneFile.GetData(), sceneFile.GetSize(), "Scene GameObjects", [&](json& objectJson)
 			{
-				auto firstObjectName = fileContentJson["Scene GameObjects"];
+				// Saved in place of the objects of an empty scene
+				if (objectJson == "NULL")
+				{
+					return true;
+				}
+				b_hasObjects = true;
 
-				// Loop through the saved GameObjects in the JSON file
-				for (int i = 0; i < fileContentJson["Scene GameObjects"].size(); i++)
+				// Add created GameObject to our freshScene
+				GameObject *loadedObject = CreateObjectFromJson(std::move(objectJson), &m_loadedScene);
+				// Check for primary camera
+				if (loadedObject != nullptr && loadedObject->HasComponent("Camera") && loadedObject->GetCamera()->IsPrimary())
 				{
-					// Add created GameObject to our freshScene
-					GameObject *loadedObject = CreateObjectFromJson(fileContentJson["Scene GameObjects"][i], &m_loadedScene);
-					// Check for primary camera
-					if (loadedObject != nullptr && loadedObject->HasComponent("Camera") && loadedObject->GetCamera()->IsPrimary())
-					{
-						m_loadedScene.SetPrimaryCamera(loadedObject->GetCamera());
-					}
+					m_loadedScene.SetPrimaryCamera(loadedObject->GetCamera());
 				}
+				return true;
+			}, parseError);
+
+			if (!b_parsed)
+			{
+				LogError("Failed to parse scene: " + pointToPath + "\n" + parseError);
 
+				// Drop the objects created before the error so a save can't write the partial scene over the file
+				m_loadedScene.UnloadSceneObjects();
+				m_loadedScene.UnloadECSManager();
+				m_loadedScene = Scene();
+				m_loadedScenePath = "";
+				F_b_colliderPairsStale = true;
+				F_ContactCache.Clear();
+				F_SpatialIndex.Clear();
+				F_RenderIndex.Clear();
+
+				// The previous scene was already unloaded, so it comes back from its file rather than just its path being restored
+				if (previousPath != "" && previousPath != loadFrom && previousPath != pointToPath)
+				{
+					LoadScene(previousPath);
+				}
+				return false;
+			}
+
+			if (b_hasObjects)
+			{
 				// Just in case any parent objects had not been created at the time of children being created on scene load,
 				// loop through objects with parents and add them as children to their parent objects
 				for (std::pair<long, GameObject> sceneObject : GetLoadedScene()->GetSceneObjects())
@@ -180,4 +201,88 @@ namespace FlatEngine
 	{
 		m_loadedScene.SetAnimatorPreviewObjects(m_animatorPreviewObjects);
 	}
+
+	// Writes a generated scene of about megabytes MB and times, in milliseconds, the getline loop scenes used to be read with plus
+	// json::parse, one read parsed in place (LoadFileData) and the streamed parse LoadScene() uses. No GameObjects are created.
+	bool SceneManager::MeasureLoadTimes(int megabytes, float& lineReadTime, float& singleReadTime, float& streamTime)
+	{
+		lineReadTime = 0;
+		singleReadTime = 0;
+		streamTime = 0;
+		std::error_code error;
+		std::string scenePath = (std::filesystem::temp_directory_path(error) / "FlatEngineLoadBenchmark.scn").string();
+		if (megabytes <= 0 || error)
+		{
+			return false;
+		}
+
+		{
+			std::ofstream file(scenePath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				return false;
+			}
+
+			uint64_t targetSize = (uint64_t)megabytes * 1024 * 1024;
+			uint64_t written = 0;
+			long objectID = 0;
+			file << "{\n    \"Scene GameObjects\": [\n";
+			while (written < targetSize)
+			{
+				json transform = json::object({ { "type", "Transform" }, { "id", objectID * 2 }, { "_isActive", true }, { "_isCollapsed", false },
+					{ "xPos", objectID % 200 * 16.0f }, { "yPos", objectID / 200 * 16.0f }, { "xScale", 1.0f }, { "yScale", 1.0f }, { "xOrigin", 0.0f }, { "yOrigin", 0.0f }, { "rotation", 0.0f } });
+				json sprite = json::object({ { "type", "Sprite" }, { "id", objectID * 2 + 1 }, { "_isActive", true }, { "_isCollapsed", false },
+					{ "path", "..\\projects\\Benchmark\\images\\tile.png" }, { "pivotPoint", "PivotCenter" }, { "renderOrder", objectID % 30 },
+					{ "tintColorX", 1.0f }, { "tintColorY", 1.0f }, { "tintColorZ", 1.0f }, { "tintColorW", 1.0f }, { "xOffset", 8.0f }, { "yOffset", 8.0f }, { "xScale", 1.0f }, { "yScale", 1.0f } });
+				json object = json::object({ { "name", "Object" + std::to_string(objectID) }, { "id", objectID }, { "parent", -1 }, { "children", json::array() },
+					{ "_isActive", true }, { "_isPersistant", false }, { "_isPrefab", false }, { "prefabName", "" }, { "components", json::array({ transform, sprite }) } });
+
+				std::string objectText = (objectID > 0 ? ",\n" : "") + object.dump(4);
+				file << objectText;
+				written += objectText.size();
+				objectID++;
+			}
+			file << "\n    ]\n}\n";
+		}
+
+		// As LoadFileData() and LoadScene() read files before they shared VirtualFileSystem::Read()
+		double start = GetTimeInMicroseconds();
+		{
+			std::ofstream fileObject;
+			std::ifstream ifstream(scenePath);
+			fileObject.open(scenePath, std::ios::in);
+			std::string fileContent = "";
+			if (fileObject.good())
+			{
+				std::string line;
+				while (!ifstream.eof())
+				{
+					std::getline(ifstream, line);
+					fileContent.append(line + "\n");
+				}
+			}
+			fileObject.close();
+			json sceneJson = json::parse(fileContent);
+		}
+		lineReadTime = (float)(GetTimeInMicroseconds() - start) / 1000;
+
+		start = GetTimeInMicroseconds();
+		{
+			json sceneJson = LoadFileData(scenePath);
+		}
+		singleReadTime = (float)(GetTimeInMicroseconds() - start) / 1000;
+
+		start = GetTimeInMicroseconds();
+		bool b_parsed = false;
+		{
+			FileData sceneFile;
+			std::string parseError = "";
+			b_parsed = F_VirtualFileSystem.Read(scenePath, sceneFile) &&
+				JsonArrayStream::Parse(sceneFile.GetData(), sceneFile.GetSize(), "Scene GameObjects", [](json& objectJson) { return true; }, parseError);
+		}
+		streamTime = (float)(GetTimeInMicroseconds() - start) / 1000;
+
+		std::filesystem::remove(scenePath, error);
+		return b_parsed;
+	}
 }
\ No newline at end of file
@@ -27,6 +27,7 @@ namespace FlatEngine
 		std::string GetLoadedScenePath();
 		void SaveAnimationPreviewObjects();
 		void LoadAnimationPreviewObjects();
+		static bool MeasureLoadTimes(int megabytes, float& lineReadTime, float& singleReadTime, float& streamTime);
 
 	private:
 		Scene m_loadedScene;
@@ -0,0 +1,423 @@
+#include "SpatialIndex.h"
+#include "Collider.h"
+
+#include <cmath>
+#include <climits>
+#include <algorithm>
+
+
+namespace FlatEngine
+{
+	SpatialIndex::SpatialIndex(float cellSize)
+	{
+		m_cellSize = cellSize;
+		m_entries = std::vector<S_Entry>();
+		m_cells = std::unordered_map<long long, std::vector<int>>();
+		m_queryStamp = 0;
+		m_minCellX = INT_MAX;
+		m_minCellY = INT_MAX;
+		m_maxCellX = INT_MIN;
+		m_maxCellY = INT_MIN;
+	}
+
+	SpatialIndex::~SpatialIndex()
+	{
+	}
+
+	// Only the cells live entries cover are erased, so clearing costs what is in the index now rather than every cell ever touched
+	void SpatialIndex::Clear()
+	{
+		for (S_Entry& entry : m_entries)
+		{
+			if (entry.collider == nullptr)
+			{
+				continue;
+			}
+			for (int cellX = GetCellCoord(entry.left); cellX <= GetCellCoord(entry.right); cellX++)
+			{
+				for (int cellY = GetCellCoord(entry.bottom); cellY <= GetCellCoord(entry.top); cellY++)
+				{
+					m_cells.erase(GetCellKey(cellX, cellY));
+				}
+			}
+		}
+		m_entries.clear();
+		m_minCellX = INT_MAX;
+		m_minCellY = INT_MAX;
+		m_maxCellX = INT_MIN;
+		m_maxCellY = INT_MIN;
+	}
+
+	// For colliders destroyed between physics steps, queries would otherwise hand back a dangling pointer until the next rebuild
+	void SpatialIndex::Remove(Collider* collider)
+	{
+		for (int entryIndex = 0; entryIndex < (int)m_entries.size(); entryIndex++)
+		{
+			S_Entry& entry = m_entries[entryIndex];
+			if (entry.collider != collider)
+			{
+				continue;
+			}
+
+			for (int cellX = GetCellCoord(entry.left); cellX <= GetCellCoord(entry.right); cellX++)
+			{
+				for (int cellY = GetCellCoord(entry.bottom); cellY <= GetCellCoord(entry.top); cellY++)
+				{
+					std::unordered_map<long long, std::vector<int>>::iterator cell = m_cells.find(GetCellKey(cellX, cellY));
+					if (cell != m_cells.end())
+					{
+						cell->second.erase(std::remove(cell->second.begin(), cell->second.end(), entryIndex), cell->second.end());
+						if (cell->second.size() == 0)
+						{
+							m_cells.erase(cell);
+						}
+					}
+				}
+			}
+			// Left in place so the indices the other cells hold stay valid
+			entry.collider = nullptr;
+		}
+	}
+
+	void SpatialIndex::SetCellSize(float cellSize)
+	{
+		if (cellSize > 0)
+		{
+			m_cellSize = cellSize;
+			m_cells.clear();
+			m_entries.clear();
+		}
+	}
+
+	float SpatialIndex::GetCellSize()
+	{
+		return m_cellSize;
+	}
+
+	long long SpatialIndex::GetCellKey(int cellX, int cellY)
+	{
+		return (long long)(((unsigned long long)(unsigned int)cellX << 32) | (unsigned int)cellY);
+	}
+
+	int SpatialIndex::GetCellCoord(float value)
+	{
+		return (int)std::floor(value / m_cellSize);
+	}
+
+	void SpatialIndex::Insert(Collider* collider, Vector4 edges)
+	{
+		S_Entry entry;
+		entry.collider = collider;
+		entry.top = edges.x;
+		entry.right = edges.y;
+		entry.bottom = edges.z;
+		entry.left = edges.w;
+		entry.layer = collider->GetActiveLayer();
+		entry.queryStamp = 0;
+
+		int entryIndex = (int)m_entries.size();
+		m_entries.push_back(entry);
+
+		int startX = GetCellCoord(entry.left);
+		int endX = GetCellCoord(entry.right);
+		int startY = GetCellCoord(entry.bottom);
+		int endY = GetCellCoord(entry.top);
+
+		for (int cellX = startX; cellX <= endX; cellX++)
+		{
+			for (int cellY = startY; cellY <= endY; cellY++)
+			{
+				m_cells[GetCellKey(cellX, cellY)].push_back(entryIndex);
+			}
+		}
+
+		m_minCellX = std::min(m_minCellX, startX);
+		m_minCellY = std::min(m_minCellY, startY);
+		m_maxCellX = std::max(m_maxCellX, endX);
+		m_maxCellY = std::max(m_maxCellY, endY);
+	}
+
+	int SpatialIndex::GetEntryCount()
+	{
+		return (int)m_entries.size();
+	}
+
+	bool SpatialIndex::MatchesMask(S_Entry& entry, int layerMask)
+	{
+		if (layerMask == -1)
+		{
+			return true;
+		}
+		return entry.layer >= 0 && entry.layer < 32 && (layerMask & (1 << entry.layer)) != 0;
+	}
+
+	// Entries span multiple cells, stamp them so each is only tested once per query
+	bool SpatialIndex::BeginVisit(S_Entry& entry)
+	{
+		if (entry.queryStamp == m_queryStamp)
+		{
+			return false;
+		}
+		entry.queryStamp = m_queryStamp;
+		return true;
+	}
+
+	float SpatialIndex::DistanceToEntry(Vector2 point, S_Entry& entry)
+	{
+		float dx = std::max(std::max(entry.left - point.x, 0.0f), point.x - entry.right);
+		float dy = std::max(std::max(entry.bottom - point.y, 0.0f), point.y - entry.top);
+		return std::sqrt((dx * dx) + (dy * dy));
+	}
+
+	// Slab test, direction is expected to be normalized
+	bool SpatialIndex::RayIntersectsEntry(Vector2 origin, Vector2 direction, float maxDistance, S_Entry& entry, float& hitDistance)
+	{
+		float tMin = 0;
+		float tMax = maxDistance;
+		float originAxis[2] = { origin.x, origin.y };
+		float directionAxis[2] = { direction.x, direction.y };
+		float minAxis[2] = { entry.left, entry.bottom };
+		float maxAxis[2] = { entry.right, entry.top };
+
+		for (int axis = 0; axis < 2; axis++)
+		{
+			if (directionAxis[axis] == 0)
+			{
+				if (originAxis[axis] < minAxis[axis] || originAxis[axis] > maxAxis[axis])
+				{
+					return false;
+				}
+			}
+			else
+			{
+				float t1 = (minAxis[axis] - originAxis[axis]) / directionAxis[axis];
+				float t2 = (maxAxis[axis] - originAxis[axis]) / directionAxis[axis];
+				if (t1 > t2)
+				{
+					std::swap(t1, t2);
+				}
+				tMin = std::max(tMin, t1);
+				tMax = std::min(tMax, t2);
+				if (tMin > tMax)
+				{
+					return false;
+				}
+			}
+		}
+
+		hitDistance = tMin;
+		return true;
+	}
+
+	// Walks the cells the ray passes through in order (Amanatides & Woo) and stops once the next cell is farther than the closest hit.
+	// Colliders that contain the origin are ignored so an object can cast from its own center.
+	bool SpatialIndex::Raycast(Vector2 origin, Vector2 direction, float maxDistance, int layerMask, RaycastHit& hit)
+	{
+		float length = std::sqrt((direction.x * direction.x) + (direction.y * direction.y));
+		if (length == 0 || maxDistance <= 0 || m_entries.size() == 0)
+		{
+			return false;
+		}
+		direction = Vector2(direction.x / length, direction.y / length);
+		m_queryStamp++;
+
+		int cellX = GetCellCoord(origin.x);
+		int cellY = GetCellCoord(origin.y);
+		int stepX = (direction.x > 0) ? 1 : ((direction.x < 0) ? -1 : 0);
+		int stepY = (direction.y > 0) ? 1 : ((direction.y < 0) ? -1 : 0);
+		float tMaxX = (stepX != 0) ? (((cellX + (stepX > 0 ? 1 : 0)) * m_cellSize) - origin.x) / direction.x : INFINITY;
+		float tMaxY = (stepY != 0) ? (((cellY + (stepY > 0 ? 1 : 0)) * m_cellSize) - origin.y) / direction.y : INFINITY;
+		float tDeltaX = (stepX != 0) ? m_cellSize / std::abs(direction.x) : INFINITY;
+		float tDeltaY = (stepY != 0) ? m_cellSize / std::abs(direction.y) : INFINITY;
+
+		float closestDistance = maxDistance;
+		S_Entry* closestEntry = nullptr;
+		float cellEntryDistance = 0;
+
+		while (cellEntryDistance <= closestDistance)
+		{
+			std::unordered_map<long long, std::vector<int>>::iterator cell = m_cells.find(GetCellKey(cellX, cellY));
+			if (cell != m_cells.end())
+			{
+				for (int entryIndex : cell->second)
+				{
+					S_Entry& entry = m_entries[entryIndex];
+					float hitDistance = 0;
+
+					if (BeginVisit(entry) && MatchesMask(entry, layerMask) && DistanceToEntry(origin, entry) > 0 && RayIntersectsEntry(origin, direction, closestDistance, entry, hitDistance))
+					{
+						closestDistance = hitDistance;
+						closestEntry = &entry;
+					}
+				}
+			}
+
+			if (tMaxX < tMaxY)
+			{
+				cellEntryDistance = tMaxX;
+				cellX += stepX;
+				tMaxX += tDeltaX;
+			}
+			else
+			{
+				cellEntryDistance = tMaxY;
+				cellY += stepY;
+				tMaxY += tDeltaY;
+			}
+
+			// Nothing left to hit once the ray has walked out of the occupied cells
+			if ((stepX > 0 && cellX > m_maxCellX) || (stepX < 0 && cellX < m_minCellX) || (stepY > 0 && cellY > m_maxCellY) || (stepY < 0 && cellY < m_minCellY))
+			{
+				break;
+			}
+		}
+
+		if (closestEntry != nullptr)
+		{
+			hit.collider = closestEntry->collider;
+			hit.object = closestEntry->collider->GetParent();
+			hit.distance = closestDistance;
+			hit.point = Vector2(origin.x + direction.x * closestDistance, origin.y + direction.y * closestDistance);
+			return true;
+		}
+
+		return false;
+	}
+
+	std::vector<Collider*> SpatialIndex::OverlapBox(Vector2 center, Vector2 halfExtents, int layerMask)
+	{
+		std::vector<Collider*> overlapping;
+		float top = center.y + halfExtents.y;
+		float right = center.x + halfExtents.x;
+		float bottom = center.y - halfExtents.y;
+		float left = center.x - halfExtents.x;
+		int startX = std::max(GetCellCoord(left), m_minCellX);
+		int endX = std::min(GetCellCoord(right), m_maxCellX);
+		int startY = std::max(GetCellCoord(bottom), m_minCellY);
+		int endY = std::min(GetCellCoord(top), m_maxCellY);
+		m_queryStamp++;
+
+		for (int cellX = startX; cellX <= endX; cellX++)
+		{
+			for (int cellY = startY; cellY <= endY; cellY++)
+			{
+				std::unordered_map<long long, std::vector<int>>::iterator cell = m_cells.find(GetCellKey(cellX, cellY));
+				if (cell != m_cells.end())
+				{
+					for (int entryIndex : cell->second)
+					{
+						S_Entry& entry = m_entries[entryIndex];
+						if (BeginVisit(entry) && MatchesMask(entry, layerMask) && entry.left <= right && entry.right >= left && entry.bottom <= top && entry.top >= bottom)
+						{
+							overlapping.push_back(entry.collider);
+						}
+					}
+				}
+			}
+		}
+
+		return overlapping;
+	}
+
+	std::vector<Collider*> SpatialIndex::OverlapCircle(Vector2 center, float radius, int layerMask)
+	{
+		std::vector<Collider*> overlapping;
+		int startX = std::max(GetCellCoord(center.x - radius), m_minCellX);
+		int endX = std::min(GetCellCoord(center.x + radius), m_maxCellX);
+		int startY = std::max(GetCellCoord(center.y - radius), m_minCellY);
+		int endY = std::min(GetCellCoord(center.y + radius), m_maxCellY);
+		m_queryStamp++;
+
+		for (int cellX = startX; cellX <= endX; cellX++)
+		{
+			for (int cellY = startY; cellY <= endY; cellY++)
+			{
+				std::unordered_map<long long, std::vector<int>>::iterator cell = m_cells.find(GetCellKey(cellX, cellY));
+				if (cell != m_cells.end())
+				{
+					for (int entryIndex : cell->second)
+					{
+						S_Entry& entry = m_entries[entryIndex];
+						if (BeginVisit(entry) && MatchesMask(entry, layerMask) && DistanceToEntry(center, entry) <= radius)
+						{
+							overlapping.push_back(entry.collider);
+						}
+					}
+				}
+			}
+		}
+
+		return overlapping;
+	}
+
+	// Searches rings of cells outward from the point's cell. Anything outside ring r is at least r * cellSize away,
+	// so the search ends as soon as the count closest found so far are all within that distance.
+	std::vector<Collider*> SpatialIndex::QueryNearest(Vector2 point, int count, int layerMask)
+	{
+		std::vector<Collider*> nearest;
+		if (count <= 0 || m_entries.size() == 0)
+		{
+			return nearest;
+		}
+
+		std::vector<std::pair<float, int>> found;
+		int centerX = GetCellCoord(point.x);
+		int centerY = GetCellCoord(point.y);
+		int maxRing = std::max(std::max(std::abs(centerX - m_minCellX), std::abs(m_maxCellX - centerX)), std::max(std::abs(centerY - m_minCellY), std::abs(m_maxCellY - centerY)));
+		m_queryStamp++;
+
+		auto visitCell = [&](int cellX, int cellY)
+		{
+			std::unordered_map<long long, std::vector<int>>::iterator cell = m_cells.find(GetCellKey(cellX, cellY));
+			if (cell != m_cells.end())
+			{
+				for (int entryIndex : cell->second)
+				{
+					S_Entry& entry = m_entries[entryIndex];
+					if (BeginVisit(entry) && MatchesMask(entry, layerMask))
+					{
+						found.push_back({ DistanceToEntry(point, entry), entryIndex });
+					}
+				}
+			}
+		};
+
+		for (int ring = 0; ring <= maxRing; ring++)
+		{
+			if (ring == 0)
+			{
+				visitCell(centerX, centerY);
+			}
+			else
+			{
+				for (int offset = -ring; offset <= ring; offset++)
+				{
+					visitCell(centerX + offset, centerY - ring);
+					visitCell(centerX + offset, centerY + ring);
+				}
+				for (int offset = -ring + 1; offset <= ring - 1; offset++)
+				{
+					visitCell(centerX - ring, centerY + offset);
+					visitCell(centerX + ring, centerY + offset);
+				}
+			}
+
+			if ((int)found.size() >= count)
+			{
+				std::nth_element(found.begin(), found.begin() + (count - 1), found.end());
+				if (found[count - 1].first <= ring * m_cellSize)
+				{
+					break;
+				}
+			}
+		}
+
+		std::sort(found.begin(), found.end());
+		for (int i = 0; i < (int)found.size() && i < count; i++)
+		{
+			nearest.push_back(m_entries[found[i].second].collider);
+		}
+
+		return nearest;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+#include "Vector2.h"
+#include "Vector4.h"
+
+#include <vector>
+#include <unordered_map>
+
+
+namespace FlatEngine
+{
+	class Collider;
+	class GameObject;
+
+	struct RaycastHit
+	{
+		GameObject* object = nullptr;
+		Collider* collider = nullptr;
+		Vector2 point = Vector2(0, 0);
+		float distance = 0;
+	};
+
+	// Uniform grid (spatial hash) of collider bounds in grid space.
+	// Rebuilt by the physics step in GameLoop::HandleCollisions so queries always see this frames bounds.
+	// layerMask is a bit mask of Collider active layers, -1 matches every layer.
+	class SpatialIndex
+	{
+	public:
+		SpatialIndex(float cellSize = 4.0f);
+		~SpatialIndex();
+
+		void Clear();
+		void SetCellSize(float cellSize);
+		float GetCellSize();
+		//Vector4(top, right, bottom, left) in grid space
+		void Insert(Collider* collider, Vector4 edges);
+		void Remove(Collider* collider);
+		int GetEntryCount();
+
+		bool Raycast(Vector2 origin, Vector2 direction, float maxDistance, int layerMask, RaycastHit& hit);
+		std::vector<Collider*> OverlapBox(Vector2 center, Vector2 halfExtents, int layerMask = -1);
+		std::vector<Collider*> OverlapCircle(Vector2 center, float radius, int layerMask = -1);
+		std::vector<Collider*> QueryNearest(Vector2 point, int count, int layerMask = -1);
+
+	private:
+		struct S_Entry
+		{
+			Collider* collider;
+			float top;
+			float right;
+			float bottom;
+			float left;
+			int layer;
+			unsigned int queryStamp;
+		};
+
+		long long GetCellKey(int cellX, int cellY);
+		int GetCellCoord(float value);
+		bool MatchesMask(S_Entry& entry, int layerMask);
+		bool BeginVisit(S_Entry& entry);
+		float DistanceToEntry(Vector2 point, S_Entry& entry);
+		bool RayIntersectsEntry(Vector2 origin, Vector2 direction, float maxDistance, S_Entry& entry, float& hitDistance);
+
+		float m_cellSize;
+		std::vector<S_Entry> m_entries;
+		std::unordered_map<long long, std::vector<int>> m_cells;
+		unsigned int m_queryStamp;
+		int m_minCellX;
+		int m_minCellY;
+		int m_maxCellX;
+		int m_maxCellY;
+	};
+}
\ No newline at end of file
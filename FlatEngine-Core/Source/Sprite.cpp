@@ -3,6 +3,9 @@
 #include "GameObject.h"
 #include "RigidBody.h"
 #include "AssetManager.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "Texture.h"
 
 
 namespace FlatEngine
@@ -20,8 +23,12 @@ namespace FlatEngine
 		m_pivotOffset = Vector2(0, 0);
 		m_offset = Vector2(0, 0);
 		m_path = "";
+		m_texture = nullptr;
 		m_tintColor = Vector4(1, 1, 1, 1);
 		m_renderOrder = F_maxSpriteLayers / 2;
+		m_atlasPage = -1;
+		m_uvStart = Vector2(0, 0);
+		m_uvEnd = Vector2(1, 1);
 	}
 
 	Sprite::~Sprite()
@@ -56,42 +63,61 @@ namespace FlatEngine
 	{
 		RemoveTexture();
 
-/*		if (newPath != "")
-		{	*/					
-		//	m_path = newPath;
-		//	if (m_texture.LoadFromFile(m_path))
-		//	{
-		//		m_textureWidth = m_texture.GetWidth();
-		//		m_textureHeight = m_texture.GetHeight();
-
-		//		// Set pivot point to the center of the texture by default
-		//		m_offset = { (float)m_textureWidth / 2, (float)m_textureHeight / 2 };
-		//		m_pivotOffset = m_offset;
-		//	}
-		//	else
-		//	{
-		//		// Set broken texture Texture
-		//		m_texture.LoadFromFile(F_AssetManager.GetFailedToLoadImagePath());
-		//		if (m_textureWidth == 0 || m_textureHeight == 0)
-		//		{
-		//			m_textureWidth = 50;
-		//			m_textureHeight = 50;
-		//			SetOffset(Vector2(25, 25));
-		//		}
-
-		//		LogError("Sprite::SetTexture() - Texture could not be loaded.");
-		//	}
-
-		//	// Recalculate the moment of inertia of the RigidBody based on sprite dimensions
-		//	if (GetParent() != nullptr)
-		//	{
-		//		RigidBody* rigidBody = GetParent()->GetRigidBody();
-		//		if (rigidBody != nullptr)
-		//		{
-		//			rigidBody->SetMass(rigidBody->GetMass());
-		//		}
-		//	}
-		//}
+		// Images packed into the atlas (see BuildProject()) draw from their page sub-rect instead of loading their own texture
+		AtlasRegion region;
+		if (newPath != "" && F_TextureAtlas.GetRegion(newPath, region))
+		{
+			m_path = newPath;
+			m_atlasPage = region.page;
+			m_uvStart = region.uvStart;
+			m_uvEnd = region.uvEnd;
+			m_textureWidth = region.width;
+			m_textureHeight = region.height;
+			m_offset = { (float)m_textureWidth / 2, (float)m_textureHeight / 2 };
+			m_pivotOffset = m_offset;
+			MarkRenderBoundsDirty();
+			return;
+		}
+
+		if (newPath != "")
+		{
+			// Every Sprite using this image shares one Texture, it is only loaded the first time. Waits for the load since the
+			// dimensions are needed for the pivot
+			m_path = newPath;
+			m_texture = F_TextureCache.Acquire(m_path, true);
+			if (m_texture->GetWidth() > 0 && m_texture->GetHeight() > 0)
+			{
+				m_textureWidth = m_texture->GetWidth();
+				m_textureHeight = m_texture->GetHeight();
+
+				// Set pivot point to the center of the texture by default
+				m_offset = { (float)m_textureWidth / 2, (float)m_textureHeight / 2 };
+				m_pivotOffset = m_offset;
+			}
+			else
+			{
+				// The cached Texture keeps showing the broken texture Texture
+				if (m_textureWidth == 0 || m_textureHeight == 0)
+				{
+					m_textureWidth = 50;
+					m_textureHeight = 50;
+					SetOffset(Vector2(25, 25));
+				}
+
+				LogError("Sprite::SetTexture() - Texture could not be loaded.");
+			}
+
+			// Recalculate the moment of inertia of the RigidBody based on sprite dimensions
+			if (GetParentID() != -1 && GetParent() != nullptr)
+			{
+				RigidBody* rigidBody = GetParent()->GetRigidBody();
+				if (rigidBody != nullptr)
+				{
+					rigidBody->SetMass(rigidBody->GetMass());
+				}
+			}
+		}
+		MarkRenderBoundsDirty();
 	}
 
 	void Sprite::SetOffset(Vector2 newOffset)
@@ -107,13 +133,21 @@ namespace FlatEngine
 
 	VkDescriptorSet Sprite::GetTexture()
 	{
-		//return m_texture.GetTexture();
+		if (m_atlasPage != -1)
+		{
+			return F_TextureAtlas.GetPageTexture(m_atlasPage);
+		}
+		if (m_texture != nullptr)
+		{
+			return m_texture->GetTexture();
+		}
 		return VK_NULL_HANDLE;
 	}
 
 	void Sprite::SetScale(Vector2 newScale)
 	{
-		m_scale = newScale;		
+		m_scale = newScale;
+		MarkRenderBoundsDirty();
 	}
 
 	Vector2 Sprite::GetScale()
@@ -149,7 +183,10 @@ namespace FlatEngine
 	void Sprite::RemoveTexture()
 	{
 		m_path = "";
-		//m_texture.FreeTexture();
+		m_atlasPage = -1;
+		m_uvStart = Vector2(0, 0);
+		m_uvEnd = Vector2(1, 1);
+		m_texture = nullptr; // F_TextureCache frees the image once nothing holds it and it is over budget
 	}
 
 	void Sprite::SetPivotPoint(Pivot newPivot)
@@ -234,6 +271,7 @@ namespace FlatEngine
 		}
 
 		m_offset = m_pivotOffset;
+		MarkRenderBoundsDirty();
 	}
 
 	Pivot Sprite::GetPivotPoint()
@@ -281,4 +319,19 @@ namespace FlatEngine
 	{
 		return m_tintColor.w;
 	}
-}
+
+	Vector2 Sprite::GetUVStart()
+	{
+		return m_uvStart;
+	}
+
+	Vector2 Sprite::GetUVEnd()
+	{
+		return m_uvEnd;
+	}
+
+	bool Sprite::IsAtlased()
+	{
+		return m_atlasPage != -1;
+	}
+}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Vector4.h"
 
 #include <SDL.h>
+#include <memory>
 #include "json.hpp"
 
 using json = nlohmann::json;
@@ -43,6 +44,9 @@ namespace FlatEngine
 		Vector4 GetTintColor();
 		void SetAlpha(float);
 		float GetAlpha();
+		Vector2 GetUVStart();
+		Vector2 GetUVEnd();
+		bool IsAtlased();
 
 	private:
 		Mesh m_mesh; // Anything that wants to be rendered needs a mesh component, even 2D ui objects		
@@ -54,6 +58,10 @@ namespace FlatEngine
 		Vector2 m_pivotOffset;
 		Vector2 m_offset;
 		std::string m_path;
+		std::shared_ptr<Texture> m_texture; // shared through F_TextureCache with every Sprite showing the same image
 		Vector4 m_tintColor;
+		int m_atlasPage; // -1 when the texture is not packed into F_TextureAtlas
+		Vector2 m_uvStart;
+		Vector2 m_uvEnd;
 	};
 }
\ No newline at end of file
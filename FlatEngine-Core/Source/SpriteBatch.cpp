@@ -0,0 +1,458 @@
+#include "SpriteBatch.h"
+#include "RenderQueue.h"
+#include "FlatEngine.h"
+#include "VulkanManager.h"
+#include "WinSys.h"
+#include "GraphicsPipeline.h"
+#include "Helper.h"
+
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+
+namespace FlatEngine
+{
+	SpriteBatch::SpriteBatch()
+	{
+		m_instances = std::vector<SpriteInstance>();
+		m_batches = std::vector<SpriteBatchRange>();
+		m_scissorStart = Vector2(0, 0);
+		m_scissorSize = Vector2(0, 0);
+		m_buildTime = 0;
+		m_pipeline = VK_NULL_HANDLE;
+		m_pipelineLayout = VK_NULL_HANDLE;
+		m_descriptorSetLayout = VK_NULL_HANDLE;
+		m_instanceBuffers = std::vector<VkBuffer>(VM_MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+		m_instanceBufferMemory = std::vector<MemoryAllocation>(VM_MAX_FRAMES_IN_FLIGHT);
+		m_mappedInstances = std::vector<void*>(VM_MAX_FRAMES_IN_FLIGHT, nullptr);
+		m_instanceCapacities = std::vector<uint32_t>(VM_MAX_FRAMES_IN_FLIGHT, 0);
+		m_uploadedCounts = std::vector<uint32_t>(VM_MAX_FRAMES_IN_FLIGHT, 0);
+		m_b_hasResources = false;
+		m_physicalDeviceHandle = nullptr;
+		m_deviceHandle = nullptr;
+		m_renderPassHandle = nullptr;
+	}
+
+	SpriteBatch::~SpriteBatch()
+	{
+	}
+
+	void SpriteBatch::Cleanup()
+	{
+		if (!m_b_hasResources)
+		{
+			return;
+		}
+
+		for (uint32_t i = 0; i < VM_MAX_FRAMES_IN_FLIGHT; i++)
+		{
+			DestroyInstanceBuffer(i);
+		}
+		vkDestroyPipeline(m_deviceHandle->GetDevice(), m_pipeline, nullptr);
+		vkDestroyPipelineLayout(m_deviceHandle->GetDevice(), m_pipelineLayout, nullptr);
+		vkDestroyDescriptorSetLayout(m_deviceHandle->GetDevice(), m_descriptorSetLayout, nullptr);
+		m_b_hasResources = false;
+	}
+
+	void SpriteBatch::SetHandles(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, RenderPass& renderPass)
+	{
+		m_physicalDeviceHandle = &physicalDevice;
+		m_deviceHandle = &logicalDevice;
+		m_renderPassHandle = &renderPass;
+	}
+
+	// Returns false (and leaves the ImDrawList path in charge) if the sprite shaders have not been compiled with Shaders/compile.bat
+	bool SpriteBatch::CreateResources(std::string vertexPath, std::string fragmentPath)
+	{
+		if (!DoesFileExist(vertexPath) || !DoesFileExist(fragmentPath))
+		{
+			LogError("Sprite batch shaders not found, falling back to ImGui sprite rendering.");
+			return false;
+		}
+
+		CreatePipeline(vertexPath, fragmentPath);
+		for (uint32_t i = 0; i < VM_MAX_FRAMES_IN_FLIGHT; i++)
+		{
+			CreateInstanceBuffer(i, 1024);
+		}
+		m_b_hasResources = true;
+
+		return true;
+	}
+
+	bool SpriteBatch::HasResources()
+	{
+		return m_b_hasResources;
+	}
+
+	void SpriteBatch::CreatePipeline(std::string vertexPath, std::string fragmentPath)
+	{
+		GraphicsPipeline shaderLoader = GraphicsPipeline();
+		VkShaderModule vertShaderModule = shaderLoader.CreateShaderModule(Helper::ReadFile(vertexPath), *m_deviceHandle);
+		VkShaderModule fragShaderModule = shaderLoader.CreateShaderModule(Helper::ReadFile(fragmentPath), *m_deviceHandle);
+
+		VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+		shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+		shaderStages[0].module = vertShaderModule;
+		shaderStages[0].pName = "main";
+		shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+		shaderStages[1].module = fragShaderModule;
+		shaderStages[1].pName = "main";
+
+		// No vertex buffer, only per instance data. The vertex shader builds the 6 corners of each quad from gl_VertexIndex
+		VkVertexInputBindingDescription bindingDescription = SpriteInstance::getBindingDescription();
+		std::array<VkVertexInputAttributeDescription, 5> attributeDescriptions = SpriteInstance::getAttributeDescriptions();
+		VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		vertexInputInfo.vertexBindingDescriptionCount = 1;
+		vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+		vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+		vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+		VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+		inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+		inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+		std::vector<VkDynamicState> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+		VkPipelineDynamicStateCreateInfo dynamicState{};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+		dynamicState.pDynamicStates = dynamicStates.data();
+
+		VkPipelineViewportStateCreateInfo viewportState{};
+		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewportState.viewportCount = 1;
+		viewportState.scissorCount = 1;
+
+		// Mirrored sprites (negative scale) flip the winding, so nothing is culled
+		VkPipelineRasterizationStateCreateInfo rasterizer{};
+		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+		rasterizer.depthClampEnable = VK_FALSE;
+		rasterizer.rasterizerDiscardEnable = VK_FALSE;
+		rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+		rasterizer.lineWidth = 1.0f;
+		rasterizer.cullMode = VK_CULL_MODE_NONE;
+		rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+		rasterizer.depthBiasEnable = VK_FALSE;
+
+		VkPipelineMultisampleStateCreateInfo multisampling{};
+		multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+		multisampling.sampleShadingEnable = VK_FALSE;
+		multisampling.rasterizationSamples = m_renderPassHandle->GetMsaa();
+
+		// Draw order comes from the RenderQueue sort, so no depth test, only alpha blending
+		VkPipelineDepthStencilStateCreateInfo depthStencil{};
+		depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depthStencil.depthTestEnable = VK_FALSE;
+		depthStencil.depthWriteEnable = VK_FALSE;
+		depthStencil.depthBoundsTestEnable = VK_FALSE;
+		depthStencil.stencilTestEnable = VK_FALSE;
+
+		VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+		colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		colorBlendAttachment.blendEnable = VK_TRUE;
+		colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+		colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+		colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+		colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+		VkPipelineColorBlendStateCreateInfo colorBlending{};
+		colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		colorBlending.logicOpEnable = VK_FALSE;
+		colorBlending.attachmentCount = 1;
+		colorBlending.pAttachments = &colorBlendAttachment;
+
+		// Same layout as the ImGui texture descriptor sets (one combined image sampler at binding 0) so sprites can bind them directly
+		VkDescriptorSetLayoutBinding samplerBinding{};
+		samplerBinding.binding = 0;
+		samplerBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		samplerBinding.descriptorCount = 1;
+		samplerBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = 1;
+		layoutInfo.pBindings = &samplerBinding;
+		if (vkCreateDescriptorSetLayout(m_deviceHandle->GetDevice(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create sprite descriptor set layout!");
+		}
+
+		// vec2 scale, vec2 translate from screen pixels to clip space
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(float) * 4;
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+		if (vkCreatePipelineLayout(m_deviceHandle->GetDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create sprite pipeline layout!");
+		}
+
+		VkGraphicsPipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.stageCount = 2;
+		pipelineInfo.pStages = shaderStages;
+		pipelineInfo.pVertexInputState = &vertexInputInfo;
+		pipelineInfo.pInputAssemblyState = &inputAssembly;
+		pipelineInfo.pViewportState = &viewportState;
+		pipelineInfo.pRasterizationState = &rasterizer;
+		pipelineInfo.pMultisampleState = &multisampling;
+		pipelineInfo.pDepthStencilState = &depthStencil;
+		pipelineInfo.pColorBlendState = &colorBlending;
+		pipelineInfo.pDynamicState = &dynamicState;
+		pipelineInfo.layout = m_pipelineLayout;
+		pipelineInfo.renderPass = m_renderPassHandle->GetRenderPass();
+		pipelineInfo.subpass = 0;
+		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+		pipelineInfo.basePipelineIndex = -1;
+
+		double creationStart = GetTimeInMicroseconds();
+		if (vkCreateGraphicsPipelines(m_deviceHandle->GetDevice(), VM_pipelineCache.GetCache(), 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create sprite graphics pipeline.");
+		}
+		VM_pipelineCache.AddCreationTime((float)(GetTimeInMicroseconds() - creationStart));
+
+		vkDestroyShaderModule(m_deviceHandle->GetDevice(), vertShaderModule, nullptr);
+		vkDestroyShaderModule(m_deviceHandle->GetDevice(), fragShaderModule, nullptr);
+	}
+
+	// Host visible and coherent, its memory block stays mapped so Upload() is a plain memcpy
+	void SpriteBatch::CreateInstanceBuffer(uint32_t frameIndex, uint32_t capacity)
+	{
+		VkDeviceSize bufferSize = sizeof(SpriteInstance) * capacity;
+		WinSys::CreateBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_instanceBuffers[frameIndex], m_instanceBufferMemory[frameIndex], *m_physicalDeviceHandle, *m_deviceHandle);
+		m_mappedInstances[frameIndex] = m_instanceBufferMemory[frameIndex].mapped;
+		m_instanceCapacities[frameIndex] = capacity;
+	}
+
+	void SpriteBatch::DestroyInstanceBuffer(uint32_t frameIndex)
+	{
+		if (m_instanceBuffers[frameIndex] != VK_NULL_HANDLE)
+		{
+			vkDestroyBuffer(m_deviceHandle->GetDevice(), m_instanceBuffers[frameIndex], nullptr);
+			VM_memoryAllocator.Free(m_instanceBufferMemory[frameIndex]);
+			m_instanceBuffers[frameIndex] = VK_NULL_HANDLE;
+			m_mappedInstances[frameIndex] = nullptr;
+			m_instanceCapacities[frameIndex] = 0;
+		}
+	}
+
+	void SpriteBatch::Begin(Vector2 scissorStart, Vector2 scissorSize)
+	{
+		m_instances.clear();
+		m_batches.clear();
+		m_scissorStart = scissorStart;
+		m_scissorSize = scissorSize;
+	}
+
+	// Same placement as AddImageToDrawList(), but the quad is kept as center, half size and rotation for the vertex shader
+	void SpriteBatch::AddQuad(RenderItem& item, Vector2 viewCenter, float zoomMultiplier)
+	{
+		Vector2 renderStart;
+		Vector2 renderEnd;
+
+		if (item.b_scalesWithZoom)
+		{
+			Vector2 newScale = Vector2(item.scale.x * F_spriteScaleMultiplier, item.scale.y * F_spriteScaleMultiplier);
+			renderStart = Vector2(viewCenter.x + (item.position.x * zoomMultiplier) - (item.offset.x * newScale.x * zoomMultiplier), viewCenter.y - (item.position.y * zoomMultiplier) - (item.offset.y * newScale.y * zoomMultiplier));
+			renderEnd = Vector2(renderStart.x + (item.textureWidth * newScale.x * zoomMultiplier), renderStart.y + (item.textureHeight * newScale.y * zoomMultiplier));
+		}
+		else
+		{
+			renderStart = Vector2(viewCenter.x + (item.position.x * zoomMultiplier) - item.offset.x * item.scale.x, viewCenter.y - (item.position.y * zoomMultiplier) - item.offset.y * item.scale.y);
+			renderEnd = Vector2(renderStart.x + item.textureWidth * item.scale.x, renderStart.y + item.textureHeight * item.scale.y);
+		}
+
+		SpriteInstance instance;
+		instance.center = glm::vec2((renderStart.x + renderEnd.x) / 2, (renderStart.y + renderEnd.y) / 2);
+		instance.halfSize = glm::vec2((renderEnd.x - renderStart.x) / 2, (renderEnd.y - renderStart.y) / 2);
+		instance.rotation = item.rotation * 2.0f * (float)M_PI / 360.0f;
+		instance.color = item.tintColor;
+		instance.uvRect = glm::vec4(item.uvStart.x, item.uvStart.y, item.uvEnd.x, item.uvEnd.y);
+
+		if (m_batches.size() == 0 || m_batches.back().texture != item.texture)
+		{
+			SpriteBatchRange batch;
+			batch.texture = item.texture;
+			batch.firstInstance = (uint32_t)m_instances.size();
+			batch.instanceCount = 0;
+			m_batches.push_back(batch);
+		}
+		m_batches.back().instanceCount++;
+		m_instances.push_back(instance);
+	}
+
+	// Expects renderQueue.Sort() to have been called, consecutive items with the same texture share a batch
+	void SpriteBatch::Build(RenderQueue& renderQueue, Vector2 viewCenter, float zoomMultiplier)
+	{
+		double buildStart = GetTimeInMicroseconds();
+		int itemCount = renderQueue.GetItemCount();
+		m_instances.reserve(itemCount);
+
+		for (int i = 0; i < itemCount; i++)
+		{
+			AddQuad(renderQueue.GetSortedItem(i), viewCenter, zoomMultiplier);
+		}
+
+		m_buildTime = (float)(GetTimeInMicroseconds() - buildStart);
+	}
+
+	// Called after the frame's fence has been waited on, so the buffer for frameIndex is no longer read by the GPU
+	void SpriteBatch::Upload(uint32_t frameIndex)
+	{
+		if (!m_b_hasResources)
+		{
+			return;
+		}
+
+		uint32_t instanceCount = (uint32_t)m_instances.size();
+		if (instanceCount > m_instanceCapacities[frameIndex])
+		{
+			uint32_t newCapacity = m_instanceCapacities[frameIndex];
+			while (newCapacity < instanceCount)
+			{
+				newCapacity *= 2;
+			}
+			DestroyInstanceBuffer(frameIndex);
+			CreateInstanceBuffer(frameIndex, newCapacity);
+		}
+
+		if (instanceCount > 0)
+		{
+			memcpy(m_mappedInstances[frameIndex], m_instances.data(), sizeof(SpriteInstance) * instanceCount);
+		}
+		m_uploadedCounts[frameIndex] = instanceCount;
+	}
+
+	void SpriteBatch::RecordDraws(VkCommandBuffer commandBuffer, uint32_t frameIndex, ImDrawData* drawData)
+	{
+		if (!m_b_hasResources || m_uploadedCounts[frameIndex] == 0 || drawData == nullptr || drawData->DisplaySize.x <= 0 || drawData->DisplaySize.y <= 0)
+		{
+			return;
+		}
+
+		// Sprite positions are in ImGui screen space, map them the same way the ImGui backend does
+		Vector2 framebufferScale = drawData->FramebufferScale;
+		VkViewport viewport{};
+		viewport.x = 0;
+		viewport.y = 0;
+		viewport.width = drawData->DisplaySize.x * framebufferScale.x;
+		viewport.height = drawData->DisplaySize.y * framebufferScale.y;
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+
+		VkRect2D scissor{};
+		scissor.offset.x = (int32_t)std::max((m_scissorStart.x - drawData->DisplayPos.x) * framebufferScale.x, 0.0f);
+		scissor.offset.y = (int32_t)std::max((m_scissorStart.y - drawData->DisplayPos.y) * framebufferScale.y, 0.0f);
+		scissor.extent.width = (uint32_t)(m_scissorSize.x * framebufferScale.x);
+		scissor.extent.height = (uint32_t)(m_scissorSize.y * framebufferScale.y);
+
+		float pushConstants[4];
+		pushConstants[0] = 2.0f / drawData->DisplaySize.x;
+		pushConstants[1] = 2.0f / drawData->DisplaySize.y;
+		pushConstants[2] = -1.0f - drawData->DisplayPos.x * pushConstants[0];
+		pushConstants[3] = -1.0f - drawData->DisplayPos.y * pushConstants[1];
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+		vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pushConstants), pushConstants);
+
+		VkDeviceSize offsets[] = { 0 };
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_instanceBuffers[frameIndex], offsets);
+
+		for (SpriteBatchRange& batch : m_batches)
+		{
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &batch.texture, 0, nullptr);
+			vkCmdDraw(commandBuffer, 6, batch.instanceCount, 0, batch.firstInstance);
+		}
+	}
+
+	// Nothing carries over, if the Game View is not rendered next frame no sprites are drawn
+	void SpriteBatch::EndFrame()
+	{
+		m_instances.clear();
+		m_batches.clear();
+	}
+
+	// Headless benchmark of Sort() + Build() over a synthetic queue spread across 16 textures, returns quads per millisecond
+	float SpriteBatch::MeasureBuildRate(int quadCount, int iterations)
+	{
+		RenderQueue renderQueue = RenderQueue();
+		SpriteBatch spriteBatch = SpriteBatch();
+		double totalTime = 0;
+
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			renderQueue.BeginExtraction();
+			for (int i = 0; i < quadCount; i++)
+			{
+				RenderItem item;
+				item.texture = reinterpret_cast<VkDescriptorSet>((uintptr_t)((i * 7) % 16 + 1)); // never bound, only compared
+				item.position = Vector2((float)(i % 100), (float)(i / 100));
+				item.textureWidth = 16;
+				item.textureHeight = 16;
+				item.offset = Vector2(8, 8);
+				item.scale = Vector2(1, 1);
+				item.rotation = (float)(i % 360);
+				item.tintColor = 0xFFFFFFFF;
+				item.uvStart = Vector2(0, 0);
+				item.uvEnd = Vector2(1, 1);
+				item.renderOrder = i % 4;
+				item.b_scalesWithZoom = true;
+				renderQueue.AddItem(item);
+			}
+			renderQueue.EndExtraction(quadCount);
+
+			double start = GetTimeInMicroseconds();
+			renderQueue.Sort();
+			spriteBatch.Begin(Vector2(0, 0), Vector2(1920, 1080));
+			spriteBatch.Build(renderQueue, Vector2(960, 540), 10);
+			totalTime += GetTimeInMicroseconds() - start;
+		}
+
+		if (totalTime <= 0)
+		{
+			return 0;
+		}
+		return (float)((double)quadCount * iterations / (totalTime / 1000));
+	}
+
+	std::vector<SpriteInstance>& SpriteBatch::GetInstances()
+	{
+		return m_instances;
+	}
+
+	std::vector<SpriteBatchRange>& SpriteBatch::GetBatches()
+	{
+		return m_batches;
+	}
+
+	int SpriteBatch::GetInstanceCount()
+	{
+		return (int)m_instances.size();
+	}
+
+	int SpriteBatch::GetBatchCount()
+	{
+		return (int)m_batches.size();
+	}
+
+	float SpriteBatch::GetBuildTime()
+	{
+		return m_buildTime;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+#include "Vector2.h"
+#include "PhysicalDevice.h"
+#include "LogicalDevice.h"
+#include "RenderPass.h"
+
+#define GLFW_INCLUDE_VULKAN
+#include <glfw3.h>
+#include <glm.hpp>
+
+#include <array>
+#include <vector>
+#include <string>
+
+
+struct ImDrawData;
+
+namespace FlatEngine
+{
+	class RenderQueue;
+	struct RenderItem;
+
+	// One quad as the sprite vertex shader reads it, the corners and rotation are expanded on the GPU
+	struct SpriteInstance
+	{
+		glm::vec2 center;     // screen pixels
+		glm::vec2 halfSize;   // screen pixels
+		float rotation;       // radians
+		uint32_t color;       // ImU32 tint, read as R8G8B8A8_UNORM
+		glm::vec4 uvRect;     // uvStart.xy, uvEnd.xy
+
+		static VkVertexInputBindingDescription getBindingDescription()
+		{
+			VkVertexInputBindingDescription bindingDescription{};
+			bindingDescription.binding = 0;
+			bindingDescription.stride = sizeof(SpriteInstance);
+			bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+			return bindingDescription;
+		}
+
+		static std::array<VkVertexInputAttributeDescription, 5> getAttributeDescriptions()
+		{
+			std::array<VkVertexInputAttributeDescription, 5> attributeDescriptions{};
+
+			attributeDescriptions[0].binding = 0;
+			attributeDescriptions[0].location = 0;
+			attributeDescriptions[0].format = VK_FORMAT_R32G32_SFLOAT;
+			attributeDescriptions[0].offset = offsetof(SpriteInstance, center);
+
+			attributeDescriptions[1].binding = 0;
+			attributeDescriptions[1].location = 1;
+			attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
+			attributeDescriptions[1].offset = offsetof(SpriteInstance, halfSize);
+
+			attributeDescriptions[2].binding = 0;
+			attributeDescriptions[2].location = 2;
+			attributeDescriptions[2].format = VK_FORMAT_R32_SFLOAT;
+			attributeDescriptions[2].offset = offsetof(SpriteInstance, rotation);
+
+			attributeDescriptions[3].binding = 0;
+			attributeDescriptions[3].location = 3;
+			attributeDescriptions[3].format = VK_FORMAT_R8G8B8A8_UNORM;
+			attributeDescriptions[3].offset = offsetof(SpriteInstance, color);
+
+			attributeDescriptions[4].binding = 0;
+			attributeDescriptions[4].location = 4;
+			attributeDescriptions[4].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+			attributeDescriptions[4].offset = offsetof(SpriteInstance, uvRect);
+
+			return attributeDescriptions;
+		}
+	};
+
+	// A run of instances that share a texture, drawn with a single instanced draw call
+	struct SpriteBatchRange
+	{
+		VkDescriptorSet texture;
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+	};
+
+	// Turns the sorted RenderQueue into instance data and draws it with its own pipeline instead of going through ImDrawList.
+	// Building the batches is plain CPU work with no Vulkan calls so it can run (and be timed) without a device.
+	// Instances are copied into a persistently mapped buffer per frame in flight and each texture run is one vkCmdDraw.
+	class SpriteBatch
+	{
+	public:
+		SpriteBatch();
+		~SpriteBatch();
+		void Cleanup();
+
+		void SetHandles(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, RenderPass& renderPass);
+		bool CreateResources(std::string vertexPath, std::string fragmentPath);
+		bool HasResources();
+
+		void Begin(Vector2 scissorStart, Vector2 scissorSize);
+		void AddQuad(RenderItem& item, Vector2 viewCenter, float zoomMultiplier);
+		void Build(RenderQueue& renderQueue, Vector2 viewCenter, float zoomMultiplier);
+		void Upload(uint32_t frameIndex);
+		void RecordDraws(VkCommandBuffer commandBuffer, uint32_t frameIndex, ImDrawData* drawData);
+		void EndFrame();
+
+		std::vector<SpriteInstance>& GetInstances();
+		std::vector<SpriteBatchRange>& GetBatches();
+		int GetInstanceCount();
+		int GetBatchCount();
+		float GetBuildTime();
+
+		static float MeasureBuildRate(int quadCount, int iterations);
+
+	private:
+		void CreatePipeline(std::string vertexPath, std::string fragmentPath);
+		void CreateInstanceBuffer(uint32_t frameIndex, uint32_t capacity);
+		void DestroyInstanceBuffer(uint32_t frameIndex);
+
+		std::vector<SpriteInstance> m_instances;
+		std::vector<SpriteBatchRange> m_batches;
+		Vector2 m_scissorStart;
+		Vector2 m_scissorSize;
+		float m_buildTime;  // microseconds
+		// gpu resources
+		VkPipeline m_pipeline;
+		VkPipelineLayout m_pipelineLayout;
+		VkDescriptorSetLayout m_descriptorSetLayout;
+		std::vector<VkBuffer> m_instanceBuffers;
+		std::vector<MemoryAllocation> m_instanceBufferMemory;
+		std::vector<void*> m_mappedInstances;
+		std::vector<uint32_t> m_instanceCapacities;
+		std::vector<uint32_t> m_uploadedCounts;
+		bool m_b_hasResources;
+		// handles
+		PhysicalDevice* m_physicalDeviceHandle;
+		LogicalDevice* m_deviceHandle;
+		RenderPass* m_renderPassHandle;
+	};
+}
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <gtx/hash.hpp>
 
 #include <array>
+#include <cstring>
 #include <optional>
 #include <vector>
 
@@ -88,17 +89,75 @@ namespace FlatEngine
         glm::mat4 view;
         glm::mat4 proj;
     };
+
+    // Per instance data of an instanced mesh draw, read by the vertex shader at binding 1 as a mat4 in locations 4 to 7
+    struct MeshInstance
+    {
+        glm::mat4 transform;
+
+        static VkVertexInputBindingDescription getBindingDescription()
+        {
+            VkVertexInputBindingDescription bindingDescription{};
+            bindingDescription.binding = 1;
+            bindingDescription.stride = sizeof(MeshInstance);
+            bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+            return bindingDescription;
+        }
+
+        // A mat4 attribute takes one location per column
+        static std::array<VkVertexInputAttributeDescription, 4> getAttributeDescriptions()
+        {
+            std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions{};
+
+            for (uint32_t column = 0; column < 4; column++)
+            {
+                attributeDescriptions[column].binding = 1;
+                attributeDescriptions[column].location = 4 + column;
+                attributeDescriptions[column].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+                attributeDescriptions[column].offset = offsetof(MeshInstance, transform) + sizeof(glm::vec4) * column;
+            }
+
+            return attributeDescriptions;
+        }
+    };
 }
 
 // Refer to - https://vulkan-tutorial.com/en/Loading_models
 // and https://vulkan-tutorial.com/Loading_models#page_Vertex-deduplication at the bottom
+// The tutorial's shifted XOR of glm's hashes cancels out for symmetric data (mirrored positions, a vertex whose position equals its normal)
+// and piles large OBJs into few buckets. Each float's bits are mixed into the seed in turn instead.
 template<> struct std::hash<FlatEngine::Vertex> 
 {
+    static void Combine(size_t& seed, float value)
+    {
+        // -0.0 and 0.0 compare equal so they have to hash equal too
+        if (value == 0.0f)
+        {
+            value = 0.0f;
+        }
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        seed ^= (size_t)bits + (size_t)0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+
     size_t operator()(FlatEngine::Vertex const& vertex) const
     {
-        return ((std::hash<glm::vec3>()(vertex.pos) ^
-            (std::hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^
-            (std::hash<glm::vec2>()(vertex.texCoord) << 1) ^
-            (std::hash<glm::vec3>()(vertex.normal) << 1);
+        size_t seed = 0;
+        for (int i = 0; i < 3; i++)
+        {
+            Combine(seed, vertex.pos[i]);
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            Combine(seed, vertex.normal[i]);
+        }
+        Combine(seed, vertex.texCoord.x);
+        Combine(seed, vertex.texCoord.y);
+        for (int i = 0; i < 3; i++)
+        {
+            Combine(seed, vertex.color[i]);
+        }
+        return seed;
     }
 };
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "FlatEngine.h"
 #include "GameObject.h"
 
+#include <cmath>
+
 
 namespace FlatEngine
 {
@@ -12,23 +14,18 @@ namespace FlatEngine
 		SetParentID(parentID);
 		m_fontPath = GetFilePath("cinzelBlack");
 		m_fontSize = 40;
-		m_font = TTF_OpenFont(m_fontPath.c_str(), m_fontSize);
 		m_offset = Vector2(0, 0);
 		m_pivotPoint = PivotCenter;
 		m_pivotOffset = Vector2(0, 0); 
 		m_tintColor = Vector4(1,1,1,1);
 		m_text = "Sample Text";
 		m_renderOrder = 0;
-		m_texture = std::make_shared<Texture>();
-		m_white = { (Uint8)255, (Uint8)255, (Uint8)255, (Uint8)255 };
-		m_transparent = { (Uint8)0, (Uint8)0, (Uint8)0, (Uint8)0 };
+		m_layout = nullptr;
 		LoadText();
 	}
 
 	Text::~Text()
 	{
-		m_font = nullptr;
-		TTF_CloseFont(m_font);
 	}
 
 	std::string Text::GetData()
@@ -54,23 +51,18 @@ namespace FlatEngine
 		return data;
 	}
 
+	// Glyphs come from the shared FontAtlas for this font and size, only the layout of the string changes here
 	void Text::LoadText()
 	{
-		if (m_text != "" && m_font != nullptr && m_fontSize > 0)
-		{
-			m_texture->LoadFromRenderedText(m_text, m_white, m_font);
-			m_pivotOffset = Vector2((float)m_texture->GetWidth() / 2, (float)m_texture->GetHeight() / 2);
-		}
-		else 
+		m_layout = nullptr;
+
+		if (m_text != "" && m_fontPath != "" && m_fontSize > 0)
 		{
-			if (m_font == nullptr)
+			m_layout = F_GlyphCache.GetLayout(m_text, m_fontPath, m_fontSize);
+			if (m_layout == nullptr)
 			{
-				TTF_CloseFont(m_font);
-				LogError("Font not valid in \"" + GetParent()->GetName() + "\" Text component.");
+				LogError("Text::LoadText() - Font \"" + m_fontPath + "\" could not be loaded.");
 			}
-			m_texture->FreeTexture();
-			m_pivotOffset = Vector2(0,0);
-			m_offset = m_pivotOffset;
 		}
 
 		UpdatePivotOffset();
@@ -86,9 +78,67 @@ namespace FlatEngine
 		return m_renderOrder;
 	}
 
-	std::shared_ptr<Texture> Text::GetTexture()
+	std::shared_ptr<TextLayout> Text::GetLayout()
 	{
-		return m_texture;
+		return m_layout;
+	}
+
+	int Text::GetWidth()
+	{
+		if (m_layout == nullptr)
+		{
+			return 0;
+		}
+		return m_layout->width;
+	}
+
+	int Text::GetHeight()
+	{
+		if (m_layout == nullptr)
+		{
+			return 0;
+		}
+		return m_layout->height;
+	}
+
+	// One RenderItem per glyph, all on the font's page so they batch together. scale is what would be handed to
+	// AddImageToDrawList() for the whole text, glyph centers are turned about the pivot so the string rotates as one.
+	void Text::GetGlyphRenderItems(Vector2 position, Vector2 scale, float rotation, ImU32 tintColor, std::vector<RenderItem>& renderItems)
+	{
+		renderItems.clear();
+
+		if (m_layout == nullptr || m_layout->font->GetTexture() == VK_NULL_HANDLE)
+		{
+			return;
+		}
+
+		VkDescriptorSet texture = m_layout->font->GetTexture();
+		float pageWidth = (float)m_layout->font->GetPageWidth();
+		float pageHeight = (float)m_layout->font->GetPageHeight();
+		float cosA = cosf(rotation * 2.0f * (float)M_PI / 360.0f);
+		float sinA = sinf(rotation * 2.0f * (float)M_PI / 360.0f);
+
+		for (GlyphQuad& quad : m_layout->quads)
+		{
+			// Glyph center relative to the pivot in grid space (y up)
+			float centerX = (quad.position.x + quad.width / 2 - m_offset.x) * scale.x * F_spriteScaleMultiplier;
+			float centerY = -(quad.position.y + quad.height / 2 - m_offset.y) * scale.y * F_spriteScaleMultiplier;
+
+			RenderItem item = RenderItem();
+			item.texture = texture;
+			item.position = Vector2(position.x + centerX * cosA + centerY * sinA, position.y - centerX * sinA + centerY * cosA);
+			item.textureWidth = quad.width;
+			item.textureHeight = quad.height;
+			item.offset = Vector2(quad.width / 2, quad.height / 2);
+			item.scale = scale;
+			item.rotation = rotation;
+			item.tintColor = tintColor;
+			item.uvStart = Vector2(quad.glyph.x / pageWidth, quad.glyph.y / pageHeight);
+			item.uvEnd = Vector2((quad.glyph.x + quad.glyph.width) / pageWidth, (quad.glyph.y + quad.glyph.height) / pageHeight);
+			item.renderOrder = m_renderOrder;
+			item.b_scalesWithZoom = true;
+			renderItems.push_back(item);
+		}
 	}
 
 	void Text::SetFontPath(std::string path)
@@ -96,14 +146,11 @@ namespace FlatEngine
 		m_fontPath = path;
 		if (path != "" && m_fontSize > 0)
 		{
-			m_font = TTF_OpenFont(m_fontPath.c_str(), m_fontSize);
 			LoadText();
 		}
 		else
 		{
-			TTF_CloseFont(m_font);
-			m_font = nullptr;
-			m_texture->FreeTexture();
+			m_layout = nullptr;
 			LogError("Font not valid in \"" + GetParent()->GetName() + "\" Text component.");
 		}
 	}
@@ -125,11 +172,12 @@ namespace FlatEngine
 
 	void Text::SetText(std::string newText)
 	{
-		m_text = newText;
-		if (m_font != nullptr)
+		if (newText == m_text && m_layout != nullptr)
 		{
-			LoadText();
+			return;
 		}
+		m_text = newText;
+		LoadText();
 	}
 
 	std::string Text::GetText()
@@ -141,9 +189,7 @@ namespace FlatEngine
 	{
 		if (fontSize > 0 && m_fontPath != "")
 		{
-			TTF_CloseFont(m_font);
 			m_fontSize = fontSize;
-			m_font = TTF_OpenFont(m_fontPath.c_str(), m_fontSize);
 			LoadText();
 		}
 	}
@@ -156,6 +202,7 @@ namespace FlatEngine
 	void Text::SetOffset(Vector2 newOffset)
 	{
 		m_offset = newOffset;
+		MarkRenderBoundsDirty();
 	}
 
 	Vector2 Text::GetOffset()
@@ -212,7 +259,7 @@ namespace FlatEngine
 
 	void Text::UpdatePivotOffset()
 	{
-		Vector2 centeredOffset = Vector2((float)m_texture->GetWidth() / 2, (float)m_texture->GetHeight() / 2);
+		Vector2 centeredOffset = Vector2((float)GetWidth() / 2, (float)GetHeight() / 2);
 
 		switch (m_pivotPoint)
 		{
@@ -223,43 +270,43 @@ namespace FlatEngine
 		}
 		case Pivot::PivotLeft:
 		{
-			m_pivotOffset = Vector2(centeredOffset.x - (m_texture->GetWidth() / 2), centeredOffset.y);
+			m_pivotOffset = Vector2(centeredOffset.x - (GetWidth() / 2), centeredOffset.y);
 			break;
 		}
 		case Pivot::PivotRight:
 		{
-			m_pivotOffset = Vector2(centeredOffset.x + (m_texture->GetWidth() / 2), centeredOffset.y);
+			m_pivotOffset = Vector2(centeredOffset.x + (GetWidth() / 2), centeredOffset.y);
 			break;
 		}
 		case Pivot::PivotTop:
 		{
-			m_pivotOffset = Vector2(centeredOffset.x, centeredOffset.y - (m_texture->GetHeight() / 2));
+			m_pivotOffset = Vector2(centeredOffset.x, centeredOffset.y - (GetHeight() / 2));
 			break;
 		}
 		case Pivot::PivotBottom:
 		{
-			m_pivotOffset = Vector2(centeredOffset.x, centeredOffset.y + (m_texture->GetHeight() / 2));
+			m_pivotOffset = Vector2(centeredOffset.x, centeredOffset.y + (GetHeight() / 2));
 			break;
 		}
 
 		case Pivot::PivotTopLeft:
 		{
-			m_pivotOffset = Vector2(centeredOffset.x - (m_texture->GetWidth() / 2), centeredOffset.y - (m_texture->GetHeight() / 2));
+			m_pivotOffset = Vector2(centeredOffset.x - (GetWidth() / 2), centeredOffset.y - (GetHeight() / 2));
 			break;
 		}
 		case Pivot::PivotTopRight:
 		{
-			m_pivotOffset = Vector2(centeredOffset.x + (m_texture->GetWidth() / 2), centeredOffset.y - (m_texture->GetHeight() / 2));
+			m_pivotOffset = Vector2(centeredOffset.x + (GetWidth() / 2), centeredOffset.y - (GetHeight() / 2));
 			break;
 		}
 		case Pivot::PivotBottomLeft:
 		{
-			m_pivotOffset = Vector2(centeredOffset.x - (m_texture->GetWidth() / 2), centeredOffset.y + (m_texture->GetHeight() / 2));
+			m_pivotOffset = Vector2(centeredOffset.x - (GetWidth() / 2), centeredOffset.y + (GetHeight() / 2));
 			break;
 		}
 		case Pivot::PivotBottomRight:
 		{
-			m_pivotOffset = Vector2(centeredOffset.x + (m_texture->GetWidth() / 2), centeredOffset.y + (m_texture->GetHeight() / 2));
+			m_pivotOffset = Vector2(centeredOffset.x + (GetWidth() / 2), centeredOffset.y + (GetHeight() / 2));
 			break;
 		}
 		default:
@@ -270,5 +317,6 @@ namespace FlatEngine
 		}
 
 		m_offset = m_pivotOffset;
+		MarkRenderBoundsDirty();
 	}
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include "Component.h"
 #include "Texture.h"
+#include "GlyphCache.h"
+#include "RenderQueue.h"
 #include "Vector2.h"
 #include "Vector4.h"
 
@@ -21,7 +23,10 @@ namespace FlatEngine
 		void LoadText();
 		void SetRenderOrder(int order);
 		int GetRenderOrder();
-		std::shared_ptr<Texture> GetTexture();
+		std::shared_ptr<TextLayout> GetLayout();
+		int GetWidth();
+		int GetHeight();
+		void GetGlyphRenderItems(Vector2 position, Vector2 scale, float rotation, ImU32 tintColor, std::vector<RenderItem>& renderItems);
 		void SetFontPath(std::string path);
 		std::string GetFontPath();
 		void SetFontSize(int fontSize);
@@ -42,18 +47,15 @@ namespace FlatEngine
 		void UpdatePivotOffset();
 		
 	private:
-		TTF_Font* m_font;
 		std::string m_fontPath;
 		int m_fontSize;
 		std::string m_text;
 		Vector4 m_tintColor;
-		std::shared_ptr<Texture> m_texture;
+		std::shared_ptr<TextLayout> m_layout; // shared through F_GlyphCache with every Text showing the same string
 		Vector2 m_offset;
 		Pivot m_pivotPoint;
 		Vector2 m_pivotOffset;
 		int m_renderOrder;
-		SDL_Color m_white;
-		SDL_Color m_transparent;
 	};
 }
 
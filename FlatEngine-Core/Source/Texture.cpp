@@ -1,6 +1,7 @@
 #include "Texture.h"
 #include "FlatEngine.h"
 #include "VulkanManager.h"
+#include "CookedTexture.h"
 
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_vulkan.h"
@@ -15,6 +16,8 @@ namespace FlatEngine
 		m_path = path;
 		m_textureWidth = 0;
 		m_textureHeight = 0;
+		m_placeholder = nullptr;
+		m_cookedTexture = nullptr;
 		if (path != "")
 		{
 			LoadFromFile(path);
@@ -25,7 +28,7 @@ namespace FlatEngine
 		m_allocationIndex = -1;
 		m_imageView = VK_NULL_HANDLE;
 		m_image = VK_NULL_HANDLE;
-		m_textureImageMemory = VK_NULL_HANDLE;
+		m_textureImageMemory = MemoryAllocation();
 		m_textureSampler = VK_NULL_HANDLE;
 		m_mipLevels = 1;
 	}
@@ -52,6 +55,46 @@ namespace FlatEngine
 		else return false;
 	}
 
+	// Uploads an already decoded RGBA buffer, used for the composed TextureAtlas pages
+	bool Texture::LoadFromPixels(std::vector<unsigned char>& pixels, int width, int height)
+	{
+		if (pixels.size() < (size_t)width * height * 4 || width <= 0 || height <= 0)
+		{
+			return false;
+		}
+
+		FreeTexture();
+		m_path = "";
+		m_pixels.swap(pixels);
+		m_textureWidth = width;
+		m_textureHeight = height;
+
+		F_VulkanManager->CreateImGuiTexture(*this, m_descriptorSets, m_allocationIndex);
+
+		m_pixels.clear();
+		m_pixels.shrink_to_fit();
+		return m_allocationIndex != -1;
+	}
+
+	// Uploads every mip level of an opened cook as it is, the mapping is released once it is in the staging ring
+	bool Texture::LoadFromCooked(std::shared_ptr<CookedTexture> cookedTexture)
+	{
+		if (cookedTexture == nullptr || !cookedTexture->IsOpen())
+		{
+			return false;
+		}
+
+		FreeTexture();
+		m_cookedTexture = cookedTexture;
+		m_textureWidth = cookedTexture->GetHeader().width;
+		m_textureHeight = cookedTexture->GetHeader().height;
+
+		F_VulkanManager->CreateImGuiTexture(*this, m_descriptorSets, m_allocationIndex);
+
+		m_cookedTexture = nullptr;
+		return m_allocationIndex != -1;
+	}
+
 	//Creates image from font string
 	bool Texture::LoadFromRenderedText(std::string textureText, SDL_Color textColor, TTF_Font* font)
 	{	
@@ -97,6 +140,10 @@ namespace FlatEngine
 
 	VkDescriptorSet Texture::GetTexture()
 	{
+		if (m_allocationIndex == -1 && m_placeholder != nullptr)
+		{
+			return m_placeholder->GetTexture();
+		}
 		return m_descriptorSets[VM_currentFrame];
 	}
 
@@ -115,6 +162,11 @@ namespace FlatEngine
 		m_textureHeight = height;
 	}
 
+	void Texture::SetPlaceholder(std::shared_ptr<Texture> placeholder)
+	{
+		m_placeholder = placeholder;
+	}
+
 
 
 
@@ -124,10 +176,12 @@ namespace FlatEngine
 	// Vulkan
 	void Texture::Cleanup(LogicalDevice& logicalDevice)
 	{
+		// The image may still be the destination of an upload that has not executed yet
+		VM_uploadManager.WaitIdle();
 		vkDestroySampler(logicalDevice.GetDevice(), m_textureSampler, nullptr);
-		vkFreeMemory(logicalDevice.GetDevice(), m_textureImageMemory, nullptr);
-		vkDestroyImage(logicalDevice.GetDevice(), m_image, nullptr);
 		vkDestroyImageView(logicalDevice.GetDevice(), m_imageView, nullptr);
+		vkDestroyImage(logicalDevice.GetDevice(), m_image, nullptr);
+		VM_memoryAllocator.Free(m_textureImageMemory);
 	}
 
 
@@ -151,7 +205,7 @@ namespace FlatEngine
 		return m_image;
 	}
 
-	VkDeviceMemory& Texture::GetTextureImageMemory()
+	MemoryAllocation& Texture::GetTextureImageMemory()
 	{
 		return m_textureImageMemory;
 	}
@@ -168,7 +222,20 @@ namespace FlatEngine
 
 	void Texture::CreateTextureImage(WinSys& winSystem, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
 	{
-		VkImage newImage = winSystem.CreateTextureImage(m_path, m_mipLevels, commandPool, physicalDevice, logicalDevice, m_textureImageMemory);
+		VkImage newImage = VK_NULL_HANDLE;
+		if (m_cookedTexture != nullptr)
+		{
+			newImage = winSystem.CreateTextureImage(*m_cookedTexture, m_mipLevels, physicalDevice, logicalDevice, m_textureImageMemory);
+		}
+		else if (m_pixels.size() > 0)
+		{
+			newImage = winSystem.CreateTextureImage(m_pixels.data(), m_textureWidth, m_textureHeight, m_mipLevels, commandPool, physicalDevice, logicalDevice, m_textureImageMemory);
+		}
+		else
+		{
+			newImage = winSystem.CreateTextureImage(m_path, m_mipLevels, commandPool, physicalDevice, logicalDevice, m_textureImageMemory);
+		}
+		m_image = newImage;
 		WinSys::CreateImageView(m_imageView, newImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, logicalDevice);
 		WinSys::CreateTextureSampler(m_textureSampler, m_mipLevels, physicalDevice, logicalDevice);
 	}
@@ -2,6 +2,7 @@
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <string>
+#include <memory>
 
 #include "PhysicalDevice.h"
 #include "LogicalDevice.h"
@@ -13,6 +14,8 @@
 
 namespace FlatEngine
 {
+	class CookedTexture;
+
 	enum Pivot {
 		PivotCenter,
 		PivotLeft,
@@ -43,12 +46,15 @@ namespace FlatEngine
 		~Texture();
 
 		bool LoadFromFile(std::string path);
+		bool LoadFromPixels(std::vector<unsigned char>& pixels, int width, int height);
+		bool LoadFromCooked(std::shared_ptr<CookedTexture> cookedTexture);
 		bool LoadFromRenderedText(std::string textureText, SDL_Color textColor, TTF_Font* font);
 		void FreeTexture();
 		VkDescriptorSet GetTexture();
 		int GetWidth();
 		int GetHeight();
 		void SetDimensions(int width, int height);
+		void SetPlaceholder(std::shared_ptr<Texture> placeholder);
 
 
 
@@ -60,7 +66,7 @@ namespace FlatEngine
 		std::string GetTexturePath();
 		VkImageView& GetImageView();
 		VkImage& GetImage();
-		VkDeviceMemory& GetTextureImageMemory();
+		MemoryAllocation& GetTextureImageMemory();
 		VkSampler& GetTextureSampler();
 		uint32_t GetMipLevels();
 		\
@@ -68,13 +74,16 @@ namespace FlatEngine
 
 	private:
 		std::string m_path;
+		std::vector<unsigned char> m_pixels; // only held between LoadFromPixels() and the upload
+		std::shared_ptr<CookedTexture> m_cookedTexture; // only held between LoadFromCooked() and the upload
 		int m_textureWidth;
 		int m_textureHeight;		
 		std::vector<VkDescriptorSet> m_descriptorSets;
+		std::shared_ptr<Texture> m_placeholder; // drawn instead while the image is still being decoded by F_TextureLoader
 		int m_allocationIndex;
 		VkImage m_image;
 		VkImageView m_imageView;
-		VkDeviceMemory m_textureImageMemory;
+		MemoryAllocation m_textureImageMemory;
 		VkSampler m_textureSampler;
 		uint32_t m_mipLevels;
 	};
@@ -0,0 +1,516 @@
+#include "TextureAtlas.h"
+#include "FlatEngine.h"
+#include "Texture.h"
+#include "VirtualFileSystem.h"
+#include "stb_image.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+
+namespace FlatEngine
+{
+	AtlasPacker::AtlasPacker(int width, int height, int padding)
+	{
+		m_width = 0;
+		m_height = 0;
+		m_padding = padding;
+		m_usedArea = 0;
+		m_skyline = std::vector<S_SkylineNode>();
+		Init(width, height);
+	}
+
+	AtlasPacker::~AtlasPacker()
+	{
+	}
+
+	void AtlasPacker::Init(int width, int height)
+	{
+		m_width = width;
+		m_height = height;
+		m_usedArea = 0;
+		m_skyline.clear();
+		m_skyline.push_back({ 0, 0, width });
+	}
+
+	// Extends the bottom of the area, everything already packed keeps its place
+	void AtlasPacker::Grow(int height)
+	{
+		if (height > m_height)
+		{
+			m_height = height;
+		}
+	}
+
+	// Returns the y a rect of this size would rest at if its left edge sits on m_skyline[nodeIndex], -1 if it does not fit there
+	int AtlasPacker::Fit(int nodeIndex, int width, int height)
+	{
+		int x = m_skyline[nodeIndex].x;
+		if (x + width > m_width)
+		{
+			return -1;
+		}
+
+		int widthLeft = width;
+		int y = m_skyline[nodeIndex].y;
+		int i = nodeIndex;
+
+		while (widthLeft > 0)
+		{
+			y = std::max(y, m_skyline[i].y);
+			if (y + height > m_height)
+			{
+				return -1;
+			}
+			widthLeft -= m_skyline[i].width;
+			i++;
+		}
+
+		return y;
+	}
+
+	void AtlasPacker::AddSkylineLevel(int nodeIndex, int x, int y, int width, int height)
+	{
+		m_skyline.insert(m_skyline.begin() + nodeIndex, { x, y + height, width });
+
+		// Nodes now covered by the new one shrink or go away
+		for (size_t i = nodeIndex + 1; i < m_skyline.size(); i++)
+		{
+			S_SkylineNode& previous = m_skyline[i - 1];
+			if (m_skyline[i].x < previous.x + previous.width)
+			{
+				int shrink = previous.x + previous.width - m_skyline[i].x;
+				m_skyline[i].x += shrink;
+				m_skyline[i].width -= shrink;
+
+				if (m_skyline[i].width <= 0)
+				{
+					m_skyline.erase(m_skyline.begin() + i);
+					i--;
+				}
+				else
+				{
+					break;
+				}
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		// Merge neighbours at the same height
+		for (size_t i = 0; i + 1 < m_skyline.size(); i++)
+		{
+			if (m_skyline[i].y == m_skyline[i + 1].y)
+			{
+				m_skyline[i].width += m_skyline[i + 1].width;
+				m_skyline.erase(m_skyline.begin() + i + 1);
+				i--;
+			}
+		}
+	}
+
+	bool AtlasPacker::Pack(int width, int height, int& x, int& y)
+	{
+		int paddedWidth = width + m_padding;
+		int paddedHeight = height + m_padding;
+		int bestIndex = -1;
+		int bestBottom = m_height + 1;
+		int bestWidth = m_width + 1;
+
+		for (int i = 0; i < (int)m_skyline.size(); i++)
+		{
+			int fitY = Fit(i, paddedWidth, paddedHeight);
+			if (fitY != -1)
+			{
+				int bottom = fitY + paddedHeight;
+				if (bottom < bestBottom || (bottom == bestBottom && m_skyline[i].width < bestWidth))
+				{
+					bestIndex = i;
+					bestBottom = bottom;
+					bestWidth = m_skyline[i].width;
+					x = m_skyline[i].x;
+					y = fitY;
+				}
+			}
+		}
+
+		if (bestIndex == -1)
+		{
+			return false;
+		}
+
+		AddSkylineLevel(bestIndex, x, y, paddedWidth, paddedHeight);
+		m_usedArea += (long long)width * height;
+		return true;
+	}
+
+	int AtlasPacker::GetUsedHeight()
+	{
+		int usedHeight = 0;
+		for (S_SkylineNode& node : m_skyline)
+		{
+			usedHeight = std::max(usedHeight, node.y);
+		}
+		return std::min(usedHeight, m_height);
+	}
+
+	float AtlasPacker::GetOccupancy()
+	{
+		int usedHeight = GetUsedHeight();
+		if (usedHeight == 0)
+		{
+			return 0;
+		}
+		return (float)((double)m_usedArea / ((double)m_width * usedHeight));
+	}
+
+	float AtlasPacker::MeasurePackRate(int rectCount, int iterations, float& occupancy, int& pageCount)
+	{
+		AtlasPacker packer = AtlasPacker();
+		std::vector<std::pair<int, int>> sizes;
+		double totalTime = 0;
+		float occupancySum = 0;
+
+		for (int i = 0; i < rectCount; i++)
+		{
+			sizes.push_back({ (i * 37) % 57 + 8, (i * 23) % 57 + 8 });
+		}
+		std::sort(sizes.begin(), sizes.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.second > b.second; });
+
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			double start = GetTimeInMicroseconds();
+			packer.Init(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+			pageCount = 1;
+			occupancySum = 0;
+
+			for (std::pair<int, int>& size : sizes)
+			{
+				int x = 0;
+				int y = 0;
+				if (!packer.Pack(size.first, size.second, x, y))
+				{
+					occupancySum += packer.GetOccupancy();
+					packer.Init(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+					packer.Pack(size.first, size.second, x, y);
+					pageCount++;
+				}
+			}
+			occupancySum += packer.GetOccupancy();
+			totalTime += GetTimeInMicroseconds() - start;
+		}
+
+		occupancy = occupancySum / pageCount;
+		if (totalTime <= 0)
+		{
+			return 0;
+		}
+		return (float)((double)rectCount * iterations / (totalTime / 1000));
+	}
+
+
+	TextureAtlas::TextureAtlas()
+	{
+		m_pages = std::vector<S_Page>();
+		m_regions = std::unordered_map<std::string, AtlasRegion>();
+		m_buildTime = 0;
+	}
+
+	TextureAtlas::~TextureAtlas()
+	{
+	}
+
+	void TextureAtlas::Clear()
+	{
+		// Pages only have textures once UploadPages() ran, and a frame still in flight may be sampling them
+		bool b_waited = false;
+		for (S_Page& page : m_pages)
+		{
+			if (page.texture != nullptr)
+			{
+				if (!b_waited)
+				{
+					F_VulkanManager->WaitIdle();
+					b_waited = true;
+				}
+				page.texture->FreeTexture();
+				page.texture->Cleanup(F_VulkanManager->GetLogicalDevice());
+			}
+		}
+		m_pages.clear();
+		m_regions.clear();
+	}
+
+	// Packs every image no larger than ATLAS_MAX_IMAGE_SIZE, tallest first, opening a new page whenever the current one is full
+	bool TextureAtlas::Build(std::vector<std::string> imagePaths)
+	{
+		double buildStart = GetTimeInMicroseconds();
+		Clear();
+
+		struct S_Image
+		{
+			std::string path;
+			int width;
+			int height;
+		};
+		std::vector<S_Image> images;
+
+		for (std::string path : imagePaths)
+		{
+			int width = 0;
+			int height = 0;
+			int channels = 0;
+			if (stbi_info(path.c_str(), &width, &height, &channels) && width <= ATLAS_MAX_IMAGE_SIZE && height <= ATLAS_MAX_IMAGE_SIZE)
+			{
+				images.push_back({ path, width, height });
+			}
+		}
+
+		std::sort(images.begin(), images.end(), [](const S_Image& a, const S_Image& b) { return a.height != b.height ? a.height > b.height : a.width > b.width; });
+
+		AtlasPacker packer = AtlasPacker();
+		std::vector<AtlasRegion*> pageRegions;
+
+		auto closePage = [&]()
+		{
+			// Trim the page down to the smallest power of two that holds what was packed
+			int pageHeight = 1;
+			while (pageHeight < packer.GetUsedHeight())
+			{
+				pageHeight *= 2;
+			}
+			m_pages.push_back({ ATLAS_PAGE_SIZE, pageHeight, nullptr });
+
+			for (AtlasRegion* region : pageRegions)
+			{
+				region->uvStart = Vector2((float)region->x / ATLAS_PAGE_SIZE, (float)region->y / pageHeight);
+				region->uvEnd = Vector2((float)(region->x + region->width) / ATLAS_PAGE_SIZE, (float)(region->y + region->height) / pageHeight);
+			}
+			pageRegions.clear();
+		};
+
+		for (S_Image& image : images)
+		{
+			int x = 0;
+			int y = 0;
+			if (!packer.Pack(image.width, image.height, x, y))
+			{
+				closePage();
+				packer.Init(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+				packer.Pack(image.width, image.height, x, y);
+			}
+
+			AtlasRegion& region = m_regions[image.path];
+			region.page = (int)m_pages.size();
+			region.x = x;
+			region.y = y;
+			region.width = image.width;
+			region.height = image.height;
+			pageRegions.push_back(&region);
+		}
+		if (pageRegions.size() > 0)
+		{
+			closePage();
+		}
+
+		m_buildTime = (float)(GetTimeInMicroseconds() - buildStart);
+		return m_regions.size() > 0;
+	}
+
+	bool TextureAtlas::SaveManifest(std::string manifestPath)
+	{
+		json pages = json::array();
+		json regions = json::array();
+
+		for (S_Page& page : m_pages)
+		{
+			pages.push_back({ { "width", page.width }, { "height", page.height } });
+		}
+		for (std::pair<const std::string, AtlasRegion>& region : m_regions)
+		{
+			regions.push_back({
+				{ "path", region.first },
+				{ "page", region.second.page },
+				{ "x", region.second.x },
+				{ "y", region.second.y },
+				{ "width", region.second.width },
+				{ "height", region.second.height }
+			});
+		}
+
+		json manifest = json::object({ { "pages", pages }, { "regions", regions } });
+		std::ofstream fileObject(manifestPath, std::ofstream::out | std::ofstream::trunc);
+		if (!fileObject.good())
+		{
+			LogError("TextureAtlas::SaveManifest() - Could not write " + manifestPath);
+			return false;
+		}
+		fileObject << manifest.dump(4);
+		fileObject.close();
+		return true;
+	}
+
+	bool TextureAtlas::LoadManifest(std::string manifestPath)
+	{
+		Clear();
+
+		json manifest = LoadFileData(manifestPath);
+		if (manifest == nullptr || !manifest.contains("pages") || !manifest.contains("regions"))
+		{
+			return false;
+		}
+
+		for (json& pageData : manifest["pages"])
+		{
+			S_Page page = { CheckJsonInt(pageData, "width", manifestPath), CheckJsonInt(pageData, "height", manifestPath), nullptr };
+			if (page.width <= 0 || page.width > ATLAS_PAGE_SIZE || page.height <= 0 || page.height > ATLAS_PAGE_SIZE)
+			{
+				LogError("TextureAtlas::LoadManifest() - " + manifestPath + " has an invalid page size, rebuild the project to repack it.");
+				Clear();
+				return false;
+			}
+			m_pages.push_back(page);
+		}
+		for (json& regionData : manifest["regions"])
+		{
+			AtlasRegion region = AtlasRegion();
+			region.page = CheckJsonInt(regionData, "page", manifestPath);
+			region.x = CheckJsonInt(regionData, "x", manifestPath);
+			region.y = CheckJsonInt(regionData, "y", manifestPath);
+			region.width = CheckJsonInt(regionData, "width", manifestPath);
+			region.height = CheckJsonInt(regionData, "height", manifestPath);
+
+			std::string path = CheckJsonString(regionData, "path", manifestPath);
+
+			// A region reaching outside its page would be copied past the end of the page's pixels, its sprites load their own texture instead
+			if (!IsRegionInPage(region))
+			{
+				LogError("TextureAtlas::LoadManifest() - " + path + " does not fit in its atlas page, rebuild the project to repack it.");
+			}
+			else
+			{
+				float pageWidth = (float)m_pages[region.page].width;
+				float pageHeight = (float)m_pages[region.page].height;
+				region.uvStart = Vector2(region.x / pageWidth, region.y / pageHeight);
+				region.uvEnd = Vector2((region.x + region.width) / pageWidth, (region.y + region.height) / pageHeight);
+				m_regions.emplace(path, region);
+			}
+		}
+
+		return UploadPages();
+	}
+
+	// Decodes every region into its page and uploads the pages, regions whose image is missing or changed size are dropped
+	// and those sprites keep loading their own texture
+	bool TextureAtlas::UploadPages()
+	{
+		double composeStart = GetTimeInMicroseconds();
+		std::vector<std::vector<unsigned char>> pagePixels;
+
+		for (S_Page& page : m_pages)
+		{
+			pagePixels.push_back(std::vector<unsigned char>((size_t)page.width * page.height * 4, 0));
+		}
+
+		for (auto region = m_regions.begin(); region != m_regions.end();)
+		{
+			if (!IsRegionInPage(region->second))
+			{
+				LogError("TextureAtlas::UploadPages() - " + region->first + " does not fit in its atlas page, rebuild the project to repack it.");
+				region = m_regions.erase(region);
+				continue;
+			}
+
+			int width = 0;
+			int height = 0;
+			int channels = 0;
+			stbi_uc* pixels = nullptr;
+			FileData file;
+			if (F_VirtualFileSystem.Read(region->first, file))
+			{
+				pixels = stbi_load_from_memory(file.GetData(), (int)file.GetSize(), &width, &height, &channels, STBI_rgb_alpha);
+			}
+
+			if (pixels == nullptr || width != region->second.width || height != region->second.height)
+			{
+				LogError("TextureAtlas::UploadPages() - " + region->first + " is missing or no longer matches the atlas manifest, rebuild the project to repack it.");
+				if (pixels != nullptr)
+				{
+					stbi_image_free(pixels);
+				}
+				region = m_regions.erase(region);
+				continue;
+			}
+
+			S_Page& page = m_pages[region->second.page];
+			unsigned char* destination = pagePixels[region->second.page].data();
+			for (int row = 0; row < height; row++)
+			{
+				std::memcpy(destination + ((size_t)(region->second.y + row) * page.width + region->second.x) * 4, pixels + (size_t)row * width * 4, (size_t)width * 4);
+			}
+
+			stbi_image_free(pixels);
+			region++;
+		}
+
+		for (size_t i = 0; i < m_pages.size(); i++)
+		{
+			m_pages[i].texture = std::make_shared<Texture>();
+			if (!m_pages[i].texture->LoadFromPixels(pagePixels[i], m_pages[i].width, m_pages[i].height))
+			{
+				LogError("TextureAtlas::UploadPages() - Failed to upload atlas page " + std::to_string(i));
+			}
+		}
+
+		m_buildTime += (float)(GetTimeInMicroseconds() - composeStart);
+		return m_regions.size() > 0;
+	}
+
+	bool TextureAtlas::IsRegionInPage(AtlasRegion& region)
+	{
+		if (region.page < 0 || region.page >= (int)m_pages.size() || region.x < 0 || region.y < 0 || region.width <= 0 || region.height <= 0)
+		{
+			return false;
+		}
+		S_Page& page = m_pages[region.page];
+		return (long long)region.x + region.width <= page.width && (long long)region.y + region.height <= page.height;
+	}
+
+	bool TextureAtlas::GetRegion(std::string path, AtlasRegion& region)
+	{
+		auto found = m_regions.find(path);
+		if (found == m_regions.end() || m_pages[found->second.page].texture == nullptr)
+		{
+			return false;
+		}
+		region = found->second;
+		return true;
+	}
+
+	VkDescriptorSet TextureAtlas::GetPageTexture(int page)
+	{
+		if (page < 0 || page >= (int)m_pages.size() || m_pages[page].texture == nullptr)
+		{
+			return VK_NULL_HANDLE;
+		}
+		return m_pages[page].texture->GetTexture();
+	}
+
+	int TextureAtlas::GetPageCount()
+	{
+		return (int)m_pages.size();
+	}
+
+	int TextureAtlas::GetRegionCount()
+	{
+		return (int)m_regions.size();
+	}
+
+	float TextureAtlas::GetBuildTime()
+	{
+		return m_buildTime;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+#include "Vector2.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#define GLFW_INCLUDE_VULKAN
+#include <glfw3.h>
+
+
+namespace FlatEngine
+{
+	class Texture;
+
+	const int ATLAS_PAGE_SIZE = 2048;
+	const int ATLAS_MAX_IMAGE_SIZE = 256; // larger images keep their own texture
+	const int ATLAS_PADDING = 2;          // transparent gutter so linear filtering never samples a neighbour
+
+	// Skyline bottom-left rectangle packer, every placement sits as low as possible on the current skyline
+	class AtlasPacker
+	{
+	public:
+		AtlasPacker(int width = ATLAS_PAGE_SIZE, int height = ATLAS_PAGE_SIZE, int padding = ATLAS_PADDING);
+		~AtlasPacker();
+
+		void Init(int width, int height);
+		void Grow(int height);
+		bool Pack(int width, int height, int& x, int& y);
+		int GetUsedHeight();
+		float GetOccupancy();
+		// Headless benchmark over synthetic 8 - 64px rects, returns rects per millisecond
+		static float MeasurePackRate(int rectCount, int iterations, float& occupancy, int& pageCount);
+
+	private:
+		struct S_SkylineNode
+		{
+			int x;
+			int y;
+			int width;
+		};
+
+		int Fit(int nodeIndex, int width, int height);
+		void AddSkylineLevel(int nodeIndex, int x, int y, int width, int height);
+
+		int m_width;
+		int m_height;
+		int m_padding;
+		long long m_usedArea;
+		std::vector<S_SkylineNode> m_skyline;
+	};
+
+	struct AtlasRegion
+	{
+		int page;
+		int x;
+		int y;
+		int width;
+		int height;
+		Vector2 uvStart;
+		Vector2 uvEnd;
+	};
+
+	// Small sprite and animation frame images packed into shared pages so they batch under one texture.
+	// Build() only measures and packs (run from BuildProject() and saved as a manifest), Load() composes
+	// and uploads the pages from the manifest at project load. Sprites pick up their region in SetTexture().
+	class TextureAtlas
+	{
+	public:
+		TextureAtlas();
+		~TextureAtlas();
+
+		void Clear();
+		bool Build(std::vector<std::string> imagePaths);
+		bool SaveManifest(std::string manifestPath);
+		bool LoadManifest(std::string manifestPath);
+		bool UploadPages();
+		bool GetRegion(std::string path, AtlasRegion& region);
+		VkDescriptorSet GetPageTexture(int page);
+		int GetPageCount();
+		int GetRegionCount();
+		float GetBuildTime();
+
+	private:
+		struct S_Page
+		{
+			int width;
+			int height;
+			std::shared_ptr<Texture> texture;
+		};
+
+		bool IsRegionInPage(AtlasRegion& region);
+
+		std::vector<S_Page> m_pages;
+		std::unordered_map<std::string, AtlasRegion> m_regions;
+		float m_buildTime; // microseconds, packing and composing
+	};
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "TextureCache.h"
+#include "FlatEngine.h"
+#include "Texture.h"
+#include "VirtualFileSystem.h"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace FlatEngine
+{
+	TextureCache::TextureCache()
+	{
+		m_entries = std::unordered_map<std::string, S_CacheEntry>();
+		m_budget = TEXTURE_CACHE_BUDGET;
+		m_frame = 0;
+		m_hits = 0;
+		m_misses = 0;
+		m_evictions = 0;
+	}
+
+	TextureCache::~TextureCache()
+	{
+	}
+
+	// "Images/Tree.png", "images\\tree.png" and "images\\..\\images\\tree.png" are the same file on Windows
+	// A path seen before returns the Texture already loaded for it. A new one is decoded by F_TextureLoader and shows the
+	// error texture until it is uploaded, unless b_waitForLoad is set because the caller needs the texture's dimensions now
+	std::shared_ptr<Texture> TextureCache::Acquire(std::string path, bool b_waitForLoad)
+	{
+		if (path == "")
+		{
+			return nullptr;
+		}
+
+		std::string key = VirtualFileSystem::NormalizePath(path);
+		auto found = m_entries.find(key);
+		if (found != m_entries.end())
+		{
+			m_hits++;
+		}
+		else
+		{
+			m_misses++;
+			S_CacheEntry entry = S_CacheEntry();
+			entry.texture = std::make_shared<Texture>();
+			entry.loaded = F_TextureLoader.Load(entry.texture, path, F_AssetManager.GetErrorTexture());
+			found = m_entries.emplace(key, entry).first;
+		}
+
+		found->second.lastReferenced = m_frame;
+		if (b_waitForLoad)
+		{
+			F_TextureLoader.Wait(found->second.loaded);
+		}
+		return found->second.texture;
+	}
+
+	// Called once a frame. Marks which entries are still held and evicts unreferenced ones, oldest first, while over budget
+	void TextureCache::Trim()
+	{
+		m_frame++;
+
+		uint64_t resident = 0;
+		std::vector<std::pair<uint64_t, std::string>> unreferenced;
+		for (std::pair<const std::string, S_CacheEntry>& entry : m_entries)
+		{
+			resident += entry.second.texture->GetTextureImageMemory().size;
+			if (entry.second.texture.use_count() > 1)
+			{
+				entry.second.lastReferenced = m_frame;
+			}
+			else
+			{
+				unreferenced.push_back({ entry.second.lastReferenced, entry.first });
+			}
+		}
+
+		if (resident <= m_budget || unreferenced.size() == 0)
+		{
+			return;
+		}
+
+		std::sort(unreferenced.begin(), unreferenced.end());
+		std::vector<std::string> evicted;
+		for (std::pair<uint64_t, std::string>& candidate : unreferenced)
+		{
+			if (resident <= m_budget)
+			{
+				break;
+			}
+			resident -= m_entries.at(candidate.second).texture->GetTextureImageMemory().size;
+			evicted.push_back(candidate.second);
+		}
+		Evict(evicted);
+	}
+
+	// Drops every entry nothing else holds regardless of the budget, returns how many were released
+	int TextureCache::ReleaseUnused()
+	{
+		std::vector<std::string> evicted;
+		for (std::pair<const std::string, S_CacheEntry>& entry : m_entries)
+		{
+			if (entry.second.texture.use_count() == 1)
+			{
+				evicted.push_back(entry.first);
+			}
+		}
+		Evict(evicted);
+		return (int)evicted.size();
+	}
+
+	void TextureCache::Evict(std::vector<std::string>& keys)
+	{
+		if (keys.size() == 0)
+		{
+			return;
+		}
+
+		// A frame still in flight may be sampling the images
+		F_VulkanManager->WaitIdle();
+		for (std::string& key : keys)
+		{
+			std::shared_ptr<Texture> texture = m_entries.at(key).texture;
+			texture->FreeTexture();
+			texture->Cleanup(F_VulkanManager->GetLogicalDevice());
+			m_entries.erase(key);
+			m_evictions++;
+		}
+	}
+
+	// Releases every cached image, held or not. Only for shutdown, before the VulkanManager is cleaned up
+	void TextureCache::Clear()
+	{
+		std::vector<std::string> keys;
+		for (std::pair<const std::string, S_CacheEntry>& entry : m_entries)
+		{
+			keys.push_back(entry.first);
+		}
+		Evict(keys);
+	}
+
+	void TextureCache::SetBudget(uint64_t budget)
+	{
+		m_budget = budget;
+	}
+
+	uint64_t TextureCache::GetBudget()
+	{
+		return m_budget;
+	}
+
+	uint64_t TextureCache::GetResidentBytes()
+	{
+		uint64_t resident = 0;
+		for (std::pair<const std::string, S_CacheEntry>& entry : m_entries)
+		{
+			resident += entry.second.texture->GetTextureImageMemory().size;
+		}
+		return resident;
+	}
+
+	int TextureCache::GetEntryCount()
+	{
+		return (int)m_entries.size();
+	}
+
+	int TextureCache::GetReferencedCount()
+	{
+		int referenced = 0;
+		for (std::pair<const std::string, S_CacheEntry>& entry : m_entries)
+		{
+			if (entry.second.texture.use_count() > 1)
+			{
+				referenced++;
+			}
+		}
+		return referenced;
+	}
+
+	long TextureCache::GetHits()
+	{
+		return m_hits;
+	}
+
+	long TextureCache::GetMisses()
+	{
+		return m_misses;
+	}
+
+	long TextureCache::GetEvictionCount()
+	{
+		return m_evictions;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+#include "TextureLoader.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+
+namespace FlatEngine
+{
+	class Texture;
+
+	const uint64_t TEXTURE_CACHE_BUDGET = 256ull * 1024 * 1024;
+
+	// One Texture per image file, keyed by normalized path and shared by every Sprite, TileSet and editor icon that shows it.
+	// The shared_ptr use count is the reference count: entries only the cache holds are unreferenced and are destroyed, least
+	// recently referenced first, once resident texture memory goes over the budget. Main thread only.
+	class TextureCache
+	{
+	public:
+		TextureCache();
+		~TextureCache();
+
+		std::shared_ptr<Texture> Acquire(std::string path, bool b_waitForLoad = false);
+		void Trim();
+		int ReleaseUnused();
+		void Clear();
+		void SetBudget(uint64_t budget);
+		uint64_t GetBudget();
+		uint64_t GetResidentBytes();
+		int GetEntryCount();
+		int GetReferencedCount();
+		long GetHits();
+		long GetMisses();
+		long GetEvictionCount();
+
+	private:
+		struct S_CacheEntry
+		{
+			std::shared_ptr<Texture> texture;
+			TextureHandle loaded;
+			uint64_t lastReferenced; // Frame the entry was last held by something other than the cache
+		};
+
+		void Evict(std::vector<std::string>& keys);
+
+		std::unordered_map<std::string, S_CacheEntry> m_entries;
+		uint64_t m_budget;
+		uint64_t m_frame;
+		long m_hits;
+		long m_misses;
+		long m_evictions;
+	};
+}
\ No newline at end of file
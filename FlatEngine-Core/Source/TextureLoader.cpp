@@ -0,0 +1,354 @@
+#include "TextureLoader.h"
+#include "FlatEngine.h"
+#include "Texture.h"
+#include "CookedTexture.h"
+#include "VirtualFileSystem.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+
+
+namespace FlatEngine
+{
+	ImageDecoder::ImageDecoder()
+	{
+		m_threads = std::vector<std::thread>();
+		m_jobs = std::deque<S_DecodeJob>();
+		m_decoded = std::vector<DecodedImage>();
+		m_nextID = 1;
+		m_pendingCount = 0;
+		m_decodedCount = 0;
+		m_decodedBytes = 0;
+		m_decodeTime = 0;
+		m_b_stopping = false;
+	}
+
+	ImageDecoder::~ImageDecoder()
+	{
+		Stop();
+	}
+
+	void ImageDecoder::Start(int threadCount)
+	{
+		Stop();
+
+		m_b_stopping = false;
+		for (int i = 0; i < std::max(1, threadCount); i++)
+		{
+			m_threads.push_back(std::thread(&ImageDecoder::WorkerLoop, this));
+		}
+	}
+
+	// Jobs that have not started are dropped, images already decoded stay available to TakeDecoded()
+	void ImageDecoder::Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_b_stopping = true;
+			m_pendingCount -= (int)m_jobs.size();
+			m_jobs.clear();
+		}
+		m_wake.notify_all();
+
+		for (std::thread& thread : m_threads)
+		{
+			thread.join();
+		}
+		m_threads.clear();
+		m_finished.notify_all();
+	}
+
+	bool ImageDecoder::IsRunning()
+	{
+		return m_threads.size() > 0;
+	}
+
+	uint64_t ImageDecoder::Enqueue(std::string path)
+	{
+		uint64_t id = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			id = m_nextID++;
+			m_jobs.push_back(S_DecodeJob{ id, path });
+			m_pendingCount++;
+		}
+		m_wake.notify_one();
+		return id;
+	}
+
+	void ImageDecoder::TakeDecoded(std::vector<DecodedImage>& decoded)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (DecodedImage& image : m_decoded)
+		{
+			decoded.push_back(std::move(image));
+		}
+		m_decoded.clear();
+	}
+
+	// Blocks until at least one image is finished, returns straight away when nothing is pending
+	void ImageDecoder::WaitForDecoded(std::vector<DecodedImage>& decoded)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_finished.wait(lock, [this] { return m_decoded.size() > 0 || m_pendingCount == 0 || m_threads.size() == 0; });
+		}
+		TakeDecoded(decoded);
+	}
+
+	// Decodes every path on the worker threads and returns the wall clock time it took in microseconds
+	float ImageDecoder::DecodeAll(std::vector<std::string>& paths, std::vector<DecodedImage>& decoded)
+	{
+		if (!IsRunning())
+		{
+			int hardwareThreads = (int)std::thread::hardware_concurrency();
+			Start(std::min(std::max(1, hardwareThreads - 1), TEXTURE_DECODE_MAX_THREADS));
+		}
+
+		double decodeStart = GetTimeInMicroseconds();
+		for (std::string& path : paths)
+		{
+			Enqueue(path);
+		}
+		while (GetPendingCount() > 0)
+		{
+			WaitForDecoded(decoded);
+		}
+		TakeDecoded(decoded);
+
+		return (float)(GetTimeInMicroseconds() - decodeStart);
+	}
+
+	int ImageDecoder::GetPendingCount()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_pendingCount;
+	}
+
+	int ImageDecoder::GetDecodedCount()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_decodedCount;
+	}
+
+	uint64_t ImageDecoder::GetDecodedBytes()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_decodedBytes;
+	}
+
+	float ImageDecoder::GetDecodeTime()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_decodeTime;
+	}
+
+	void ImageDecoder::WorkerLoop()
+	{
+		while (true)
+		{
+			S_DecodeJob job;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [this] { return m_b_stopping || m_jobs.size() > 0; });
+				if (m_b_stopping)
+				{
+					return;
+				}
+				job = m_jobs.front();
+				m_jobs.pop_front();
+			}
+
+			DecodedImage image = DecodedImage();
+			image.id = job.id;
+			image.path = job.path;
+			double decodeStart = GetTimeInMicroseconds();
+			DecodeFile(image);
+			float decodeTime = (float)(GetTimeInMicroseconds() - decodeStart);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_decodeTime += decodeTime;
+				m_decodedCount++;
+				m_decodedBytes += image.cooked != nullptr ? image.cooked->GetHeader().dataSize : image.pixels.size();
+				m_pendingCount--;
+				m_decoded.push_back(std::move(image));
+			}
+			m_finished.notify_all();
+		}
+	}
+
+	void ImageDecoder::DecodeFile(DecodedImage& image)
+	{
+		// Cooked by BuildProject(), nothing to decode
+		if (CookedTexture::HasCurrentCook(image.path))
+		{
+			std::shared_ptr<CookedTexture> cooked = std::make_shared<CookedTexture>();
+			if (cooked->Open(CookedTexture::GetCookedPath(image.path)))
+			{
+				image.cooked = cooked;
+				image.width = cooked->GetHeader().width;
+				image.height = cooked->GetHeader().height;
+				image.b_success = true;
+				return;
+			}
+		}
+
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		stbi_uc* pixels = nullptr;
+		FileData file;
+		if (F_VirtualFileSystem.Read(image.path, file))
+		{
+			pixels = stbi_load_from_memory(file.GetData(), (int)file.GetSize(), &width, &height, &channels, STBI_rgb_alpha);
+		}
+
+		if (pixels != nullptr)
+		{
+			image.pixels.assign(pixels, pixels + (size_t)width * height * 4);
+			image.width = width;
+			image.height = height;
+			image.b_success = true;
+			stbi_image_free(pixels);
+		}
+	}
+
+
+	TextureLoader::TextureLoader()
+	{
+		m_requests = std::map<uint64_t, S_TextureRequest>();
+		m_loadedCount = 0;
+		m_uploadTime = 0;
+	}
+
+	TextureLoader::~TextureLoader()
+	{
+	}
+
+	TextureHandle TextureLoader::Load(std::shared_ptr<Texture> texture, std::string path, std::shared_ptr<Texture> placeholder)
+	{
+		if (!m_decoder.IsRunning())
+		{
+			int hardwareThreads = (int)std::thread::hardware_concurrency();
+			m_decoder.Start(std::min(std::max(1, hardwareThreads - 1), TEXTURE_DECODE_MAX_THREADS));
+		}
+
+		texture->SetTexturePath(path);
+		texture->SetPlaceholder(placeholder);
+
+		uint64_t id = m_decoder.Enqueue(path);
+		S_TextureRequest& request = m_requests[id];
+		request.texture = texture;
+		return request.loaded.get_future().share();
+	}
+
+	void TextureLoader::ProcessDecoded()
+	{
+		if (m_requests.size() == 0)
+		{
+			return;
+		}
+
+		std::vector<DecodedImage> decoded = std::vector<DecodedImage>();
+		m_decoder.TakeDecoded(decoded);
+		Upload(decoded);
+	}
+
+	// The pixels are copied into the upload manager's staging ring by LoadFromPixels(), so the copy itself runs with the next frame
+	void TextureLoader::Upload(std::vector<DecodedImage>& decoded)
+	{
+		double uploadStart = GetTimeInMicroseconds();
+
+		for (DecodedImage& image : decoded)
+		{
+			if (!m_requests.count(image.id))
+			{
+				continue;
+			}
+
+			S_TextureRequest& request = m_requests.at(image.id);
+			bool b_loaded = false;
+			if (image.b_success)
+			{
+				if (image.cooked != nullptr)
+				{
+					b_loaded = request.texture->LoadFromCooked(image.cooked);
+				}
+				else
+				{
+					b_loaded = request.texture->LoadFromPixels(image.pixels, image.width, image.height);
+				}
+				request.texture->SetTexturePath(image.path);
+			}
+			else
+			{
+				LogError("Failed to load texture image: " + image.path);
+			}
+
+			if (b_loaded)
+			{
+				m_loadedCount++;
+			}
+			request.loaded.set_value(b_loaded);
+			m_requests.erase(image.id);
+		}
+
+		m_uploadTime += (float)(GetTimeInMicroseconds() - uploadStart);
+	}
+
+	bool TextureLoader::Wait(TextureHandle& handle)
+	{
+		while (handle.valid() && handle.wait_for(std::chrono::seconds(0)) != std::future_status::ready && m_requests.size() > 0)
+		{
+			std::vector<DecodedImage> decoded = std::vector<DecodedImage>();
+			m_decoder.WaitForDecoded(decoded);
+			Upload(decoded);
+		}
+		return handle.valid() && handle.wait_for(std::chrono::seconds(0)) == std::future_status::ready && handle.get();
+	}
+
+	// Blocks until every requested Texture is uploaded
+	void TextureLoader::Finish()
+	{
+		while (m_requests.size() > 0 && m_decoder.GetPendingCount() > 0)
+		{
+			std::vector<DecodedImage> decoded = std::vector<DecodedImage>();
+			m_decoder.WaitForDecoded(decoded);
+			Upload(decoded);
+		}
+		ProcessDecoded();
+	}
+
+	// Outstanding requests are abandoned, their Textures keep showing the placeholder
+	void TextureLoader::Stop()
+	{
+		m_decoder.Stop();
+		for (std::pair<const uint64_t, S_TextureRequest>& request : m_requests)
+		{
+			request.second.loaded.set_value(false);
+		}
+		m_requests.clear();
+	}
+
+	int TextureLoader::GetPendingCount()
+	{
+		return (int)m_requests.size();
+	}
+
+	int TextureLoader::GetLoadedCount()
+	{
+		return m_loadedCount;
+	}
+
+	float TextureLoader::GetDecodeTime()
+	{
+		return m_decoder.GetDecodeTime();
+	}
+
+	float TextureLoader::GetUploadTime()
+	{
+		return m_uploadTime;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <cstdint>
+
+
+namespace FlatEngine
+{
+	class Texture;
+	class CookedTexture;
+
+	const int TEXTURE_DECODE_MAX_THREADS = 4;
+
+	struct DecodedImage
+	{
+		uint64_t id = 0;
+		std::string path = "";
+		std::vector<unsigned char> pixels; // RGBA, width * height * 4 bytes
+		std::shared_ptr<CookedTexture> cooked; // Set instead of pixels when the image has a current cook, mapped and ready to upload
+		int width = 0;
+		int height = 0;
+		bool b_success = false;
+	};
+
+	// Decodes image files to RGBA pixels on its own worker threads. Enqueue() returns straight away, finished images are
+	// collected with TakeDecoded(). Touches no Vulkan objects so decode throughput can be measured on its own with DecodeAll().
+	class ImageDecoder
+	{
+	public:
+		ImageDecoder();
+		~ImageDecoder();
+
+		void Start(int threadCount);
+		void Stop();
+		bool IsRunning();
+		uint64_t Enqueue(std::string path);
+		void TakeDecoded(std::vector<DecodedImage>& decoded);
+		void WaitForDecoded(std::vector<DecodedImage>& decoded);
+		float DecodeAll(std::vector<std::string>& paths, std::vector<DecodedImage>& decoded);
+		int GetPendingCount();
+		int GetDecodedCount();
+		uint64_t GetDecodedBytes();
+		float GetDecodeTime();
+
+	private:
+		struct S_DecodeJob
+		{
+			uint64_t id;
+			std::string path;
+		};
+
+		void WorkerLoop();
+		static void DecodeFile(DecodedImage& image);
+
+		std::vector<std::thread> m_threads;
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_finished;
+		std::deque<S_DecodeJob> m_jobs;
+		std::vector<DecodedImage> m_decoded;
+		uint64_t m_nextID;
+		int m_pendingCount; // Queued or being decoded
+		int m_decodedCount;
+		uint64_t m_decodedBytes;
+		float m_decodeTime; // Summed across workers
+		bool m_b_stopping;
+	};
+
+	typedef std::shared_future<bool> TextureHandle;
+
+	// Loads Textures from file without blocking the main thread. Images are decoded by an ImageDecoder and uploaded by
+	// ProcessDecoded(), which runs on the main thread once a frame. Until then the Texture hands out the placeholder's
+	// descriptor. The returned handle becomes ready after the upload, true if the image decoded. Do not block on it from
+	// the main thread, use Wait() which keeps processing decoded images while it waits.
+	class TextureLoader
+	{
+	public:
+		TextureLoader();
+		~TextureLoader();
+
+		TextureHandle Load(std::shared_ptr<Texture> texture, std::string path, std::shared_ptr<Texture> placeholder);
+		void ProcessDecoded();
+		bool Wait(TextureHandle& handle);
+		void Finish();
+		void Stop();
+		int GetPendingCount();
+		int GetLoadedCount();
+		float GetDecodeTime();
+		float GetUploadTime();
+
+	private:
+		struct S_TextureRequest
+		{
+			std::shared_ptr<Texture> texture;
+			std::promise<bool> loaded;
+		};
+
+		void Upload(std::vector<DecodedImage>& decoded);
+
+		ImageDecoder m_decoder;
+		std::map<uint64_t, S_TextureRequest> m_requests;
+		int m_loadedCount;
+		float m_uploadTime;
+	};
+}
\ No newline at end of file
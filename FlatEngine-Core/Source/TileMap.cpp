@@ -2,6 +2,9 @@
 #include "FlatEngine.h"
 #include "Scene.h"
 
+#include <algorithm>
+#include <climits>
+
 
 namespace FlatEngine
 {
@@ -15,12 +18,15 @@ namespace FlatEngine
 		m_tileWidth = 16;
 		m_tileHeight = 16;
 		m_renderOrder = F_maxSpriteLayers / 2;
-		m_tiles = std::map<int, std::map<int, Tile>>();
-		m_tempMoveTiles = std::map<int, std::map<int, Tile>>();
+		m_internedTileSetNames = std::vector<std::string>();
 		m_selectedTileSet = "";
 		m_tileSetNames = std::vector<std::string>();
 		m_selectedCollisionArea = "";
 		m_collisionAreas = std::map<std::string, std::vector<CollisionAreaData>>();	
+		m_chunks = std::map<std::pair<int, int>, TileMapChunk>();
+		m_b_chunksStale = true;
+		m_tileSetsGeneration = F_tileSetsGeneration;
+		m_b_missingTileSetLogged = false;
 	}
 
 	TileMap::~TileMap()
@@ -30,7 +36,6 @@ namespace FlatEngine
 	std::string TileMap::GetData()
 	{
 		json tileSetNames = json::array();
-		json tileData = json::array();
 		json collisionAreaData = json::array();
 
 		// TileSet names
@@ -41,22 +46,6 @@ namespace FlatEngine
 			};
 			tileSetNames.push_back(name);
 		}
-		// Tile data
-		for (std::pair<int, std::map<int, Tile>> row : m_tiles)
-		{
-			for (std::pair<int, Tile> col : row.second)
-			{
-				Tile tile = col.second;
-
-				json tileJson = {
-					{ "tileCoordX", tile.tileCoord.x },
-					{ "tileCoordY", tile.tileCoord.y },
-					{ "tileSetName", tile.tileSetName },
-					{ "tileSetIndex", tile.tileSetIndex }
-				};
-				tileData.push_back(tileJson);
-			}
-		}
 		// Collision Area data
 		for (std::pair<std::string, std::vector<CollisionAreaData>> colData : m_collisionAreas)
 		{			
@@ -78,6 +67,7 @@ namespace FlatEngine
 
 			json colAreaData = {
 				{ "name", colData.first },
+				{ "_isMerged", true },
 				{ "areaData", areaCoords }
 			};
 
@@ -94,7 +84,7 @@ namespace FlatEngine
 			{ "tileWidth", m_tileWidth },
 			{ "tileHeight", m_tileHeight },
 			{ "tileSets", tileSetNames },
-			{ "tiles", tileData },
+			{ "tileData", EncodeBase64(EncodeTiles()) },
 			{ "collisionAreas", collisionAreaData }
 		};
 
@@ -126,21 +116,29 @@ namespace FlatEngine
 	void TileMap::SetTileWidth(int width)
 	{
 		m_tileWidth = width;
+		m_b_chunksStale = true;
+		MarkRenderBoundsDirty();
 	}
 
 	void TileMap::SetTileHeight(int height)
 	{
 		m_tileHeight = height;
+		m_b_chunksStale = true;
+		MarkRenderBoundsDirty();
 	}
 
 	void TileMap::SetWidth(int width)
 	{
 		m_width = width;
+		m_b_chunksStale = true;
+		MarkRenderBoundsDirty();
 	}
 
 	void TileMap::SetHeight(int height)
 	{
 		m_height = height;
+		m_b_chunksStale = true;
+		MarkRenderBoundsDirty();
 	}
 
 	void TileMap::SetRenderOrder(int renderOrder)
@@ -229,7 +227,9 @@ namespace FlatEngine
 	//	}
 	//}
 
-	void TileMap::SetCollisionAreaValues(std::string label, std::vector<std::pair<Vector2, Vector2>> colCoords)
+	// Collision areas are rebaked by diffing against the current BoxColliders so only rectangles that actually changed are removed or created.
+	// Pass b_merge = false when the coords are already merged, (loaded from a saved scene).
+	void TileMap::SetCollisionAreaValues(std::string label, std::vector<std::pair<Vector2, Vector2>> colCoords, bool b_merge)
 	{
 		if (m_collisionAreas.count(label) == 0)
 		{
@@ -237,23 +237,147 @@ namespace FlatEngine
 			m_collisionAreas.emplace(label, collAreaData);
 		}
 
-		// Delete old BoxColliders
-		for (CollisionAreaData collisionArea : m_collisionAreas.at(label))
+		if (b_merge)
 		{
-			GetLoadedScene()->RemoveComponent(collisionArea.collider);
+			colCoords = MergeCollisionRects(colCoords);
 		}
+
+		std::vector<CollisionAreaData> oldAreas = m_collisionAreas.at(label);
+		std::vector<bool> b_coordsInUse = std::vector<bool>(colCoords.size(), false);
 		m_collisionAreas.at(label).clear();
 
-		// Use the passed coords to create new CollisionAreaDatas in this Collision Area
-		for (std::pair<Vector2, Vector2> coord : colCoords)
+		// Keep BoxColliders whose rectangle survived, delete the rest
+		for (CollisionAreaData collisionArea : oldAreas)
 		{
-			// Create CollisionAreaData object with that data, including BoxCollider
-			BoxCollider* collider = AddCollisionArea(label, coord.first, coord.second);
+			bool b_keep = false;
+
+			for (int i = 0; i < colCoords.size(); i++)
+			{
+				if (!b_coordsInUse[i] && colCoords[i].first == collisionArea.startCoord && colCoords[i].second == collisionArea.endCoord)
+				{
+					b_coordsInUse[i] = true;
+					b_keep = true;
+					break;
+				}
+			}
+
+			if (b_keep)
+			{
+				m_collisionAreas.at(label).push_back(collisionArea);
+			}
+			else
+			{
+				GetLoadedScene()->RemoveComponent(collisionArea.collider);
+			}
+		}
+
+		// Create CollisionAreaData objects, including BoxColliders, for the new rectangles
+		for (int i = 0; i < colCoords.size(); i++)
+		{
+			if (!b_coordsInUse[i])
+			{
+				AddCollisionArea(label, colCoords[i].first, colCoords[i].second);
+			}
 		}
 
 		CalculateColliderValues(label);
 	}
 
+	// Greedy meshing: rasterize the rectangles into solid tile cells, then sweep the cells in row order growing each
+	// unclaimed solid cell as wide as possible and then as tall as possible. Overlapping or adjacent rectangles collapse
+	// into the fewest rectangles the sweep can find, which keeps static BoxColliders out of the collision pair list.
+	std::vector<std::pair<Vector2, Vector2>> TileMap::MergeCollisionRects(std::vector<std::pair<Vector2, Vector2>> colCoords)
+	{
+		std::vector<std::pair<Vector2, Vector2>> mergedCoords;
+		if (colCoords.size() == 0)
+		{
+			return mergedCoords;
+		}
+
+		int minX = INT_MAX;
+		int minY = INT_MAX;
+		int maxX = INT_MIN;
+		int maxY = INT_MIN;
+
+		for (std::pair<Vector2, Vector2> coord : colCoords)
+		{
+			minX = std::min(minX, (int)std::min(coord.first.x, coord.second.x));
+			minY = std::min(minY, (int)std::min(coord.first.y, coord.second.y));
+			maxX = std::max(maxX, (int)std::max(coord.first.x, coord.second.x));
+			maxY = std::max(maxY, (int)std::max(coord.first.y, coord.second.y));
+		}
+
+		int width = maxX - minX + 1;
+		int height = maxY - minY + 1;
+		std::vector<char> cells = std::vector<char>(width * height, 0);
+
+		for (std::pair<Vector2, Vector2> coord : colCoords)
+		{
+			int startX = (int)std::min(coord.first.x, coord.second.x) - minX;
+			int endX = (int)std::max(coord.first.x, coord.second.x) - minX;
+			int startY = (int)std::min(coord.first.y, coord.second.y) - minY;
+			int endY = (int)std::max(coord.first.y, coord.second.y) - minY;
+
+			for (int y = startY; y <= endY; y++)
+			{
+				for (int x = startX; x <= endX; x++)
+				{
+					cells[y * width + x] = 1;
+				}
+			}
+		}
+
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				if (cells[y * width + x] != 1)
+				{
+					continue;
+				}
+
+				int rectWidth = 1;
+				while (x + rectWidth < width && cells[y * width + x + rectWidth] == 1)
+				{
+					rectWidth++;
+				}
+
+				int rectHeight = 1;
+				bool b_rowSolid = true;
+				while (y + rectHeight < height && b_rowSolid)
+				{
+					for (int checkX = x; checkX < x + rectWidth; checkX++)
+					{
+						if (cells[(y + rectHeight) * width + checkX] != 1)
+						{
+							b_rowSolid = false;
+							break;
+						}
+					}
+					if (b_rowSolid)
+					{
+						rectHeight++;
+					}
+				}
+
+				// Claim the cells so they are not used again
+				for (int claimY = y; claimY < y + rectHeight; claimY++)
+				{
+					for (int claimX = x; claimX < x + rectWidth; claimX++)
+					{
+						cells[claimY * width + claimX] = 2;
+					}
+				}
+
+				Vector2 startCoord = Vector2((float)(x + minX), (float)(y + minY));
+				Vector2 endCoord = Vector2((float)(x + minX + rectWidth - 1), (float)(y + minY + rectHeight - 1));
+				mergedCoords.push_back({ startCoord, endCoord });
+			}
+		}
+
+		return mergedCoords;
+	}
+
 	void TileMap::CalculateColliderValues(std::string label)
 	{
 		if (m_collisionAreas.count(label) >= 0)
@@ -346,85 +470,28 @@ namespace FlatEngine
 
 	void TileMap::MoveTiles(std::vector<Vector2> tiles, Vector2 moveAmount)
 	{
-		m_tempMoveTiles.clear();
-		
-		// Make temp copies first so that no Tile being copied over gets overridden by a Tile before it before it gets copied itself.
-		for (Vector2 tile : tiles)
-		{
-			MoveTile(tile, moveAmount);
-		}
+		// Lift every Tile out first so that no Tile being moved gets overridden by a Tile before it before it gets moved itself.
+		std::vector<std::pair<Vector2, Tile>> movedTiles;
 
-		// Copy new, temp tiles into the main TileMap.
-		for (std::pair<int, std::map<int, Tile>> tileRow : m_tempMoveTiles)
+		for (Vector2 tileCoords : tiles)
 		{
-			for (std::pair<int, Tile> tileCol : tileRow.second)
+			Tile* tile = GetTile((int)tileCoords.x, (int)tileCoords.y);
+			if (tile != nullptr)
 			{
-				int x = tileRow.first;
-				int y = tileCol.first;
-				Tile tileCopy = tileCol.second;
-
-				if (m_tiles.count(x) > 0 && m_tiles.at(x).count(y) > 0)
-				{
-					m_tiles.at(x).at(y) = tileCopy;
-				}
-				else if (m_tiles.count(x) > 0 && m_tiles.at(x).count(y) == 0)
-				{
-					std::pair<int, Tile> newPair = { y, tileCopy };
-					m_tiles.at(x).emplace(newPair);
-				}
-				else if (m_tiles.count(x) == 0)
-				{
-					std::pair<int, Tile> newPair = { y, tileCopy };
-					std::map<int, Tile> yCoords;
-					yCoords.emplace(newPair);
-					m_tiles.emplace(x, yCoords);
-				}
+				movedTiles.push_back({ Vector2(tileCoords.x + moveAmount.x, tileCoords.y + moveAmount.y), *tile });
+				EraseTile(tileCoords);
 			}
 		}
+
+		for (std::pair<Vector2, Tile> movedTile : movedTiles)
+		{
+			PlaceTile((int)movedTile.first.x, (int)movedTile.first.y, movedTile.second);
+		}
 	}
 
 	void TileMap::MoveTile(Vector2 tileCoords, Vector2 moveAmount)
 	{
-		int oldX = (int)tileCoords.x;
-		int oldY = (int)tileCoords.y;
-
-		if (m_tiles.count(oldX) > 0 && m_tiles.at(oldX).count(oldY) > 0)
-		{
-			int x = (int)(tileCoords.x + moveAmount.x);
-			int y = (int)(tileCoords.y + moveAmount.y);
-
-			Tile originalTile = m_tiles.at(oldX).at(oldY);
-			Tile newTile;
-			
-			if (originalTile.tileSetName != "")
-			{
-				newTile.tileSetTexture = GetTileSet(originalTile.tileSetName)->GetTexture()->GetTexture();
-			}
-			newTile.tileSetIndex = originalTile.tileSetIndex;
-			newTile.tileSetName = originalTile.tileSetName;
-			newTile.tileCoord = Vector2((float)x, (float)y);
-			newTile.uvStart = originalTile.uvStart;
-			newTile.uvEnd = originalTile.uvEnd;
-
-			// Erase old tile data
-			if (m_tiles.count(oldX) > 0 && m_tiles.at(oldX).count(oldY) > 0)
-			{
-				m_tiles.at(oldX).erase(oldY);
-			}
-
-			// Copy new data into m_tempMoveTiles to be copied after all tiles are copied
-			std::pair<int, Tile> newPair = { y, newTile };
-			std::map<int, Tile> yCoords;
-			yCoords.emplace(newPair);
-			if (m_tempMoveTiles.count(x) > 0)
-			{
-				m_tempMoveTiles.at(x).emplace(newPair);
-			}
-			else
-			{
-				m_tempMoveTiles.emplace(x, yCoords);
-			}
-		}
+		MoveTiles(std::vector<Vector2>{ tileCoords }, moveAmount);
 	}
 
 	bool TileMap::ContainsCollisionAreaLabel(std::string label)
@@ -458,58 +525,434 @@ namespace FlatEngine
 		return m_tileSetNames;
 	}
 
-	std::map<int, std::map<int, Tile>> TileMap::GetTiles()
+	void TileMap::SetTile(Vector2 coord, TileSet* tileSet, int tileSetIndex)
 	{
-		return m_tiles;
+		SetTile((int)coord.x, (int)coord.y, tileSet->GetName(), tileSetIndex);
 	}
 
-	void TileMap::SetTile(Vector2 coord, TileSet* tileSet, int tileSetIndex)
+	void TileMap::SetTile(int x, int y, std::string tileSetName, int tileSetIndex)
 	{
-		VkDescriptorSet texture = tileSet->GetTexture()->GetTexture();
-		Vector2 uvStart = tileSet->GetIndexUVs(tileSetIndex).first;
-		Vector2 uvEnd = tileSet->GetIndexUVs(tileSetIndex).second;
+		if (tileSetIndex < 0 || tileSetIndex > 0xFFFF)
+		{
+			LogError("TileMap - TileSet index " + std::to_string(tileSetIndex) + " is out of range.");
+			return;
+		}
 
 		Tile newTile = Tile();
-		newTile.tileCoord = coord;
-		int x = (int)coord.x;
-		int y = (int)coord.y;
-		newTile.tileSetName = tileSet->GetName();
-		newTile.tileSetIndex = tileSetIndex;
-		newTile.tileSetTexture = texture;
-		newTile.uvStart = uvStart;
-		newTile.uvEnd = uvEnd;
+		newTile.tileSet = InternTileSetName(tileSetName);
+		newTile.tileSetIndex = (uint16_t)tileSetIndex;
 
-		if (m_tiles.count(x) > 0 && m_tiles.at(x).count(y) > 0)
+		if (newTile.tileSet != EMPTY_TILE)
 		{
-			m_tiles.at(x).at(y) = newTile;
+			PlaceTile(x, y, newTile);
 		}
-		else if (m_tiles.count(x) > 0 && m_tiles.at(x).count(y) == 0)
+	}
+
+	Tile* TileMap::GetTile(int x, int y)
+	{
+		std::map<std::pair<int, int>, TileMapChunk>::iterator chunkIter = m_chunks.find({ GetChunkCoord(x), GetChunkCoord(y) });
+		if (chunkIter == m_chunks.end())
 		{
-			std::pair<int, Tile> newPair = { y, newTile };
-			m_tiles.at(x).emplace(newPair);
+			return nullptr;
 		}
-		else if (m_tiles.count(x) == 0)
+
+		TileMapChunk& chunk = chunkIter->second;
+		Tile& tile = chunk.tiles[(y - chunk.chunkY * TILEMAP_CHUNK_SIZE) * TILEMAP_CHUNK_SIZE + (x - chunk.chunkX * TILEMAP_CHUNK_SIZE)];
+		if (tile.tileSet == EMPTY_TILE)
 		{
-			std::pair<int, Tile> newPair = { y, newTile };
-			std::map<int, Tile> yCoords;
-			yCoords.emplace(newPair);
-			m_tiles.emplace(x, yCoords);
+			return nullptr;
 		}
+
+		return &tile;
+	}
+
+	std::string TileMap::GetTileSetName(Tile tile)
+	{
+		if (tile.tileSet < m_internedTileSetNames.size())
+		{
+			return m_internedTileSetNames[tile.tileSet];
+		}
+		return "";
 	}
 
-	void TileMap::SetTiles(std::map<int, std::map<int, Tile>> tiles)
+	// In pixels of the TileSet texture, the same as TileSet::GetIndexUVs
+	std::pair<Vector2, Vector2> TileMap::GetTileUVs(Tile tile)
 	{
-		m_tiles = tiles;
+		TileSet* tileSet = GetTileSet(GetTileSetName(tile));
+		if (tileSet != nullptr)
+		{
+			return tileSet->GetIndexUVs(tile.tileSetIndex);
+		}
+		return { Vector2(0, 0), Vector2(0, 0) };
 	}
 
 	void TileMap::EraseTile(Vector2 tileMapCoords)
 	{
 		int x = (int)tileMapCoords.x;
 		int y = (int)tileMapCoords.y;
+		Tile* tile = GetTile(x, y);
+
+		if (tile != nullptr)
+		{
+			*tile = Tile();
+			TileMapChunk& chunk = m_chunks.at({ GetChunkCoord(x), GetChunkCoord(y) });
+			chunk.tileCount--;
+			chunk.b_dirty = true;
+			// Render bounds cover the chunks holding tiles
+			if (chunk.tileCount == 0)
+			{
+				MarkRenderBoundsDirty();
+			}
+		}
+	}
+
+	void TileMap::ClearTiles()
+	{
+		m_chunks.clear();
+		m_internedTileSetNames.clear();
+		MarkRenderBoundsDirty();
+	}
+
+	int TileMap::GetTileCount()
+	{
+		int tileCount = 0;
+		for (std::pair<const std::pair<int, int>, TileMapChunk>& chunk : m_chunks)
+		{
+			tileCount += chunk.second.tileCount;
+		}
+		return tileCount;
+	}
+
+	uint16_t TileMap::InternTileSetName(std::string tileSetName)
+	{
+		if (tileSetName == "")
+		{
+			return EMPTY_TILE;
+		}
+
+		for (size_t i = 0; i < m_internedTileSetNames.size(); i++)
+		{
+			if (m_internedTileSetNames[i] == tileSetName)
+			{
+				return (uint16_t)i;
+			}
+		}
 
-		if (m_tiles.count(x) > 0 && m_tiles.at(x).count(y) > 0)
+		if (m_internedTileSetNames.size() >= EMPTY_TILE)
 		{
-			m_tiles.at(x).erase(y);
+			LogError("TileMap - Too many TileSets used in one TileMap.");
+			return EMPTY_TILE;
+		}
+
+		m_internedTileSetNames.push_back(tileSetName);
+		return (uint16_t)(m_internedTileSetNames.size() - 1);
+	}
+
+	TileMapChunk& TileMap::GetOrCreateChunk(int x, int y)
+	{
+		std::pair<int, int> chunkKey = { GetChunkCoord(x), GetChunkCoord(y) };
+
+		if (m_chunks.count(chunkKey) == 0)
+		{
+			TileMapChunk chunk = TileMapChunk();
+			chunk.chunkX = chunkKey.first;
+			chunk.chunkY = chunkKey.second;
+			chunk.tiles = std::vector<Tile>(TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE);
+			chunk.tileCount = 0;
+			chunk.b_dirty = true;
+			m_chunks.emplace(chunkKey, chunk);
+		}
+
+		return m_chunks.at(chunkKey);
+	}
+
+	void TileMap::PlaceTile(int x, int y, Tile tile)
+	{
+		TileMapChunk& chunk = GetOrCreateChunk(x, y);
+		Tile& cell = chunk.tiles[(y - chunk.chunkY * TILEMAP_CHUNK_SIZE) * TILEMAP_CHUNK_SIZE + (x - chunk.chunkX * TILEMAP_CHUNK_SIZE)];
+
+		if (cell.tileSet == EMPTY_TILE)
+		{
+			chunk.tileCount++;
+			if (chunk.tileCount == 1)
+			{
+				MarkRenderBoundsDirty();
+			}
+		}
+		cell = tile;
+		chunk.b_dirty = true;
+	}
+
+	static void WriteUint16(std::vector<uint8_t>& data, uint16_t value)
+	{
+		data.push_back((uint8_t)(value & 0xFF));
+		data.push_back((uint8_t)(value >> 8));
+	}
+
+	static void WriteUint32(std::vector<uint8_t>& data, uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			data.push_back((uint8_t)((value >> (i * 8)) & 0xFF));
+		}
+	}
+
+	static bool ReadUint16(const std::vector<uint8_t>& data, size_t& offset, uint16_t& value)
+	{
+		if (offset + 2 > data.size())
+		{
+			return false;
+		}
+		value = (uint16_t)(data[offset] | (data[offset + 1] << 8));
+		offset += 2;
+		return true;
+	}
+
+	static bool ReadUint32(const std::vector<uint8_t>& data, size_t& offset, uint32_t& value)
+	{
+		if (offset + 4 > data.size())
+		{
+			return false;
+		}
+		value = (uint32_t)data[offset] | ((uint32_t)data[offset + 1] << 8) | ((uint32_t)data[offset + 2] << 16) | ((uint32_t)data[offset + 3] << 24);
+		offset += 4;
+		return true;
+	}
+
+	// Little endian layout:
+	// "FLTM" | u16 version | u16 name count | (u16 length, chars) per name |
+	// u32 chunk count | (i32 chunkX, i32 chunkY, u16 tile count, (u16 cell, u16 tileSet, u16 tileSetIndex) per tile) per chunk
+	std::vector<uint8_t> TileMap::EncodeTiles()
+	{
+		std::vector<uint8_t> data;
+		data.push_back('F');
+		data.push_back('L');
+		data.push_back('T');
+		data.push_back('M');
+		WriteUint16(data, 1);
+
+		WriteUint16(data, (uint16_t)m_internedTileSetNames.size());
+		for (std::string tileSetName : m_internedTileSetNames)
+		{
+			WriteUint16(data, (uint16_t)tileSetName.size());
+			data.insert(data.end(), tileSetName.begin(), tileSetName.end());
+		}
+
+		uint32_t chunkCount = 0;
+		for (std::pair<const std::pair<int, int>, TileMapChunk>& chunk : m_chunks)
+		{
+			if (chunk.second.tileCount > 0)
+			{
+				chunkCount++;
+			}
+		}
+		WriteUint32(data, chunkCount);
+
+		for (std::pair<const std::pair<int, int>, TileMapChunk>& chunkPair : m_chunks)
+		{
+			TileMapChunk& chunk = chunkPair.second;
+			if (chunk.tileCount == 0)
+			{
+				continue;
+			}
+
+			WriteUint32(data, (uint32_t)chunk.chunkX);
+			WriteUint32(data, (uint32_t)chunk.chunkY);
+			WriteUint16(data, (uint16_t)chunk.tileCount);
+
+			for (size_t cell = 0; cell < chunk.tiles.size(); cell++)
+			{
+				if (chunk.tiles[cell].tileSet != EMPTY_TILE)
+				{
+					WriteUint16(data, (uint16_t)cell);
+					WriteUint16(data, chunk.tiles[cell].tileSet);
+					WriteUint16(data, chunk.tiles[cell].tileSetIndex);
+				}
+			}
+		}
+
+		return data;
+	}
+
+	// Replaces every tile in the TileMap. Names are interned again so the indices in data do not have to match the current ones
+	bool TileMap::DecodeTiles(const std::vector<uint8_t>& data)
+	{
+		ClearTiles();
+
+		if (data.size() < 6 || data[0] != 'F' || data[1] != 'L' || data[2] != 'T' || data[3] != 'M')
+		{
+			LogError("TileMap - Tile data is not in a recognized format.");
+			return false;
+		}
+
+		size_t offset = 4;
+		uint16_t version = 0;
+		ReadUint16(data, offset, version);
+		if (version != 1)
+		{
+			LogError("TileMap - Tile data version " + std::to_string(version) + " is not supported.");
+			return false;
+		}
+
+		uint16_t nameCount = 0;
+		std::vector<uint16_t> nameRemap;
+		bool b_valid = ReadUint16(data, offset, nameCount);
+
+		for (uint16_t i = 0; b_valid && i < nameCount; i++)
+		{
+			uint16_t length = 0;
+			b_valid = ReadUint16(data, offset, length) && offset + length <= data.size();
+			if (b_valid)
+			{
+				nameRemap.push_back(InternTileSetName(std::string(data.begin() + offset, data.begin() + offset + length)));
+				offset += length;
+			}
+		}
+
+		uint32_t chunkCount = 0;
+		b_valid = b_valid && ReadUint32(data, offset, chunkCount);
+
+		for (uint32_t i = 0; b_valid && i < chunkCount; i++)
+		{
+			uint32_t chunkX = 0;
+			uint32_t chunkY = 0;
+			uint16_t tileCount = 0;
+			b_valid = ReadUint32(data, offset, chunkX) && ReadUint32(data, offset, chunkY) && ReadUint16(data, offset, tileCount);
+
+			for (uint16_t t = 0; b_valid && t < tileCount; t++)
+			{
+				uint16_t cell = 0;
+				Tile tile = Tile();
+				b_valid = ReadUint16(data, offset, cell) && ReadUint16(data, offset, tile.tileSet) && ReadUint16(data, offset, tile.tileSetIndex) &&
+					cell < TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE && tile.tileSet < nameRemap.size();
+
+				if (b_valid && nameRemap[tile.tileSet] != EMPTY_TILE)
+				{
+					tile.tileSet = nameRemap[tile.tileSet];
+					int x = (int)chunkX * TILEMAP_CHUNK_SIZE + cell % TILEMAP_CHUNK_SIZE;
+					int y = (int)chunkY * TILEMAP_CHUNK_SIZE + cell / TILEMAP_CHUNK_SIZE;
+					PlaceTile(x, y, tile);
+				}
+			}
+		}
+
+		if (!b_valid)
+		{
+			LogError("TileMap - Tile data is truncated or corrupt.");
+			ClearTiles();
+			return false;
+		}
+
+		return true;
+	}
+
+	std::map<std::pair<int, int>, TileMapChunk>& TileMap::GetChunks()
+	{
+		return m_chunks;
+	}
+
+	// Floor division so tiles at negative coordinates land in their own chunks
+	int TileMap::GetChunkCoord(int tileCoord)
+	{
+		if (tileCoord < 0)
+		{
+			return (tileCoord - TILEMAP_CHUNK_SIZE + 1) / TILEMAP_CHUNK_SIZE;
+		}
+		return tileCoord / TILEMAP_CHUNK_SIZE;
+	}
+
+	// Rebuilds the chunks touched since the last call, or all of them after the map or tile size or the loaded TileSets changed
+	void TileMap::UpdateChunks()
+	{
+		if (m_tileSetsGeneration != F_tileSetsGeneration)
+		{
+			m_tileSetsGeneration = F_tileSetsGeneration;
+			m_b_missingTileSetLogged = false;
+			m_b_chunksStale = true;
+		}
+
+		if (m_b_chunksStale)
+		{
+			for (std::pair<const std::pair<int, int>, TileMapChunk>& chunk : m_chunks)
+			{
+				chunk.second.b_dirty = true;
+			}
+			m_b_chunksStale = false;
+		}
+
+		std::map<std::pair<int, int>, TileMapChunk>::iterator chunkIter = m_chunks.begin();
+		while (chunkIter != m_chunks.end())
+		{
+			if (chunkIter->second.tileCount == 0)
+			{
+				chunkIter = m_chunks.erase(chunkIter);
+				continue;
+			}
+
+			if (chunkIter->second.b_dirty)
+			{
+				RebuildChunk(chunkIter->second);
+			}
+			chunkIter++;
+		}
+	}
+
+	// Scale and render order come from the owner when the chunk is drawn so changing them does not need a rebuild
+	void TileMap::RebuildChunk(TileMapChunk& chunk)
+	{
+		chunk.items.clear();
+		chunk.b_dirty = false;
+
+		int startX = chunk.chunkX * TILEMAP_CHUNK_SIZE;
+		int startY = chunk.chunkY * TILEMAP_CHUNK_SIZE;
+		ImU32 white = GetColor32("white");
+		TileSet* usedTileSet = nullptr;
+		uint16_t usedTileSetID = EMPTY_TILE;
+
+		for (int cell = 0; cell < (int)chunk.tiles.size(); cell++)
+		{
+			Tile& tile = chunk.tiles[cell];
+			int x = startX + cell % TILEMAP_CHUNK_SIZE;
+			int y = startY + cell / TILEMAP_CHUNK_SIZE;
+
+			if (tile.tileSet == EMPTY_TILE || x < 0 || x >= m_width || y < 0 || y >= m_height)
+			{
+				continue;
+			}
+			if (usedTileSet == nullptr || tile.tileSet != usedTileSetID)
+			{
+				usedTileSet = GetTileSet(GetTileSetName(tile));
+				usedTileSetID = tile.tileSet;
+			}
+			// The chunk stays clean without these tiles, UpdateChunks() rebuilds every chunk once F_TileSets changes
+			if (usedTileSet == nullptr)
+			{
+				if (!m_b_missingTileSetLogged)
+				{
+					LogError("TileMap - TileSet \"" + GetTileSetName(tile) + "\" is not loaded, its tiles are not drawn.");
+					m_b_missingTileSetLogged = true;
+				}
+				continue;
+			}
+
+			float textureWidth = (float)usedTileSet->GetTexture()->GetWidth();
+			float textureHeight = (float)usedTileSet->GetTexture()->GetHeight();
+			std::pair<Vector2, Vector2> uvs = usedTileSet->GetIndexUVs(tile.tileSetIndex);
+
+			RenderItem item = RenderItem();
+			item.texture = usedTileSet->GetTexture()->GetTexture();
+			item.position = Vector2(2 * (float)x, -2 * (float)y);
+			item.textureWidth = (float)m_tileWidth;
+			item.textureHeight = (float)m_tileHeight;
+			item.offset = Vector2(0, 0);
+			item.scale = Vector2(1, 1);
+			item.rotation = 0;
+			item.tintColor = white;
+			item.uvStart = Vector2(uvs.first.x / textureWidth, uvs.first.y / textureHeight);
+			item.uvEnd = Vector2(uvs.second.x / textureWidth, uvs.second.y / textureHeight);
+			item.renderOrder = m_renderOrder;
+			item.b_scalesWithZoom = true;
+			chunk.items.push_back(item);
 		}
 	}
 }
\ No newline at end of file
@@ -3,21 +3,34 @@
 #include "BoxCollider.h"
 #include "TileSet.h"
 #include "Vector2.h"
+#include "RenderQueue.h"
 
 #include <vector>
 #include <string>
 #include <map>
+#include <cstdint>
 
 
 namespace FlatEngine
 {
+    const uint16_t EMPTY_TILE = 0xFFFF;
+
+    // 4 bytes per cell. The TileSet name lives once in the TileMap and the UVs are looked up in the TileSet when needed
     struct Tile {
-        Vector2 tileCoord;
-        std::string tileSetName;
-        VkDescriptorSet tileSetTexture;
-        int tileSetIndex;
-        Vector2 uvStart;
-        Vector2 uvEnd;
+        uint16_t tileSet = EMPTY_TILE; // index into the TileMap's interned TileSet names
+        uint16_t tileSetIndex = 0;
+    };
+
+    const int TILEMAP_CHUNK_SIZE = 32; // in tiles
+
+    // Dense TILEMAP_CHUNK_SIZE square of tiles (row by row) plus its render items, which are only rebuilt when a tile inside it changes
+    struct TileMapChunk {
+        int chunkX;
+        int chunkY;
+        std::vector<Tile> tiles;
+        int tileCount;
+        std::vector<RenderItem> items; // positions relative to the top left corner of the TileMap, in grid space
+        bool b_dirty;
     };
 
     struct CollisionAreaData {
@@ -49,7 +62,8 @@ namespace FlatEngine
         BoxCollider* AddCollisionArea(std::string label, Vector2 startCoord, Vector2 endCoord);
         void SetCollisionAreas(std::map<std::string, std::vector<CollisionAreaData>> collisionAreas);
         //void RemoveCollisionArea(std::string label, Vector2 startCoord, Vector2 endCoord);
-        void SetCollisionAreaValues(std::string label, std::vector<std::pair<Vector2, Vector2>> colCoords);
+        void SetCollisionAreaValues(std::string label, std::vector<std::pair<Vector2, Vector2>> colCoords, bool b_merge = true);
+        static std::vector<std::pair<Vector2, Vector2>> MergeCollisionRects(std::vector<std::pair<Vector2, Vector2>> colCoords);
         void CalculateColliderValues(std::string label);
         std::string GetSelectedCollisionArea();
         void SetSelectedCollisionArea(std::string selectedCollisionArea);
@@ -61,23 +75,40 @@ namespace FlatEngine
         void RemoveTileSet(std::string name);
         void SetTileSets(std::vector<std::string> tileSets);
         std::vector<std::string> GetTileSets();
-        std::map<int, std::map<int, Tile>> GetTiles();        
         void SetTile(Vector2 tileMapCoords, TileSet* tileSet, int tileSetIndex);
-        void SetTiles(std::map<int, std::map<int, Tile>> tiles);
+        void SetTile(int x, int y, std::string tileSetName, int tileSetIndex);
+        Tile* GetTile(int x, int y);
+        std::string GetTileSetName(Tile tile);
+        std::pair<Vector2, Vector2> GetTileUVs(Tile tile);
         void EraseTile(Vector2 tileMapCoords);
+        void ClearTiles();
+        int GetTileCount();
+        std::vector<uint8_t> EncodeTiles();
+        bool DecodeTiles(const std::vector<uint8_t>& data);
+        std::map<std::pair<int, int>, TileMapChunk>& GetChunks();
+        void UpdateChunks();
+        static int GetChunkCoord(int tileCoord);
 
     private:
+        uint16_t InternTileSetName(std::string tileSetName);
+        TileMapChunk& GetOrCreateChunk(int x, int y);
+        void PlaceTile(int x, int y, Tile tile);
+        void RebuildChunk(TileMapChunk& chunk);
+
         int m_width;
         int m_height;
         int m_tileWidth;
         int m_tileHeight;
         int m_renderOrder;
-        std::map<int, std::map<int, Tile>> m_tiles;
-        std::map<int, std::map<int, Tile>> m_tempMoveTiles;
+        std::vector<std::string> m_internedTileSetNames;
         std::string m_selectedTileSet;
         std::vector<std::string> m_tileSetNames;  
         std::string m_selectedCollisionArea;
         std::map<std::string, std::vector<CollisionAreaData>> m_collisionAreas;
+        std::map<std::pair<int, int>, TileMapChunk> m_chunks;
+        bool m_b_chunksStale; // every chunk needs new render items, the map or tile size changed
+        unsigned long m_tileSetsGeneration; // F_tileSetsGeneration the chunks were last built against
+        bool m_b_missingTileSetLogged;
     };
 }
 
@@ -1,5 +1,6 @@
 #include "TileSet.h"
 #include "FlatEngine.h"
+#include "TextureCache.h"
 
 #include <filesystem>
 #include "json.hpp"
@@ -64,7 +65,9 @@ namespace FlatEngine
     void TileSet::SetTexturePath(std::string texturePath)
     {
         m_texturePath = texturePath;
-        m_texture->LoadFromFile(m_texturePath);
+        // Shared with any Sprite or TileSet using the same image, waits for the load because the UVs need its dimensions
+        std::shared_ptr<Texture> texture = F_TextureCache.Acquire(m_texturePath, true);
+        m_texture = texture != nullptr ? texture : std::make_shared<Texture>();
         InitializeUVs();
     }
 
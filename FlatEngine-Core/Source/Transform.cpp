@@ -2,6 +2,7 @@
 #include "FlatEngine.h"
 #include "GameObject.h"
 #include "Button.h"
+#include "BoxCollider.h"
 
 
 namespace FlatEngine
@@ -49,11 +50,14 @@ namespace FlatEngine
 	{
 		m_position = initialPos;
 		m_position3D = Vector3(m_position.x, m_position.y, 0);
+		MarkRenderBoundsDirty();
 	}
 
 	void Transform::SetOrigin(Vector2 newOrigin)
 	{
 		m_origin = Vector2(newOrigin.x * m_baseScale.x, newOrigin.y * m_baseScale.y);
+		MarkRenderBoundsDirty();
+		MarkStaticCollidersMoved();
 
 		if (GetParent() != nullptr && GetParent()->HasComponent("Button"))
 		{
@@ -75,6 +79,8 @@ namespace FlatEngine
 	{
 		m_position = newPosition;
 		m_position3D = Vector3(m_position.x, m_position.y, 0);
+		MarkRenderBoundsDirty();
+		MarkStaticCollidersMoved();
 
 		if (GetParent() != nullptr && GetParent()->HasChildren())
 		{
@@ -93,6 +99,8 @@ namespace FlatEngine
 	void Transform::UpdateOrigin(Vector2 newOrigin)
 	{
 		m_origin = Vector2(newOrigin.x * m_baseScale.x, newOrigin.y * m_baseScale.y);
+		MarkRenderBoundsDirty();
+		MarkStaticCollidersMoved();
 		UpdateChildOrigins(GetTruePosition());
 	}
 
@@ -154,12 +162,15 @@ namespace FlatEngine
 	void Transform::SetScale(Vector2 newScale)
 	{
 		m_scale = newScale;
+		MarkRenderBoundsDirty();
+		MarkStaticCollidersMoved();
 		//UpdateChildBaseScale(m_scale);
 	}
 
 	void Transform::SetRotation(float newRotation)
 	{
 		m_rotation = newRotation;
+		MarkRenderBoundsDirty();
 	}
 
 	Vector2 Transform::GetPosition()
@@ -187,5 +198,22 @@ namespace FlatEngine
 		Vector2 slope = Vector2(lookAt.x - GetTruePosition().x, lookAt.y - GetTruePosition().y);
 		float angle = atan(slope.y / slope.x) * 180.0f / (float)M_PI;
 		m_rotation = angle;
+		MarkRenderBoundsDirty();
 	}
-}
+
+	// Static collider bounds are only recalculated when F_StaticColliderIndex is rebuilt, so moving one has to ask for a rebuild
+	void Transform::MarkStaticCollidersMoved()
+	{
+		if (GetParent() != nullptr && !F_b_staticCollidersChanged)
+		{
+			for (BoxCollider* boxCollider : GetParent()->GetBoxColliders())
+			{
+				if (boxCollider->IsStatic())
+				{
+					F_b_staticCollidersChanged = true;
+					break;
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
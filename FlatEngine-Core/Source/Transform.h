@@ -39,6 +39,8 @@ namespace FlatEngine
 		void LookAt(Vector2 lookAt);
 
 	private:
+		void MarkStaticCollidersMoved();
+
 		Vector2 m_origin;
 		Vector2 m_position;
 		Vector3 m_position3D;
@@ -0,0 +1,122 @@
+#include "UniformRing.h"
+#include "VulkanManager.h"
+#include "WinSys.h"
+
+#include <cstring>
+#include <algorithm>
+
+
+namespace FlatEngine
+{
+    UniformRing::UniformRing()
+    {
+        m_physicalDeviceHandle = nullptr;
+        m_deviceHandle = nullptr;
+        m_stride = 0;
+        m_capacity = 0;
+        m_buffers = std::vector<VkBuffer>();
+        m_buffersMemory = std::vector<MemoryAllocation>();
+    }
+
+    UniformRing::~UniformRing()
+    {
+    }
+
+    void UniformRing::Cleanup()
+    {
+        DestroyBuffers();
+    }
+
+    void UniformRing::Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
+    {
+        m_physicalDeviceHandle = &physicalDevice;
+        m_deviceHandle = &logicalDevice;
+
+        // Dynamic offsets have to be multiples of the device's alignment
+        VkDeviceSize alignment = physicalDevice.GetProperties().limits.minUniformBufferOffsetAlignment;
+        m_stride = sizeof(UniformBufferObject);
+        if (alignment > 0)
+        {
+            m_stride = (m_stride + alignment - 1) & ~(alignment - 1);
+        }
+
+        CreateBuffers(UNIFORM_RING_STARTING_OBJECTS);
+    }
+
+    void UniformRing::CreateBuffers(uint32_t capacity)
+    {
+        VkDeviceSize bufferSize = m_stride * capacity;
+        m_capacity = capacity;
+        m_buffers.resize(VM_MAX_FRAMES_IN_FLIGHT);
+        m_buffersMemory.resize(VM_MAX_FRAMES_IN_FLIGHT);
+
+        for (size_t i = 0; i < VM_MAX_FRAMES_IN_FLIGHT; i++)
+        {
+            // Host visible blocks stay mapped, m_buffersMemory[i].mapped is valid for the buffer's whole lifetime
+            WinSys::CreateBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_buffers[i], m_buffersMemory[i], *m_physicalDeviceHandle, *m_deviceHandle);
+        }
+    }
+
+    void UniformRing::DestroyBuffers()
+    {
+        if (m_deviceHandle == nullptr)
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < m_buffers.size(); i++)
+        {
+            vkDestroyBuffer(m_deviceHandle->GetDevice(), m_buffers[i], nullptr);
+            VM_memoryAllocator.Free(m_buffersMemory[i]);
+        }
+        m_buffers.clear();
+        m_buffersMemory.clear();
+        m_capacity = 0;
+    }
+
+    // Grows by doubling so a steadily growing scene only reallocates a handful of times
+    bool UniformRing::Reserve(uint32_t objectCount)
+    {
+        if (objectCount <= m_capacity)
+        {
+            return false;
+        }
+
+        uint32_t capacity = std::max(m_capacity, UNIFORM_RING_STARTING_OBJECTS);
+        while (capacity < objectCount)
+        {
+            capacity *= 2;
+        }
+
+        // The other frame in flight may still be reading its buffer
+        vkDeviceWaitIdle(m_deviceHandle->GetDevice());
+        DestroyBuffers();
+        CreateBuffers(capacity);
+        return true;
+    }
+
+    void UniformRing::Write(uint32_t frameIndex, uint32_t slot, UniformBufferObject& ubo)
+    {
+        memcpy((unsigned char*)m_buffersMemory[frameIndex].mapped + m_stride * slot, &ubo, sizeof(ubo));
+    }
+
+    uint32_t UniformRing::GetOffset(uint32_t slot)
+    {
+        return static_cast<uint32_t>(m_stride * slot);
+    }
+
+    VkBuffer UniformRing::GetBuffer(uint32_t frameIndex)
+    {
+        return m_buffers[frameIndex];
+    }
+
+    uint32_t UniformRing::GetCapacity()
+    {
+        return m_capacity;
+    }
+
+    VkDeviceSize UniformRing::GetStride()
+    {
+        return m_stride;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include "Structs.h"
+#include "PhysicalDevice.h"
+#include "LogicalDevice.h"
+#include "MemoryAllocator.h"
+
+#define GLFW_INCLUDE_VULKAN
+#include <glfw3.h>
+
+#include <vector>
+
+
+namespace FlatEngine
+{
+	const uint32_t UNIFORM_RING_STARTING_OBJECTS = 256;
+
+	// One persistently mapped uniform buffer per frame in flight holding every drawn object's UniformBufferObject for that frame.
+	// Slot i of a frame lives at GetOffset(i) and is bound through a VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC descriptor, so
+	// objects share one buffer and one allocation instead of owning their own. Reserve() grows the ring to fit the frame's
+	// objects, descriptors pointing at the old buffers must be rewritten when it returns true.
+	class UniformRing
+	{
+	public:
+		UniformRing();
+		~UniformRing();
+		void Cleanup();
+
+		void Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
+		bool Reserve(uint32_t objectCount);
+		void Write(uint32_t frameIndex, uint32_t slot, UniformBufferObject& ubo);
+		uint32_t GetOffset(uint32_t slot);
+		VkBuffer GetBuffer(uint32_t frameIndex);
+		uint32_t GetCapacity();
+		VkDeviceSize GetStride();
+
+	private:
+		void CreateBuffers(uint32_t capacity);
+		void DestroyBuffers();
+
+		PhysicalDevice* m_physicalDeviceHandle;
+		LogicalDevice* m_deviceHandle;
+		VkDeviceSize m_stride;
+		uint32_t m_capacity;
+		std::vector<VkBuffer> m_buffers;
+		std::vector<MemoryAllocation> m_buffersMemory;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,508 @@
+#include "UploadManager.h"
+#include "VulkanManager.h"
+#include "WinSys.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace FlatEngine
+{
+    UploadManager::UploadManager()
+    {
+        m_physicalDeviceHandle = nullptr;
+        m_deviceHandle = nullptr;
+        m_queue = VK_NULL_HANDLE;
+        m_b_dedicatedQueue = false;
+        m_ringBuffer = VK_NULL_HANDLE;
+        m_ringMemory = MemoryAllocation();
+        m_ringHead = 0;
+        m_ringTail = 0;
+        m_ringUsed = 0;
+        m_copyAlignment = 16;
+        m_batches = std::vector<S_UploadBatch>();
+        m_submitted = std::deque<int>();
+        m_openBatch = -1;
+        m_uploadedBytes = 0;
+        m_stallCount = 0;
+    }
+
+    UploadManager::~UploadManager()
+    {
+    }
+
+    void UploadManager::Cleanup()
+    {
+        if (m_deviceHandle == nullptr)
+        {
+            return;
+        }
+
+        WaitIdle();
+
+        for (S_UploadBatch& batch : m_batches)
+        {
+            // Destroying the pool frees its command buffer
+            vkDestroyCommandPool(m_deviceHandle->GetDevice(), batch.commandPool, nullptr);
+            vkDestroyFence(m_deviceHandle->GetDevice(), batch.fence, nullptr);
+            if (batch.semaphore != VK_NULL_HANDLE)
+            {
+                vkDestroySemaphore(m_deviceHandle->GetDevice(), batch.semaphore, nullptr);
+            }
+        }
+        m_batches.clear();
+
+        vkDestroyBuffer(m_deviceHandle->GetDevice(), m_ringBuffer, nullptr);
+        VM_memoryAllocator.Free(m_ringMemory);
+        m_ringBuffer = VK_NULL_HANDLE;
+        m_deviceHandle = nullptr;
+    }
+
+    void UploadManager::Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, uint32_t queueFamilyIndex)
+    {
+        m_physicalDeviceHandle = &physicalDevice;
+        m_deviceHandle = &logicalDevice;
+        m_queue = logicalDevice.GetUploadQueue();
+        m_b_dedicatedQueue = logicalDevice.HasDedicatedUploadQueue();
+
+        // Image copies need offsets that are a multiple of the texel size, 16 covers every format in use
+        m_copyAlignment = std::max((VkDeviceSize)16, physicalDevice.GetProperties().limits.optimalBufferCopyOffsetAlignment);
+
+        WinSys::CreateBuffer(UPLOAD_STAGING_RING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_ringBuffer, m_ringMemory, physicalDevice, logicalDevice);
+        m_ringHead = 0;
+        m_ringTail = 0;
+        m_ringUsed = 0;
+
+        m_batches.resize(UPLOAD_BATCH_COUNT);
+        for (S_UploadBatch& batch : m_batches)
+        {
+            VulkanManager::CreateCommandPool(batch.commandPool, logicalDevice, queueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = batch.commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+
+            if (vkAllocateCommandBuffers(logicalDevice.GetDevice(), &allocInfo, &batch.commandBuffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate upload command buffers!");
+            }
+
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            if (vkCreateFence(logicalDevice.GetDevice(), &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create upload fences!");
+            }
+
+            batch.semaphore = m_b_dedicatedQueue ? CreateBatchSemaphore() : VK_NULL_HANDLE;
+            batch.b_recording = false;
+            batch.b_submitted = false;
+            batch.b_semaphoreSignaled = false;
+            batch.waitingFrame = -1;
+            batch.ringEnd = 0;
+            batch.ringUsed = 0;
+        }
+    }
+
+    VkSemaphore UploadManager::CreateBatchSemaphore()
+    {
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        if (vkCreateSemaphore(m_deviceHandle->GetDevice(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create upload semaphores!");
+        }
+        return semaphore;
+    }
+
+    void UploadManager::UploadBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        VkBuffer stagingBuffer = VK_NULL_HANDLE;
+        VkDeviceSize stagingOffset = 0;
+        void* mapped = nullptr;
+        S_UploadBatch& batch = ReserveStaging(size, stagingBuffer, stagingOffset, mapped);
+        memcpy(mapped, data, static_cast<size_t>(size));
+
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = stagingOffset;
+        copyRegion.dstOffset = 0;
+        copyRegion.size = size;
+        vkCmdCopyBuffer(batch.commandBuffer, stagingBuffer, dstBuffer, 1, &copyRegion);
+
+        // Vertex and index buffers are read by vertex input in later submissions
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = dstBuffer;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+        m_uploadedBytes += size;
+    }
+
+    // Fills mip level 0 of an RGBA8 image from pixels and generates the rest, the image ends in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    void UploadManager::UploadImage(const void* pixels, VkDeviceSize size, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        VkBuffer stagingBuffer = VK_NULL_HANDLE;
+        VkDeviceSize stagingOffset = 0;
+        void* mapped = nullptr;
+        S_UploadBatch& batch = ReserveStaging(size, stagingBuffer, stagingOffset, mapped);
+        memcpy(mapped, pixels, static_cast<size_t>(size));
+
+        WinSys::RecordTransitionImageLayout(batch.commandBuffer, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+        WinSys::RecordCopyBufferToImage(batch.commandBuffer, stagingBuffer, stagingOffset, image, width, height);
+        WinSys::RecordGenerateMipmaps(batch.commandBuffer, image, static_cast<int32_t>(width), static_cast<int32_t>(height), mipLevels);
+
+        m_uploadedBytes += size;
+    }
+
+    // For images whose whole mip chain is already in data, one region per level with bufferOffset relative to data. No blits are recorded
+    void UploadManager::UploadImageLevels(const void* data, VkDeviceSize size, VkImage image, std::vector<VkBufferImageCopy>& regions)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        VkBuffer stagingBuffer = VK_NULL_HANDLE;
+        VkDeviceSize stagingOffset = 0;
+        void* mapped = nullptr;
+        S_UploadBatch& batch = ReserveStaging(size, stagingBuffer, stagingOffset, mapped);
+        memcpy(mapped, data, static_cast<size_t>(size));
+
+        std::vector<VkBufferImageCopy> stagedRegions = regions;
+        for (VkBufferImageCopy& region : stagedRegions)
+        {
+            region.bufferOffset += stagingOffset;
+        }
+
+        uint32_t mipLevels = static_cast<uint32_t>(regions.size());
+        WinSys::RecordTransitionImageLayout(batch.commandBuffer, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+        vkCmdCopyBufferToImage(batch.commandBuffer, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(stagedRegions.size()), stagedRegions.data());
+        WinSys::RecordTransitionImageLayout(batch.commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
+
+        m_uploadedBytes += size;
+    }
+
+    // Returns the open batch the caller records its copy into, with size bytes of staging memory for it at stagingOffset of stagingBuffer
+    UploadManager::S_UploadBatch& UploadManager::ReserveStaging(VkDeviceSize size, VkBuffer& stagingBuffer, VkDeviceSize& stagingOffset, void*& mapped)
+    {
+        if (size > UPLOAD_STAGING_RING_SIZE / 2)
+        {
+            // Too big to share the ring, gets a staging buffer of its own that is destroyed when its batch retires
+            S_UploadBatch& batch = OpenBatch();
+            batch.oversizedBuffers.push_back(VK_NULL_HANDLE);
+            batch.oversizedMemory.push_back(MemoryAllocation());
+            WinSys::CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, batch.oversizedBuffers.back(), batch.oversizedMemory.back(), *m_physicalDeviceHandle, *m_deviceHandle);
+
+            stagingBuffer = batch.oversizedBuffers.back();
+            stagingOffset = 0;
+            mapped = batch.oversizedMemory.back().mapped;
+            return batch;
+        }
+
+        VkDeviceSize offset = 0;
+        VkDeviceSize consumed = 0;
+        while (!AllocateRing(size, offset, consumed))
+        {
+            // The ring is full of data the GPU has not copied out yet, submit what has been recorded and wait on the oldest batch
+            if (m_openBatch != -1)
+            {
+                Submit(m_openBatch);
+            }
+            m_stallCount++;
+            RetireCompleted(true);
+        }
+
+        S_UploadBatch& batch = OpenBatch();
+        batch.ringUsed += consumed;
+        batch.ringEnd = m_ringHead;
+
+        stagingBuffer = m_ringBuffer;
+        stagingOffset = offset;
+        mapped = (unsigned char*)m_ringMemory.mapped + offset;
+        return batch;
+    }
+
+    // Ring space is handed out in submission order and given back in the same order as batches retire, so live staging data is always
+    // the range from m_ringTail to m_ringHead. A request that does not fit before the end of the ring wraps around to offset 0.
+    // consumed includes alignment padding and any space skipped at the end of the ring.
+    bool UploadManager::AllocateRing(VkDeviceSize size, VkDeviceSize& offset, VkDeviceSize& consumed)
+    {
+        if (m_ringUsed == 0)
+        {
+            m_ringHead = 0;
+            m_ringTail = 0;
+        }
+
+        VkDeviceSize alignedHead = (m_ringHead + m_copyAlignment - 1) / m_copyAlignment * m_copyAlignment;
+
+        if (m_ringUsed == 0 || m_ringHead > m_ringTail)
+        {
+            if (alignedHead + size <= UPLOAD_STAGING_RING_SIZE)
+            {
+                offset = alignedHead;
+                consumed = alignedHead + size - m_ringHead;
+            }
+            else if (size <= m_ringTail)
+            {
+                offset = 0;
+                consumed = UPLOAD_STAGING_RING_SIZE - m_ringHead + size;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if (m_ringHead < m_ringTail && alignedHead + size <= m_ringTail)
+        {
+            offset = alignedHead;
+            consumed = alignedHead + size - m_ringHead;
+        }
+        else
+        {
+            return false;
+        }
+
+        m_ringHead = offset + size;
+        m_ringUsed += consumed;
+        return true;
+    }
+
+    UploadManager::S_UploadBatch& UploadManager::OpenBatch()
+    {
+        if (m_openBatch != -1)
+        {
+            return m_batches[m_openBatch];
+        }
+
+        int batchIndex = -1;
+        while (batchIndex == -1)
+        {
+            for (int i = 0; i < (int)m_batches.size(); i++)
+            {
+                if (!m_batches[i].b_submitted && m_batches[i].waitingFrame == -1)
+                {
+                    batchIndex = i;
+                    break;
+                }
+            }
+
+            if (batchIndex == -1)
+            {
+                m_stallCount++;
+                if (m_submitted.size() > 0)
+                {
+                    RetireCompleted(true);
+                }
+                else
+                {
+                    // Every batch's semaphore is still waited on by a frame in flight, only happens when uploading faster than frames complete
+                    vkQueueWaitIdle(m_deviceHandle->GetGraphicsQueue());
+                    for (S_UploadBatch& batch : m_batches)
+                    {
+                        batch.waitingFrame = -1;
+                    }
+                }
+            }
+        }
+
+        S_UploadBatch& batch = m_batches[batchIndex];
+
+        // A binary semaphore can not be signaled again before it is waited on, one no frame picked up is replaced instead
+        if (batch.b_semaphoreSignaled)
+        {
+            vkDestroySemaphore(m_deviceHandle->GetDevice(), batch.semaphore, nullptr);
+            batch.semaphore = CreateBatchSemaphore();
+            batch.b_semaphoreSignaled = false;
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(batch.commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to begin recording upload command buffer!");
+        }
+
+        batch.b_recording = true;
+        m_openBatch = batchIndex;
+        return batch;
+    }
+
+    void UploadManager::Submit(int batchIndex)
+    {
+        S_UploadBatch& batch = m_batches[batchIndex];
+
+        if (vkEndCommandBuffer(batch.commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to record upload command buffer!");
+        }
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.commandBuffer;
+        if (m_b_dedicatedQueue)
+        {
+            submitInfo.signalSemaphoreCount = 1;
+            submitInfo.pSignalSemaphores = &batch.semaphore;
+        }
+
+        if (vkQueueSubmit(m_queue, 1, &submitInfo, batch.fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to submit upload command buffer!");
+        }
+
+        batch.b_recording = false;
+        batch.b_submitted = true;
+        batch.b_semaphoreSignaled = m_b_dedicatedQueue;
+        m_submitted.push_back(batchIndex);
+        m_openBatch = -1;
+    }
+
+    // Retires every batch whose fence has signaled, b_wait blocks on the oldest one first
+    void UploadManager::RetireCompleted(bool b_wait)
+    {
+        while (m_submitted.size() > 0)
+        {
+            int batchIndex = m_submitted.front();
+            S_UploadBatch& batch = m_batches[batchIndex];
+
+            if (b_wait)
+            {
+                vkWaitForFences(m_deviceHandle->GetDevice(), 1, &batch.fence, VK_TRUE, UINT64_MAX);
+                b_wait = false;
+            }
+            else if (vkGetFenceStatus(m_deviceHandle->GetDevice(), batch.fence) != VK_SUCCESS)
+            {
+                break;
+            }
+
+            m_submitted.pop_front();
+            Retire(batchIndex);
+        }
+    }
+
+    void UploadManager::Retire(int batchIndex)
+    {
+        S_UploadBatch& batch = m_batches[batchIndex];
+
+        vkResetFences(m_deviceHandle->GetDevice(), 1, &batch.fence);
+        vkResetCommandPool(m_deviceHandle->GetDevice(), batch.commandPool, 0);
+
+        for (size_t i = 0; i < batch.oversizedBuffers.size(); i++)
+        {
+            vkDestroyBuffer(m_deviceHandle->GetDevice(), batch.oversizedBuffers[i], nullptr);
+            VM_memoryAllocator.Free(batch.oversizedMemory[i]);
+        }
+        batch.oversizedBuffers.clear();
+        batch.oversizedMemory.clear();
+
+        if (batch.ringUsed > 0)
+        {
+            m_ringTail = batch.ringEnd;
+            m_ringUsed -= batch.ringUsed;
+            batch.ringUsed = 0;
+        }
+        batch.b_submitted = false;
+    }
+
+    // Submits whatever has been recorded since the last flush, called once a frame so uploads reach the GPU while loading continues
+    void UploadManager::Flush()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        RetireCompleted(false);
+        if (m_openBatch != -1)
+        {
+            Submit(m_openBatch);
+        }
+    }
+
+    void UploadManager::WaitIdle()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_openBatch != -1)
+        {
+            Submit(m_openBatch);
+        }
+        while (m_submitted.size() > 0)
+        {
+            RetireCompleted(true);
+        }
+    }
+
+    // Call once the frame's fence has been waited on, semaphores its last submission waited on are free to signal again
+    void UploadManager::BeginFrame(uint32_t frameIndex)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (S_UploadBatch& batch : m_batches)
+        {
+            if (batch.waitingFrame == (int)frameIndex)
+            {
+                batch.waitingFrame = -1;
+            }
+        }
+        RetireCompleted(false);
+    }
+
+    // Semaphores of the batches submitted since the last frame, for the frame's vkQueueSubmit to wait on. Empty without a dedicated upload queue
+    void UploadManager::GetWaitSemaphores(uint32_t frameIndex, std::vector<VkSemaphore>& semaphores, std::vector<VkPipelineStageFlags>& waitStages)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (S_UploadBatch& batch : m_batches)
+        {
+            if (batch.b_semaphoreSignaled)
+            {
+                semaphores.push_back(batch.semaphore);
+                waitStages.push_back(VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+                batch.b_semaphoreSignaled = false;
+                batch.waitingFrame = (int)frameIndex;
+            }
+        }
+    }
+
+    bool UploadManager::HasDedicatedQueue()
+    {
+        return m_b_dedicatedQueue;
+    }
+
+    int UploadManager::GetPendingBatchCount()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return (int)m_submitted.size() + (m_openBatch != -1 ? 1 : 0);
+    }
+
+    uint64_t UploadManager::GetUploadedBytes()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_uploadedBytes;
+    }
+
+    uint64_t UploadManager::GetStagingUsed()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_ringUsed;
+    }
+
+    int UploadManager::GetStallCount()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stallCount;
+    }
+}
\ No newline at end of file
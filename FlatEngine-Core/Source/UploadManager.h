@@ -0,0 +1,88 @@
+#pragma once
+#include "PhysicalDevice.h"
+#include "LogicalDevice.h"
+#include "MemoryAllocator.h"
+
+#define GLFW_INCLUDE_VULKAN
+#include <glfw3.h>
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <cstdint>
+
+
+namespace FlatEngine
+{
+	const uint64_t UPLOAD_STAGING_RING_SIZE = 32ull * 1024 * 1024;
+	const int UPLOAD_BATCH_COUNT = 4;
+
+	// Streams buffer and image data to device local memory without stalling the caller. Data is copied into one persistently
+	// mapped staging ring and the copy commands of many uploads are recorded into the same batch command buffer, which is
+	// submitted by Flush() (once a frame from DrawFrame) or when the ring runs out of room. Each batch has a fence, ring space
+	// and the batch are reused once it has signaled. With a dedicated upload queue every batch also signals a semaphore that the
+	// next frame's submission waits on, on the shared graphics queue submission order and the recorded barriers are enough.
+	class UploadManager
+	{
+	public:
+		UploadManager();
+		~UploadManager();
+		void Cleanup();
+
+		void Init(PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, uint32_t queueFamilyIndex);
+		void UploadBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer);
+		void UploadImage(const void* pixels, VkDeviceSize size, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels);
+		void UploadImageLevels(const void* data, VkDeviceSize size, VkImage image, std::vector<VkBufferImageCopy>& regions);
+		void Flush();
+		void WaitIdle();
+		void BeginFrame(uint32_t frameIndex);
+		void GetWaitSemaphores(uint32_t frameIndex, std::vector<VkSemaphore>& semaphores, std::vector<VkPipelineStageFlags>& waitStages);
+		bool HasDedicatedQueue();
+		int GetPendingBatchCount();
+		uint64_t GetUploadedBytes();
+		uint64_t GetStagingUsed();
+		int GetStallCount();
+
+	private:
+		struct S_UploadBatch
+		{
+			VkCommandPool commandPool;
+			VkCommandBuffer commandBuffer;
+			VkFence fence;
+			VkSemaphore semaphore;
+			bool b_recording;
+			bool b_submitted;
+			bool b_semaphoreSignaled; // Signaled and not yet handed to a frame through GetWaitSemaphores()
+			int waitingFrame; // Frame in flight whose submission waits on the semaphore, -1 when none
+			VkDeviceSize ringEnd;
+			VkDeviceSize ringUsed;
+			std::vector<VkBuffer> oversizedBuffers;
+			std::vector<MemoryAllocation> oversizedMemory;
+		};
+
+		S_UploadBatch& ReserveStaging(VkDeviceSize size, VkBuffer& stagingBuffer, VkDeviceSize& stagingOffset, void*& mapped);
+		bool AllocateRing(VkDeviceSize size, VkDeviceSize& offset, VkDeviceSize& consumed);
+		S_UploadBatch& OpenBatch();
+		void Submit(int batchIndex);
+		void RetireCompleted(bool b_wait);
+		void Retire(int batchIndex);
+		VkSemaphore CreateBatchSemaphore();
+
+		PhysicalDevice* m_physicalDeviceHandle;
+		LogicalDevice* m_deviceHandle;
+		VkQueue m_queue;
+		bool m_b_dedicatedQueue;
+		VkBuffer m_ringBuffer;
+		MemoryAllocation m_ringMemory;
+		VkDeviceSize m_ringHead;
+		VkDeviceSize m_ringTail;
+		VkDeviceSize m_ringUsed;
+		VkDeviceSize m_copyAlignment;
+		std::vector<S_UploadBatch> m_batches;
+		std::deque<int> m_submitted; // Submission order, batches on one queue complete in this order
+		int m_openBatch;
+		uint64_t m_uploadedBytes;
+		int m_stallCount;
+		std::mutex m_mutex;
+	};
+}
\ No newline at end of file
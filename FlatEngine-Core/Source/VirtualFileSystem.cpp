@@ -0,0 +1,230 @@
+#include "VirtualFileSystem.h"
+
+#include <filesystem>
+#include <algorithm>
+
+
+namespace FlatEngine
+{
+	FileData::FileData()
+	{
+		m_data = nullptr;
+		m_size = 0;
+		m_buffer = std::vector<unsigned char>();
+	}
+
+	FileData::~FileData()
+	{
+		Close();
+	}
+
+	void FileData::Close()
+	{
+		m_file.Close();
+		m_buffer.clear();
+		m_buffer.shrink_to_fit();
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+	bool FileData::IsOpen()
+	{
+		return m_data != nullptr;
+	}
+
+	const unsigned char* FileData::GetData()
+	{
+		return m_data;
+	}
+
+	uint64_t FileData::GetSize()
+	{
+		return m_size;
+	}
+
+
+	VirtualFileSystem::VirtualFileSystem()
+	{
+		m_packedPaths = std::vector<std::string>();
+		m_packedReads = 0;
+		m_looseReads = 0;
+	}
+
+	VirtualFileSystem::~VirtualFileSystem()
+	{
+		Unmount();
+	}
+
+	bool VirtualFileSystem::Mount(std::string packPath)
+	{
+		Unmount();
+
+		if (!m_pack.Open(packPath))
+		{
+			return false;
+		}
+
+		m_packedPaths.reserve(m_pack.GetEntryCount());
+		for (uint32_t i = 0; i < m_pack.GetEntryCount(); i++)
+		{
+			m_packedPaths.push_back(NormalizePath(m_pack.GetEntryPath(m_pack.GetEntries()[i])));
+		}
+		return true;
+	}
+
+	void VirtualFileSystem::Unmount()
+	{
+		m_pack.Close();
+		m_packedPaths.clear();
+	}
+
+	bool VirtualFileSystem::IsMounted()
+	{
+		return m_pack.IsOpen();
+	}
+
+	bool VirtualFileSystem::IsPacked(std::string path)
+	{
+		return path != "" && m_pack.Find(path) != nullptr;
+	}
+
+	bool VirtualFileSystem::Exists(std::string path)
+	{
+		if (path == "")
+		{
+			return false;
+		}
+		std::error_code error;
+		return IsPacked(path) || std::filesystem::exists(path, error);
+	}
+
+	// The pack is built after everything in it is cooked, so a packed cook is always current
+	bool VirtualFileSystem::IsUpToDate(std::string path, std::string sourcePath)
+	{
+		return IsPacked(path) || MappedFile::IsUpToDate(path, sourcePath);
+	}
+
+	bool VirtualFileSystem::Read(std::string path, FileData& file)
+	{
+		file.Close();
+
+		const AssetPackEntry* entry = m_pack.Find(path);
+		if (entry != nullptr)
+		{
+			if (entry->compression == PackStored)
+			{
+				file.m_data = m_pack.GetEntryData(*entry);
+			}
+			else if (m_pack.Decompress(*entry, file.m_buffer))
+			{
+				file.m_data = file.m_buffer.data();
+			}
+			else
+			{
+				return false;
+			}
+			file.m_size = entry->size;
+			m_packedReads.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		if (path == "" || !file.m_file.Open(path))
+		{
+			return false;
+		}
+		file.m_data = file.m_file.GetData();
+		file.m_size = file.m_file.GetSize();
+		m_looseReads.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool VirtualFileSystem::ReadText(std::string path, std::string& text)
+	{
+		FileData file;
+		if (!Read(path, file))
+		{
+			// MappedFile does not open empty files, which still exist and read as empty
+			text = "";
+			std::error_code error;
+			return path != "" && std::filesystem::is_regular_file(path, error) && std::filesystem::file_size(path, error) == 0;
+		}
+
+		text.assign((const char*)file.GetData(), static_cast<size_t>(file.GetSize()));
+		return true;
+	}
+
+	// With a pack mounted only the pack is listed, a runtime build never walks the disk looking for assets
+	std::vector<std::string> VirtualFileSystem::FindAllFilesWithExtension(std::string dirPath, std::string extension)
+	{
+		std::vector<std::string> files;
+
+		if (!IsMounted())
+		{
+			for (auto& p : std::filesystem::recursive_directory_iterator(dirPath))
+			{
+				if (p.path().extension() == extension || p.path().string().find(extension) != std::string::npos)
+				{
+					files.push_back(p.path().string());
+				}
+			}
+			return files;
+		}
+
+		std::string directory = NormalizePath(dirPath);
+		if (directory != "" && directory.back() != '/')
+		{
+			directory += "/";
+		}
+		std::string normalizedExtension = NormalizePath(extension);
+
+		for (uint32_t i = 0; i < m_pack.GetEntryCount(); i++)
+		{
+			std::string& packedPath = m_packedPaths[i];
+			if (packedPath.compare(0, directory.size(), directory) == 0 && packedPath.find(normalizedExtension, directory.size()) != std::string::npos)
+			{
+				files.push_back(m_pack.GetEntryPath(m_pack.GetEntries()[i]));
+			}
+		}
+		// Table order is by hash, listings come back in path order like a directory walk
+		std::sort(files.begin(), files.end());
+		return files;
+	}
+
+	uint64_t VirtualFileSystem::GetPackedReads()
+	{
+		return m_packedReads.load(std::memory_order_relaxed);
+	}
+
+	uint64_t VirtualFileSystem::GetLooseReads()
+	{
+		return m_looseReads.load(std::memory_order_relaxed);
+	}
+
+	// Where the cook of sourcePath lives: its path under COOKED_CACHE_DIRECTORY with the leading "..\\" segments dropped,
+	// so "..\\projects\\Game\\images\\a.png" cooks to "..\\cache\\cooked\\projects\\game\\images\\a.png" + extension
+	std::string VirtualFileSystem::GetCookedPath(std::string sourcePath, std::string extension)
+	{
+		std::string relativePath = NormalizePath(sourcePath);
+		while (relativePath.compare(0, 3, "../") == 0)
+		{
+			relativePath.erase(0, 3);
+		}
+		// Absolute sources keep their drive as a directory name
+		std::replace(relativePath.begin(), relativePath.end(), ':', '_');
+		while (relativePath.size() > 0 && relativePath[0] == '/')
+		{
+			relativePath.erase(0, 1);
+		}
+		std::replace(relativePath.begin(), relativePath.end(), '/', '\\');
+		return COOKED_CACHE_DIRECTORY + "\\" + relativePath + extension;
+	}
+
+	// Separators unified, "." and ".." segments resolved and lowercased, the same file named two ways gives the same string
+	std::string VirtualFileSystem::NormalizePath(std::string path)
+	{
+		std::replace(path.begin(), path.end(), '\\', '/');
+		std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+		std::transform(normalized.begin(), normalized.end(), normalized.begin(), [](unsigned char character) { return (char)std::tolower(character); });
+		return normalized;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include "AssetPack.h"
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+
+namespace FlatEngine
+{
+	const std::string COOKED_CACHE_DIRECTORY = "..\\cache\\cooked"; // Cooks are written here, never beside their sources in the project tree
+
+	// A file's contents as returned by VirtualFileSystem::Read(). Points into the mounted pack for stored entries and into the
+	// mapped loose file otherwise, only LZ4 entries are decompressed into a buffer of its own.
+	class FileData
+	{
+	public:
+		FileData();
+		~FileData();
+		FileData(const FileData&) = delete;
+		FileData& operator=(const FileData&) = delete;
+
+		void Close();
+		bool IsOpen();
+		const unsigned char* GetData();
+		uint64_t GetSize();
+
+	private:
+		friend class VirtualFileSystem;
+		const unsigned char* m_data;
+		uint64_t m_size;
+		std::vector<unsigned char> m_buffer;
+		MappedFile m_file;
+	};
+
+	// Every asset read goes through here. With no pack mounted (the editor) it is a pass through to loose files, a runtime build
+	// mounts the pack written by BuildProject() and reads from it first, falling back to loose files for anything not packed.
+	// Mount() and Unmount() are only called while no other thread is reading.
+	class VirtualFileSystem
+	{
+	public:
+		VirtualFileSystem();
+		~VirtualFileSystem();
+
+		bool Mount(std::string packPath);
+		void Unmount();
+		bool IsMounted();
+		bool IsPacked(std::string path);
+		bool Exists(std::string path);
+		bool IsUpToDate(std::string path, std::string sourcePath);
+		bool Read(std::string path, FileData& file);
+		bool ReadText(std::string path, std::string& text);
+		std::vector<std::string> FindAllFilesWithExtension(std::string dirPath, std::string extension);
+		uint64_t GetPackedReads();
+		uint64_t GetLooseReads();
+		static std::string NormalizePath(std::string path);
+		static std::string GetCookedPath(std::string sourcePath, std::string extension);
+
+	private:
+		AssetPack m_pack;
+		std::vector<std::string> m_packedPaths; // Normalized, by entry index
+		// Read() runs on the ImageDecoder workers as well as the main thread, the counts are only statistics so relaxed ordering is enough
+		std::atomic<uint64_t> m_packedReads;
+		std::atomic<uint64_t> m_looseReads;
+	};
+}
\ No newline at end of file
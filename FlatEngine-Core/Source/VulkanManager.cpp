@@ -2,6 +2,7 @@
 #include "VulkanManager.h"
 #include "Helper.h"
 #include "Material.h"
+#include "CookedTexture.h"
 
 // Refer to - https://vulkan-tutorial.com/en/Uniform_buffers/Descriptor_layout_and_buffer
 #include <gtc/matrix_transform.hpp> // Not used currently but might need it later
@@ -9,12 +10,19 @@
 #include <chrono> // Time keeping
 #include <memory>
 #include <array>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
 
 
 namespace FlatEngine
 {
     ValidationLayers VM_validationLayers = ValidationLayers();
     uint32_t VM_currentFrame = 0;
+    UniformRing VM_uniformRing = UniformRing();
+    MemoryAllocator VM_memoryAllocator;
+    PipelineCache VM_pipelineCache = PipelineCache();
+    UploadManager VM_uploadManager;
 
     void VulkanManager::check_vk_result(VkResult err)
     {
@@ -39,10 +47,15 @@ namespace FlatEngine
         m_mainRenderPass = RenderPass();
         m_sceneTextureRenderPass = RenderPass();
         m_imguiManager = ImGuiManager();               
+        m_spriteBatch = SpriteBatch();
+        m_models = std::map<std::string, std::shared_ptr<Model>>();
+        m_drawList = std::vector<Mesh*>();
+        m_drawGroups = std::vector<MeshDrawGroup>();
+        m_b_drawListStale = true;
 
         m_viewportImages = std::vector<VkImage>();
         m_viewportImageViews = std::vector<VkImageView>();
-        m_viewportImageMemory = std::vector<VkDeviceMemory>();
+        m_viewportImageMemory = std::vector<MemoryAllocation>();
         m_viewportSampler = VK_NULL_HANDLE;
         viewportDescriptorSets = std::vector<VkDescriptorSet>();
 
@@ -76,6 +89,7 @@ namespace FlatEngine
     void VulkanManager::Cleanup()
     {
         vkDeviceWaitIdle(m_logicalDevice.GetDevice()); // This may need to be moved elsewhere potentially
+        VM_uploadManager.Cleanup();
 
         // Semaphores and Fences
         for (size_t i = 0; i < VM_MAX_FRAMES_IN_FLIGHT; i++)
@@ -93,10 +107,22 @@ namespace FlatEngine
             materialPair.second->CleanupGraphicsPipeline();
         }
 
+        m_spriteBatch.Cleanup();
+        m_commandRecorder.Cleanup();
+        VM_uniformRing.Cleanup();
+        m_meshInstances.Cleanup();
+        for (std::pair<const std::string, std::shared_ptr<Model>>& model : m_models)
+        {
+            model.second->CleanupVertexBuffers(m_logicalDevice);
+            model.second->CleanupIndexBuffers(m_logicalDevice);
+        }
+        m_models.clear();
         vkDestroyCommandPool(m_logicalDevice.GetDevice(), m_commandPool, nullptr);
 
         m_mainRenderPass.Cleanup(m_logicalDevice);
         m_sceneTextureRenderPass.Cleanup(m_logicalDevice);
+        VM_memoryAllocator.Cleanup();
+        VM_pipelineCache.Cleanup();
         m_logicalDevice.Cleanup();
         m_physicalDevice.Cleanup();
         VM_validationLayers.Cleanup(m_instance);
@@ -156,10 +182,16 @@ namespace FlatEngine
                 VM_validationLayers.SetupDebugMessenger(m_instance);
                 m_physicalDevice.Init(m_instance, m_winSystem.GetSurface());
                 m_logicalDevice.Init(m_physicalDevice, m_winSystem.GetSurface());
+                VM_memoryAllocator.Init(m_physicalDevice, m_logicalDevice);
+                VM_pipelineCache.Init(m_physicalDevice, m_logicalDevice, PIPELINE_CACHE_FILEPATH);
                 m_winSystem.CreateDrawingResources();
                 QueueFamilyIndices indices = Helper::FindQueueFamilies(m_physicalDevice.GetDevice(), m_winSystem.GetSurface());
                 m_logicalDevice.SetGraphicsIndex(indices.graphicsFamily.value());
                 CreateCommandPool(m_commandPool, m_logicalDevice, indices.graphicsFamily.value());
+                m_commandRecorder.Init(m_logicalDevice, indices.graphicsFamily.value());
+                VM_uploadManager.Init(m_physicalDevice, m_logicalDevice, indices.graphicsFamily.value());
+                VM_uniformRing.Init(m_physicalDevice, m_logicalDevice);
+                m_meshInstances.Init(m_physicalDevice, m_logicalDevice);
                 CreateSyncObjects();
 
                 // Main RenderPass Configuration
@@ -193,6 +225,10 @@ namespace FlatEngine
                         meshIter->CreateResources(m_commandPool, m_physicalDevice, m_logicalDevice);                       
                     }
                 }
+
+                // 2D sprites, text and tiles from the Game View render queue
+                m_spriteBatch.SetHandles(m_physicalDevice, m_logicalDevice, m_mainRenderPass);
+                m_spriteBatch.CreateResources("../Shaders/compiledShaders/spriteVert.spv", "../Shaders/compiledShaders/spriteFrag.spv");
             }
         }
 
@@ -265,7 +301,7 @@ namespace FlatEngine
         m_sceneTextureRenderPass.AddSubpass(subpass);
     }
 
-    void VulkanManager::CreateWriteToImageResources(std::vector<VkImage>& images, std::vector<VkImageView>& imageViews, std::vector<VkDeviceMemory>& imageMemory)
+    void VulkanManager::CreateWriteToImageResources(std::vector<VkImage>& images, std::vector<VkImageView>& imageViews, std::vector<MemoryAllocation>& imageMemory)
     {        
         images.resize(m_winSystem.GetSwapChainImageViews().size());
         imageViews.resize(m_winSystem.GetSwapChainImageViews().size());
@@ -279,7 +315,7 @@ namespace FlatEngine
             int texHeight = extent.height;
             VkDeviceSize imageSize = texWidth * texHeight * 4;
             VkBuffer stagingBuffer{};
-            VkDeviceMemory stagingBufferMemory{};
+            MemoryAllocation stagingBufferMemory{};
             WinSys::CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory, m_physicalDevice, m_logicalDevice);
             WinSys::CreateImage(texWidth, texHeight, 1, VK_SAMPLE_COUNT_1_BIT, m_winSystem.GetImageFormat(), VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, images[i], imageMemory[i], m_physicalDevice, m_logicalDevice);
 
@@ -301,7 +337,7 @@ namespace FlatEngine
             //WinSys::TransitionImageLayout(images[i], VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 1, m_commandPool, m_logicalDevice);
 
             //vkDestroyBuffer(m_logicalDevice.GetDevice(), stagingBuffer, nullptr);
-            //vkFreeMemory(m_logicalDevice.GetDevice(), stagingBufferMemory, nullptr);
+            //VM_memoryAllocator.Free(stagingBufferMemory);
 
             WinSys::CreateImageView(imageViews[i], images[i], m_winSystem.GetImageFormat(), VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, m_logicalDevice);
             WinSys::CreateTextureSampler(m_viewportSampler, mipLevels, m_physicalDevice, m_logicalDevice);
@@ -337,15 +373,10 @@ namespace FlatEngine
             WinSys::CreateTextureSampler(m_viewportSampler, 1, m_physicalDevice, m_logicalDevice);
             // Create memory to back up the image
             VkMemoryRequirements memRequirements;
-            VkMemoryAllocateInfo memAllocInfo{};
-            memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            // VkDeviceMemory dstImageMemory;
             vkGetImageMemoryRequirements(m_logicalDevice.GetDevice(), m_viewportImages[i], &memRequirements);
-            memAllocInfo.allocationSize = memRequirements.size;
             // Memory must be host visible to copy from
-            memAllocInfo.memoryTypeIndex = Helper::FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_physicalDevice.GetDevice());
-            vkAllocateMemory(m_logicalDevice.GetDevice(), &memAllocInfo, nullptr, &m_viewportImageMemory[i]);
-            vkBindImageMemory(m_logicalDevice.GetDevice(), m_viewportImages[i], m_viewportImageMemory[i], 0);
+            VM_memoryAllocator.Allocate(memRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, true, m_viewportImageMemory[i]);
+            vkBindImageMemory(m_logicalDevice.GetDevice(), m_viewportImages[i], m_viewportImageMemory[i].memory, m_viewportImageMemory[i].offset);
 
             VkCommandBuffer copyCmd = Helper::BeginSingleTimeCommands(m_commandPool, m_logicalDevice);
             WinSys::InsertImageMemoryBarrier(
@@ -503,20 +534,31 @@ namespace FlatEngine
         // manually reset the fence to the unsignaled state with the vkResetFences call:
         vkResetFences(m_logicalDevice.GetDevice(), 1, &m_inFlightFences[VM_currentFrame]);
 
+        // Uploads recorded since the last frame start copying now, before the frame is recorded
+        VM_uploadManager.BeginFrame(VM_currentFrame);
+        VM_uploadManager.Flush();
 
 
+
+        // This frame's fence has been waited on so its instance buffer is free to overwrite
+        m_spriteBatch.Upload(VM_currentFrame);
+
         ///////////////////////
         // Main RenderPass
-        m_mainRenderPass.BeginRenderPass(imageIndex);
-        for (std::pair<std::string, std::vector<Mesh>> meshes : m_meshesByMaterial)
+        if (m_b_drawListStale)
         {
-            for (Mesh& mesh : meshes.second)
-            {
-                m_mainRenderPass.RecordCommandBuffer(imageIndex, mesh);  
-                m_mainRenderPass.DrawIndexed(mesh);
-                mesh.GetModel().UpdateUniformBuffer(VM_currentFrame, m_winSystem, 0.5f);
-            }
+            RebuildDrawList();
         }
+        WriteUniforms();
+
+        // Everything inside the main pass is recorded into secondary command buffers, mesh ranges across the worker threads
+        m_mainRenderPass.BeginRenderPass(imageIndex, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        m_commandRecorder.BeginFrame(VM_currentFrame, m_mainRenderPass.GetRenderPass(), m_mainRenderPass.GetFrameBuffers()[imageIndex], m_winSystem.GetExtent());
+        m_commandRecorder.RecordMeshes(m_drawGroups, m_meshInstances.GetBuffer(VM_currentFrame));
+        m_spriteBatch.RecordDraws(m_commandRecorder.BeginCallerBuffer(), VM_currentFrame, drawData);
+        m_commandRecorder.EndCallerBuffer();
+        m_commandRecorder.Execute(m_mainRenderPass.GetCommandBuffers()[VM_currentFrame]);
+        m_spriteBatch.EndFrame();
         m_mainRenderPass.EndRenderPass();
         ///////////////////////
 
@@ -548,11 +590,14 @@ namespace FlatEngine
         VkSubmitInfo submitInfo{};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-        VkSemaphore waitSemaphores[] = { m_imageAvailableSemaphores[VM_currentFrame] };
-        VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.pWaitSemaphores = waitSemaphores;
-        submitInfo.pWaitDstStageMask = waitStages;
+        // Resources uploaded on a dedicated upload queue are waited on as well, the frame draws them
+        VM_uploadManager.Flush();
+        std::vector<VkSemaphore> waitSemaphores = { m_imageAvailableSemaphores[VM_currentFrame] };
+        std::vector<VkPipelineStageFlags> waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+        VM_uploadManager.GetWaitSemaphores(VM_currentFrame, waitSemaphores, waitStages);
+        submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+        submitInfo.pWaitSemaphores = waitSemaphores.data();
+        submitInfo.pWaitDstStageMask = waitStages.data();
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &m_mainRenderPass.GetCommandBuffers()[VM_currentFrame];
 
@@ -615,8 +660,104 @@ namespace FlatEngine
         return b_swapChainGood;
     }
 
+    // Meshes sharing a pipeline end up next to each other so the recorder can skip redundant binds, and within that meshes
+    // sharing a Material and Model form one draw group that is drawn instanced
+    void VulkanManager::RebuildDrawList()
+    {
+        m_drawList.clear();
+        for (std::pair<const std::string, std::vector<Mesh>>& meshes : m_meshesByMaterial)
+        {
+            for (Mesh& mesh : meshes.second)
+            {
+                m_drawList.push_back(&mesh);
+            }
+        }
+        std::stable_sort(m_drawList.begin(), m_drawList.end(), [](Mesh* first, Mesh* second)
+        {
+            VkPipeline firstPipeline = first->GetMaterial()->GetGraphicsPipeline();
+            VkPipeline secondPipeline = second->GetMaterial()->GetGraphicsPipeline();
+            if (firstPipeline != secondPipeline)
+            {
+                return firstPipeline < secondPipeline;
+            }
+            if (first->GetMaterial() != second->GetMaterial())
+            {
+                return first->GetMaterial() < second->GetMaterial();
+            }
+            return first->GetSharedModel() < second->GetSharedModel();
+        });
+
+        m_drawGroups.clear();
+        for (size_t i = 0; i < m_drawList.size(); i++)
+        {
+            Mesh* mesh = m_drawList[i];
+            if (m_drawGroups.size() > 0 && m_drawGroups.back().mesh->GetMaterial() == mesh->GetMaterial() && m_drawGroups.back().mesh->GetSharedModel() == mesh->GetSharedModel())
+            {
+                m_drawGroups.back().instanceCount++;
+            }
+            else
+            {
+                m_drawGroups.push_back(MeshDrawGroup{ mesh, static_cast<uint32_t>(i), 1 });
+            }
+        }
+        m_b_drawListStale = false;
+    }
+
+    // Every draw group's UniformBufferObject for this frame goes into its slot of the ring, and every mesh's transform into
+    // its draw list entry of the instance buffer, in one pass before recording
+    void VulkanManager::WriteUniforms()
+    {
+        if (VM_uniformRing.Reserve(static_cast<uint32_t>(m_drawGroups.size())))
+        {
+            for (Mesh* mesh : m_drawList)
+            {
+                if (mesh->GetModel().GetModelPath() != "" && mesh->GetMaterial() != nullptr)
+                {
+                    mesh->GetMaterial()->GetAllocator().WriteUniformDescriptors(mesh->GetDescriptorSets());
+                }
+            }
+        }
+
+        UniformBufferObject ubo{};
+        for (size_t i = 0; i < m_drawGroups.size(); i++)
+        {
+            m_drawGroups[i].mesh->GetModel().FillUniformBufferObject(ubo, m_winSystem, 0.5f);
+            VM_uniformRing.Write(VM_currentFrame, static_cast<uint32_t>(i), ubo);
+        }
+
+        m_meshInstances.Reserve(static_cast<uint32_t>(m_drawList.size()));
+        for (size_t i = 0; i < m_drawList.size(); i++)
+        {
+            MeshInstance instance = m_drawList[i]->GetInstance();
+            m_meshInstances.Write(VM_currentFrame, static_cast<uint32_t>(i), instance);
+        }
+    }
+
+    // Loads a model file and uploads its buffers the first time it is asked for, later Meshes using the same file share them
+    std::shared_ptr<Model> VulkanManager::LoadSharedModel(std::string modelPath)
+    {
+        if (m_models.count(modelPath))
+        {
+            return m_models.at(modelPath);
+        }
+
+        std::shared_ptr<Model> model = std::make_shared<Model>();
+        model->SetModelPath(modelPath);
+        model->LoadModel();
+        model->CreateVertexBuffer(m_commandPool, m_physicalDevice, m_logicalDevice);
+        model->CreateIndexBuffer(m_commandPool, m_physicalDevice, m_logicalDevice);
+        m_models.emplace(modelPath, model);
+        return model;
+    }
+
+    std::map<std::string, std::shared_ptr<Model>>& VulkanManager::GetModels()
+    {
+        return m_models;
+    }
+
     void VulkanManager::AddMeshesByMaterial(std::pair<std::string, std::vector<Mesh>>& mesh)
     {
+        m_b_drawListStale = true;
         if (m_meshesByMaterial.count(mesh.first))
         {
             m_meshesByMaterial.at(mesh.first).insert(m_meshesByMaterial.at(mesh.first).end(), mesh.second.begin(), mesh.second.end());            
@@ -630,6 +771,94 @@ namespace FlatEngine
     void VulkanManager::SetMeshes(std::map<std::string, std::vector<Mesh>>& meshes)
     {
         m_meshesByMaterial = meshes;
+        m_b_drawListStale = true;
+    }
+
+    CommandRecorder& VulkanManager::GetCommandRecorder()
+    {
+        return m_commandRecorder;
+    }
+
+    LogicalDevice& VulkanManager::GetLogicalDevice()
+    {
+        return m_logicalDevice;
+    }
+
+    // For destroying resources a frame in flight may still be reading
+    void VulkanManager::WaitIdle()
+    {
+        vkDeviceWaitIdle(m_logicalDevice.GetDevice());
+    }
+
+    // Cooked textures ship a mip chain built on the CPU while everything else gets its chain from the blits in WinSys::RecordGenerateMipmaps(),
+    // so the two have to agree or cooked and uncooked builds of a project sample differently. Each GPU level is compared against the CPU filter
+    // applied to the GPU level above it, which keeps rounding from piling up down the chain
+    bool VulkanManager::CheckCookedMips(std::string& failure)
+    {
+        const int sizes[][2] = { { 64, 64 }, { 37, 20 }, { 1, 9 }, { 128, 3 } };
+        const int tolerance = 2;
+
+        for (const int* size : sizes)
+        {
+            int width = size[0];
+            int height = size[1];
+
+            // A smooth gradient with 8 pixel blocks over it so both the filter weights and hard edges are covered
+            std::vector<unsigned char> pixels((size_t)width * height * 4);
+            for (int y = 0; y < height; y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    unsigned char* pixel = &pixels[((size_t)y * width + x) * 4];
+                    bool b_block = ((x / 8) + (y / 8)) % 2 == 0;
+                    pixel[0] = (unsigned char)(x * 255 / std::max(width - 1, 1));
+                    pixel[1] = (unsigned char)(y * 255 / std::max(height - 1, 1));
+                    pixel[2] = b_block ? 255 : 0;
+                    pixel[3] = b_block ? 255 : 64;
+                }
+            }
+
+            std::vector<unsigned char> gpuChain;
+            std::vector<CookedMip> gpuMips;
+            WinSys::ReadBackGeneratedMips(pixels.data(), width, height, gpuChain, gpuMips, m_commandPool, m_physicalDevice, m_logicalDevice);
+
+            std::string sizeName = std::to_string(width) + "x" + std::to_string(height);
+            if (memcmp(gpuChain.data(), pixels.data(), pixels.size()) != 0)
+            {
+                failure = "level 0 of the " + sizeName + " texture changed on upload";
+                return false;
+            }
+
+            for (size_t level = 1; level < gpuMips.size(); level++)
+            {
+                CookedMip& source = gpuMips[level - 1];
+                CookedMip& gpuMip = gpuMips[level];
+                std::vector<unsigned char> cpuChain;
+                std::vector<CookedMip> cpuMips;
+                CookedTexture::BuildMipChain(gpuChain.data() + source.offset, source.width, source.height, cpuChain, cpuMips);
+
+                if (cpuMips.size() < 2 || cpuMips[1].width != gpuMip.width || cpuMips[1].height != gpuMip.height)
+                {
+                    failure = "level " + std::to_string(level) + " of the " + sizeName + " texture has a different size on the CPU";
+                    return false;
+                }
+
+                const unsigned char* cpuPixels = cpuChain.data() + cpuMips[1].offset;
+                const unsigned char* gpuPixels = gpuChain.data() + gpuMip.offset;
+                for (uint64_t i = 0; i < gpuMip.size; i++)
+                {
+                    if (std::abs((int)cpuPixels[i] - (int)gpuPixels[i]) > tolerance)
+                    {
+                        uint64_t pixel = i / 4;
+                        failure = "level " + std::to_string(level) + " of the " + sizeName + " texture differs at (" + std::to_string(pixel % gpuMip.width) + ", " + std::to_string(pixel / gpuMip.width) +
+                            "), CPU " + std::to_string(cpuPixels[i]) + " GPU " + std::to_string(gpuPixels[i]);
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
     }
 
     WinSys& VulkanManager::GetWinSystem()
@@ -647,6 +876,11 @@ namespace FlatEngine
         return m_logicalDevice.GetGraphicsQueue();
     }
 
+    SpriteBatch& VulkanManager::GetSpriteBatch()
+    {
+        return m_spriteBatch;
+    }
+
     void VulkanManager::FramebufferResizeCallback(GLFWwindow* window, int width, int height)
     {
         // Called when GLFW detects the window has been resized.
@@ -8,6 +8,12 @@
 #include "RenderPass.h"
 #include "Mesh.h"
 #include "Material.h"
+#include "SpriteBatch.h"
+#include "CommandRecorder.h"
+#include "UniformRing.h"
+#include "PipelineCache.h"
+#include "UploadManager.h"
+#include "InstanceBuffer.h"
 #include "Vector2.h"
 
 #define GLFW_INCLUDE_VULKAN
@@ -36,6 +42,10 @@ namespace FlatEngine
     extern ValidationLayers VM_validationLayers;
     const int VM_MAX_FRAMES_IN_FLIGHT = 2;
     extern uint32_t VM_currentFrame;
+    extern UniformRing VM_uniformRing;
+    extern MemoryAllocator VM_memoryAllocator;
+    extern PipelineCache VM_pipelineCache;
+    extern UploadManager VM_uploadManager;
 
     class VulkanManager
     {
@@ -48,11 +58,18 @@ namespace FlatEngine
         WinSys& GetWinSystem();
         VkInstance& GetInstance();
         VkQueue& GetGraphicsQueue();             
+        SpriteBatch& GetSpriteBatch();
         void AddMeshesByMaterial(std::pair<std::string, std::vector<Mesh>>& mesh);
         void SetMeshes(std::map<std::string, std::vector<Mesh>>& meshes);
+        std::shared_ptr<Model> LoadSharedModel(std::string modelPath);
+        std::map<std::string, std::shared_ptr<Model>>& GetModels();
         void CreateImGuiTexture(Texture& texture, std::vector<VkDescriptorSet>& descriptorSets, int& allocatedFrom); // TEMPORARY WORK AROUND BEFORE FULL IMPLIMENATION OF 2D TEXTURES
         void FreeImGuiTexture(uint32_t allocatedFrom);       
         void DrawFrame(ImDrawData* draw_data);
+        CommandRecorder& GetCommandRecorder();
+        LogicalDevice& GetLogicalDevice();
+        void WaitIdle();
+        bool CheckCookedMips(std::string& failure);
 
         static void FramebufferResizeCallback(GLFWwindow* window, int width, int height);
         static void check_vk_result(VkResult err);
@@ -60,7 +77,7 @@ namespace FlatEngine
 
         std::vector<VkImage> m_viewportImages;
         std::vector<VkImageView> m_viewportImageViews;
-        std::vector<VkDeviceMemory> m_viewportImageMemory;
+        std::vector<MemoryAllocation> m_viewportImageMemory;
         VkSampler m_viewportSampler;
         std::vector<VkDescriptorSet> viewportDescriptorSets;
 
@@ -70,18 +87,27 @@ namespace FlatEngine
         void RecreateSwapChainAndFrameBuffers();
         bool CreateVulkanInstance();    
         void CreateSyncObjects();
-        void CreateWriteToImageResources(std::vector<VkImage>& images, std::vector<VkImageView>& imageViews, std::vector<VkDeviceMemory>& imageMemory);
+        void CreateWriteToImageResources(std::vector<VkImage>& images, std::vector<VkImageView>& imageViews, std::vector<MemoryAllocation>& imageMemory);
         void CreateSceneRenderPassResources();
         void CreateViewportImages();
         void CreateViewportImageViews();
+        void RebuildDrawList();
+        void WriteUniforms();
 
         // To be moved into FlatEngine implimentation eventually
         std::map<std::string, std::vector<Mesh>> m_meshesByMaterial;
         std::map<std::string, std::shared_ptr<Material>> m_materials;
+        std::map<std::string, std::shared_ptr<Model>> m_models; // by model path, vertex and index buffers shared by every Mesh using the file
+        std::vector<Mesh*> m_drawList; // m_meshesByMaterial flattened and grouped by pipeline, Material and Model, rebuilt when the meshes change
+        std::vector<MeshDrawGroup> m_drawGroups; // runs of m_drawList drawn with one instanced call each
+        bool m_b_drawListStale;
+        InstanceBuffer m_meshInstances;
 
         RenderPass m_mainRenderPass;
         RenderPass m_sceneTextureRenderPass;
         ImGuiManager m_imguiManager;
+        SpriteBatch m_spriteBatch;
+        CommandRecorder m_commandRecorder;
 
         VkInstance m_instance;
         WinSys m_winSystem;
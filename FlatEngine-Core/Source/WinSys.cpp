@@ -1,6 +1,9 @@
 #include "WinSys.h"
 #include "VulkanManager.h"
 #include "Helper.h"
+#include "CookedTexture.h"
+#include "FlatEngine.h"
+#include "VirtualFileSystem.h"
 
 #define STB_IMAGE_IMPLEMENTATION // Image loading
 #include "stb_image.h"
@@ -11,6 +14,7 @@
 #include <array>
 #include <algorithm> // Necessary for std::clamp
 #include <stdexcept>
+#include <cstring>
 
 
 namespace FlatEngine
@@ -312,7 +316,7 @@ namespace FlatEngine
 
 
     // statics
-    void WinSys::CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory, PhysicalDevice &physicalDevice, LogicalDevice &logicalDevice)
+    void WinSys::CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, MemoryAllocation& imageMemory, PhysicalDevice &physicalDevice, LogicalDevice &logicalDevice)
     {
         VkImageCreateInfo imageInfo{};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -336,17 +340,8 @@ namespace FlatEngine
         VkMemoryRequirements memRequirements{};
         vkGetImageMemoryRequirements(logicalDevice.GetDevice(), image, &memRequirements);
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = physicalDevice.FindMemoryType(memRequirements.memoryTypeBits, properties);
-
-        if (vkAllocateMemory(logicalDevice.GetDevice(), &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to allocate image memory!");
-        }
-
-        vkBindImageMemory(logicalDevice.GetDevice(), image, imageMemory, 0);
+        VM_memoryAllocator.Allocate(memRequirements, properties, tiling == VK_IMAGE_TILING_LINEAR, imageMemory);
+        vkBindImageMemory(logicalDevice.GetDevice(), image, imageMemory.memory, imageMemory.offset);
     }
 
     void WinSys::CreateImageView(VkImageView& imageView, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels, LogicalDevice& logicalDevice)
@@ -400,54 +395,174 @@ namespace FlatEngine
         }
     }
 
-    VkImage WinSys::CreateTextureImage(std::string path, uint32_t mipLevels, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, VkDeviceMemory textureImageMemory)
+    VkImage WinSys::CreateTextureImage(std::string path, uint32_t& mipLevels, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, MemoryAllocation& textureImageMemory)
     {
-        // Refer to - https://vulkan-tutorial.com/en/Texture_mapping/Images
-        // And refer to - https://vulkan-tutorial.com/en/Generating_Mipmaps
-
-        VkImage newImage = VK_NULL_HANDLE;
+        // A cook written by BuildProject() skips the decode and the mip blits
+        if (CookedTexture::HasCurrentCook(path))
+        {
+            CookedTexture cookedTexture;
+            if (cookedTexture.Open(CookedTexture::GetCookedPath(path)))
+            {
+                return CreateTextureImage(cookedTexture, mipLevels, physicalDevice, logicalDevice, textureImageMemory);
+            }
+        }
 
         int texWidth, texHeight, texChannels;
-        stbi_uc* pixels = stbi_load(path.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-        VkDeviceSize imageSize = texWidth * texHeight * 4;
+        stbi_uc* pixels = nullptr;
+        FileData file;
+        if (F_VirtualFileSystem.Read(path, file))
+        {
+            pixels = stbi_load_from_memory(file.GetData(), (int)file.GetSize(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+        }
 
         if (!pixels)
         {
             throw std::runtime_error("failed to load texture image: " + path);
         }
 
-        mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
-
-        VkBuffer stagingBuffer{};
-        VkDeviceMemory stagingBufferMemory{};
-        CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory, physicalDevice, logicalDevice);
-
-        void* data{};
-        vkMapMemory(logicalDevice.GetDevice(), stagingBufferMemory, 0, imageSize, 0, &data);
-        memcpy(data, pixels, static_cast<size_t>(imageSize));
-        vkUnmapMemory(logicalDevice.GetDevice(), stagingBufferMemory);
+        VkImage newImage = CreateTextureImage(pixels, texWidth, texHeight, mipLevels, commandPool, physicalDevice, logicalDevice, textureImageMemory);
 
         // Cleanup pixel array
         stbi_image_free(pixels);
 
+        return newImage;
+    }
+
+    // Uploads already decoded RGBA pixels (texWidth * texHeight * 4 bytes)
+    VkImage WinSys::CreateTextureImage(unsigned char* pixels, int texWidth, int texHeight, uint32_t& mipLevels, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, MemoryAllocation& textureImageMemory)
+    {
+        // Refer to - https://vulkan-tutorial.com/en/Texture_mapping/Images
+        // And refer to - https://vulkan-tutorial.com/en/Generating_Mipmaps
+
+        VkImage newImage = VK_NULL_HANDLE;
+        VkDeviceSize imageSize = texWidth * texHeight * 4;
+
+        mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+
         CreateImage(texWidth, texHeight, mipLevels, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, newImage, textureImageMemory, physicalDevice, logicalDevice);
 
-        TransitionImageLayout(newImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels, commandPool, logicalDevice);
-        CopyBufferToImage(stagingBuffer, newImage, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), commandPool, logicalDevice);
-        // TransitionImageLayout(m_textureImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_mipLevels);
-        //  Removed this call ^^ because we are transiting to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps instead now
-        GenerateMipmaps(newImage, VK_FORMAT_R8G8B8A8_UNORM, texWidth, texHeight, mipLevels, commandPool, physicalDevice, logicalDevice);
+        // Copy, layout transitions and mipmap generation are recorded into the upload manager's open batch rather than submitted and waited on here.
+        // The pixels are copied into its staging ring before this returns so the caller is free to release them
+        CheckLinearBlitSupport(VK_FORMAT_R8G8B8A8_UNORM, physicalDevice);
+        VM_uploadManager.UploadImage(pixels, imageSize, newImage, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), mipLevels);
 
-        vkDestroyBuffer(logicalDevice.GetDevice(), stagingBuffer, nullptr);
-        vkFreeMemory(logicalDevice.GetDevice(), stagingBufferMemory, nullptr);
+        return newImage;
+    }
+
+    // Copies every level of an opened CookedTexture straight from its mapping into the staging ring, the file can be closed once this returns
+    VkImage WinSys::CreateTextureImage(CookedTexture& cookedTexture, uint32_t& mipLevels, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, MemoryAllocation& textureImageMemory)
+    {
+        VkImage newImage = VK_NULL_HANDLE;
+        CookedTextureHeader& header = cookedTexture.GetHeader();
+        mipLevels = header.mipLevels;
+
+        CreateImage(header.width, header.height, mipLevels, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, newImage, textureImageMemory, physicalDevice, logicalDevice);
+
+        std::vector<VkBufferImageCopy> regions;
+        for (uint32_t level = 0; level < mipLevels; level++)
+        {
+            CookedMip& mip = cookedTexture.GetMips()[level];
+            VkBufferImageCopy region{};
+            region.bufferOffset = mip.offset;
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = level;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = { 0, 0, 0 };
+            region.imageExtent = { mip.width, mip.height, 1 };
+            regions.push_back(region);
+        }
+
+        VM_uploadManager.UploadImageLevels(cookedTexture.GetPixelData(), header.dataSize, newImage, regions);
 
         return newImage;
     }
 
-    void WinSys::GenerateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
+    // Uploads level 0, builds the rest of the chain with the same blits CreateTextureImage() records and copies every level back,
+    // chain and mips come back laid out like CookedTexture::BuildMipChain() so the two can be compared level by level. Waits on the GPU
+    void WinSys::ReadBackGeneratedMips(const unsigned char* pixels, int texWidth, int texHeight, std::vector<unsigned char>& chain, std::vector<CookedMip>& mips, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
     {
-        // Refer to - https://vulkan-tutorial.com/en/Generating_Mipmaps
+        uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+        chain.clear();
+        mips.clear();
 
+        std::vector<VkBufferImageCopy> regions;
+        VkDeviceSize chainSize = 0;
+        uint32_t mipWidth = static_cast<uint32_t>(texWidth);
+        uint32_t mipHeight = static_cast<uint32_t>(texHeight);
+        for (uint32_t level = 0; level < mipLevels; level++)
+        {
+            CookedMip mip = CookedMip();
+            mip.width = mipWidth;
+            mip.height = mipHeight;
+            mip.offset = chainSize;
+            mip.size = (uint64_t)mipWidth * mipHeight * 4;
+            mips.push_back(mip);
+            chainSize += mip.size;
+
+            VkBufferImageCopy region{};
+            region.bufferOffset = mip.offset;
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = level;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = { 0, 0, 0 };
+            region.imageExtent = { mip.width, mip.height, 1 };
+            regions.push_back(region);
+
+            if (mipWidth > 1) mipWidth /= 2;
+            if (mipHeight > 1) mipHeight /= 2;
+        }
+
+        CheckLinearBlitSupport(VK_FORMAT_R8G8B8A8_UNORM, physicalDevice);
+
+        VkImage image = VK_NULL_HANDLE;
+        MemoryAllocation imageMemory;
+        CreateImage(texWidth, texHeight, mipLevels, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, imageMemory, physicalDevice, logicalDevice);
+
+        // One buffer for the upload of level 0 and the read back of the whole chain
+        VkBuffer buffer = VK_NULL_HANDLE;
+        MemoryAllocation bufferMemory;
+        CreateBuffer(chainSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffer, bufferMemory, physicalDevice, logicalDevice);
+        memcpy(bufferMemory.mapped, pixels, static_cast<size_t>(mips[0].size));
+
+        VkCommandBuffer commandBuffer = Helper::BeginSingleTimeCommands(commandPool, logicalDevice);
+        RecordTransitionImageLayout(commandBuffer, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+        RecordCopyBufferToImage(commandBuffer, buffer, 0, image, texWidth, texHeight);
+        RecordGenerateMipmaps(commandBuffer, image, texWidth, texHeight, mipLevels);
+
+        VkImageSubresourceRange allLevels{};
+        allLevels.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        allLevels.baseMipLevel = 0;
+        allLevels.levelCount = mipLevels;
+        allLevels.baseArrayLayer = 0;
+        allLevels.layerCount = 1;
+        InsertImageMemoryBarrier(commandBuffer, image, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, allLevels);
+
+        vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, static_cast<uint32_t>(regions.size()), regions.data());
+
+        VkMemoryBarrier hostBarrier{};
+        hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+        Helper::EndSingleTimeCommands(commandPool, commandBuffer, logicalDevice);
+
+        const unsigned char* readBack = (const unsigned char*)bufferMemory.mapped;
+        chain.assign(readBack, readBack + chainSize);
+
+        vkDestroyBuffer(logicalDevice.GetDevice(), buffer, nullptr);
+        VM_memoryAllocator.Free(bufferMemory);
+        vkDestroyImage(logicalDevice.GetDevice(), image, nullptr);
+        VM_memoryAllocator.Free(imageMemory);
+    }
+
+    void WinSys::CheckLinearBlitSupport(VkFormat imageFormat, PhysicalDevice& physicalDevice)
+    {
         // Check if image format supports linear blitting
         VkFormatProperties formatProperties;
         vkGetPhysicalDeviceFormatProperties(physicalDevice.GetDevice(), imageFormat, &formatProperties);
@@ -455,8 +570,21 @@ namespace FlatEngine
         {
             throw std::runtime_error("texture image format does not support linear blitting!");
         }
+    }
+
+    void WinSys::GenerateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
+    {
+        CheckLinearBlitSupport(imageFormat, physicalDevice);
 
         VkCommandBuffer commandBuffer = Helper::BeginSingleTimeCommands(commandPool, logicalDevice);
+        RecordGenerateMipmaps(commandBuffer, image, texWidth, texHeight, mipLevels);
+        Helper::EndSingleTimeCommands(commandPool, commandBuffer, logicalDevice);
+    }
+
+    // Expects every mip level in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL with level 0 filled, leaves them all in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    void WinSys::RecordGenerateMipmaps(VkCommandBuffer commandBuffer, VkImage image, int32_t texWidth, int32_t texHeight, uint32_t mipLevels)
+    {
+        // Refer to - https://vulkan-tutorial.com/en/Generating_Mipmaps
 
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -532,16 +660,19 @@ namespace FlatEngine
             0, nullptr,
             0, nullptr,
             1, &barrier);
+    }
 
+    void WinSys::TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels, VkCommandPool commandPool, LogicalDevice &logicalDevice)
+    {
+        VkCommandBuffer commandBuffer = Helper::BeginSingleTimeCommands(commandPool, logicalDevice);
+        RecordTransitionImageLayout(commandBuffer, image, oldLayout, newLayout, mipLevels);
         Helper::EndSingleTimeCommands(commandPool, commandBuffer, logicalDevice);
     }
 
-    void WinSys::TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels, VkCommandPool commandPool, LogicalDevice &logicalDevice)
+    void WinSys::RecordTransitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels)
     {
         // Refer to - https://vulkan-tutorial.com/en/Texture_mapping/Images
 
-        VkCommandBuffer commandBuffer = Helper::BeginSingleTimeCommands(commandPool, logicalDevice);
-
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         barrier.pNext = 0;
@@ -579,11 +710,9 @@ namespace FlatEngine
         }
 
         vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-        Helper::EndSingleTimeCommands(commandPool, commandBuffer, logicalDevice);
     }
 
-    void WinSys::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
+    void WinSys::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, MemoryAllocation& bufferMemory, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice)
     {
         // Refer to - https://vulkan-tutorial.com/en/Vertex_buffers/Vertex_buffer_creation
         VkBufferCreateInfo bufferInfo{};
@@ -600,18 +729,9 @@ namespace FlatEngine
         VkMemoryRequirements memRequirements{};
         vkGetBufferMemoryRequirements(logicalDevice.GetDevice(), buffer, &memRequirements);
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = physicalDevice.FindMemoryType(memRequirements.memoryTypeBits, properties);
-
-        // NOTE FROM THE WIKI: It should be noted that in a real world application, you're not supposed to actually call vkAllocateMemory for every individual buffer. The maximum number of simultaneous memory allocations is limited by the maxMemoryAllocationCount physical device limit
-        if (vkAllocateMemory(logicalDevice.GetDevice(), &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to allocate vertex buffer memory!");
-        }
-
-        vkBindBufferMemory(logicalDevice.GetDevice(), buffer, bufferMemory, 0);
+        // Sub-allocated from a shared block, vkAllocateMemory per buffer would run into the maxMemoryAllocationCount limit
+        VM_memoryAllocator.Allocate(memRequirements, properties, true, bufferMemory);
+        vkBindBufferMemory(logicalDevice.GetDevice(), buffer, bufferMemory.memory, bufferMemory.offset);
     }
 
     void WinSys::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkCommandPool commandPool, LogicalDevice& logicalDevice)
@@ -629,9 +749,14 @@ namespace FlatEngine
     void WinSys::CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkCommandPool commandPool, LogicalDevice &logicalDevice)
     {
         VkCommandBuffer commandBuffer = Helper::BeginSingleTimeCommands(commandPool, logicalDevice);
+        RecordCopyBufferToImage(commandBuffer, buffer, 0, image, width, height);
+        Helper::EndSingleTimeCommands(commandPool, commandBuffer, logicalDevice);
+    }
 
+    void WinSys::RecordCopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize bufferOffset, VkImage image, uint32_t width, uint32_t height)
+    {
         VkBufferImageCopy region{};
-        region.bufferOffset = 0;
+        region.bufferOffset = bufferOffset;
         region.bufferRowLength = 0;
         region.bufferImageHeight = 0;
 
@@ -655,8 +780,6 @@ namespace FlatEngine
             1,
             &region
         );
-
-        Helper::EndSingleTimeCommands(commandPool, commandBuffer, logicalDevice);
     }
 
     void WinSys::InsertImageMemoryBarrier(VkCommandBuffer commandBuffer, VkImage image, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask, VkImageLayout oldImageLayout, VkImageLayout newImageLayout, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkImageSubresourceRange subresourceRange)
@@ -1,6 +1,7 @@
 #pragma once
 #include "PhysicalDevice.h"
 #include "LogicalDevice.h"
+#include "MemoryAllocator.h"
 
 #define GLFW_INCLUDE_VULKAN
 #include <glfw3.h>
@@ -12,6 +13,9 @@
 
 namespace FlatEngine
 {
+	class CookedTexture;
+	struct CookedMip;
+
 	class WinSys
 	{
 	public:
@@ -44,15 +48,22 @@ namespace FlatEngine
 		VkExtent2D GetExtent();
 		VkSwapchainKHR& GetSwapChain();
 
-		static void CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
+		static void CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, MemoryAllocation& imageMemory, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
 		static void CreateImageView(VkImageView& imageView, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels, LogicalDevice& logicalDevice);
 		static void CreateTextureSampler(VkSampler& textureSampler, uint32_t mipLevels, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
-		static VkImage CreateTextureImage(std::string path, uint32_t mipLevels, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, VkDeviceMemory textureImageMemory);
+		static VkImage CreateTextureImage(std::string path, uint32_t& mipLevels, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, MemoryAllocation& textureImageMemory);
+		static VkImage CreateTextureImage(unsigned char* pixels, int texWidth, int texHeight, uint32_t& mipLevels, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, MemoryAllocation& textureImageMemory);
+		static VkImage CreateTextureImage(CookedTexture& cookedTexture, uint32_t& mipLevels, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice, MemoryAllocation& textureImageMemory);
+		static void ReadBackGeneratedMips(const unsigned char* pixels, int texWidth, int texHeight, std::vector<unsigned char>& chain, std::vector<CookedMip>& mips, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
+		static void CheckLinearBlitSupport(VkFormat imageFormat, PhysicalDevice& physicalDevice);
 		static void GenerateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels, VkCommandPool commandPool, PhysicalDevice& physicalDevice, LogicalDevice& logicalDevice);
+		static void RecordGenerateMipmaps(VkCommandBuffer commandBuffer, VkImage image, int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
 		static void TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels, VkCommandPool commandPool, LogicalDevice& logicalDevice);
-		static void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory, PhysicalDevice& physicalDevice, LogicalDevice &logicalDevice);
+		static void RecordTransitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels);
+		static void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, MemoryAllocation& bufferMemory, PhysicalDevice& physicalDevice, LogicalDevice &logicalDevice);
 		static void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkCommandPool commandPool, LogicalDevice &logicalDevice);
 		static void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkCommandPool commandPool, LogicalDevice& logicalDevice);
+		static void RecordCopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize bufferOffset, VkImage image, uint32_t width, uint32_t height);
 		static void InsertImageMemoryBarrier(VkCommandBuffer commandBuffer, VkImage image, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask, VkImageLayout oldImageLayout, VkImageLayout newImageLayout, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkImageSubresourceRange subresourceRange);
 		
 		bool m_b_framebufferResized;
@@ -0,0 +1,139 @@
+#include "WorkerPool.h"
+
+
+namespace FlatEngine
+{
+	WorkerPool::WorkerPool()
+	{
+		m_threads = std::vector<std::thread>();
+		m_job = nullptr;
+		m_jobCount = 0;
+		m_nextJob = 0;
+		m_jobsRemaining = 0;
+		m_generation = 0;
+		m_b_stopping = false;
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		Stop();
+	}
+
+	void WorkerPool::Start(int threadCount)
+	{
+		Stop();
+		m_b_stopping = false;
+
+		for (int i = 0; i < threadCount; i++)
+		{
+			m_threads.push_back(std::thread(&WorkerPool::WorkerLoop, this));
+		}
+	}
+
+	void WorkerPool::Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_b_stopping = true;
+		}
+		m_wake.notify_all();
+
+		for (std::thread& thread : m_threads)
+		{
+			if (thread.joinable())
+			{
+				thread.join();
+			}
+		}
+		m_threads.clear();
+	}
+
+	int WorkerPool::GetThreadCount()
+	{
+		return (int)m_threads.size();
+	}
+
+	void WorkerPool::ParallelFor(int jobCount, std::function<void(int)> job)
+	{
+		if (jobCount <= 0)
+		{
+			return;
+		}
+		if (jobCount == 1 || m_threads.size() == 0)
+		{
+			for (int i = 0; i < jobCount; i++)
+			{
+				job(i);
+			}
+			return;
+		}
+
+		unsigned long generation;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_job = job;
+			m_jobCount = jobCount;
+			m_nextJob = 0;
+			m_jobsRemaining = jobCount;
+			generation = ++m_generation;
+		}
+		m_wake.notify_all();
+
+		RunJobs(generation);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this]() { return m_jobsRemaining == 0; });
+		m_job = nullptr;
+	}
+
+	// Job indices are handed out under the lock along with the generation check, so a worker that wakes late
+	// can never pick up an index belonging to the next ParallelFor() with the previous job
+	void WorkerPool::RunJobs(unsigned long generation)
+	{
+		while (true)
+		{
+			int index;
+			std::function<void(int)>* job;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (m_generation != generation || m_nextJob >= m_jobCount)
+				{
+					return;
+				}
+				index = m_nextJob++;
+				job = &m_job;
+			}
+
+			(*job)(index);
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobsRemaining--;
+			if (m_jobsRemaining == 0)
+			{
+				m_done.notify_all();
+			}
+		}
+	}
+
+	void WorkerPool::WorkerLoop()
+	{
+		unsigned long seenGeneration = 0;
+
+		while (true)
+		{
+			unsigned long generation;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [&]() { return m_b_stopping || m_generation != seenGeneration; });
+				if (m_b_stopping)
+				{
+					return;
+				}
+				generation = m_generation;
+				seenGeneration = generation;
+			}
+
+			RunJobs(generation);
+		}
+	}
+}
\ No newline at end of file
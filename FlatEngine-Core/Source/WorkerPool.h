@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+
+namespace FlatEngine
+{
+	// Small set of persistent worker threads for splitting per-frame work into a handful of coarse jobs.
+	// ParallelFor() blocks, the calling thread takes jobs too, so with no workers it simply runs them in order.
+	class WorkerPool
+	{
+	public:
+		WorkerPool();
+		~WorkerPool();
+
+		void Start(int threadCount);
+		void Stop();
+		int GetThreadCount();
+		void ParallelFor(int jobCount, std::function<void(int)> job);
+
+	private:
+		void WorkerLoop();
+		void RunJobs(unsigned long generation);
+
+		std::vector<std::thread> m_threads;
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		std::function<void(int)> m_job;
+		int m_jobCount;
+		int m_nextJob;
+		int m_jobsRemaining;
+		unsigned long m_generation;
+		bool m_b_stopping;
+	};
+}
\ No newline at end of file
@@ -1444,10 +1444,10 @@ namespace FlatGui
 									tempText.SetFontPath(fs_path.string());
 									tempText.SetText(text->text);
 
-									if (tempText.GetTexture() != nullptr)
+									if (tempText.GetLayout() != nullptr)
 									{
-										text->xOffset = (float)(tempText.GetTexture()->GetWidth() / 2);
-										text->yOffset = (float)(tempText.GetTexture()->GetHeight() / 2);
+										text->xOffset = (float)(tempText.GetWidth() / 2);
+										text->yOffset = (float)(tempText.GetHeight() / 2);
 									}
 								}
 								else
@@ -141,10 +141,18 @@ namespace FlatGui
 			if (FG_b_showGameView)
 			{
 				FL::AddProfilerProcess("Game View");
+				FL::AddProfilerProcess("Render Index");
+				FL::AddProfilerProcess("Render Extraction");
+				FL::AddProfilerProcess("Render Sort");
+				FL::AddProfilerProcess("Sprite Batch");
 			}
 			else
 			{
 				FL::RemoveProfilerProcess("Game View");
+				FL::RemoveProfilerProcess("Render Index");
+				FL::RemoveProfilerProcess("Render Extraction");
+				FL::RemoveProfilerProcess("Render Sort");
+				FL::RemoveProfilerProcess("Sprite Batch");
 			}
 
 			if (FG_b_showSceneView)
@@ -416,6 +424,7 @@ namespace FlatGui
 			{ "resolutionHeight", project.GetResolution().y },
 			{ "_fullscreen", project.IsFullscreen() },
 			{ "_vsyncEnabled", project.IsVsyncEnabled() },
+			{ "_packTexturesOnLoad", project.PacksTexturesOnLoad() },
 			{ "musicVolume", project.GetMusicVolume() },
 			{ "effectsVolume", project.GetEffectsVolume() },
 			{ "currentFileDirectory", FG_currentDirectory },
@@ -642,7 +651,7 @@ namespace FlatGui
 		}
 	}
 
-	void RenderViewObjects(std::map<long, GameObject>& objects, Vector2 centerPoint, Vector2 canvasP0, Vector2 canvasSize, float gridStep)
+	void RenderViewObjects(std::vector<GameObject*>& objects, Vector2 centerPoint, Vector2 canvasP0, Vector2 canvasSize, float gridStep)
 	{
 		// Split our drawlist into multiple channels for different rendering orders
 		ImDrawList* drawList = ImGui::GetWindowDrawList();
@@ -652,11 +661,11 @@ namespace FlatGui
 		drawSplitter->Split(drawList, FL::F_maxSpriteLayers + 5);
 		
 
-		for (std::pair<long, GameObject> object : objects)
+		for (GameObject* object : objects)
 		{
-			if (object.second.IsActive())
+			if (object->IsActive())
 			{
-				RenderViewObject(object.second, centerPoint, canvasP0, canvasSize, gridStep, drawList, drawSplitter);
+				RenderViewObject(*object, centerPoint, canvasP0, canvasSize, gridStep, drawList, drawSplitter);
 			}
 		}
 
@@ -728,15 +737,14 @@ namespace FlatGui
 
 				if (spriteScale.x > 0 && spriteScale.y > 0 && spriteTexture != nullptr)
 				{
-					FL::AddImageToDrawList(spriteTexture, position, scrolling, spriteTextureWidth, spriteTextureHeight, offset, spriteScale, b_spriteScalesWithZoom, gridStep, drawList, rotation, ImGui::GetColorU32(tintColor));
+					FL::AddImageToDrawList(spriteTexture, position, scrolling, spriteTextureWidth, spriteTextureHeight, offset, spriteScale, b_spriteScalesWithZoom, gridStep, drawList, rotation, ImGui::GetColorU32(tintColor), sprite->GetUVStart(), sprite->GetUVEnd());
 				}
 			}
 
 			if (text != nullptr)
 			{
-				std::shared_ptr<Texture> textTexture = text->GetTexture();
-				float textWidth = (float)textTexture->GetWidth();
-				float textHeight = (float)textTexture->GetHeight();
+				float textWidth = (float)text->GetWidth();
+				float textHeight = (float)text->GetHeight();
 				Vector2 offset = text->GetOffset();
 				int renderOrder = text->GetRenderOrder();				
 				bool b_spriteScalesWithZoom = true;
@@ -746,7 +754,7 @@ namespace FlatGui
 				
 				Vector2 newScale = Vector2(scale.x * FL::F_spriteScaleMultiplier, scale.y * FL::F_spriteScaleMultiplier);
 
-				if (textTexture->GetTexture() != nullptr)
+				if (textWidth > 0 && textHeight > 0)
 				{
 					//Vector2 scaledPosition = Vector2(origin.x + (relativePosition.x * baseScale.x), origin.y + (relativePosition.y * baseScale.y));
 					Vector2 positionOnScreen = Vector2(FG_sceneViewCenter.x + (position.x * gridStep) - ((offset.x * FL::F_spriteScaleMultiplier * gridStep) * newScale.x), FG_sceneViewCenter.y - (position.y * gridStep) - ((offset.y * FL::F_spriteScaleMultiplier * gridStep) * newScale.y));
@@ -768,7 +776,12 @@ namespace FlatGui
 						drawSplitter->SetCurrentChannel(drawList, 0);
 					}
 									
-					FL::AddImageToDrawList(textTexture->GetTexture(), position, FG_sceneViewCenter, textWidth, textHeight, offset, newScale, b_spriteScalesWithZoom, FG_sceneViewGridStep.x, drawList, rotation, ImGui::GetColorU32(tintColor));
+					static std::vector<FL::RenderItem> glyphItems = std::vector<FL::RenderItem>();
+					text->GetGlyphRenderItems(position, newScale, rotation, ImGui::GetColorU32(tintColor), glyphItems);
+					for (FL::RenderItem& item : glyphItems)
+					{
+						FL::AddImageToDrawList(item.texture, item.position, FG_sceneViewCenter, item.textureWidth, item.textureHeight, item.offset, item.scale, b_spriteScalesWithZoom, FG_sceneViewGridStep.x, drawList, item.rotation, item.tintColor, item.uvStart, item.uvEnd);
+					}
 				}
 			}
 			
@@ -1002,7 +1015,6 @@ namespace FlatGui
 				float gridWidth = width * tileWidth / FL::F_pixelsPerGridSpace;		// in grid tiles
 				float gridHeight = height * tileHeight / FL::F_pixelsPerGridSpace;	// in grid tiles
 				int renderOrder = tileMap->GetRenderOrder();
-				std::map<int, std::map<int, FL::Tile>> tiles = tileMap->GetTiles();
 
 				static std::vector<Vector2> hoveredTiles = std::vector<Vector2>();
 				static std::vector<Vector2> selectedTiles = std::vector<Vector2>();
@@ -1361,54 +1373,53 @@ namespace FlatGui
 				}
 
 				// Draw TileMap indice Textures
-				for (std::pair<int, std::map<int, FL::Tile>> xPair : tiles)
+				for (std::pair<const std::pair<int, int>, FL::TileMapChunk>& chunkPair : tileMap->GetChunks())
 				{
-					float x = (float)xPair.first;
-					
-					if (x <= width)
-					{
-						for (std::pair<int, FL::Tile> yPair : xPair.second)
-						{
-							float y = (float)yPair.first;
+					FL::TileMapChunk& chunk = chunkPair.second;
 
-							if (y <= height)
-							{
-								FL::Tile tile = yPair.second;
-								TileSet* usedTileSet = nullptr;
-								std::string tileSetName = tile.tileSetName;
+					for (int cell = 0; cell < (int)chunk.tiles.size(); cell++)
+					{
+						FL::Tile tile = chunk.tiles[cell];
+						float x = (float)(chunk.chunkX * FL::TILEMAP_CHUNK_SIZE + cell % FL::TILEMAP_CHUNK_SIZE);
+						float y = (float)(chunk.chunkY * FL::TILEMAP_CHUNK_SIZE + cell / FL::TILEMAP_CHUNK_SIZE);
 
-								if (tileSetName != "")
-								{
-									usedTileSet = FL::GetTileSet(tileSetName);
-								}
+						if (tile.tileSet == FL::EMPTY_TILE || x > width || y > height)
+						{
+							continue;
+						}
 
-								// this many grid spaces fit into a single tiles width (if tileWidth is 16: 16 / 8 is 2 grid spaces in for a single tile 
-								float gridWidthsInATile = tileWidth / FL::F_pixelsPerGridSpace;
-								float gridHeightsInATile = tileHeight / FL::F_pixelsPerGridSpace;
+						TileSet* usedTileSet = FL::GetTileSet(tileMap->GetTileSetName(tile));
+						if (usedTileSet == nullptr)
+						{
+							continue;
+						}
 
-								VkDescriptorSet texture = tile.tileSetTexture;
-								float textureWidth = (float)usedTileSet->GetTexture()->GetWidth();
-								float textureHeight = (float)usedTileSet->GetTexture()->GetHeight();
-								Vector2 uvStart = Vector2(tile.uvStart.x / textureWidth, tile.uvStart.y / textureHeight);
-								Vector2 uvEnd = Vector2(tile.uvEnd.x / textureWidth, tile.uvEnd.y / textureHeight);
-								float gridXPosition = (position.x - (gridWidth / 2)) + gridWidthsInATile * x;
-								float gridYPosition = (position.y + (gridHeight / 2)) - gridHeightsInATile * y;
-								Vector2 tilePosition = Vector2(gridXPosition, gridYPosition);
+						// this many grid spaces fit into a single tiles width (if tileWidth is 16: 16 / 8 is 2 grid spaces in for a single tile 
+						float gridWidthsInATile = tileWidth / FL::F_pixelsPerGridSpace;
+						float gridHeightsInATile = tileHeight / FL::F_pixelsPerGridSpace;
 
+						VkDescriptorSet texture = usedTileSet->GetTexture()->GetTexture();
+						float textureWidth = (float)usedTileSet->GetTexture()->GetWidth();
+						float textureHeight = (float)usedTileSet->GetTexture()->GetHeight();
+						std::pair<Vector2, Vector2> uvs = usedTileSet->GetIndexUVs(tile.tileSetIndex);
+						Vector2 uvStart = Vector2(uvs.first.x / textureWidth, uvs.first.y / textureHeight);
+						Vector2 uvEnd = Vector2(uvs.second.x / textureWidth, uvs.second.y / textureHeight);
+						float gridXPosition = (position.x - (gridWidth / 2)) + gridWidthsInATile * x;
+						float gridYPosition = (position.y + (gridHeight / 2)) - gridHeightsInATile * y;
+						Vector2 tilePosition = Vector2(gridXPosition, gridYPosition);
 
-								// Change the draw channel for the scene object
-								if (renderOrder <= FL::F_maxSpriteLayers && renderOrder >= 0)
-								{
-									drawSplitter->SetCurrentChannel(drawList, renderOrder);
-								}
-								else
-								{
-									drawSplitter->SetCurrentChannel(drawList, 0);
-								}
 
-								FL::AddImageToDrawList(texture, tilePosition, FG_sceneViewCenter, tileWidth, tileHeight, Vector2(0, 0), scale, true, FG_sceneViewGridStep.x, drawList, 0, FL::GetColor32("white"), uvStart, uvEnd);
-							}
+						// Change the draw channel for the scene object
+						if (renderOrder <= FL::F_maxSpriteLayers && renderOrder >= 0)
+						{
+							drawSplitter->SetCurrentChannel(drawList, renderOrder);
 						}
+						else
+						{
+							drawSplitter->SetCurrentChannel(drawList, 0);
+						}
+
+						FL::AddImageToDrawList(texture, tilePosition, FG_sceneViewCenter, tileWidth, tileHeight, Vector2(0, 0), scale, true, FG_sceneViewGridStep.x, drawList, 0, FL::GetColor32("white"), uvStart, uvEnd);
 					}
 				}
 			}
@@ -1360,9 +1360,8 @@ namespace FlatGui
 	void RenderTextComponent(Text* text)
 	{
 		bool b_isActive = text->IsActive();
-		std::shared_ptr<Texture> texture = text->GetTexture();
-		float textureWidth = (float)texture->GetWidth();
-		float textureHeight = (float)texture->GetHeight();
+		float textureWidth = (float)text->GetWidth();
+		float textureHeight = (float)text->GetHeight();
 		int renderOrder = text->GetRenderOrder();
 		int fontSize = text->GetFontSize();
 		FL::Pivot pivotPoint = text->GetPivotPoint();
@@ -1498,6 +1497,7 @@ namespace FlatGui
 		bool b_isActive = boxCollider->IsActive();
 		bool b_isColliding = boxCollider->IsColliding();
 		bool b_isContinuous = boxCollider->IsContinuous();
+		bool b_firesStayEvents = boxCollider->FiresStayEvents();
 		bool b_isStatic = boxCollider->IsStatic();
 		bool b_isSolid = boxCollider->IsSolid();
 		bool b_showActiveRadius = boxCollider->GetShowActiveRadius();
@@ -1572,6 +1572,10 @@ namespace FlatGui
 		{
 			boxCollider->SetIsContinuous(b_isContinuous);
 		}
+		if (FL::RenderCheckbox(" Fires Stay Events", b_firesStayEvents))
+		{
+			boxCollider->SetFiresStayEvents(b_firesStayEvents);
+		}
 		if (FL::RenderCheckbox(" Is Static", b_isStatic))
 		{
 			boxCollider->SetIsStatic(b_isStatic);
@@ -1610,6 +1614,7 @@ namespace FlatGui
 		bool b_isActive = circleCollider->IsActive();
 		bool b_isColliding = circleCollider->IsColliding();
 		bool b_isContinuous = circleCollider->IsContinuous();
+		bool b_firesStayEvents = circleCollider->FiresStayEvents();
 		bool b_isStatic = circleCollider->IsStatic();
 		//bool b_isSolid = circleCollider->IsSolid();	temporarily disabled because circle physics is not sorted out yet
 		bool b_isSolid = false;
@@ -1656,6 +1661,10 @@ namespace FlatGui
 		{
 			circleCollider->SetIsContinuous(b_isContinuous);
 		}
+		if (FL::RenderCheckbox(" Fires Stay Events", b_firesStayEvents))
+		{
+			circleCollider->SetFiresStayEvents(b_firesStayEvents);
+		}
 		if (FL::RenderCheckbox(" Is Static", b_isStatic))
 		{
 			circleCollider->SetIsStatic(b_isStatic);
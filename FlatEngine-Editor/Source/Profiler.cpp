@@ -6,6 +6,13 @@
 #include "Collider.h"
 #include "Application.h"
 #include "Scene.h"
+#include "RenderQueue.h"
+#include "RenderIndex.h"
+#include "TextureAtlas.h"
+#include "GlyphCache.h"
+#include "TextureLoader.h"
+#include "TextureCache.h"
+#include "VirtualFileSystem.h"
 
 #include <deque>
 #include "implot.h"
@@ -28,6 +35,8 @@ namespace FlatGui
 			static bool b_animate = false;
 			static int offset = 0;
 			static bool b_showColliderPairs = true;
+			static bool b_showRenderExtraction = true;
+			static bool b_showGpuMemory = false;
 
 			FL::RenderCheckbox("Show Collider Pairs", b_showColliderPairs);
 			if (b_showColliderPairs)
@@ -52,6 +61,133 @@ namespace FlatGui
 				}
 			}
 
+			// Extraction time against object count for the Game View render queue
+			FL::RenderCheckbox("Show Render Extraction", b_showRenderExtraction);
+			if (b_showRenderExtraction)
+			{
+				if (FL::PushTable("##RenderExtractionData", 2))
+				{
+					FL::RenderQueue& renderQueue = FL::F_GameRenderQueue;
+					int objectCount = renderQueue.GetObjectCount();
+					float extractionTime = renderQueue.GetExtractionTime();
+					float timePerThousand = 0;
+					if (objectCount > 0)
+					{
+						timePerThousand = extractionTime / objectCount * 1000;
+					}
+
+					FL::RenderTextTableRow("##RenderExtractionIndexed", "Indexed Objects", std::to_string(FL::F_RenderIndex.GetEntryCount()));
+					FL::RenderTextTableRow("##RenderExtractionIndexUpdate", "Index Update (us)", std::to_string((int)FL::F_RenderIndex.GetUpdateTime()));
+					FL::RenderTextTableRow("##RenderExtractionObjects", "Visible Objects", std::to_string(objectCount));
+					FL::RenderTextTableRow("##RenderExtractionItems", "Render Items", std::to_string(renderQueue.GetItemCount()));
+					FL::RenderTextTableRow("##RenderExtractionTime", "Extraction (us)", std::to_string((int)extractionTime));
+					FL::RenderTextTableRow("##RenderExtractionPerThousand", "Per 1000 Objects (us)", std::to_string((int)timePerThousand));
+					FL::RenderTextTableRow("##RenderExtractionSortTime", "Sort (us)", std::to_string((int)renderQueue.GetSortTime()));
+					FL::RenderTextTableRow("##RenderExtractionBatches", "Draw Batches", std::to_string(renderQueue.GetBatchCount()));
+					FL::RenderTextTableRow("##RenderExtractionAtlasPages", "Atlas Pages", std::to_string(FL::F_TextureAtlas.GetPageCount()));
+					FL::RenderTextTableRow("##RenderExtractionAtlasRegions", "Atlased Images", std::to_string(FL::F_TextureAtlas.GetRegionCount()));
+					FL::RenderTextTableRow("##RenderExtractionGlyphFonts", "Glyph Pages", std::to_string(FL::F_GlyphCache.GetFontCount()));
+					FL::RenderTextTableRow("##RenderExtractionTextLayouts", "Cached Text Layouts", std::to_string(FL::F_GlyphCache.GetLayoutCount()));
+					FL::RenderTextTableRow("##RenderExtractionLayoutMisses", "Text Layouts Built", std::to_string(FL::F_GlyphCache.GetLayoutMisses()));
+					FL::RenderTextTableRow("##RenderExtractionTexturesLoading", "Textures Loading", std::to_string(FL::F_TextureLoader.GetPendingCount()));
+					FL::RenderTextTableRow("##RenderExtractionTexturesLoaded", "Textures Loaded", std::to_string(FL::F_TextureLoader.GetLoadedCount()));
+					FL::RenderTextTableRow("##RenderExtractionTextureDecode", "Texture Decode (us)", std::to_string((int)FL::F_TextureLoader.GetDecodeTime()));
+					FL::RenderTextTableRow("##RenderExtractionTextureUpload", "Texture Upload (us)", std::to_string((int)FL::F_TextureLoader.GetUploadTime()));
+					FL::RenderTextTableRow("##RenderExtractionAssetPack", "Asset Pack", FL::F_VirtualFileSystem.IsMounted() ? "Mounted" : "Loose Files");
+					FL::RenderTextTableRow("##RenderExtractionPackedReads", "Packed Reads", std::to_string(FL::F_VirtualFileSystem.GetPackedReads()));
+					FL::RenderTextTableRow("##RenderExtractionLooseReads", "Loose Reads", std::to_string(FL::F_VirtualFileSystem.GetLooseReads()));
+					if (FL::F_VulkanManager != nullptr && FL::F_VulkanManager->GetSpriteBatch().HasResources())
+					{
+						float buildTime = FL::F_VulkanManager->GetSpriteBatch().GetBuildTime();
+						float quadsPerMs = 0;
+						if (buildTime > 0)
+						{
+							quadsPerMs = renderQueue.GetItemCount() / (buildTime / 1000);
+						}
+						FL::RenderTextTableRow("##RenderExtractionSpriteBuild", "Sprite Batch Build (us)", std::to_string((int)buildTime));
+						FL::RenderTextTableRow("##RenderExtractionQuadsPerMs", "Quads per ms", std::to_string((int)quadsPerMs));
+					}
+					if (FL::F_VulkanManager != nullptr)
+					{
+						FL::CommandRecorder& commandRecorder = FL::F_VulkanManager->GetCommandRecorder();
+						FL::RenderTextTableRow("##RenderExtractionMeshRanges", "Mesh Command Buffers", std::to_string(commandRecorder.GetRangeCount()));
+						FL::RenderTextTableRow("##RenderExtractionMeshRecord", "Mesh Recording (us)", std::to_string((int)commandRecorder.GetRecordTime()));
+						FL::RenderTextTableRow("##RenderExtractionMeshDraws", "Mesh Draw Calls", std::to_string(commandRecorder.GetDrawCount()));
+						FL::RenderTextTableRow("##RenderExtractionMeshInstances", "Mesh Instances", std::to_string(commandRecorder.GetInstanceCount()));
+						FL::RenderTextTableRow("##RenderExtractionUniformRing", "Uniform Ring Slots", std::to_string(FL::VM_uniformRing.GetCapacity()));
+						FL::RenderTextTableRow("##RenderExtractionPipelineCache", "Pipeline Cache", FL::VM_pipelineCache.LoadedFromDisk() ? "Warm" : "Cold");
+						FL::RenderTextTableRow("##RenderExtractionPipelines", "Pipelines Created", std::to_string(FL::VM_pipelineCache.GetPipelineCount()));
+						FL::RenderTextTableRow("##RenderExtractionPipelineTime", "Pipeline Creation (us)", std::to_string((int)FL::VM_pipelineCache.GetCreationTime()));
+
+						int cookedModels = 0;
+						float modelLoadTime = 0;
+						for (std::pair<const std::string, std::shared_ptr<FL::Model>>& model : FL::F_VulkanManager->GetModels())
+						{
+							if (model.second->LoadedFromCook())
+							{
+								cookedModels++;
+							}
+							modelLoadTime += model.second->GetLoadTime();
+						}
+						FL::RenderTextTableRow("##RenderExtractionModels", "Models Loaded", std::to_string(FL::F_VulkanManager->GetModels().size()));
+						FL::RenderTextTableRow("##RenderExtractionCookedModels", "Models From Cook", std::to_string(cookedModels));
+						FL::RenderTextTableRow("##RenderExtractionModelLoad", "Model Load (us)", std::to_string((int)modelLoadTime));
+					}
+					FL::PopTable();
+				}
+				// Times every loaded model from its .obj and from its cook, the cook includes the vertex cache optimized order
+				if (FL::F_VulkanManager != nullptr && FL::RenderButton("Benchmark Model Loads"))
+				{
+					for (std::pair<const std::string, std::shared_ptr<FL::Model>>& model : FL::F_VulkanManager->GetModels())
+					{
+						float objTime = 0;
+						float cookedTime = 0;
+						if (FL::Model::BenchmarkLoad(model.first, 10, objTime, cookedTime))
+						{
+							FL::LogString(model.first + " - obj: " + std::to_string((int)objTime) + "us, cooked: " + std::to_string((int)cookedTime) + "us");
+						}
+						else
+						{
+							FL::LogError("Could not benchmark " + model.first);
+						}
+					}
+				}
+			}
+
+			// Device memory sub-allocated by VM_memoryAllocator
+			FL::RenderCheckbox("Show GPU Memory", b_showGpuMemory);
+			if (b_showGpuMemory)
+			{
+				if (FL::PushTable("##GpuMemoryData", 2))
+				{
+					FL::MemoryStats memoryStats = FL::VM_memoryAllocator.GetStats();
+					float megabyte = 1024.0f * 1024.0f;
+
+					FL::RenderTextTableRow("##GpuMemoryBlocks", "Memory Blocks", std::to_string(memoryStats.blockCount));
+					FL::RenderTextTableRow("##GpuMemoryAllocations", "Allocations", std::to_string(memoryStats.allocationCount));
+					FL::RenderTextTableRow("##GpuMemoryReserved", "Reserved (MB)", std::to_string(memoryStats.reserved / megabyte));
+					FL::RenderTextTableRow("##GpuMemoryUsed", "Used (MB)", std::to_string(memoryStats.used / megabyte));
+					FL::RenderTextTableRow("##GpuMemoryFree", "Free (MB)", std::to_string((memoryStats.reserved - memoryStats.used) / megabyte));
+					FL::RenderTextTableRow("##GpuMemoryLargestFree", "Largest Free Range (MB)", std::to_string(memoryStats.largestFree / megabyte));
+					FL::RenderTextTableRow("##GpuMemoryFragmentation", "Fragmentation (%)", std::to_string((int)(memoryStats.fragmentation * 100)));
+					FL::RenderTextTableRow("##GpuMemoryUploadQueue", "Upload Queue", FL::VM_uploadManager.HasDedicatedQueue() ? "Dedicated" : "Graphics");
+					FL::RenderTextTableRow("##GpuMemoryStaging", "Staging Ring Used (MB)", std::to_string(FL::VM_uploadManager.GetStagingUsed() / megabyte));
+					FL::RenderTextTableRow("##GpuMemoryUploaded", "Uploaded (MB)", std::to_string(FL::VM_uploadManager.GetUploadedBytes() / megabyte));
+					FL::RenderTextTableRow("##GpuMemoryUploadBatches", "Upload Batches In Flight", std::to_string(FL::VM_uploadManager.GetPendingBatchCount()));
+					FL::RenderTextTableRow("##GpuMemoryUploadStalls", "Upload Stalls", std::to_string(FL::VM_uploadManager.GetStallCount()));
+					FL::RenderTextTableRow("##GpuMemoryTextures", "Cached Textures", std::to_string(FL::F_TextureCache.GetEntryCount()));
+					FL::RenderTextTableRow("##GpuMemoryTexturesReferenced", "Referenced Textures", std::to_string(FL::F_TextureCache.GetReferencedCount()));
+					FL::RenderTextTableRow("##GpuMemoryTextureMemory", "Texture Memory (MB)", std::to_string(FL::F_TextureCache.GetResidentBytes() / megabyte));
+					FL::RenderTextTableRow("##GpuMemoryTextureHits", "Texture Cache Hits", std::to_string(FL::F_TextureCache.GetHits()));
+					FL::RenderTextTableRow("##GpuMemoryTextureEvictions", "Textures Evicted", std::to_string(FL::F_TextureCache.GetEvictionCount()));
+					FL::PopTable();
+				}
+				if (FL::RenderButton("Release Empty Blocks"))
+				{
+					FL::VM_memoryAllocator.ReleaseEmptyBlocks();
+				}
+			}
+
 			FL::RenderCheckbox("Animate", b_animate);
 			if (b_animate)
 			{
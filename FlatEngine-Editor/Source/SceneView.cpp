@@ -5,9 +5,11 @@
 #include "SceneManager.h"
 #include "Scene.h"
 #include "Project.h"
+#include "RenderIndex.h"
 
 #include "imgui_internal.h"
 #include <cmath> // trunc
+#include <algorithm>
 
 
 namespace FlatGui 
@@ -97,22 +99,22 @@ namespace FlatGui
 				}
 			}
 			
-			Scene* loadedScene = FL::F_SceneManager.GetLoadedScene();
-			std::map<long, GameObject> sceneObjects = std::map<long, GameObject>();
-			std::map<long, GameObject> persistantObjects = std::map<long, GameObject>();
+			// Only visit what is inside the Scene View, plus the focused object so its gizmos and TileMap editing keep working off screen
+			float viewTop = (FG_sceneViewCenter.y - canvas_p0.y) / FG_sceneViewGridStep.y;
+			float viewRight = (canvas_p0.x + canvas_sz.x - FG_sceneViewCenter.x) / FG_sceneViewGridStep.x;
+			float viewBottom = (FG_sceneViewCenter.y - (canvas_p0.y + canvas_sz.y)) / FG_sceneViewGridStep.y;
+			float viewLeft = (canvas_p0.x - FG_sceneViewCenter.x) / FG_sceneViewGridStep.x;
 
-			if (loadedScene != nullptr)
-			{
-				sceneObjects = loadedScene->GetSceneObjects();
-			}
-			if (FL::GetLoadedProject().GetPersistantGameObjectScene() != nullptr)
+			FL::F_RenderIndex.Update();
+			std::vector<GameObject*> visibleObjects = FL::F_RenderIndex.Query(Vector4(viewTop, viewRight, viewBottom, viewLeft));
+			GameObject* focusedObject = FL::GetObjectByID(GetFocusedGameObjectID());
+
+			if (focusedObject != nullptr && std::find(visibleObjects.begin(), visibleObjects.end(), focusedObject) == visibleObjects.end())
 			{
-				persistantObjects = FL::GetLoadedProject().GetPersistantGameObjectScene()->GetSceneObjects();
+				visibleObjects.push_back(focusedObject);
 			}
 
-
-			RenderViewObjects(sceneObjects, FG_sceneViewCenter, canvas_p0, canvas_sz, FG_sceneViewGridStep.x);
-			RenderViewObjects(persistantObjects, FG_sceneViewCenter, canvas_p0, canvas_sz, FG_sceneViewGridStep.x);
+			RenderViewObjects(visibleObjects, FG_sceneViewCenter, canvas_p0, canvas_sz, FG_sceneViewGridStep.x);
 
 
 			// For centering on focused GameObject
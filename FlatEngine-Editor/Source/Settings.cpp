@@ -109,6 +109,11 @@ namespace FlatGui
 						{
 							FL::F_LoadedProject.SetVsyncEnabled(b_vsyncEnabled);
 						}
+						bool b_packTexturesOnLoad = FL::F_LoadedProject.PacksTexturesOnLoad();
+						if (FL::RenderCheckboxTableRow("##PackTexturesOnLoadCheckbox", "Pack Sprite Atlas On Load", b_packTexturesOnLoad))
+						{
+							FL::F_LoadedProject.SetPackTexturesOnLoad(b_packTexturesOnLoad);
+						}
 					}
 					else if (settingSelected == "State")
 					{
@@ -6,9 +6,19 @@
 #include "AssetManager.h"
 #include "PrefabManager.h"
 #include "Project.h"
+#include "Replay.h"
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "SceneManager.h"
+#include "VirtualFileSystem.h"
+#include "MemoryAllocator.h"
+#include "TextureLoader.h"
 
 #include <string>
 #include <memory>
+#include <cstdlib>
+#include <climits>
+#include <stdexcept>
 #include "imgui_internal.h"
 
 namespace FL = FlatEngine;
@@ -57,6 +67,11 @@ public:
 	{
 		A_GameLoop = new RuntimeGameLoop();
 		m_recreateWindow = false;
+		m_spriteBenchmarkQuads = 0;
+		m_atlasBenchmarkRects = 0;
+		m_sceneBenchmarkMegabytes = 0;
+		m_extractionBenchmarkObjects = 0;
+		m_decodeBenchmarkThreads = 0;
 		SetDirectoryType(FL::RuntimeDir);
 	}
 	~RuntimeApplication()
@@ -76,6 +91,46 @@ public:
 	void Run()
 	{
 		bool& b_hasQuit = HasQuit();
+
+		if (m_selfTest != "")
+		{
+			RunSelfTest();
+			return;
+		}
+		if (m_replayPath != "")
+		{
+			RunOnceAfterInitialization();
+			RunReplay();
+			return;
+		}
+		if (m_spriteBenchmarkQuads > 0)
+		{
+			RunSpriteBenchmark();
+			return;
+		}
+		if (m_atlasBenchmarkRects > 0)
+		{
+			RunAtlasBenchmark();
+			return;
+		}
+		if (m_sceneBenchmarkMegabytes > 0)
+		{
+			RunSceneLoadBenchmark();
+			return;
+		}
+		if (m_extractionBenchmarkObjects > 0)
+		{
+			RunOnceAfterInitialization();
+			RunExtractionBenchmark();
+			return;
+		}
+		if (m_decodeBenchmarkThreads > 0)
+		{
+			RunOnceAfterInitialization();
+			RunDecodeBenchmark();
+			return;
+		}
+
 		while (!b_hasQuit)
 		{
 			RunOnceAfterInitialization();
@@ -87,6 +142,11 @@ public:
 			if (!A_GameLoop->IsStarted())
 			{
 				A_GameLoop->Start();
+
+				if (m_recordPath != "")
+				{
+					FL::F_Replay.StartRecording();
+				}
 			}
 
 			if ((GameLoopStarted() && !GameLoopPaused()) || (GameLoopPaused() && A_GameLoop->IsFrameSkipped()))
@@ -105,6 +165,8 @@ public:
 						FL::HandleEvents(b_hasQuit);
 						A_GameLoop->Update();
 						A_GameLoop->SetFrameSkipped(false);
+						// Deleted after every step, the same order RunReplay() steps in, so a recording replays to the same state hashes
+						A_GameLoop->DeleteObjectsInDeleteQueue();
 
 						A_GameLoop->m_time += A_GameLoop->m_deltaTime;
 						A_GameLoop->m_accumulator -= A_GameLoop->m_deltaTime;
@@ -133,7 +195,7 @@ public:
 
 			EndRender();
 
-
+			// Only has anything left when objects were queued outside of a step (paused or not started)
 			A_GameLoop->DeleteObjectsInDeleteQueue();
 
 			if (FL::F_b_closeProgramQueued)
@@ -141,6 +203,154 @@ public:
 				Quit();
 			}
 		}
+
+		if (FL::F_Replay.IsRecording())
+		{
+			FL::F_Replay.StopRecording();
+			FL::F_Replay.SaveToFile(m_recordPath);
+		}
+	}
+	// Headless playback of a recording made with -record, steps the GameLoop as fast as possible without rendering and exits with 0 if every step's state hash matched
+	void RunReplay()
+	{
+		if (!FL::F_Replay.LoadFromFile(m_replayPath))
+		{
+			SetExitCode(1);
+			return;
+		}
+
+		bool& b_hasQuit = HasQuit();
+		A_GameLoop->Start();
+		FL::F_Replay.StartPlayback();
+
+		while (FL::F_Replay.IsPlaying() && !b_hasQuit)
+		{
+			FL::HandleEvents(b_hasQuit);
+			A_GameLoop->Update();
+			A_GameLoop->DeleteObjectsInDeleteQueue();
+			A_GameLoop->m_time += A_GameLoop->m_deltaTime;
+		}
+
+		if (FL::F_Replay.HasMismatch() || FL::F_Replay.GetCurrentStep() < FL::F_Replay.GetStepCount())
+		{
+			FL::LogError("Replay failed at step " + std::to_string(FL::F_Replay.GetCurrentStep()) + " of " + std::to_string(FL::F_Replay.GetStepCount()));
+			SetExitCode(1);
+		}
+		else
+		{
+			FL::LogString("Replay verified " + std::to_string(FL::F_Replay.GetStepCount()) + " steps");
+			SetExitCode(0);
+		}
+
+		A_GameLoop->Stop();
+	}
+	// Runs one of the engine's built in checks by name and exits with 0 if it passed
+	void RunSelfTest()
+	{
+		std::string failure = "";
+		bool b_passed = false;
+
+		// The Vulkan side throws on failure rather than returning false
+		try
+		{
+			if (m_selfTest == "memoryAllocator")
+			{
+				b_passed = FL::MemoryAllocator::RunSelfTest(failure);
+			}
+			else if (m_selfTest == "cookedMips")
+			{
+				b_passed = FL::F_VulkanManager->CheckCookedMips(failure);
+			}
+			else
+			{
+				failure = "no self test named \"" + m_selfTest + "\"";
+			}
+		}
+		catch (const std::exception& exception)
+		{
+			b_passed = false;
+			failure = exception.what();
+		}
+
+		if (b_passed)
+		{
+			FL::LogString("Self test " + m_selfTest + " passed");
+			SetExitCode(0);
+		}
+		else
+		{
+			FL::LogError("Self test " + m_selfTest + " failed: " + failure);
+			SetExitCode(1);
+		}
+	}
+	// Headless timing of the CPU side of sprite batching (render queue sort + instance building), no frames are drawn
+	void RunSpriteBenchmark()
+	{
+		float quadsPerMs = FL::SpriteBatch::MeasureBuildRate(m_spriteBenchmarkQuads, 100);
+		FL::LogString("Sprite batch built " + std::to_string(m_spriteBenchmarkQuads) + " quads at " + std::to_string((int)quadsPerMs) + " quads/ms");
+		SetExitCode(0);
+	}
+	// Headless timing of the atlas skyline packer, no images are loaded
+	void RunAtlasBenchmark()
+	{
+		float occupancy = 0;
+		int pageCount = 0;
+		float rectsPerMs = FL::AtlasPacker::MeasurePackRate(m_atlasBenchmarkRects, 100, occupancy, pageCount);
+		FL::LogString("Atlas packed " + std::to_string(m_atlasBenchmarkRects) + " rects into " + std::to_string(pageCount) + " pages at " + std::to_string((int)rectsPerMs) + " rects/ms, " + std::to_string(occupancy * 100) + " percent occupancy");
+		SetExitCode(0);
+	}
+	// Headless timing of reading and parsing a generated scene file, no GameObjects are created
+	void RunSceneLoadBenchmark()
+	{
+		float lineReadTime = 0;
+		float singleReadTime = 0;
+		float streamTime = 0;
+		if (!FL::SceneManager::MeasureLoadTimes(m_sceneBenchmarkMegabytes, lineReadTime, singleReadTime, streamTime))
+		{
+			FL::LogError("Scene load benchmark failed");
+			SetExitCode(1);
+			return;
+		}
+		FL::LogString(std::to_string(m_sceneBenchmarkMegabytes) + " MB scene: line by line " + std::to_string(lineReadTime) + " ms, single read " + std::to_string(singleReadTime) + " ms, streamed " + std::to_string(streamTime) + " ms");
+		SetExitCode(0);
+	}
+	// Headless timing of game view render extraction against object count, sprites are added to the runtime scene and nothing is drawn
+	void RunExtractionBenchmark()
+	{
+		std::vector<int> objectCounts;
+		std::vector<float> extractionTimes;
+		if (!FL::Game_MeasureExtraction(m_extractionBenchmarkObjects, 100, objectCounts, extractionTimes))
+		{
+			FL::LogError("Render extraction benchmark failed");
+			SetExitCode(1);
+			return;
+		}
+		for (size_t i = 0; i < objectCounts.size(); i++)
+		{
+			FL::LogString("Render extraction of " + std::to_string(objectCounts[i]) + " objects: " + std::to_string(extractionTimes[i]) + " us per frame, " + std::to_string(extractionTimes[i] * 1000 / objectCounts[i]) + " us per 1000 objects");
+		}
+		SetExitCode(0);
+	}
+	// Headless timing of decoding every project image on one worker thread and on the given number of worker threads
+	void RunDecodeBenchmark()
+	{
+		int imageCount = 0;
+		uint64_t decodedBytes = 0;
+		float singleThreadTime = 0;
+		float threadedTime = 0;
+
+		// The scene's own texture loads would compete for the cores
+		FL::F_TextureLoader.Finish();
+
+		if (!FL::MeasureImageDecode(m_decodeBenchmarkThreads, imageCount, decodedBytes, singleThreadTime, threadedTime))
+		{
+			FL::LogError("Image decode benchmark failed, the project has no images that decode");
+			SetExitCode(1);
+			return;
+		}
+		FL::LogString("Decoded " + std::to_string(imageCount) + " images (" + std::to_string(decodedBytes / (1024 * 1024)) + " MB): 1 thread " + std::to_string(singleThreadTime / 1000) + " ms, " +
+			std::to_string(m_decodeBenchmarkThreads) + " threads " + std::to_string(threadedTime / 1000) + " ms");
+		SetExitCode(0);
 	}
 	void RunOnceAfterInitialization()
 	{
@@ -226,16 +436,88 @@ public:
 
 	bool m_recreateWindow;
 	std::string m_startupProject;
+	std::string m_recordPath;
+	std::string m_replayPath;
+	std::string m_selfTest;
+	int m_spriteBenchmarkQuads;
+	int m_atlasBenchmarkRects;
+	int m_sceneBenchmarkMegabytes;
+	int m_extractionBenchmarkObjects;
+	int m_decodeBenchmarkThreads;
 
 private:
 	RuntimeGameLoop* A_GameLoop;
 };
 
 
+// Counts given on the command line must be whole numbers above 0, anything else is logged and the flag is ignored
+static bool ParseCountArgument(std::string flag, std::string text, int& count)
+{
+	char* end = nullptr;
+	long value = std::strtol(text.c_str(), &end, 10);
+
+	if (text == "" || end == nullptr || *end != '\0' || value <= 0 || value > INT_MAX)
+	{
+		FL::LogError(flag + " expects a whole number above 0, got \"" + text + "\"");
+		return false;
+	}
+
+	count = (int)value;
+	return true;
+}
+
+
 // Define our CreateApplication() for the Runtime
 std::shared_ptr<FL::Application> FL::CreateApplication(int argc, char** argv)
 {
 	std::shared_ptr<RuntimeApplication> RuntimeApp = std::make_shared<RuntimeApplication>();
 	RuntimeApp->SetWindowDimensions(1920, 1080);
+
+	// -record <file> saves the input and state hashes of the session, -replay <file> verifies them headlessly
+	// -test <name> runs a built in self test (memoryAllocator, cookedMips) and exits with 0 if it passed
+	// -benchmarkSprites <quadCount> prints the sprite batch build rate and exits
+	// -benchmarkAtlas <rectCount> prints the atlas packing rate and page occupancy and exits
+	// -benchmarkSceneLoad <megabytes> prints the read and parse times of a generated scene that size and exits
+	// -benchmarkExtraction <objectCount> prints the game view render extraction time at a quarter, half and all of objectCount sprites and exits
+	// -benchmarkDecode <threadCount> prints the time to decode every project image on one thread and on threadCount threads and exits
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (std::string(argv[i]) == "-record")
+		{
+			RuntimeApp->m_recordPath = argv[i + 1];
+		}
+		else if (std::string(argv[i]) == "-replay")
+		{
+			RuntimeApp->m_replayPath = argv[i + 1];
+		}
+		else if (std::string(argv[i]) == "-test")
+		{
+			RuntimeApp->m_selfTest = argv[i + 1];
+		}
+		else if (std::string(argv[i]) == "-benchmarkSprites")
+		{
+			ParseCountArgument(argv[i], argv[i + 1], RuntimeApp->m_spriteBenchmarkQuads);
+		}
+		else if (std::string(argv[i]) == "-benchmarkAtlas")
+		{
+			ParseCountArgument(argv[i], argv[i + 1], RuntimeApp->m_atlasBenchmarkRects);
+		}
+		else if (std::string(argv[i]) == "-benchmarkSceneLoad")
+		{
+			ParseCountArgument(argv[i], argv[i + 1], RuntimeApp->m_sceneBenchmarkMegabytes);
+		}
+		else if (std::string(argv[i]) == "-benchmarkExtraction")
+		{
+			ParseCountArgument(argv[i], argv[i + 1], RuntimeApp->m_extractionBenchmarkObjects);
+		}
+		else if (std::string(argv[i]) == "-benchmarkDecode")
+		{
+			ParseCountArgument(argv[i], argv[i + 1], RuntimeApp->m_decodeBenchmarkThreads);
+		}
+	}
+
+	// A build made by BuildProject() reads its assets out of the pack beside it, a run from the solution reads loose files
+	FL::F_VirtualFileSystem.Mount("..\\" + FL::ASSET_PACK_FILENAME);
+
 	return RuntimeApp;
 }
\ No newline at end of file
@@ -4,6 +4,8 @@ C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader.vert -o compiledShaders/vert.spv
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader.frag -o compiledShaders/frag.spv
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader2.vert -o compiledShaders/vert2.spv
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader2.frag -o compiledShaders/frag2.spv
+C:/VulkanSDK/1.3.283.0/Bin/glslc.exe sprite.vert -o compiledShaders/spriteVert.spv
+C:/VulkanSDK/1.3.283.0/Bin/glslc.exe sprite.frag -o compiledShaders/spriteFrag.spv
 
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe imgui.vert -o ../Binaries/windows-x86_64/Release/Shaders/compiledShaders/imguiVert.spv
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe imgui.frag -o ../Binaries/windows-x86_64/Release/Shaders/compiledShaders/imguiFrag.spv
@@ -11,6 +13,8 @@ C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader.vert -o ../Binaries/windows-x86_64/R
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader.frag -o ../Binaries/windows-x86_64/Release/Shaders/compiledShaders/frag.spv
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader2.vert -o ../Binaries/windows-x86_64/Release/Shaders/compiledShaders/vert2.spv
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader2.frag -o ../Binaries/windows-x86_64/Release/Shaders/compiledShaders/frag2.spv
+C:/VulkanSDK/1.3.283.0/Bin/glslc.exe sprite.vert -o ../Binaries/windows-x86_64/Release/Shaders/compiledShaders/spriteVert.spv
+C:/VulkanSDK/1.3.283.0/Bin/glslc.exe sprite.frag -o ../Binaries/windows-x86_64/Release/Shaders/compiledShaders/spriteFrag.spv
 
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe imgui.vert -o ../Binaries/windows-x86_64/Debug/Shaders/compiledShaders/imguiVert.spv
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe imgui.frag -o ../Binaries/windows-x86_64/Debug/Shaders/compiledShaders/imguiFrag.spv
@@ -18,5 +22,7 @@ C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader.vert -o ../Binaries/windows-x86_64/D
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader.frag -o ../Binaries/windows-x86_64/Debug/Shaders/compiledShaders/frag.spv
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader2.vert -o ../Binaries/windows-x86_64/Debug/Shaders/compiledShaders/vert2.spv
 C:/VulkanSDK/1.3.283.0/Bin/glslc.exe shader2.frag -o ../Binaries/windows-x86_64/Debug/Shaders/compiledShaders/frag2.spv
+C:/VulkanSDK/1.3.283.0/Bin/glslc.exe sprite.vert -o ../Binaries/windows-x86_64/Debug/Shaders/compiledShaders/spriteVert.spv
+C:/VulkanSDK/1.3.283.0/Bin/glslc.exe sprite.frag -o ../Binaries/windows-x86_64/Debug/Shaders/compiledShaders/spriteFrag.spv
 
 pause
\ No newline at end of file
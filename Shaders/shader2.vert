@@ -14,13 +14,14 @@ layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTexCoord;
 layout(location = 3) in vec3 inNormal;
+layout(location = 4) in mat4 instanceTransform;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
 layout(location = 2) out vec3 normal;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition + position, 1.0);
+    gl_Position = ubo.proj * ubo.view * instanceTransform * ubo.model * vec4(inPosition + position, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
     normal = inNormal;
@@ -0,0 +1,35 @@
+#version 450
+
+// Screen pixels to clip space, same mapping the ImGui backend uses
+layout(push_constant, std430) uniform pc {
+    vec2 scale;
+    vec2 translate;
+};
+
+// Per instance, see SpriteInstance in SpriteBatch.h
+layout(location = 0) in vec2 inCenter;
+layout(location = 1) in vec2 inHalfSize;
+layout(location = 2) in float inRotation;
+layout(location = 3) in vec4 inColor;
+layout(location = 4) in vec4 inUVRect;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+
+// Two triangles per quad, no vertex buffer needed
+const vec2 corners[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+    vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0)
+);
+
+void main() {
+    vec2 corner = corners[gl_VertexIndex];
+    vec2 local = corner * inHalfSize;
+    float cosA = cos(inRotation);
+    float sinA = sin(inRotation);
+    vec2 rotated = vec2(local.x * cosA - local.y * sinA, local.x * sinA + local.y * cosA);
+
+    gl_Position = vec4((inCenter + rotated) * scale + translate, 0.0, 1.0);
+    fragColor = inColor;
+    fragTexCoord = mix(inUVRect.xy, inUVRect.zw, corner * 0.5 + 0.5);
+}
\ No newline at end of file